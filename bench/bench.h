@@ -0,0 +1,97 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_BENCH_BENCH_H_
+#define FSB_BENCH_BENCH_H_
+
+#include "synthetic_window_source.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fsb {
+//! @brief Settings shared by every suite, from the command line of fsb_bench.
+struct BenchOptions {
+    //! Windows on the synthetic desktop.
+    size_t window_count_ = 10000;
+    //! Timed runs per case.
+    size_t iterations_ = 20;
+    //! Probe worker threads, 0 to size the pool from the hardware.
+    size_t threads_ = 0;
+    //! Latency added to every per-window and per-process call of the synthetic desktop.
+    std::chrono::microseconds call_latency_{0};
+    double hung_fraction_ = 0.01;
+    //! Trace the replay suite replays, empty to record one from the synthetic desktop.
+    std::string trace_path_;
+};
+
+//! @brief Returns the synthetic desktop the options describe.
+SyntheticOptions DesktopOptions(const BenchOptions& options);
+
+//! @brief Number of heap allocations made by the process so far, counted by the operator new of
+//! fsb_bench.
+uint64_t AllocationCount();
+
+//! @brief Timings of one case, one sample per iteration.
+class BenchCase {
+public:
+    //! @param name Printed in the first column.
+    //! @param items Items one iteration processes, for the throughput column, e.g. windows.
+    //! @param unit Name of an item, e.g. "windows".
+    BenchCase(std::string_view name, double items, std::string_view unit);
+    ~BenchCase();
+
+    BenchCase(const BenchCase&) = delete;
+    BenchCase& operator=(const BenchCase&) = delete;
+
+    //! @brief Times one iteration of body.
+    template <typename Body>
+    void Run(Body&& body) {
+        const uint64_t kAllocations = AllocationCount();
+        const auto kStart = std::chrono::steady_clock::now();
+        body();
+        const auto kEnd = std::chrono::steady_clock::now();
+        allocations_ += AllocationCount() - kAllocations;
+        samples_.push_back(std::chrono::duration<double, std::micro>(kEnd - kStart).count());
+    }
+
+    //! @brief Adds a sample the caller timed itself, e.g. a latency spanning several calls.
+    void AddSample(std::chrono::steady_clock::duration sample) {
+        samples_.push_back(std::chrono::duration<double, std::micro>(sample).count());
+    }
+
+    //! @brief Adds a value averaged over the iterations to the line, e.g. bytes per frame.
+    void SetExtra(std::string_view label, double total);
+
+private:
+    std::string_view name_;
+    double items_;
+    std::string_view unit_;
+    std::vector<double> samples_;
+    uint64_t allocations_;
+    std::string_view extra_label_;
+    double extra_total_;
+};
+
+//! @brief Prints the header of the case table.
+void PrintBenchHeader(std::string_view suite);
+
+void BenchConfig(const BenchOptions& options);
+void BenchEnumeration(const BenchOptions& options);
+void BenchFiltering(const BenchOptions& options);
+void BenchGeometry(const BenchOptions& options);
+void BenchRendering(const BenchOptions& options);
+void BenchReplay(const BenchOptions& options);
+void BenchRules(const BenchOptions& options);
+void BenchServing(const BenchOptions& options);
+void BenchSnapshots(const BenchOptions& options);
+void BenchStrings(const BenchOptions& options);
+void BenchTranscoding(const BenchOptions& options);
+} // namespace fsb
+
+#endif // #ifndef FSB_BENCH_BENCH_H_
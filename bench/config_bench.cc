@@ -0,0 +1,133 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "bench.h"
+
+#include "mapped_file.h"
+#include "probe_pool.h"
+#include "string_pool.h"
+#include "window_probe.h"
+#include "window_table.h"
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fsb {
+namespace {
+constexpr std::string_view kTypicalConfig =
+    "# fsb settings\r\n"
+    "hide_hidden_windows = true\r\n"
+    "hide_blank_title_windows = true\r\n"
+    "\r\n"
+    "# 0 sizes the pool from the hardware.\r\n"
+    "probe_threads = 0\r\n"
+    "prefetch_radius = 4\r\n"
+    "max_fps = 60\r\n"
+    "trace = off\r\n";
+
+std::string BenchConfigPath() {
+#ifdef _WIN32
+    return "fsb-bench.config";
+#else
+    return "/tmp/fsb-bench-" + std::to_string(getpid()) + ".config";
+#endif
+}
+
+bool WriteFile(const std::string& path, std::string_view contents) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    const bool kWritten = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    return std::fclose(file) == 0 && kWritten;
+}
+} // namespace
+
+void BenchConfig(const BenchOptions& options) {
+    PrintBenchHeader("config");
+    {
+        BenchCase bench("ParseConfigText, typical file", static_cast<double>(kTypicalConfig.size()),
+            "bytes");
+        size_t invalid_lines = 0;
+        for (size_t i = 0; i < options.iterations_ * 100; ++i) {
+            Config config = kDefaultConfig;
+            bench.Run([&]() { invalid_lines += ParseConfigText(kTypicalConfig, &config); });
+        }
+        bench.SetExtra("invalid lines", static_cast<double>(invalid_lines));
+    }
+    {
+        // The largest file ReadConfigFile accepts.
+        std::string text;
+        while (text.size() + kTypicalConfig.size() <= (size_t{1} << 20)) {
+            text += kTypicalConfig;
+        }
+        BenchCase bench("ParseConfigText, 1 MiB file", static_cast<double>(text.size()), "bytes");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            Config config = kDefaultConfig;
+            bench.Run([&]() { static_cast<void>(ParseConfigText(text, &config)); });
+        }
+    }
+
+    // A reload as ConfigWatcher::Poll does it once the file changed: one read, a comparison with
+    // the contents the current config came from, and a parse into a fresh Config.
+    const std::string kPath = BenchConfigPath();
+    {
+        const std::string kEdited = std::string(kTypicalConfig) + "max_fps = 30\r\n";
+        std::string contents(kTypicalConfig);
+        BenchCase bench("reload, read and parse", 1.0, "reloads");
+        size_t reloads = 0;
+        for (size_t i = 0; i < options.iterations_ * 10; ++i) {
+            if (!WriteFile(kPath, i % 2 == 0 ? kEdited : kTypicalConfig)) {
+                break;
+            }
+            Config config = kDefaultConfig;
+            bench.Run([&]() {
+                MappedFile file;
+                std::string read;
+                if (file.Open(kPath)) {
+                    read.assign(reinterpret_cast<const char*>(file.data()), file.size());
+                }
+                if (read == contents) {
+                    return;
+                }
+                contents = std::move(read);
+                config = kDefaultConfig;
+                static_cast<void>(ParseConfigText(contents, &config));
+                ++reloads;
+            });
+        }
+        bench.SetExtra("reloads", static_cast<double>(reloads));
+    }
+    static_cast<void>(std::remove(kPath.c_str()));
+
+    {
+        // Console::ApplyConfig with tightened filters: the table drops rows, nothing is
+        // enumerated again.
+        SyntheticWindowSource source(DesktopOptions(options));
+        ProbePool pool(options.threads_);
+        StringPool strings;
+        Config everything = kDefaultConfig;
+        everything.hide_hidden_windows_ = false;
+        everything.hide_blank_title_windows_ = false;
+        std::vector<ProcessData> windows;
+        EnumerateWindows(source, strings, pool, everything, &windows);
+
+        BenchCase bench("reload, apply tightened filters", static_cast<double>(windows.size()),
+            "windows");
+        size_t removed = 0;
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            WindowTable table;
+            table.Reset(windows);
+            bench.Run([&]() { removed += table.RemoveFiltered(kDefaultConfig); });
+        }
+        bench.SetExtra("rows removed", static_cast<double>(removed));
+    }
+}
+} // namespace fsb
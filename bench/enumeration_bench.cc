@@ -0,0 +1,276 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "bench.h"
+
+#include "headless.h"
+#include "probe_pool.h"
+#include "rule_engine.h"
+#include "string_pool.h"
+#include "trace.h"
+#include "window_columns.h"
+#include "window_health.h"
+#include "window_probe.h"
+#include "window_search.h"
+#include "window_table.h"
+
+#include <cstdio>
+#include <string>
+#include <utility>
+
+namespace fsb {
+namespace {
+#ifdef _WIN32
+constexpr char kNullDevice[] = "NUL";
+#else
+constexpr char kNullDevice[] = "/dev/null";
+#endif
+
+//! Enumerates the whole desktop once, outside of any timing.
+std::vector<ProcessData> Enumerate(SyntheticWindowSource& source, StringPool& strings,
+    ProbePool& pool, const Config& config) {
+    std::vector<ProcessData> windows;
+    EnumerateWindows(source, strings, pool, config, &windows);
+    return windows;
+}
+} // namespace
+
+void BenchEnumeration(const BenchOptions& options) {
+    SyntheticWindowSource source(DesktopOptions(options));
+    ProbePool pool(options.threads_);
+    StringPool strings;
+    const auto kWindows = static_cast<double>(source.window_count());
+
+    PrintBenchHeader("enumeration");
+    {
+        BenchCase bench("EnumerateWindows", kWindows, "windows");
+        std::vector<ProcessData> windows;
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() { EnumerateWindows(source, strings, pool, kDefaultConfig, &windows); });
+        }
+    }
+    {
+        // What --trace adds to a refresh, against EnumerateWindows above.
+        Tracer::Get().Reset();
+        Tracer::Get().SetEnabled(true);
+        BenchCase bench("EnumerateWindows, traced", kWindows, "windows");
+        std::vector<ProcessData> windows;
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() { EnumerateWindows(source, strings, pool, kDefaultConfig, &windows); });
+        }
+    }
+    for (const bool kEnabled : {false, true}) {
+        // One probe point, which every call into the window system goes through.
+        constexpr size_t kScopes = 100000;
+        Tracer::Get().Reset();
+        Tracer::Get().SetEnabled(kEnabled);
+        BenchCase bench(kEnabled ? "ScopedTrace, enabled" : "ScopedTrace, disabled",
+            static_cast<double>(kScopes), "scopes");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                for (size_t j = 0; j < kScopes; ++j) {
+                    ScopedTrace trace(TracePhase::Title, reinterpret_cast<HWND>(j * 4));
+                }
+            });
+        }
+    }
+    Tracer::Get().SetEnabled(false);
+    Tracer::Get().Reset();
+    {
+        // How long the menu stays empty before the first rows show up.
+        BenchCase bench("StreamWindows", kWindows, "windows");
+        double first_batch = 0.0;
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                const auto kStart = std::chrono::steady_clock::now();
+                bool first = true;
+                static_cast<void>(StreamWindows(source, strings, pool, kDefaultConfig,
+                    std::chrono::milliseconds(8), nullptr,
+                    [&](std::vector<ProcessData> batch, bool done) {
+                        static_cast<void>(done);
+                        if (first && !batch.empty()) {
+                            first = false;
+                            first_batch += std::chrono::duration<double, std::micro>(
+                                std::chrono::steady_clock::now() - kStart).count();
+                        }
+                    }));
+            });
+        }
+        bench.SetExtra("us to first batch", first_batch);
+    }
+    // The first record of --list against the first batch of StreamWindows above, with the
+    // default fields and with the font and executable queries of every field.
+    const std::pair<std::string_view, uint32_t> kListFields[] = {
+        {"ListWindows, ndjson, default fields", kDefaultRecordFields},
+        {"ListWindows, ndjson, every field",
+            (uint32_t{1} << static_cast<uint32_t>(RecordField::Count)) - 1},
+    };
+    for (const auto& [name, fields] : kListFields) {
+        BenchCase bench(name, kWindows, "windows");
+        HeadlessOptions headless;
+        headless.fields_ = fields;
+        double first_record = 0.0;
+        std::FILE* output = std::fopen(kNullDevice, "wb");
+        for (size_t i = 0; output != nullptr && i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                first_record += static_cast<double>(
+                    ListWindows(source, pool, headless, output).first_record_) / 1e3;
+            });
+        }
+        if (output != nullptr) {
+            static_cast<void>(std::fclose(output));
+        }
+        bench.SetExtra("us to first record", first_record);
+    }
+    {
+        // Every tenth process hung: the font probes of a listing stay within the round budget
+        // of HealthTracker instead of growing with the number of hung windows.
+        BenchOptions hung_options = options;
+        hung_options.hung_fraction_ = 0.1;
+        SyntheticWindowSource hung_source(DesktopOptions(hung_options));
+        const std::vector<ProcessData> kListed =
+            Enumerate(hung_source, strings, pool, kDefaultConfig);
+        size_t hung_windows = 0;
+        for (const ProcessData& window : kListed) {
+            std::string font_name;
+            uint32_t font_size = 0;
+            hung_windows += hung_source.GetWindowFont(window.window_handle_, 0, &font_name,
+                &font_size) == ProbeStatus::TimedOut ? 1 : 0;
+        }
+
+        HeadlessOptions headless;
+        headless.fields_ = kDefaultRecordFields | FieldBit(RecordField::Font);
+        std::FILE* output = std::fopen(kNullDevice, "wb");
+        {
+            BenchCase bench("ListWindows, fonts, 10% of processes hung",
+                static_cast<double>(kListed.size()), "windows");
+            double font_queries = 0.0;
+            for (size_t i = 0; output != nullptr && i < options.iterations_; ++i) {
+                bench.Run([&]() {
+                    font_queries += static_cast<double>(
+                        ListWindows(hung_source, pool, headless, output).font_queries_);
+                });
+            }
+            bench.SetExtra("font queries", font_queries);
+        }
+        if (output != nullptr) {
+            static_cast<void>(std::fclose(output));
+        }
+        const HealthOptions kHealth;
+        std::printf("    %zu hung windows, %.0f ms on %zu threads if each waited out its "
+            "timeout, round budget %u ms\n", hung_windows,
+            static_cast<double>(hung_windows * kHealth.max_timeout_)
+                / static_cast<double>(pool.thread_count()),
+            pool.thread_count(), kHealth.round_budget_);
+    }
+    {
+        // A refresh driven by window events: 1% of the windows were retitled.
+        WindowTable table;
+        table.Reset(Enumerate(source, strings, pool, kDefaultConfig));
+        std::vector<WindowEvent> events;
+        for (size_t i = 0; i < table.size(); i += 100) {
+            events.push_back({WindowEventType::TitleChanged, table[i].window_handle_});
+        }
+        BenchCase bench("WindowTable::Apply, 1% retitled", static_cast<double>(events.size()),
+            "events");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                static_cast<void>(table.Apply(events, source, strings, kDefaultConfig));
+            });
+        }
+    }
+}
+
+void BenchFiltering(const BenchOptions& options) {
+    SyntheticWindowSource source(DesktopOptions(options));
+    ProbePool pool(options.threads_);
+    StringPool strings;
+    Config everything = kDefaultConfig;
+    everything.hide_hidden_windows_ = false;
+    everything.hide_blank_title_windows_ = false;
+    WindowTable table;
+    table.Reset(Enumerate(source, strings, pool, everything));
+    const auto kRows = static_cast<double>(table.size());
+
+    PrintBenchHeader("filtering");
+    const std::pair<std::string_view, std::string_view> kFilters[] = {
+        {"filter class=literal", "class=Chrome_WidgetWin_1"},
+        {"filter title=*glob*", "title=*Pull*request*"},
+        {"filter class, title and exe", "class=Chrome* title=*Inbox* exe=chrome.exe"},
+    };
+    for (const auto& [name, text] : kFilters) {
+        std::vector<RuleCondition> conditions;
+        if (!ParseConditions(text, &conditions)) {
+            continue;
+        }
+        RuleMatcher matcher;
+        matcher.Compile({Rule{conditions, {0}, 0}});
+        BenchCase bench(name, kRows, "windows");
+        size_t matches = 0;
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                for (const ProcessData& window : table) {
+                    matches += matcher.Match(window.class_name_, window.title_, {}) >= 0 ? 1 : 0;
+                }
+            });
+        }
+        bench.SetExtra("matches", static_cast<double>(matches));
+    }
+
+    // Typing into the search box of the menu, one keystroke per iteration.
+    WindowSearch search;
+    {
+        std::vector<std::string_view> file_names(table.size());
+        BenchCase bench("WindowSearch::Build", kRows, "windows");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() { search.Build(table, file_names); });
+        }
+    }
+    constexpr std::string_view kQuery = "chrome";
+    {
+        BenchCase bench("search, first keystroke", 1.0, "keys");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            search.Clear();
+            bench.Run([&]() { search.Push(kQuery[0]); });
+        }
+    }
+    {
+        BenchCase bench("search, each later keystroke", 1.0, "keys");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            search.Clear();
+            for (char character : kQuery) {
+                if (search.active()) {
+                    bench.Run([&]() { search.Push(character); });
+                } else {
+                    search.Push(character);
+                }
+            }
+        }
+    }
+    {
+        BenchCase bench("search, backspace", 1.0, "keys");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            search.SetQuery(kQuery);
+            bench.Run([&]() { search.Pop(); });
+        }
+    }
+
+    WindowColumns columns;
+    {
+        BenchCase bench("WindowColumns::Build", kRows, "windows");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() { columns.Build(table); });
+        }
+    }
+    {
+        BenchCase bench("visible, sorted by title", kRows, "windows");
+        std::vector<uint32_t> order;
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                columns.SortIndex(WindowColumns::SortKey::Title, columns.MatchVisible(), &order);
+            });
+        }
+    }
+}
+} // namespace fsb
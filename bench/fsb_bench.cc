@@ -0,0 +1,180 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace {
+std::atomic<uint64_t> allocation_count(0);
+
+struct Suite {
+    std::string_view name_;
+    void (*run_)(const fsb::BenchOptions& options);
+};
+
+//! Every suite, in the order they run when none is named.
+constexpr Suite kSuites[] = {
+    {"config", fsb::BenchConfig},
+    {"enumeration", fsb::BenchEnumeration},
+    {"filtering", fsb::BenchFiltering},
+    {"geometry", fsb::BenchGeometry},
+    {"rendering", fsb::BenchRendering},
+    {"replay", fsb::BenchReplay},
+    {"rules", fsb::BenchRules},
+    {"serving", fsb::BenchServing},
+    {"snapshots", fsb::BenchSnapshots},
+    {"strings", fsb::BenchStrings},
+    {"transcoding", fsb::BenchTranscoding},
+};
+
+constexpr std::string_view kUsage =
+    "Usage: fsb_bench [--windows N] [--iterations N] [--threads N] [--latency US]\n"
+    "                 [--hung FRACTION] [--trace FILE] [--quick] [SUITE...]\n"
+    "\n"
+    "Runs every suite, or the ones named: config, enumeration, filtering,\n"
+    "geometry, rendering, replay, rules, serving, snapshots, strings, transcoding.\n"
+    "--quick runs 500 windows and 3 iterations, to check the suites still work.\n"
+    "--trace replays a trace written by --record instead of the synthetic desktop,\n"
+    "e.g. fsb_bench --trace slow.fsbt replay under a profiler.\n";
+
+template <typename T>
+bool ParseNumber(std::string_view text, T* value) {
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), *value);
+    return error == std::errc() && end == text.data() + text.size();
+}
+} // namespace
+
+// Counts every allocation, so suites can report allocations per iteration.
+void* operator new(size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size != 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t size) noexcept {
+    static_cast<void>(size);
+    std::free(memory);
+}
+
+namespace fsb {
+uint64_t AllocationCount() {
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+SyntheticOptions DesktopOptions(const BenchOptions& options) {
+    SyntheticOptions desktop;
+    desktop.window_count_ = options.window_count_;
+    desktop.call_latency_ = options.call_latency_;
+    desktop.hung_fraction_ = options.hung_fraction_;
+    return desktop;
+}
+
+BenchCase::BenchCase(std::string_view name, double items, std::string_view unit)
+    : name_(name), items_(items), unit_(unit), allocations_(0), extra_total_(0.0) {}
+
+BenchCase::~BenchCase() {
+    if (samples_.empty()) {
+        return;
+    }
+    std::vector<double> sorted = samples_;
+    std::sort(sorted.begin(), sorted.end());
+    const size_t kCount = sorted.size();
+    double total = 0.0;
+    for (double sample : sorted) {
+        total += sample;
+    }
+    const double kMean = total / static_cast<double>(kCount);
+    std::printf("%-44s %10.1f %10.1f %10.1f %12.0f %-8s %10.1f", std::string(name_).c_str(),
+        sorted[kCount / 2], sorted[std::min(kCount - 1, kCount * 99 / 100)], sorted.back(),
+        kMean > 0.0 ? items_ * 1e6 / kMean : 0.0, (std::string(unit_) + "/s").c_str(),
+        static_cast<double>(allocations_) / static_cast<double>(kCount));
+    if (!extra_label_.empty()) {
+        std::printf("  %.1f %s", extra_total_ / static_cast<double>(kCount),
+            std::string(extra_label_).c_str());
+    }
+    std::printf("\n");
+}
+
+void BenchCase::SetExtra(std::string_view label, double total) {
+    extra_label_ = label;
+    extra_total_ = total;
+}
+
+void PrintBenchHeader(std::string_view suite) {
+    std::printf("\n%-44s %10s %10s %10s %21s %10s\n", std::string(suite).c_str(), "p50 us",
+        "p99 us", "max us", "throughput", "allocs");
+}
+} // namespace fsb
+
+int main(int argc, char* argv[]) {
+    fsb::BenchOptions options;
+    std::vector<std::string_view> suites;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view kArgument = argv[i];
+        const std::string_view kValue = i + 1 < argc ? argv[i + 1] : "";
+        uint32_t latency = 0;
+        bool valid = true;
+        if (kArgument == "--help" || kArgument == "-h") {
+            std::printf("%s", std::string(kUsage).c_str());
+            return 0;
+        } else if (kArgument == "--quick") {
+            options.window_count_ = 500;
+            options.iterations_ = 3;
+        } else if (kArgument == "--windows") {
+            valid = ParseNumber(kValue, &options.window_count_) && options.window_count_ != 0;
+            ++i;
+        } else if (kArgument == "--iterations") {
+            valid = ParseNumber(kValue, &options.iterations_) && options.iterations_ != 0;
+            ++i;
+        } else if (kArgument == "--threads") {
+            valid = ParseNumber(kValue, &options.threads_);
+            ++i;
+        } else if (kArgument == "--latency") {
+            valid = ParseNumber(kValue, &latency);
+            options.call_latency_ = std::chrono::microseconds(latency);
+            ++i;
+        } else if (kArgument == "--hung") {
+            valid = ParseNumber(kValue, &options.hung_fraction_) && options.hung_fraction_ >= 0.0
+                && options.hung_fraction_ <= 1.0;
+            ++i;
+        } else if (kArgument == "--trace") {
+            options.trace_path_ = std::string(kValue);
+            valid = !options.trace_path_.empty();
+            ++i;
+        } else {
+            valid = std::any_of(std::begin(kSuites), std::end(kSuites),
+                [&](const Suite& suite) { return suite.name_ == kArgument; });
+            suites.push_back(kArgument);
+        }
+        if (!valid) {
+            std::fprintf(stderr, "Invalid argument %s.\n\n%s", std::string(kArgument).c_str(),
+                std::string(kUsage).c_str());
+            return 2;
+        }
+    }
+
+    std::printf("%zu synthetic windows, %zu iterations, %lld us per call, %.1f%% hung\n",
+        options.window_count_, options.iterations_,
+        static_cast<long long>(options.call_latency_.count()), options.hung_fraction_ * 100.0);
+    for (const Suite& suite : kSuites) {
+        if (suites.empty()
+            || std::find(suites.begin(), suites.end(), suite.name_) != suites.end()) {
+            suite.run_(options);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "bench.h"
+
+#include "fake_window_source.h"
+#include "geometry_batch.h"
+#include "recording_geometry_backend.h"
+
+namespace fsb {
+namespace {
+//! Windows of a batch, about what rules on a busy desktop apply at once.
+constexpr int kBatchWindows = 500;
+
+//! Two monitors and kBatchWindows framed windows spread over the first.
+void SetUpDesktop(RecordingGeometryBackend* backend) {
+    backend->AddMonitor({0, 0}, {1920, 1080});
+    backend->AddMonitor({1920, 0}, {2560, 1440});
+    for (int i = 0; i < kBatchWindows; ++i) {
+        backend->SetWindow(FakeHandle(i + 1),
+            {{(i * 13) % 1800, (i * 7) % 900}, {640, 480}, 0x14CF0000, 0x00000100});
+    }
+}
+} // namespace
+
+void BenchGeometry(const BenchOptions& options) {
+    PrintBenchHeader("geometry");
+
+    // Each case plans and commits every window on a fresh desktop, and reports the calls into the
+    // backend, which on Windows are the cross-process round trips.
+    const auto kCommit = [&](std::string_view name, bool batched, bool refuse) {
+        BenchCase bench(name, kBatchWindows, "windows");
+        double calls = 0.0;
+        for (size_t i = 0; i < options.iterations_ * 5; ++i) {
+            RecordingGeometryBackend backend;
+            SetUpDesktop(&backend);
+            if (refuse) {
+                backend.RefuseMoves(FakeHandle(kBatchWindows));
+            }
+            bench.Run([&]() {
+                const int kPerBatch = batched ? kBatchWindows : 1;
+                for (int first = 0; first < kBatchWindows; first += kPerBatch) {
+                    GeometryBatch batch(backend);
+                    for (int j = first; j < first + kPerBatch; ++j) {
+                        static_cast<void>(batch.AddBorderless(FakeHandle(j + 1), j % 3));
+                    }
+                    static_cast<void>(batch.Commit());
+                }
+            });
+            calls += static_cast<double>(backend.calls().size());
+        }
+        bench.SetExtra("backend calls", calls);
+    };
+    kCommit("GeometryBatch, one window per batch", false, false);
+    kCommit("GeometryBatch, 500 windows", true, false);
+    // The last window stays put, so the other 499 are put back.
+    kCommit("GeometryBatch, 500 windows, rolled back", true, true);
+}
+} // namespace fsb
@@ -0,0 +1,195 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "bench.h"
+
+#include "event_loop.h"
+#include "frame_renderer.h"
+#include "list_view.h"
+#include "probe_pool.h"
+#include "render_scheduler.h"
+#include "scripted_event_waiter.h"
+#include "string_pool.h"
+#include "window_probe.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fsb {
+namespace {
+constexpr int kWidth = 120;
+constexpr int kHeight = 50;
+//! Rows above and below the list, like the menu's header and status line.
+constexpr int kChromeRows = 4;
+
+//! In-memory terminal that only counts what it is sent.
+class CountingSink : public TerminalSink {
+public:
+    void Write(std::string_view bytes) override {
+        bytes_ += bytes.size();
+        ++writes_;
+    }
+
+    size_t bytes_ = 0;
+    size_t writes_ = 0;
+};
+
+//! Draws a menu-like frame: a header, the visible rows of the list with the selection
+//! highlighted, and a ruler.
+void DrawFrame(const std::vector<ProcessData>& windows, const ListView& list,
+    ScreenBuffer* screen) {
+    screen->Clear();
+    static_cast<void>(screen->Put(0, 0, "fsb: Full Screen Borderless", CellAttribute::Normal));
+    screen->Fill(0, 1, kWidth, U'=', CellAttribute::Normal);
+    char number[16];
+    for (int i = list.first_visible(); i < list.end_visible(); ++i) {
+        const int kRow = 2 + i - list.first_visible();
+        const CellAttribute kAttribute = i == list.selection() ? CellAttribute::Highlight
+            : CellAttribute::Normal;
+        const ProcessData& kWindow = windows[static_cast<size_t>(i)];
+        std::snprintf(number, sizeof(number), "%6u ", kWindow.process_id_);
+        int x = screen->Put(0, kRow, number, kAttribute);
+        x = screen->Put(x, kRow, kWindow.class_name_.substr(0, 28), kAttribute);
+        static_cast<void>(screen->Put(36, kRow, kWindow.title_, kAttribute));
+        screen->SetRowAttribute(kRow, kAttribute);
+    }
+    screen->Fill(0, kHeight - 1, kWidth, U'=', CellAttribute::Normal);
+}
+
+void Spin(EventLoop::Clock::duration duration) {
+    const EventLoop::Clock::time_point kEnd = EventLoop::Clock::now() + duration;
+    while (EventLoop::Clock::now() < kEnd) {
+    }
+}
+
+//! @brief Drives the menu's paint loop with changes arriving at rate per second for duration.
+//!
+//! Every change is an input event that invalidates the view, and painting takes paint_time, the
+//! way Console::Paint runs from the idle handler with a timer for frames that are not due yet.
+//! Samples are the time from each input batch to the end of the frame that showed it.
+void BenchPaintLoop(std::string_view name, int frames_per_second, int rate,
+    EventLoop::Clock::duration paint_time, EventLoop::Clock::duration duration) {
+    using Clock = EventLoop::Clock;
+    ScriptedEventWaiter waiter;
+    EventLoop loop(waiter);
+    RenderScheduler scheduler(frames_per_second);
+    EventLoop::TimerId frame_timer = 0;
+    std::atomic<bool> done(false);
+    std::vector<Clock::time_point> waiting;
+    std::vector<Clock::time_point> painting;
+    uint64_t batches = 0;
+
+    RenderStats stats;
+    {
+        BenchCase bench(name, 1.0, "batches");
+        loop.SetHandler(EventSource::Input, [&]() {
+            ++batches;
+            const Clock::time_point kNow = Clock::now();
+            waiting.push_back(kNow);
+            scheduler.Invalidate(kNow);
+        });
+        loop.SetIdleHandler([&]() {
+            Clock::duration wait;
+            if (!scheduler.ShouldPaint(Clock::now(), &wait)) {
+                if (scheduler.dirty() && frame_timer == 0) {
+                    frame_timer = loop.AddTimer(wait, [&]() { frame_timer = 0; });
+                }
+                return;
+            }
+            scheduler.BeginFrame(Clock::now());
+            painting.swap(waiting);
+            Spin(paint_time);
+            const Clock::time_point kEnd = Clock::now();
+            scheduler.EndFrame(kEnd);
+            for (Clock::time_point change : painting) {
+                bench.AddSample(kEnd - change);
+            }
+            painting.clear();
+            if (done && !scheduler.dirty()) {
+                loop.Quit();
+            }
+        });
+
+        std::thread producer([&]() {
+            const auto kStep = std::chrono::nanoseconds(std::chrono::seconds(1)) / rate;
+            const auto kChanges = duration / kStep;
+            Clock::time_point next = Clock::now();
+            for (auto i = kChanges; i > 0; --i) {
+                next += kStep;
+                std::this_thread::sleep_until(next);
+                waiter.Signal(EventSource::Input);
+            }
+            done = true;
+            loop.Post([]() {});
+        });
+        loop.Run();
+        producer.join();
+        stats = scheduler.stats();
+    }
+    // Changes signaled while the loop is busy are handled as one batch.
+    std::printf("    %llu input batches, %s", static_cast<unsigned long long>(batches),
+        FormatRenderStats(stats).c_str());
+}
+} // namespace
+
+void BenchRendering(const BenchOptions& options) {
+    SyntheticWindowSource source(DesktopOptions(options));
+    ProbePool pool(options.threads_);
+    StringPool strings;
+    std::vector<ProcessData> windows;
+    EnumerateWindows(source, strings, pool, kDefaultConfig, &windows);
+    if (windows.empty()) {
+        return;
+    }
+
+    ListView list;
+    list.SetItemCount(static_cast<int>(windows.size()));
+    list.SetViewportHeight(kHeight - kChromeRows);
+    FrameRenderer renderer;
+    renderer.Resize(kWidth, kHeight);
+    CountingSink sink;
+
+    // Each case presents one frame per iteration and reports what reached the terminal.
+    const auto kFrames = [&](std::string_view name, auto&& step) {
+        BenchCase bench(name, 1.0, "frames");
+        const size_t kBytes = sink.bytes_;
+        for (size_t i = 0; i < options.iterations_ * 10; ++i) {
+            bench.Run([&]() {
+                step();
+                DrawFrame(windows, list, &renderer.back_buffer());
+                static_cast<void>(renderer.Present(sink));
+            });
+        }
+        bench.SetExtra("bytes/frame", static_cast<double>(sink.bytes_ - kBytes));
+    };
+
+    PrintBenchHeader("rendering");
+    kFrames("full repaint", [&]() { renderer.Invalidate(); });
+    kFrames("unchanged frame", []() {});
+    kFrames("selection moved one row", [&]() {
+        list.MoveBy(list.selection() + 1 < list.item_count() ? 1 : -list.selection());
+    });
+    kFrames("page down", [&]() {
+        if (list.selection() + 1 >= list.item_count()) {
+            list.Home();
+        } else {
+            list.PageDown();
+        }
+    });
+
+    // Bursts of changes against the frame cap, e.g. windows streaming in during enumeration.
+    const auto kDuration = std::chrono::milliseconds(50) * options.iterations_;
+    BenchPaintLoop("paint loop, 2000 changes/s, 2 ms, no cap", 0, 2000,
+        std::chrono::milliseconds(2), kDuration);
+    BenchPaintLoop("paint loop, 2000 changes/s, 2 ms, 60 fps", 60, 2000,
+        std::chrono::milliseconds(2), kDuration);
+    BenchPaintLoop("paint loop, 2000 changes/s, 25 ms, no cap", 0, 2000,
+        std::chrono::milliseconds(25), kDuration);
+    BenchPaintLoop("paint loop, 2000 changes/s, 25 ms, 60 fps", 60, 2000,
+        std::chrono::milliseconds(25), kDuration);
+}
+} // namespace fsb
@@ -0,0 +1,122 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "bench.h"
+
+#include "probe_pool.h"
+#include "recording_window_source.h"
+#include "replay_window_source.h"
+#include "string_pool.h"
+#include "window_probe.h"
+#include "window_table.h"
+#include "window_trace.h"
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fsb {
+namespace {
+//! Batches of window events recorded after the enumeration.
+constexpr size_t kEventBatches = 20;
+constexpr size_t kEventsPerBatch = 50;
+
+std::string BenchTracePath() {
+#ifdef _WIN32
+    return "fsb-bench.fsbt";
+#else
+    return "/tmp/fsb-bench-" + std::to_string(getpid()) + ".fsbt";
+#endif
+}
+
+//! Records what --record would on the synthetic desktop: a full enumeration, then batches of
+//! windows being retitled and moved.
+bool RecordSyntheticTrace(const BenchOptions& options, const std::string& path) {
+    SyntheticWindowSource source(DesktopOptions(options));
+    ProbePool pool(options.threads_);
+    StringPool strings;
+    TraceWriter writer;
+    if (!writer.Open(path)) {
+        return false;
+    }
+    RecordingWindowSource recording(source, writer);
+
+    std::vector<ProcessData> windows;
+    EnumerateWindows(recording, strings, pool, kDefaultConfig, &windows);
+    std::vector<HWND> window_handles;
+    for (const ProcessData& window : windows) {
+        window_handles.push_back(window.window_handle_);
+    }
+    WindowTable table;
+    table.Reset(std::move(windows));
+
+    std::vector<WindowEvent> events;
+    for (size_t batch = 0; batch < kEventBatches && !window_handles.empty(); ++batch) {
+        events.clear();
+        for (size_t i = 0; i < kEventsPerBatch; ++i) {
+            const HWND kWindowHandle =
+                window_handles[(batch * kEventsPerBatch + i) % window_handles.size()];
+            events.push_back({i % 2 == 0 ? WindowEventType::TitleChanged : WindowEventType::Moved,
+                kWindowHandle});
+        }
+        static_cast<void>(table.Apply(events, recording, strings, kDefaultConfig));
+    }
+    return writer.Flush();
+}
+} // namespace
+
+void BenchReplay(const BenchOptions& options) {
+    const bool kRecorded = options.trace_path_.empty();
+    const std::string kPath = kRecorded ? BenchTracePath() : options.trace_path_;
+    if (kRecorded && !RecordSyntheticTrace(options, kPath)) {
+        std::fprintf(stderr, "Cannot write the trace %s.\n", kPath.c_str());
+        return;
+    }
+
+    ReplayWindowSource source(0.0);
+    if (!source.Open(kPath)) {
+        std::fprintf(stderr, "Cannot read the trace %s.\n", kPath.c_str());
+        return;
+    }
+    if (!kRecorded) {
+        // What --replay prints, so a trace from the field can be read without the menu.
+        std::string report;
+        static_cast<void>(ReplayTraceFile(kPath, 0.0, kDefaultConfig, &report));
+        std::printf("\n%s", report.c_str());
+    }
+    const auto kRecords = static_cast<double>(source.records().size());
+
+    PrintBenchHeader("replay");
+    {
+        BenchCase bench("TraceReader::Open", kRecords, "records");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            TraceReader reader;
+            bench.Run([&]() { static_cast<void>(reader.Open(kPath)); });
+        }
+    }
+    {
+        // Every step back to back, i.e. the time the recorded refreshes spent in this process.
+        ProbePool pool(options.threads_);
+        StringPool strings;
+        std::vector<ReplayStep> steps;
+        BenchCase bench("ReplayTrace, speed 0", kRecords, "records");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            static_cast<void>(source.Open(kPath));
+            WindowTable table;
+            bench.Run([&]() {
+                ReplayTrace(source, strings, pool, kDefaultConfig, &table, &steps);
+            });
+        }
+    }
+
+    if (kRecorded) {
+        static_cast<void>(std::remove(kPath.c_str()));
+    }
+}
+} // namespace fsb
@@ -0,0 +1,132 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "bench.h"
+
+#include "probe_pool.h"
+#include "rule_engine.h"
+#include "string_pool.h"
+#include "window_probe.h"
+
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fsb {
+namespace {
+//! A rules file of count lines in the shapes people write: literal classes and executables,
+//! title globs, path globs and combinations. Only the last few match anything on the desktop.
+std::string RulesText(size_t count) {
+    std::mt19937 random(16);
+    std::string text;
+    for (size_t i = 0; i < count; ++i) {
+        const std::string kId = std::to_string(i);
+        switch (random() % 6) {
+            case 0:
+                text += "class=Class" + kId + " -> borderless\n";
+                break;
+            case 1:
+                text += "exe=app" + kId + ".exe -> borderless monitor=2\n";
+                break;
+            case 2:
+                text += "title=\"*Project " + kId + "*\" -> borderless\n";
+                break;
+            case 3:
+                text += "class=Cls" + kId + "* title=\"* - Game " + kId + "\" -> borderless\n";
+                break;
+            case 4:
+                text += "path=\"C:\\Games\\Title" + kId + "\\*.exe\" -> borderless\n";
+                break;
+            default:
+                text += "title=\"?Level " + kId + "?*\" exe=game" + kId + ".exe -> borderless\n";
+                break;
+        }
+    }
+    text += "class=Chrome_WidgetWin_1 exe=chrome.exe -> borderless\n";
+    text += "exe=*code*.exe -> borderless monitor=1\n";
+    text += "title=\"*- Notepad\" -> borderless\n";
+    return text;
+}
+
+struct RuleInput {
+    std::string_view class_name_;
+    std::string_view title_;
+    std::string file_name_;
+};
+} // namespace
+
+void BenchRules(const BenchOptions& options) {
+    SyntheticWindowSource source(DesktopOptions(options));
+    ProbePool pool(options.threads_);
+    StringPool strings;
+    Config everything = kDefaultConfig;
+    everything.hide_hidden_windows_ = false;
+    everything.hide_blank_title_windows_ = false;
+    std::vector<ProcessData> windows;
+    EnumerateWindows(source, strings, pool, everything, &windows);
+
+    // What RuleMatcher::Match is handed for every window, read once up front.
+    std::vector<RuleInput> inputs;
+    for (const ProcessData& window : windows) {
+        RuleInput input = {window.class_name_, window.title_, {}};
+        uint64_t start_time = 0;
+        static_cast<void>(source.GetProcessInfo(window.process_id_, &start_time,
+            &input.file_name_));
+        inputs.push_back(std::move(input));
+    }
+    const auto kWindows = static_cast<double>(inputs.size());
+
+    PrintBenchHeader("rules");
+    for (size_t count : {size_t{10}, size_t{1000}, size_t{5000}}) {
+        const std::string kText = RulesText(count);
+        const std::string kCount = std::to_string(count);
+        std::vector<Rule> rules;
+        {
+            const std::string kName = "ParseRules, " + kCount + " rules";
+            BenchCase bench(kName, static_cast<double>(count), "rules");
+            for (size_t i = 0; i < options.iterations_; ++i) {
+                rules.clear();
+                bench.Run([&]() { static_cast<void>(ParseRules(kText, &rules)); });
+            }
+        }
+        RuleMatcher matcher;
+        {
+            const std::string kName = "RuleMatcher::Compile, " + kCount + " rules";
+            BenchCase bench(kName, static_cast<double>(count), "rules");
+            for (size_t i = 0; i < options.iterations_; ++i) {
+                bench.Run([&]() { matcher.Compile(rules); });
+            }
+        }
+        {
+            // Automaton states are built by the first windows that reach them.
+            const std::string kName = "RuleMatcher::Match, " + kCount + " rules, cold";
+            BenchCase bench(kName, kWindows, "windows");
+            size_t matches = 0;
+            for (size_t i = 0; i < options.iterations_; ++i) {
+                matcher.Compile(rules);
+                bench.Run([&]() {
+                    for (const RuleInput& input : inputs) {
+                        matches += matcher.Match(input.class_name_, input.title_,
+                            input.file_name_) >= 0 ? 1 : 0;
+                    }
+                });
+            }
+            bench.SetExtra("matches", static_cast<double>(matches));
+        }
+        {
+            const std::string kName = "RuleMatcher::Match, " + kCount + " rules";
+            BenchCase bench(kName, kWindows, "windows");
+            for (size_t i = 0; i < options.iterations_; ++i) {
+                bench.Run([&]() {
+                    for (const RuleInput& input : inputs) {
+                        static_cast<void>(matcher.Match(input.class_name_, input.title_,
+                            input.file_name_));
+                    }
+                });
+            }
+        }
+    }
+}
+} // namespace fsb
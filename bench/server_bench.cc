@@ -0,0 +1,94 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "bench.h"
+
+#include "ipc_channel.h"
+#include "recording_geometry_backend.h"
+#include "window_server.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fsb {
+namespace {
+std::string BenchAddress() {
+#ifdef _WIN32
+    return "\\\\.\\pipe\\fsb-bench";
+#else
+    return "/tmp/fsb-bench-" + std::to_string(getpid()) + ".sock";
+#endif
+}
+
+//! Sends one request the way fsb --client does, a connection per request.
+size_t Ask(const std::string& address, const std::string& message) {
+    IpcChannel channel;
+    std::string response;
+    if (!channel.Connect(address) || !channel.Send(message) || !channel.Receive(&response)) {
+        return 0;
+    }
+    return response.size();
+}
+} // namespace
+
+void BenchServing(const BenchOptions& options) {
+    SyntheticWindowSource source(DesktopOptions(options));
+    RecordingGeometryBackend geometry;
+    ProbePool pool(options.threads_);
+    WindowServer server(source, geometry, pool);
+    server.Refresh();
+
+    const std::string kAddress = BenchAddress();
+    IpcListener listener;
+    if (!listener.Listen(kAddress)) {
+        std::fprintf(stderr, "Could not listen on %s.\n", kAddress.c_str());
+        return;
+    }
+    std::thread serve_thread([&]() { server.Serve(listener, []() {}); });
+
+    // Each case is one client round trip per iteration: connect, request, response.
+    const auto kRequests = [&](std::string_view name, const std::vector<std::string>& request) {
+        const std::string kMessage = EncodeServerRequest(request);
+        BenchCase bench(name, 1.0, "requests");
+        size_t bytes = 0;
+        for (size_t i = 0; i < options.iterations_ * 10; ++i) {
+            bench.Run([&]() { bytes += Ask(kAddress, kMessage); });
+        }
+        bench.SetExtra("bytes/response", static_cast<double>(bytes));
+    };
+
+    std::vector<HWND> window_handles;
+    source.EnumerateWindowHandles(&window_handles);
+    const std::string kHandle = std::to_string(reinterpret_cast<uintptr_t>(window_handles[0]));
+
+    PrintBenchHeader("serving");
+    kRequests("query one window", {"query", kHandle});
+    kRequests("list listed windows", {"list"});
+    kRequests("list every window", {"list", "--all"});
+    kRequests("list filtered by class", {"list", "--filter", "class=Chrome*"});
+    kRequests("list with executables", {"list", "--fields", "handle,exe"});
+
+    // Window events keep taking the table lock while clients are answered.
+    std::atomic<bool> updating(true);
+    std::thread update_thread([&]() {
+        const std::vector<WindowEvent> kEvents = {{WindowEventType::Moved, window_handles[0]}};
+        while (updating.load(std::memory_order_relaxed)) {
+            server.Update(kEvents);
+        }
+    });
+    kRequests("query one window during updates", {"query", kHandle});
+    updating = false;
+    update_thread.join();
+
+    server.StopServing();
+    serve_thread.join();
+}
+} // namespace fsb
@@ -0,0 +1,110 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "bench.h"
+
+#include "layout_snapshot.h"
+#include "probe_pool.h"
+#include "string_pool.h"
+#include "window_probe.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fsb {
+namespace {
+std::string BenchSnapshotPath() {
+#ifdef _WIN32
+    return "fsb-bench.fsb-layouts";
+#else
+    return "/tmp/fsb-bench-" + std::to_string(getpid()) + ".fsb-layouts";
+#endif
+}
+
+void RemoveSnapshot(const std::string& path) {
+    static_cast<void>(std::remove(path.c_str()));
+    static_cast<void>(std::remove((path + ".lock").c_str()));
+}
+} // namespace
+
+void BenchSnapshots(const BenchOptions& options) {
+    SyntheticWindowSource source(DesktopOptions(options));
+    ProbePool pool(options.threads_);
+    StringPool strings;
+    Config everything = kDefaultConfig;
+    everything.hide_hidden_windows_ = false;
+    everything.hide_blank_title_windows_ = false;
+    std::vector<ProcessData> windows;
+    EnumerateWindows(source, strings, pool, everything, &windows);
+    const auto kWindows = static_cast<double>(windows.size());
+    const std::string kPath = BenchSnapshotPath();
+
+    PrintBenchHeader("snapshots");
+    {
+        // Every window made borderless at once, e.g. by the rules at startup.
+        BenchCase bench("SnapshotWriter, one flush", kWindows, "windows");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            RemoveSnapshot(kPath);
+            bench.Run([&]() {
+                SnapshotWriter writer;
+                static_cast<void>(writer.Open(kPath));
+                for (const ProcessData& window : windows) {
+                    static_cast<void>(writer.Add(window));
+                }
+                static_cast<void>(writer.Flush());
+            });
+        }
+    }
+    {
+        // Windows made borderless one at a time, each written before the next.
+        BenchCase bench("SnapshotWriter, flush per window", kWindows, "windows");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            RemoveSnapshot(kPath);
+            bench.Run([&]() {
+                SnapshotWriter writer;
+                static_cast<void>(writer.Open(kPath));
+                for (const ProcessData& window : windows) {
+                    static_cast<void>(writer.Add(window));
+                    static_cast<void>(writer.Flush());
+                }
+            });
+        }
+    }
+    {
+        // What the daemon and the menu do at startup with the file the other one wrote.
+        BenchCase bench("SnapshotWriter::Open, existing file", kWindows, "windows");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                SnapshotWriter writer;
+                static_cast<void>(writer.Open(kPath));
+            });
+        }
+    }
+    {
+        // Restoring reads every record in place through the mapping.
+        BenchCase bench("SnapshotReader, open and read", kWindows, "windows");
+        size_t bytes = 0;
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                SnapshotReader reader;
+                if (!reader.Open(kPath)) {
+                    return;
+                }
+                for (size_t j = 0; j < reader.size(); ++j) {
+                    if (reader.valid(j)) {
+                        bytes += reader.class_name(j).size() + reader.title(j).size();
+                    }
+                }
+            });
+        }
+        bench.SetExtra("string bytes", static_cast<double>(bytes));
+    }
+    RemoveSnapshot(kPath);
+}
+} // namespace fsb
@@ -0,0 +1,87 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "bench.h"
+
+#include "probe_pool.h"
+#include "string_pool.h"
+#include "window_probe.h"
+
+#include <string>
+#include <vector>
+
+namespace fsb {
+void BenchStrings(const BenchOptions& options) {
+    SyntheticWindowSource source(DesktopOptions(options));
+    ProbePool pool(options.threads_);
+    Config everything = kDefaultConfig;
+    everything.hide_hidden_windows_ = false;
+    everything.hide_blank_title_windows_ = false;
+
+    // The strings a refresh hands to the pool: class names and executable paths of every window.
+    std::vector<std::string> values;
+    {
+        StringPool strings;
+        std::vector<ProcessData> windows;
+        EnumerateWindows(source, strings, pool, everything, &windows);
+        std::string file_name;
+        for (const ProcessData& window : windows) {
+            values.emplace_back(window.class_name_);
+            uint64_t start_time = 0;
+            if (source.GetProcessInfo(window.process_id_, &start_time, &file_name)) {
+                values.push_back(file_name);
+            }
+        }
+    }
+    const auto kValues = static_cast<double>(values.size());
+
+    PrintBenchHeader("strings");
+    {
+        // What ProcessData used to hold: a copy of every string per window.
+        BenchCase bench("std::string copies", kValues, "strings");
+        double bytes = 0.0;
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                std::vector<std::string> copies(values.begin(), values.end());
+                for (const std::string& copy : copies) {
+                    bytes += static_cast<double>(copy.capacity() + sizeof(std::string));
+                }
+            });
+        }
+        bench.SetExtra("KiB held", bytes / 1024.0);
+    }
+    {
+        BenchCase bench("StringPool::Intern, new pool", kValues, "strings");
+        double bytes = 0.0;
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                StringPool strings;
+                for (const std::string& value : values) {
+                    static_cast<void>(strings.InternView(value));
+                }
+                bytes += static_cast<double>(strings.reserved_bytes()
+                    + values.size() * sizeof(std::string_view));
+            });
+        }
+        bench.SetExtra("KiB held", bytes / 1024.0);
+    }
+    {
+        // Every refresh after the first finds the strings already interned.
+        StringPool strings;
+        for (const std::string& value : values) {
+            static_cast<void>(strings.Intern(value));
+        }
+        BenchCase bench("StringPool::Intern, warm pool", kValues, "strings");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                for (const std::string& value : values) {
+                    static_cast<void>(strings.InternView(value));
+                }
+            });
+        }
+        bench.SetExtra("distinct strings",
+            static_cast<double>(strings.size() * options.iterations_));
+    }
+}
+} // namespace fsb
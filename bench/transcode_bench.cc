@@ -0,0 +1,98 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "bench.h"
+
+#include "probe_pool.h"
+#include "string_pool.h"
+#include "utf_transcode.h"
+#include "window_probe.h"
+
+#include <string>
+
+namespace fsb {
+void BenchTranscoding(const BenchOptions& options) {
+    SyntheticWindowSource source(DesktopOptions(options));
+    ProbePool pool(options.threads_);
+    StringPool strings;
+    Config everything = kDefaultConfig;
+    everything.hide_hidden_windows_ = false;
+    everything.hide_blank_title_windows_ = false;
+    std::vector<ProcessData> windows;
+    EnumerateWindows(source, strings, pool, everything, &windows);
+
+    // Titles as the window system hands them over, in UTF-16.
+    std::vector<std::u16string> titles;
+    size_t title_units = 0;
+    for (const ProcessData& window : windows) {
+        std::u16string title(Utf16UpperBound(window.title_.size()), u'\0');
+        title.resize(TranscodeUtf8ToUtf16(window.title_.data(), window.title_.size(),
+            title.data()));
+        title_units += title.size();
+        titles.push_back(std::move(title));
+    }
+
+    PrintBenchHeader("transcoding");
+    {
+        BenchCase bench("titles UTF-16 to UTF-8, new strings", static_cast<double>(titles.size()),
+            "titles");
+        std::vector<std::string> converted(titles.size());
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                for (size_t j = 0; j < titles.size(); ++j) {
+                    std::string& out = converted[j];
+                    out.assign(Utf8UpperBound(titles[j].size()), '\0');
+                    out.resize(TranscodeUtf16ToUtf8(titles[j].data(), titles[j].size(),
+                        out.data()));
+                }
+            });
+        }
+        bench.SetExtra("UTF-16 units/title", static_cast<double>(title_units)
+            * static_cast<double>(options.iterations_) / static_cast<double>(titles.size()));
+    }
+    {
+        BenchCase bench("titles UTF-16 to UTF-8, reused buffer",
+            static_cast<double>(titles.size()), "titles");
+        std::string buffer;
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                for (const std::u16string& title : titles) {
+                    buffer.resize(Utf8UpperBound(title.size()));
+                    static_cast<void>(TranscodeUtf16ToUtf8(title.data(), title.size(),
+                        buffer.data()));
+                }
+            });
+        }
+    }
+
+    constexpr size_t kBulkUnits = size_t{1} << 20;
+    const std::u16string kAscii(kBulkUnits, u'a');
+    std::u16string mixed;
+    while (mixed.size() < kBulkUnits) {
+        mixed += u"Café 日本語 \U0001F3AE plain ascii text ";
+    }
+    std::string output(Utf8UpperBound(kBulkUnits + 64), '\0');
+    std::u16string back(Utf16UpperBound(output.size()), u'\0');
+    const auto kBulk = [&](std::string_view name, const std::u16string& input) {
+        BenchCase bench(name, static_cast<double>(input.size()) / 1e6, "M units");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                static_cast<void>(TranscodeUtf16ToUtf8(input.data(), input.size(), output.data()));
+            });
+        }
+    };
+    kBulk("1M units ASCII UTF-16 to UTF-8", kAscii);
+    kBulk("1M units mixed UTF-16 to UTF-8", mixed);
+    {
+        const size_t kLength = TranscodeUtf16ToUtf8(mixed.data(), mixed.size(), output.data());
+        BenchCase bench("1M units mixed UTF-8 to UTF-16", static_cast<double>(kLength) / 1e6,
+            "M bytes");
+        for (size_t i = 0; i < options.iterations_; ++i) {
+            bench.Run([&]() {
+                static_cast<void>(TranscodeUtf8ToUtf16(output.data(), kLength, back.data()));
+            });
+        }
+    }
+}
+} // namespace fsb
@@ -11,6 +11,7 @@
 //
 // Classes:     fsb::ProcessData
 //              fsb::SizeVec2
+//              fsb::WindowDetails
 //
 // Functions:   None
 //
@@ -26,7 +27,15 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
+
+#ifdef _WIN32
 #include <Windows.h>
+#else
+// Opaque stand-in for the Win32 window handle so the platform-independent modules (enumeration,
+// probing and everything built on top of them) can be compiled and exercised on other platforms.
+using HWND = struct HWND__*;
+#endif
 
 namespace fsb {
 
@@ -39,8 +48,6 @@ struct SizeVec2 {
 struct WindowMetrics {
     SizeVec2 position_;
     SizeVec2 size_;
-    std::string font_name_;
-    uint32_t font_size_;
     //! @note DWORD type stored as uint32_t. Should always cast to DWORD when using or cast to
     //! uint32_t when storing.
     uint32_t style_;
@@ -59,6 +66,21 @@ struct WindowAttributes {
     WindowState state_;
 };
 
+//! @brief Expensive information about a window, only computed once the window is selected or
+//! inspected.
+//!
+//! Each of these needs a cross-process call (WM_GETFONT, OpenProcess, etc.), so they are kept out
+//! of the data filled during enumeration. See DetailLoader.
+struct WindowDetails {
+    //! Full path of the executable that owns the window. Interned, see StringPool.
+    std::string_view file_name_;
+    std::string font_name_;
+    uint32_t font_size_;
+    //! Set when the window did not answer (or was not asked, see HealthTracker) and the font is
+    //! the last one it reported, if any.
+    bool font_stale_;
+};
+
 //! @brief Holds information about a process and its associated window.
 //!
 //! This structure is the main structure used within the application to manage the window's full
@@ -71,10 +93,13 @@ struct ProcessData {
     uint32_t process_id_;
     //! Title of the window to display in the interface.
     std::string title_;
-    std::string class_name_;
-    std::string file_name_;
+    //! Interned, see StringPool.
+    std::string_view class_name_;
     WindowAttributes attributes_;
     WindowMetrics metrics_;
+    //! Only valid once has_details_ is set.
+    WindowDetails details_;
+    bool has_details_;
 };
 
 }  // namespace fsb
@@ -0,0 +1,196 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "command_line.h"
+
+#include <charconv>
+#include <cstddef>
+
+namespace fsb {
+namespace {
+//! Upper bound of --speed. Faster than this is as good as 0, i.e. no waiting at all.
+constexpr double kMaxReplaySpeed = 1e6;
+} // namespace
+
+bool ParseCommandLine(const std::vector<std::string>& arguments, CommandLine* command_line,
+    std::string* error) {
+    // First option given that only makes sense with --list.
+    std::string listing_option;
+    bool has_speed = false;
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        std::string_view name = arguments[i];
+        std::string_view value;
+        bool has_value = false;
+        const size_t kEqualPosition = name.find('=');
+        if (kEqualPosition != std::string_view::npos) {
+            value = name.substr(kEqualPosition + 1);
+            name = name.substr(0, kEqualPosition);
+            has_value = true;
+        }
+
+        // Reads the value of an option that takes one.
+        const auto kTakeValue = [&]() {
+            if (!has_value && i + 1 < arguments.size()) {
+                value = arguments[++i];
+                has_value = true;
+            }
+            if (!has_value) {
+                *error = std::string(name) + " needs a value.";
+            }
+            return has_value;
+        };
+
+        if (name == "--help" || name == "-h" || name == "/?") {
+            command_line->help_ = true;
+            return true;
+        }
+        // The rest of the line is the request, which the daemon parses itself.
+        if (name == "--client") {
+            command_line->client_ = true;
+            command_line->client_request_.assign(
+                arguments.begin() + static_cast<ptrdiff_t>(i + 1), arguments.end());
+            if (command_line->client_request_.empty()) {
+                *error = "--client needs a request: list, query, apply or stop.";
+                return false;
+            }
+            break;
+        }
+        if (name != "--list" && name != "--profile-startup" && name != "--frame-stats"
+            && name != "--daemon"
+            && name != "--record" && name != "--replay" && name != "--speed"
+            && listing_option.empty()) {
+            listing_option = std::string(name);
+        }
+
+        if (name == "--list") {
+            command_line->list_ = true;
+        } else if (name == "--all") {
+            command_line->headless_.config_.hide_hidden_windows_ = false;
+            command_line->headless_.config_.hide_blank_title_windows_ = false;
+        } else if (name == "--timing") {
+            command_line->timing_ = true;
+        } else if (name == "--profile-startup") {
+            command_line->profile_startup_ = true;
+        } else if (name == "--frame-stats") {
+            command_line->frame_stats_ = true;
+        } else if (name == "--daemon") {
+            command_line->daemon_ = true;
+        } else if (name == "--format") {
+            if (!kTakeValue()) {
+                return false;
+            }
+            if (value == "ndjson") {
+                command_line->headless_.format_ = OutputFormat::Ndjson;
+            } else if (value == "csv") {
+                command_line->headless_.format_ = OutputFormat::Csv;
+            } else {
+                *error = "Unknown format " + std::string(value) + ", expected ndjson or csv.";
+                return false;
+            }
+        } else if (name == "--fields") {
+            if (!kTakeValue()) {
+                return false;
+            }
+            if (!ParseRecordFields(value, &command_line->headless_.fields_)) {
+                *error = "Invalid field list " + std::string(value) + ".";
+                return false;
+            }
+        } else if (name == "--filter") {
+            if (!kTakeValue()) {
+                return false;
+            }
+            if (!ParseConditions(value, &command_line->headless_.filter_)) {
+                *error = "Invalid filter " + std::string(value) + ".";
+                return false;
+            }
+        } else if (name == "--record" || name == "--replay") {
+            if (!kTakeValue()) {
+                return false;
+            }
+            if (value.empty()) {
+                *error = std::string(name) + " needs a file.";
+                return false;
+            }
+            if (name == "--record") {
+                command_line->record_path_ = value;
+            } else {
+                command_line->replay_path_ = value;
+            }
+        } else if (name == "--speed") {
+            if (!kTakeValue()) {
+                return false;
+            }
+            double speed = 0.0;
+            const auto [end, parse_error] = std::from_chars(value.data(),
+                value.data() + value.size(), speed);
+            if (parse_error != std::errc() || end != value.data() + value.size() || !(speed >= 0.0)
+                || speed > kMaxReplaySpeed) {
+                *error = "Invalid speed " + std::string(value) + ".";
+                return false;
+            }
+            command_line->replay_speed_ = speed;
+            has_speed = true;
+        } else {
+            *error = "Unknown option " + std::string(arguments[i]) + ".";
+            return false;
+        }
+    }
+
+    if (static_cast<int>(command_line->list_) + static_cast<int>(command_line->daemon_)
+        + static_cast<int>(command_line->client_) > 1) {
+        *error = "Only one of --list, --daemon and --client can be given.";
+        return false;
+    }
+    const bool kReplaying = !command_line->replay_path_.empty();
+    if (kReplaying && (command_line->daemon_ || !command_line->record_path_.empty())) {
+        *error = "--replay cannot be combined with --daemon or --record.";
+        return false;
+    }
+    if (!kReplaying && has_speed) {
+        *error = "--speed is only valid with --replay.";
+        return false;
+    }
+    if (!command_line->list_ && !listing_option.empty()) {
+        *error = listing_option + " is only valid with --list.";
+        return false;
+    }
+    return true;
+}
+
+std::string_view CommandLineUsage() {
+    return "Usage: fsb [--help] [--profile-startup] [--frame-stats] [--list [options]]\n"
+           "           [--daemon] [--record FILE] [--replay FILE [--speed X]]\n"
+           "           [--client REQUEST]\n"
+           "\n"
+           "Without options, shows the interactive menu.\n"
+           "\n"
+           "  --profile-startup   Print the startup milestones of the menu to stderr on exit.\n"
+           "  --frame-stats       Print the frames the menu painted, coalesced and dropped to\n"
+           "                      stderr on exit. The frame rate is capped by max_fps.\n"
+           "  --list              Write one record per window to stdout and exit.\n"
+           "  --format FORMAT     ndjson (default) or csv.\n"
+           "  --fields LIST       Comma-separated fields: handle, pid, class, title, state,\n"
+           "                      visible, enabled, x, y, width, height, style, ex_style,\n"
+           "                      exe, font, font_size. Default: handle,pid,class,title.\n"
+           "  --filter CONDITIONS Only windows matching every condition, e.g.\n"
+           "                      \"class=Chrome* exe=chrome.exe\". Fields are class, title,\n"
+           "                      exe and path; patterns are case-insensitive globs.\n"
+           "  --all               Include hidden and untitled windows.\n"
+           "  --timing            Print the time to first record and the throughput to stderr.\n"
+           "  --daemon            Keep the window list up to date in the background and\n"
+           "                      answer --client requests until stopped.\n"
+           "  --client REQUEST    Send the rest of the line to the daemon as one request:\n"
+           "                        list [--format F] [--fields L] [--filter C] [--all]\n"
+           "                        query HANDLE [--format F] [--fields L]\n"
+           "                        apply (HANDLE | --filter C) [--monitor N] [--all]\n"
+           "                        stop\n"
+           "  --record FILE       Record every call into the window system and every window\n"
+           "                      event to FILE, with the menu, --list or --daemon.\n"
+           "  --replay FILE       Read the window system from a recorded trace. With --list,\n"
+           "                      lists the recorded desktop; alone, replays the refreshes and\n"
+           "                      events of the trace and prints how long each took.\n"
+           "  --speed X           Replay X times faster than recorded, 0 for no waiting.\n"
+           "                      Default: 1.\n";
+}
+} // namespace fsb
@@ -0,0 +1,61 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_COMMAND_LINE_H_
+#define FSB_COMMAND_LINE_H_
+
+#include "headless.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fsb {
+//! @brief What the process was asked to do on its command line.
+struct CommandLine {
+    //! Print the usage and exit (--help).
+    bool help_ = false;
+    //! Write the window list to stdout and exit instead of showing the menu (--list).
+    bool list_ = false;
+    //! Format, fields and filter of --list. Hidden and untitled windows are included with --all.
+    HeadlessOptions headless_;
+    //! Print the timings of --list to stderr (--timing).
+    bool timing_ = false;
+    //! Print how long the menu took to paint and to become interactive to stderr on exit
+    //! (--profile-startup).
+    bool profile_startup_ = false;
+    //! Print how many frames the menu painted, coalesced and dropped to stderr on exit
+    //! (--frame-stats).
+    bool frame_stats_ = false;
+    //! Keep the window table warm and answer clients until stopped (--daemon).
+    bool daemon_ = false;
+    //! Send every argument after --client to the daemon as one request, e.g.
+    //! "--client list --fields handle,title".
+    bool client_ = false;
+    std::vector<std::string> client_request_;
+    //! Record every call into the window system to this trace, UTF-8 (--record).
+    std::string record_path_;
+    //! Read the window system from this trace instead (--replay). Without --list, replays its
+    //! timeline and prints how long each step took.
+    std::string replay_path_;
+    //! How many times faster than recorded the trace is replayed, 0 for as fast as possible
+    //! (--speed).
+    double replay_speed_ = 1.0;
+};
+
+//! @brief Parses the arguments, without the program name.
+//!
+//! Options take their value either as the next argument or after '=' (--format=csv).
+//!
+//! @param error Receives a message naming the offending argument when parsing fails.
+//! @returns Returns false if an argument is unknown or invalid.
+bool ParseCommandLine(const std::vector<std::string>& arguments, CommandLine* command_line,
+    std::string* error);
+
+//! @brief Returns the help text listing every option.
+std::string_view CommandLineUsage();
+} // namespace fsb
+
+#endif // #ifndef FSB_COMMAND_LINE_H_
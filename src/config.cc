@@ -9,17 +9,22 @@
 
 #include <ShlObj.h>
 #include <Windows.h>
-#include <cassert>
 
 #include <cassert>
-#include <filesystem>
-#include <fstream>
-#include <vector>
+#include <iterator>
 #include <string_view>
 
 #include "base_types.h"
 
-std::string fsb::GetUserDirectory() {
+namespace {
+std::string QueryUserDirectory() {
+    // The environment is already in memory, so this avoids loading the shell for the usual case.
+    wchar_t environment[MAX_PATH];
+    const DWORD kLength = GetEnvironmentVariableW(L"USERPROFILE", environment, MAX_PATH);
+    if (kLength != 0 && kLength < MAX_PATH) {
+        return fsb::Utf16ToUtf8(environment);
+    }
+
     wchar_t* buffer = nullptr;
     HRESULT result = SHGetKnownFolderPath(FOLDERID_Profile, 0, nullptr, &buffer);
     if (FAILED(result)) {
@@ -33,73 +38,98 @@ std::string fsb::GetUserDirectory() {
     }
     assert(SUCCEEDED(result) && buffer != nullptr);
 
-    std::string final = Utf16ToUtf8(buffer);
+    std::string final = fsb::Utf16ToUtf8(buffer);
     CoTaskMemFree(buffer);
 
     return final;
 }
+} // namespace
 
-fsb::Config fsb::ParseConfig() {
-    Config result = {true, true};
+std::string fsb::GetUserDirectory() {
+    // Asked for by the config, the rules and the trace paths, and it does not change while running.
+    static const std::string kUserDirectory = QueryUserDirectory();
+    return kUserDirectory;
+}
 
+std::string fsb::GetConfigPath() {
     std::string user_path = fsb::GetUserDirectory();
     if (user_path == "$ERROR") {
-        std::exit(FSB_GENERIC_FAILURE);
+        return {};
     }
+    return user_path + "\\.fsb";
+}
 
-    std::string file_path = user_path + "\\.fsb";
+std::string fsb::GetRulesPath() {
+    std::string user_path = fsb::GetUserDirectory();
+    if (user_path == "$ERROR") {
+        return {};
+    }
+    return user_path + "\\.fsb-rules";
+}
 
-    if (!std::filesystem::exists(file_path)) {
-        result.hide_hidden_windows_ = true;
-        result.hide_blank_title_windows_ = true;
-        return result;
+std::string fsb::GetSnapshotPath() {
+    std::string user_path = fsb::GetUserDirectory();
+    if (user_path == "$ERROR") {
+        return {};
+    }
+    return user_path + "\\.fsb-layouts";
+}
+
+std::string fsb::GetDaemonAddress() {
+    // Pipe names are global to the machine, so every user gets their own daemon.
+    wchar_t user_name[256];
+    const DWORD kLength = GetEnvironmentVariableW(L"USERNAME", user_name,
+        static_cast<DWORD>(std::size(user_name)));
+    if (kLength == 0 || kLength >= std::size(user_name)) {
+        return "\\\\.\\pipe\\fsb-daemon";
+    }
+    return "\\\\.\\pipe\\fsb-daemon-" + fsb::Utf16ToUtf8(user_name);
+}
+
+bool fsb::ReadConfigFile(const std::string& path, std::string* contents) {
+    // A missing file is the normal case, so it is not reported.
+    HANDLE file = CreateFileW(Utf8ToUtf16(path).c_str(), GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart > (1 << 20)) {
+        static_cast<void>(CloseHandle(file));
+        return false;
     }
 
-    std::ifstream config_file(file_path);
-    if (!config_file.is_open()) {
-        result.hide_hidden_windows_ = true;
-        result.hide_blank_title_windows_ = true;
-        return result;
+    contents->resize(static_cast<size_t>(size.QuadPart));
+    DWORD read = 0;
+    const BOOL kResult = ReadFile(file, contents->data(), static_cast<DWORD>(contents->size()),
+        &read, nullptr);
+    static_cast<void>(CloseHandle(file));
+    if (!kResult) {
+        constexpr std::string_view kActionDescription = "read the config file.";
+        constexpr std::string_view kQualifiedName = "config.cc::fsb::ReadConfigFile";
+        constexpr std::string_view kExportedOperationName = "Kernel32.dll!ReadFile";
+        constexpr int kReturnCode = 0;
+        WIN32_ERROR(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode);
+        return false;
     }
 
-    // TODO(jhowell728): Cleanup parsing logic.
-    std::string line;
-    const std::vector<std::string_view> kTargetKeys = {"hide_hidden_windows",
-        "hide_blank_title_windows"};
-    while (std::getline(config_file, line)) {
-        if (line.empty() || line[0] == '#')
-            continue;
-
-        size_t equal_pos = line.find('=');
-        if (equal_pos == std::string::npos)
-            continue;
-
-        std::string_view key_part(line.data(), equal_pos);
-        std::string_view value_part(line.data() + equal_pos + 1,
-            line.size() - equal_pos - 1);
-
-        for (const auto& key : kTargetKeys) {
-            if (key_part == key) {
-                if (value_part == "true") {
-                    if (key_part == "hide_hidden_windows") {
-                        result.hide_hidden_windows_ = true;
-                    } else if (key_part == "hide_blank_title_windows") {
-                        result.hide_blank_title_windows_ = true;
-                    }
-                } else if (value_part == "true") {
-                    if (key_part == "hide_hidden_windows") {
-                        result.hide_hidden_windows_ = false;
-                    } else if (key_part == "hide_blank_title_windows") {
-                        result.hide_blank_title_windows_ = false;
-                    }
-                }
-            }
-        }
-
-        return result;
+    contents->resize(read);
+    return true;
+}
+
+fsb::Config fsb::ParseConfig() {
+    Config result = kDefaultConfig;
+
+    const std::string kFilePath = GetConfigPath();
+    if (kFilePath.empty()) {
+        std::exit(FSB_GENERIC_FAILURE);
     }
 
-    result.hide_hidden_windows_ = true;
-    result.hide_blank_title_windows_ = true;
+    std::string contents;
+    if (ReadConfigFile(kFilePath, &contents)) {
+        static_cast<void>(ParseConfigText(contents, &result));
+    }
     return result;
 }
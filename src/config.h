@@ -5,17 +5,51 @@
 #ifndef FSB_CONFIG_H_
 #define FSB_CONFIG_H_
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 
 namespace fsb {
 struct Config {
     bool hide_hidden_windows_;
     bool hide_blank_title_windows_;
+    //! Number of probe worker threads, 0 to size the pool from the hardware. Read at startup only.
+    int probe_threads_;
+    //! Rows on each side of the selection whose details are loaded ahead of time.
+    int prefetch_radius_;
+    //! Upper bound of the frame rate of the menu, 0 to paint after every change.
+    int max_fps_;
+    //! Record enumeration timings for export with the trace key in the menu.
+    bool trace_;
 };
 
+//! Values used for every key that is missing from the config file.
+constexpr Config kDefaultConfig = {true, true, 0, 2, 60, false};
+
+//! @brief Applies the "key=value" lines of text to config in a single pass.
+//!
+//! Blank lines and lines starting with '#' are skipped. Keys are matched against a compile-time
+//! table, and each value is checked against the type and range of its key. Lines with an unknown
+//! key or a bad value are skipped and leave config unchanged.
+//!
+//! @returns Returns the number of lines that were skipped because they were invalid.
+size_t ParseConfigText(std::string_view text, Config* config);
+
 std::string GetUserDirectory();
+//! @brief Returns the path of the config file, or an empty string if the user profile is unknown.
+std::string GetConfigPath();
+//! @brief Returns the path of the auto-apply rules file (see ParseRules), or an empty string if
+//! the user profile is unknown.
+std::string GetRulesPath();
+//! @brief Returns the path of the window layout snapshot (see SnapshotWriter), or an empty string
+//! if the user profile is unknown.
+std::string GetSnapshotPath();
+//! @brief Returns the name of the pipe the daemon listens on (see Daemon), one per user.
+std::string GetDaemonAddress();
+//! @brief Reads the whole config file with a single read. Returns false if it cannot be read.
+bool ReadConfigFile(const std::string& path, std::string* contents);
 Config ParseConfig();
 
 } // namespace fsb
 
-#endif // #ifndef FSB_CONFIG_H_
\ No newline at end of file
+#endif // #ifndef FSB_CONFIG_H_
@@ -0,0 +1,139 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include <charconv>
+
+namespace fsb {
+namespace {
+enum class ValueType {
+    Bool,
+    Int
+};
+
+struct ConfigKey {
+    std::string_view name_;
+    ValueType type_;
+    bool Config::*bool_field_;
+    int Config::*int_field_;
+    int min_;
+    int max_;
+};
+
+//! Every recognized key. Must stay sorted by name, which FindKey relies on.
+constexpr ConfigKey kConfigKeys[] = {
+    {"hide_blank_title_windows", ValueType::Bool, &Config::hide_blank_title_windows_, nullptr,
+        0, 0},
+    {"hide_hidden_windows", ValueType::Bool, &Config::hide_hidden_windows_, nullptr, 0, 0},
+    {"max_fps", ValueType::Int, nullptr, &Config::max_fps_, 0, 1000},
+    {"prefetch_radius", ValueType::Int, nullptr, &Config::prefetch_radius_, 0, 64},
+    {"probe_threads", ValueType::Int, nullptr, &Config::probe_threads_, 0, 64},
+    {"trace", ValueType::Bool, &Config::trace_, nullptr, 0, 0},
+};
+
+constexpr bool IsSortedByName() {
+    for (size_t i = 1; i < std::size(kConfigKeys); ++i) {
+        if (!(kConfigKeys[i - 1].name_ < kConfigKeys[i].name_)) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(IsSortedByName(), "kConfigKeys must be sorted by name.");
+
+const ConfigKey* FindKey(std::string_view name) {
+    size_t low = 0;
+    size_t high = std::size(kConfigKeys);
+    while (low < high) {
+        const size_t kMiddle = (low + high) / 2;
+        const int kOrder = kConfigKeys[kMiddle].name_.compare(name);
+        if (kOrder == 0) {
+            return &kConfigKeys[kMiddle];
+        }
+        if (kOrder < 0) {
+            low = kMiddle + 1;
+        } else {
+            high = kMiddle;
+        }
+    }
+    return nullptr;
+}
+
+std::string_view Trim(std::string_view text) {
+    constexpr std::string_view kWhitespace = " \t\r";
+    const size_t kFirst = text.find_first_not_of(kWhitespace);
+    if (kFirst == std::string_view::npos) {
+        return {};
+    }
+    return text.substr(kFirst, text.find_last_not_of(kWhitespace) - kFirst + 1);
+}
+
+bool ParseBool(std::string_view text, bool* value) {
+    if (text == "true" || text == "yes" || text == "on" || text == "1") {
+        *value = true;
+        return true;
+    }
+    if (text == "false" || text == "no" || text == "off" || text == "0") {
+        *value = false;
+        return true;
+    }
+    return false;
+}
+
+bool ParseInt(std::string_view text, int min, int max, int* value) {
+    int parsed = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+    if (error != std::errc() || end != text.data() + text.size() || parsed < min || parsed > max) {
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+//! Applies one non-empty, non-comment line. Returns false if the line is invalid.
+bool ApplyLine(std::string_view line, Config* config) {
+    const size_t kEqualPosition = line.find('=');
+    if (kEqualPosition == std::string_view::npos) {
+        return false;
+    }
+
+    const ConfigKey* key = FindKey(Trim(line.substr(0, kEqualPosition)));
+    if (key == nullptr) {
+        return false;
+    }
+
+    const std::string_view kValue = Trim(line.substr(kEqualPosition + 1));
+    switch (key->type_) {
+        case ValueType::Bool:
+            return ParseBool(kValue, &(config->*key->bool_field_));
+        case ValueType::Int:
+            return ParseInt(kValue, key->min_, key->max_, &(config->*key->int_field_));
+    }
+    return false;
+}
+} // namespace
+
+size_t ParseConfigText(std::string_view text, Config* config) {
+    constexpr std::string_view kByteOrderMark = "\xEF\xBB\xBF";
+    if (text.substr(0, kByteOrderMark.size()) == kByteOrderMark) {
+        text.remove_prefix(kByteOrderMark.size());
+    }
+
+    size_t invalid_lines = 0;
+    while (!text.empty()) {
+        const size_t kLineEnd = text.find('\n');
+        const std::string_view kLine = Trim(text.substr(0, kLineEnd));
+        text.remove_prefix(kLineEnd == std::string_view::npos ? text.size() : kLineEnd + 1);
+
+        if (kLine.empty() || kLine.front() == '#') {
+            continue;
+        }
+        if (!ApplyLine(kLine, config)) {
+            ++invalid_lines;
+        }
+    }
+    return invalid_lines;
+}
+} // namespace fsb
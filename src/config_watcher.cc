@@ -0,0 +1,70 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "config_watcher.h"
+
+#include "error.h"
+#include "fsb_string.h"
+
+#include <string_view>
+
+namespace fsb {
+ConfigWatcher::ConfigWatcher() : change_handle_(nullptr) {}
+
+ConfigWatcher::~ConfigWatcher() {
+    if (change_handle_ != nullptr) {
+        static_cast<void>(FindCloseChangeNotification(change_handle_));
+    }
+}
+
+bool ConfigWatcher::Start(const std::string& path) {
+    const size_t kSeparator = path.find_last_of("\\/");
+    if (kSeparator == std::string::npos) {
+        return false;
+    }
+
+    path_ = path;
+    if (!ReadConfigFile(path_, &contents_)) {
+        contents_.clear();
+    }
+
+    const std::wstring kDirectory = Utf8ToUtf16(std::string_view(path).substr(0, kSeparator));
+    HANDLE handle = FindFirstChangeNotificationW(kDirectory.c_str(), FALSE,
+        FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+    if (handle == INVALID_HANDLE_VALUE) {
+        constexpr std::string_view kActionDescription = "watch the config file for changes.";
+        constexpr std::string_view kQualifiedName = "config_watcher.cc::fsb::ConfigWatcher::Start";
+        constexpr std::string_view kExportedOperationName =
+            "Kernel32.dll!FindFirstChangeNotificationW";
+        constexpr int kReturnCode = -1;
+        WIN32_ERROR(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode);
+        return false;
+    }
+
+    change_handle_ = handle;
+    return true;
+}
+
+bool ConfigWatcher::Poll(Config* config) {
+    if (change_handle_ == nullptr || WaitForSingleObject(change_handle_, 0) != WAIT_OBJECT_0) {
+        return false;
+    }
+    static_cast<void>(FindNextChangeNotification(change_handle_));
+
+    // A deleted file falls back to the defaults, the same as at startup.
+    std::string contents;
+    if (!ReadConfigFile(path_, &contents)) {
+        contents.clear();
+    }
+    if (contents == contents_) {
+        return false;
+    }
+    contents_ = std::move(contents);
+
+    Config parsed = kDefaultConfig;
+    static_cast<void>(ParseConfigText(contents_, &parsed));
+    *config = parsed;
+    return true;
+}
+} // namespace fsb
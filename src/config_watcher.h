@@ -0,0 +1,47 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_CONFIG_WATCHER_H_
+#define FSB_CONFIG_WATCHER_H_
+
+#include "config.h"
+
+#include <Windows.h>
+#include <string>
+
+namespace fsb {
+//! @brief Watches the config file so edits can be applied while the menu is open.
+//!
+//! Windows can only watch directories, so the watcher waits on a change notification for the
+//! directory that holds the file and compares the file contents to tell edits apart from
+//! unrelated changes next to it. A changed file is parsed into a fresh Config that replaces the
+//! old one as a whole, so a half-applied file is never observed.
+class ConfigWatcher {
+public:
+    ConfigWatcher();
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    //! @brief Starts watching the file at path. Returns false if its directory cannot be watched.
+    bool Start(const std::string& path);
+
+    //! @brief Handle that is signaled when the watched directory changes, or nullptr.
+    HANDLE change_handle() const { return change_handle_; }
+
+    //! @brief Checks for a change without blocking.
+    //!
+    //! @returns Returns true and fills config if the file contents changed since the last call.
+    bool Poll(Config* config);
+
+private:
+    std::string path_;
+    //! Contents the current config was parsed from.
+    std::string contents_;
+    HANDLE change_handle_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_CONFIG_WATCHER_H_
@@ -6,23 +6,106 @@
 
 #include "error.h"
 #include "fsb_string.h"
-#include <colors/colors.hpp>
-
+#include "geometry_batch.h"
+#include "startup_profiler.h"
+#include "trace.h"
+#include "win32_display_topology.h"
+#include "window_actions.h"
+#include "window_probe.h"
+
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
 #include <fcntl.h>
 #include <io.h>
+#include <iterator>
 #include <sstream>
 #include <string>
+#include <utility>
 
 namespace fsb {
-Console::Console(const Config& config)
+namespace {
+// Ruler, details of the selected window and the controls line.
+constexpr int kFooterRows = 3;
+constexpr int kSortKeyCount = static_cast<int>(WindowColumns::SortKey::Title) + 1;
+//! Window events tend to arrive in bursts (a window opening moves, shows and renames itself), so
+//! they are applied once the burst has been quiet for this long.
+constexpr auto kWindowEventDelay = std::chrono::milliseconds(50);
+//! Without the hook nothing reports window changes, so the list is re-enumerated this often.
+constexpr auto kPollInterval = std::chrono::seconds(2);
+constexpr auto kStatusDuration = std::chrono::seconds(5);
+//! Enumerated windows are added to the list at most this often, about twice per frame at 60 Hz.
+constexpr auto kStreamInterval = std::chrono::milliseconds(8);
+//! Error log records kept for the log view.
+constexpr size_t kErrorHistory = 512;
+
+//! Returns the menu key code of a console key event, or -1 for keys the menu ignores.
+int TranslateKey(const KEY_EVENT_RECORD& key_event) {
+    switch (key_event.wVirtualKeyCode) {
+        case VK_UP:
+            return kKeyUp;
+        case VK_DOWN:
+            return kKeyDown;
+        case VK_PRIOR:
+            return kKeyPageUp;
+        case VK_NEXT:
+            return kKeyPageDown;
+        case VK_HOME:
+            return kKeyHome;
+        case VK_END:
+            return kKeyEnd;
+    }
+
+    // Escape, Enter and Backspace come through as their control characters. Only ASCII is
+    // searchable, so other characters are dropped.
+    const wchar_t kCharacter = key_event.uChar.UnicodeChar;
+    if (kCharacter == 0 || kCharacter > 0x7F) {
+        return -1;
+    }
+    return static_cast<int>(kCharacter);
+}
+
+//! Sends rendered frames straight to the console output handle in one write.
+class ConsoleSink : public TerminalSink {
+public:
+    explicit ConsoleSink(HANDLE console_handle) : console_handle_(console_handle) {}
+
+    void Write(std::string_view bytes) override {
+        DWORD written = 0;
+        static_cast<void>(WriteFile(console_handle_, bytes.data(),
+            static_cast<DWORD>(bytes.size()), &written, nullptr));
+    }
+
+private:
+    HANDLE console_handle_;
+};
+} // namespace
+
+Console::Console(const Config& config, WindowSource& window_source)
     : clear_console_(false),
       refresh_line_(0),
       menu_section_(true),
-      index_section_0_(0),
       index_section_1_x_(0),
       index_section_1_y_(0),
-      config_(config) {
+      config_(config),
+      loop_(waiter_),
+      render_scheduler_(config.max_fps_),
+      frame_timer_(0),
+      update_timer_(0),
+      status_timer_(0),
+      window_source_(window_source),
+      process_cache_(strings_),
+      detail_loader_(window_source_, process_cache_, health_, probe_pool_),
+      probe_pool_(static_cast<size_t>(config.probe_threads_)),
+      enumerating_(false),
+      enumeration_generation_(0),
+      interactive_(false),
+      sort_key_(WindowColumns::SortKey::ZOrder),
+      hide_minimized_(false),
+      searching_(false),
+      showing_errors_(false) {
     const auto kConsoleHandle = GetStdHandle(STD_OUTPUT_HANDLE);
     if (kConsoleHandle == INVALID_HANDLE_VALUE) {
         constexpr std::string_view kActionDesc = "setup the console for UTF-8 I/O.";
@@ -39,6 +122,13 @@ Console::Console(const Config& config)
     info.bVisible = false;
     static_cast<void>(SetConsoleCursorInfo(kConsoleHandle, &info));
 
+    // Frames are rendered as ANSI escape sequences.
+    DWORD mode = 0;
+    if (GetConsoleMode(kConsoleHandle, &mode) && !(mode & ENABLE_VIRTUAL_TERMINAL_PROCESSING)) {
+        static_cast<void>(SetConsoleMode(kConsoleHandle,
+            mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING));
+    }
+
     if (!SetConsoleOutputCP(CP_UTF8) || !SetConsoleCP(CP_UTF8)) {
         constexpr std::string_view kActionDesc = "setup the console active code page.";
         constexpr std::string_view kQualifiedName = "console.cc::fsb::Console::Console";
@@ -48,17 +138,22 @@ Console::Console(const Config& config)
         std::exit(FSB_CONSOLE_INIT_FAILURE);
     }
 
-    // Note: _O_TEXT and _O_U8TEXT, while fundamentally the same and have the same value serve two
-    // different functions and greatly impact the console output.
-    // The C Runtime will differentiate between the two internally.
-    // _O_U8TEXT translates UTF-16 (wcout) output to UTF-8, however, this will mangle UTF-8 output
-    // and result in mojibake output.
-    // Return value is ignored because _setmode returns the previous translation mode of the file.
-    static_cast<void>(_setmode(_fileno(stdout), _O_TEXT));
-    static_cast<void>(_setmode(_fileno(stderr), _O_TEXT));
-    static_cast<void>(_setmode(_fileno(stdin), _O_TEXT));
+    // Everything else waits until the first frame is on screen, see DeferredSetup.
+    Tracer::Get().SetEnabled(config.trace_);
 
-    static_cast<void>(SetConsoleTitleW(L"Full Screen Borderless"));
+    waiter_.Watch(EventSource::Input, GetStdHandle(STD_INPUT_HANDLE));
+    loop_.SetHandler(EventSource::Input, [this]() { ReadInput(); });
+
+    // Prefetches finish on the workers. Only the loop thread touches the list, so they report
+    // back through it, and a frame is drawn once the selected window's details are in.
+    detail_loader_.SetReadyCallback([this](HWND window_handle) {
+        loop_.Post([this, window_handle]() {
+            const ProcessData* kSelected = SelectedWindow();
+            if (kSelected != nullptr && kSelected->window_handle_ == window_handle) {
+                render_scheduler_.Invalidate(EventLoop::Clock::now());
+            }
+        });
+    });
 }
 
 Console::~Console() {
@@ -79,282 +174,690 @@ Console::~Console() {
     static_cast<void>(SetConsoleCursorInfo(kConsoleHandle, &cursorInfo));
 }
 
-bool Console::GetWindowAttributes(HWND window_handle, WindowAttributes* window_attributes) {
-    if (window_handle == nullptr || !IsWindow(window_handle)) {
-        return false;
+void Console::ClearConsole() {
+    // Modern Windows consoles (post UTF-16 implementation) don't interpret ANSI escape codes and
+    // must be either set via attributes or ANSI codes must be enabled
+    auto console_handle = GetStdHandle(STD_OUTPUT_HANDLE);
+    if (console_handle == INVALID_HANDLE_VALUE) {
+        constexpr std::string_view kActionDescription = "clear the console.";
+        constexpr std::string_view kQualifiedName = "console.cc::fsb::Console::ClearConsole";
+        constexpr std::string_view kExportedFunctionName = "Kernel32.dll!GetStdHandle";
+        constexpr int kReturnCode = -1;
+        WIN32_ERROR(kActionDescription, kQualifiedName, kExportedFunctionName, kReturnCode);
+        return;
     }
 
-    const bool kIsWindowVisible = IsWindowVisible(window_handle);
-
-    const bool kIsWindowEnabled = IsWindowEnabled(window_handle);
-
-    WindowState window_state = WindowState::Normal;
-    WINDOWPLACEMENT window_placement;
-    window_placement.length = sizeof(window_placement);
-
-    if (GetWindowPlacement(window_handle, &window_placement)) {
-        // showCmd is the property used to determine window state.
-        // For example, nCmdShow in the WinMain entry point is the state to show the window in.
-        // I used to think it meant whether to show the CMD window or not, however it means show
-        // command not show command prompt.
-        // It's only real use is this and ShowWindow which is the prefix in the macro SW means.
-        // The values we need here are SW_SHOWMAXIMIZED, SW_SHOWMINIMIZED, SW_SHOWNORMAL and/or
-        // SW_RESTORE (these two mean the same).
-        switch (window_placement.showCmd) {
-            case SW_SHOWMAXIMIZED:
-                window_state = WindowState::Maximized;
-                break;
-            case SW_SHOWMINIMIZED:
-                window_state = WindowState::Minimized;
-                break;
-            default:
-                window_state = WindowState::Normal;
-                break;
+    DWORD mode = 0;
+    if (GetConsoleMode(console_handle, &mode)) {
+        if (!(mode & ENABLE_VIRTUAL_TERMINAL_PROCESSING)) {
+            SetConsoleMode(console_handle, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
         }
-    } else {
-        return false;
     }
 
-    window_attributes->is_enabled_ = kIsWindowEnabled;
-    window_attributes->is_visible_ = kIsWindowVisible;
-    window_attributes->state_ = window_state;
+    std::cout << "\033c[2J\033[H" << std::flush;
+}
 
-    return true;
+void Console::DeferredSetup() {
+    // Note: _O_TEXT and _O_U8TEXT, while fundamentally the same and have the same value serve two
+    // different functions and greatly impact the console output.
+    // The C Runtime will differentiate between the two internally.
+    // _O_U8TEXT translates UTF-16 (wcout) output to UTF-8, however, this will mangle UTF-8 output
+    // and result in mojibake output.
+    // Return value is ignored because _setmode returns the previous translation mode of the file.
+    static_cast<void>(_setmode(_fileno(stdout), _O_TEXT));
+    static_cast<void>(_setmode(_fileno(stderr), _O_TEXT));
+    static_cast<void>(_setmode(_fileno(stdin), _O_TEXT));
+
+    static_cast<void>(SetConsoleTitleW(L"Full Screen Borderless"));
+
+    // Without the watcher config edits only apply on the next start.
+    static_cast<void>(config_watcher_.Start(GetConfigPath()));
+    waiter_.Watch(EventSource::ConfigChanged, config_watcher_.change_handle());
+    loop_.SetHandler(EventSource::ConfigChanged, [this]() { OnConfigChanged(); });
+    // The rules file lives next to the config file, so the same watcher covers it.
+    LoadRules();
+
+    // Layouts left over mean the last run ended without putting the windows back.
+    const std::string kSnapshotPath = GetSnapshotPath();
+    if (!kSnapshotPath.empty() && snapshot_.Open(kSnapshotPath) && !snapshot_.empty()) {
+        SetStatus(std::to_string(snapshot_.size())
+            + " window layout(s) from the last run can be restored with U.");
+    }
+    StartupProfiler::Get().Mark("deferred setup");
 }
 
-bool Console::GetWindowMetrics(HWND window_handle, WindowMetrics* window_metrics) {
-    if (window_handle == nullptr || !IsWindow(window_handle)) {
-        return false;
+void Console::StartEnumeration() {
+    process_cache_.BeginRefresh();
+    health_.BeginRound();
+    detail_loader_.Clear();
+
+    windows_.Reset({});
+    OnWindowsChanged(nullptr);
+    enumerating_ = true;
+    const uint32_t kGeneration = ++enumeration_generation_;
+
+    // The config may be reloaded while the enumeration runs, so it gets its own copy.
+    probe_pool_.Submit([this, kGeneration, config = config_]() {
+        static_cast<void>(StreamWindows(window_source_, strings_, probe_pool_, config,
+            kStreamInterval, nullptr, [this, kGeneration](std::vector<ProcessData> batch,
+                bool done) {
+                loop_.Post([this, batch = std::move(batch), done, kGeneration]() mutable {
+                    AppendWindows(std::move(batch), done, kGeneration);
+                });
+            }));
+    });
+}
+
+void Console::AppendWindows(std::vector<ProcessData> batch, bool done, uint32_t generation) {
+    if (generation != enumeration_generation_) {
+        return;
     }
 
-    RECT window_rect;
-    if (!GetWindowRect(window_handle, &window_rect)) {
-        return false;
+    const bool kFirst = windows_.empty() && !batch.empty();
+    const ProcessData* kSelected = SelectedWindow();
+    const HWND kSelectedHandle = kSelected != nullptr ? kSelected->window_handle_ : nullptr;
+    if (windows_.Append(std::move(batch)) != 0) {
+        OnWindowsChanged(kSelectedHandle);
+    }
+    if (kFirst) {
+        StartupProfiler::Get().Mark("first windows");
     }
 
-    int x, y, width, height;
-    x = window_rect.left;
-    y = window_rect.top;
-    width = window_rect.right - window_rect.left;
-    height = window_rect.bottom - window_rect.top;
-
-    auto font_handle = reinterpret_cast<HFONT>(SendMessageTimeoutW(window_handle, WM_GETFONT,
-        0, 0, SMTO_ABORTIFHUNG, 100, nullptr));
-
-    std::string font_name = "";
-    uint32_t font_size = 0;
-
-    LOGFONT log_font = {};
-    if (font_handle != nullptr) {
-        if (GetObjectW(font_handle, sizeof(LOGFONT), &log_font)) {
-            std::wstring buffer = log_font.lfFaceName;
-            font_name = Utf16ToUtf8(buffer);
-
-            HDC device_context = GetDC(window_handle);
-            int dpi = GetDeviceCaps(device_context, LOGPIXELSY);
-            ReleaseDC(window_handle, device_context);
-
-            // Conversion: font size (in pixels) = lfHeight * 72 / DPI.
-            // 72 in this case is representative of 1 point (pixel) being 1/72 of an inch which is
-            // divided by DPI in case the dots per inch is more than 1/72.
-            if (log_font.lfHeight < 0) {
-                // Normally, negative height means character height in logical units.
-                font_size = static_cast<uint32_t>(-log_font.lfHeight * 72 / dpi);
-            } else {
-                // While uncommon, positive height is possible.
-                // Consider calling GetTextMetrics if this conversion is buggy.
-                font_size = static_cast<uint32_t>(log_font.lfHeight * 72 / dpi);
-            }
+    if (done) {
+        enumerating_ = false;
+        StartupProfiler::Get().Mark("enumerated");
+        // Events that arrived during the enumeration were held back until now.
+        if (window_event_hook_.has_pending()) {
+            ScheduleUpdate();
         }
-    } else {
-        // TODO (jhowell728): Implement logging calls.
-        font_name = "None";
-        font_size = 0;
     }
+    render_scheduler_.Invalidate(EventLoop::Clock::now());
+}
 
-    const uint32_t kStyle = static_cast<uint32_t>(GetWindowLongPtrW(window_handle,
-        GWL_STYLE));
-    const uint32_t kExStyle = static_cast<uint32_t>(GetWindowLongPtrW(window_handle,
-        GWL_EXSTYLE));
+void Console::RefreshWindows() {
+    // Supersedes a streamed enumeration that is still running.
+    ++enumeration_generation_;
+    enumerating_ = false;
+
+    process_cache_.BeginRefresh();
+    health_.BeginRound();
+    detail_loader_.Clear();
+
+    std::vector<ProcessData> windows;
+    EnumerateWindows(window_source_, strings_, probe_pool_, config_, &windows);
+    windows_.Reset(std::move(windows));
+    for (auto it = ruled_windows_.begin(); it != ruled_windows_.end();) {
+        it = windows_.Find(*it) < 0 ? ruled_windows_.erase(it) : std::next(it);
+    }
+    OnWindowsChanged(nullptr);
+}
 
-    const SizeVec2 kPosition = {x, y};
-    const SizeVec2 kSize = {width, height};
+void Console::UpdateWindows() {
+    // The enumeration applies the pending events itself once it is done.
+    if (enumerating_) {
+        return;
+    }
+    if (!window_event_hook_.installed()) {
+        RefreshWindows();
+        return;
+    }
 
-    window_metrics->position_ = kPosition;
-    window_metrics->size_ = kSize;
-    window_metrics->font_name_ = font_name;
-    window_metrics->font_size_ = font_size;
-    window_metrics->style_ = kStyle;
-    window_metrics->ex_style_ = kExStyle;
+    std::vector<WindowEvent> events;
+    window_event_hook_.Drain(&events);
+    if (events.empty()) {
+        return;
+    }
 
-    return true;
+    process_cache_.BeginRefresh();
+    health_.BeginRound();
+
+    // Follow the selected window rather than the selected row, as rows can move.
+    const ProcessData* kSelected = SelectedWindow();
+    const HWND kSelectedHandle = kSelected != nullptr ? kSelected->window_handle_ : nullptr;
+
+    std::vector<HWND> removed;
+    std::vector<HWND> probed;
+    static_cast<void>(windows_.Apply(events, window_source_, strings_, config_, &removed,
+        &probed));
+    for (HWND window_handle : removed) {
+        detail_loader_.Forget(window_handle);
+        ruled_windows_.erase(window_handle);
+    }
+    // Rules are for windows as they appear, which includes a title set right after creation.
+    ApplyRules(probed);
+
+    OnWindowsChanged(kSelectedHandle);
 }
 
-std::string Console::GetProcessFileName(uint32_t process_id) {
-    HANDLE process_handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION,
-        false, process_id);
-    if (!process_handle) {
-        // TODO(jhowell728): Come up with a better unknown file name value
-        return "???";
+void Console::ApplyConfig(const Config& config) {
+    const Config kPrevious = config_;
+    config_ = config;
+    Tracer::Get().SetEnabled(config.trace_);
+    render_scheduler_.SetFrameRate(config.max_fps_);
+
+    const bool kRelaxed = (kPrevious.hide_hidden_windows_ && !config.hide_hidden_windows_)
+        || (kPrevious.hide_blank_title_windows_ && !config.hide_blank_title_windows_);
+    const bool kTightened = (!kPrevious.hide_hidden_windows_ && config.hide_hidden_windows_)
+        || (!kPrevious.hide_blank_title_windows_ && config.hide_blank_title_windows_);
+
+    // Windows hidden by the old filters were never probed, so only a full pass can add them. An
+    // enumeration in progress has the old filters too.
+    if (kRelaxed || (enumerating_ && kTightened)) {
+        RefreshWindows();
+        return;
+    }
+    if (!kTightened) {
+        return;
     }
 
-    wchar_t process_file_name[MAX_PATH];
-    uint32_t size = MAX_PATH;
+    const ProcessData* kSelected = SelectedWindow();
+    const HWND kSelectedHandle = kSelected != nullptr ? kSelected->window_handle_ : nullptr;
 
-    if (QueryFullProcessImageNameW(process_handle, 0, process_file_name,
-        reinterpret_cast<DWORD*>(&size))) {
-        CloseHandle(process_handle);
-        return Utf16ToUtf8(process_file_name);
+    std::vector<HWND> removed;
+    static_cast<void>(windows_.RemoveFiltered(config_, &removed));
+    for (HWND window_handle : removed) {
+        detail_loader_.Forget(window_handle);
     }
 
-    CloseHandle(process_handle);
-    return "???";
+    OnWindowsChanged(kSelectedHandle);
 }
 
-void Console::ClearConsole() {
-    // Modern Windows consoles (post UTF-16 implementation) don't interpret ANSI escape codes and
-    // must be either set via attributes or ANSI codes must be enabled
-    auto console_handle = GetStdHandle(STD_OUTPUT_HANDLE);
-    if (console_handle == INVALID_HANDLE_VALUE) {
-        constexpr std::string_view kActionDescription = "clear the console.";
-        constexpr std::string_view kQualifiedName = "console.cc::fsb::Console::ClearConsole";
-        constexpr std::string_view kExportedFunctionName = "Kernel32.dll!GetStdHandle";
-        constexpr int kReturnCode = -1;
-        WIN32_ERROR(kActionDescription, kQualifiedName, kExportedFunctionName, kReturnCode);
-        return;
-    }
+void Console::ReadInput() {
+    const HANDLE kInputHandle = GetStdHandle(STD_INPUT_HANDLE);
+
+    // Every record has to be read, as the handle stays signaled while any are left, including
+    // the mouse, focus and menu records the menu has no use for.
+    DWORD available = 0;
+    while (GetNumberOfConsoleInputEvents(kInputHandle, &available) && available > 0) {
+        INPUT_RECORD records[64];
+        DWORD read = 0;
+        if (!ReadConsoleInputW(kInputHandle, records, static_cast<DWORD>(std::size(records)),
+                &read)) {
+            constexpr std::string_view kActionDescription = "read the console input.";
+            constexpr std::string_view kQualifiedName = "console.cc::fsb::Console::ReadInput";
+            constexpr std::string_view kExportedOperationName = "Kernel32.dll!ReadConsoleInputW";
+            constexpr int kReturnCode = 0;
+            WIN32_ERROR(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode);
+            return;
+        }
 
-    DWORD mode = 0;
-    if (GetConsoleMode(console_handle, &mode)) {
-        if (!(mode & ENABLE_VIRTUAL_TERMINAL_PROCESSING)) {
-            SetConsoleMode(console_handle, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+        for (DWORD i = 0; i < read; ++i) {
+            if (records[i].EventType == WINDOW_BUFFER_SIZE_EVENT) {
+                render_scheduler_.Invalidate(EventLoop::Clock::now());
+                continue;
+            }
+            if (records[i].EventType != KEY_EVENT || !records[i].Event.KeyEvent.bKeyDown) {
+                continue;
+            }
+
+            const int kKey = TranslateKey(records[i].Event.KeyEvent);
+            if (kKey < 0) {
+                continue;
+            }
+            for (WORD repeat = 0; repeat < records[i].Event.KeyEvent.wRepeatCount; ++repeat) {
+                DispatchKeyPress(kKey, SelectedWindow());
+            }
+            render_scheduler_.Invalidate(EventLoop::Clock::now());
         }
     }
-
-    std::cout << "\033c[2J\033[H" << std::flush;
 }
 
-// TODO(jhowell728): clean up logic and add better error codes
-int Console::EnumWindowsCallback(HWND window_handle, LPARAM message_param) {
-    if (window_handle == nullptr || !IsWindow(window_handle)) {
-        return 1;
+void Console::OnWindowMessages() {
+    window_event_hook_.Pump();
+    if (Win32DisplayTopology::Get().TakeChanged()) {
+        SetStatus("Displays changed, the monitor layout was reloaded.");
+        render_scheduler_.Invalidate(EventLoop::Clock::now());
+    }
+    if (enumerating_ || !window_event_hook_.has_pending()) {
+        return;
     }
+    ScheduleUpdate();
+}
 
-    auto console = reinterpret_cast<Console*>(message_param);
+void Console::ScheduleUpdate() {
+    // Restart the delay on every event, so a burst is applied once.
+    loop_.CancelTimer(update_timer_);
+    update_timer_ = loop_.AddTimer(kWindowEventDelay, [this]() {
+        update_timer_ = 0;
+        UpdateWindows();
+        render_scheduler_.Invalidate(EventLoop::Clock::now());
+    });
+}
 
-    WindowAttributes window_attributes = {};
-    if (!GetWindowAttributes(window_handle, &window_attributes)) {
-        constexpr std::string_view kActionDescription = "get the attributes for a window";
-        constexpr std::string_view kQualifiedName =
-            "console.cc::fsb::Console::EnumWindowsCallback";
-        constexpr std::string_view kExportedOperationName = "fsb.exe!GetWindowAttributes";
-        const auto kReturnCode = static_cast<uint32_t>(GetLastError());
-        WIN32_ERROR(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode);
+void Console::OnConfigChanged() {
+    Config config = config_;
+    if (config_watcher_.Poll(&config)) {
+        ApplyConfig(config);
+        render_scheduler_.Invalidate(EventLoop::Clock::now());
     }
+    LoadRules();
+}
 
-    if (!window_attributes.is_visible_ && console->config_.hide_hidden_windows_) {
-        return 1;
+void Console::LoadRules() {
+    const std::string kPath = GetRulesPath();
+    std::string contents;
+    if (kPath.empty() || !ReadConfigFile(kPath, &contents)) {
+        contents.clear();
+    }
+    if (contents == rules_contents_) {
+        return;
     }
+    rules_contents_ = std::move(contents);
 
-    WindowMetrics window_metrics = {};
-    if (!GetWindowMetrics(window_handle, &window_metrics)) {
-        constexpr std::string_view kActionDescription = "get the metrics for a window";
-        constexpr std::string_view kQualifiedName =
-            "console.cc::fsb::Console::EnumWindowsCallback";
-        constexpr std::string_view kExportedOperationName = "fsb.exe!GetWindowMetrics";
-        const auto kReturnCode = static_cast<uint32_t>(GetLastError());
-        WIN32_ERROR(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode);
+    std::vector<Rule> rules;
+    const size_t kInvalidLines = ParseRules(rules_contents_, &rules);
+    rules_.Compile(std::move(rules));
+    if (kInvalidLines != 0) {
+        SetStatus("Skipped " + std::to_string(kInvalidLines) + " invalid line(s) in " + kPath);
     }
+}
 
-    if (window_metrics.ex_style_ & WS_EX_TOOLWINDOW) {
-        return 1;
+void Console::ApplyRules(const std::vector<HWND>& window_handles) {
+    if (rules_.empty()) {
+        return;
     }
 
-    uint32_t process_id = 0;
-    if (GetWindowThreadProcessId(window_handle, reinterpret_cast<DWORD*>(&process_id)) == 0) {
-        constexpr std::string_view kActionDescription = "get the process ID for a window.";
-        constexpr std::string_view kQualifiedName =
-            "console.cc::fsb::Console::EnumWindowsCallback";
-        constexpr std::string_view kExportedFunctionName = "User32.dll!GetWindowThreadProcessId";
-        constexpr int kReturnCode = 0;
-        WIN32_ERROR(kActionDescription, kQualifiedName, kExportedFunctionName, kReturnCode);
-        return 1;
-    }
-
-    wchar_t title_buffer[256];
-    if (GetWindowTextW(window_handle, title_buffer, std::size(title_buffer)) == 0) {
-        if (const auto kReturnCode = static_cast<uint32_t>(GetLastError());
-            kReturnCode != 0 && kReturnCode != ERROR_SEM_NOT_FOUND
-            && kReturnCode != ERROR_ACCESS_DENIED) {
-            constexpr std::string_view kActionDescription = "get the title of a window.";
-            constexpr std::string_view kQualifiedName =
-                "console.cc::fsb::Console::EnumWindowsCallback";
-            constexpr std::string_view kExportedOperationName = "User32.dll!GetWindowTextW";
-            WIN32_ERROR(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode);
+    // Every window that matches goes into one batch, which applies as a whole or not at all.
+    GeometryBatch batch(geometry_);
+    bool snapshot_changed = false;
+    for (HWND window_handle : window_handles) {
+        const int kRow = windows_.Find(window_handle);
+        if (kRow < 0 || ruled_windows_.count(window_handle) != 0) {
+            continue;
+        }
+
+        const ProcessData& window = windows_[kRow];
+        const std::string_view kFileName = rules_.needs_file_name()
+            ? process_cache_.GetFileName(window_source_, window.process_id_) : std::string_view();
+        const int kRule = rules_.Match(window.class_name_, window.title_, kFileName);
+        if (kRule < 0) {
+            continue;
         }
+
+        ruled_windows_.insert(window_handle);
+        const Rule& rule = rules_.rule(static_cast<size_t>(kRule));
+        const GeometryChange& kChange = batch.AddBorderless(window_handle, rule.action_.monitor_);
+        if (kChange.status_ != ApplyStatus::Pending) {
+            continue;
+        }
+
+        // The batch read the geometry right before the change, which is what the window goes
+        // back to.
+        ProcessData layout = window;
+        layout.metrics_ = kChange.before_;
+        static_cast<void>(window_source_.GetWindowAttributes(window_handle, &layout.attributes_));
+        snapshot_changed = snapshot_.Add(layout) || snapshot_changed;
+    }
+    if (batch.changes().empty()) {
+        return;
     }
 
-    if (title_buffer[0] == L'\0' && console->config_.hide_blank_title_windows_) {
-        return 1;
+    // Written before the change, so the layouts survive fsb going away half-way.
+    if (snapshot_changed) {
+        static_cast<void>(snapshot_.Flush());
+    }
+    if (batch.Commit()) {
+        return;
     }
 
-    wchar_t class_buffer[256];
-    if (GetClassNameW(window_handle, class_buffer, std::size(class_buffer)) == 0) {
-        if (const auto kReturnCode = static_cast<uint32_t>(GetLastError());
-            kReturnCode != 0) {
-            constexpr std::string_view kActionDescription = "get the class name of a window.";
-            constexpr std::string_view kQualifiedName =
-                "console.cc::fsb::Console::EnumWindowsCallback";
-            constexpr std::string_view kExportedOperationName = "User32.dll!GetClassNameW";
-            WIN32_ERROR(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode);
+    // Windows that were only rolled back because of another one get another chance.
+    for (const GeometryChange& change : batch.changes()) {
+        if (change.status_ == ApplyStatus::RolledBack) {
+            ruled_windows_.erase(change.window_handle_);
         }
     }
+    SetStatus("Rules: " + batch.Summary());
+}
+
+void Console::RestoreWindows() {
+    const std::string kSnapshotPath = GetSnapshotPath();
+    if (kSnapshotPath.empty()) {
+        SetStatus("No window layouts to restore.");
+        return;
+    }
+
+    // The daemon may have recorded layouts this process has not seen, so the file decides.
+    size_t restored = 0;
+    size_t recorded = 0;
+    const auto kRestore = [&](const SnapshotReader& reader) {
+        restored = RestoreLayouts(reader);
+        recorded = reader.size();
+    };
+    if (!snapshot_.Take(kRestore)) {
+        SetStatus("Could not read " + kSnapshotPath);
+        return;
+    }
+    if (recorded == 0) {
+        SetStatus("No window layouts to restore.");
+        return;
+    }
+
+    // Restored windows can be matched by the rules again.
+    ruled_windows_.clear();
+    SetStatus("Restored " + std::to_string(restored) + " of " + std::to_string(recorded)
+        + " window layout(s).");
+}
+
+void Console::SetStatus(std::string status) {
+    status_ = std::move(status);
+    loop_.CancelTimer(status_timer_);
+    status_timer_ = loop_.AddTimer(kStatusDuration, [this]() {
+        status_timer_ = 0;
+        status_.clear();
+        render_scheduler_.Invalidate(EventLoop::Clock::now());
+    });
+}
+
+void Console::DumpTrace() {
+    Tracer& tracer = Tracer::Get();
+    if (!tracer.enabled()) {
+        SetStatus("Tracing is off. Set trace=true in the config file.");
+        return;
+    }
+
+    // Probing never resolves executables, so attribute the recorded windows now.
+    for (uint32_t process_id : tracer.UnattributedProcesses()) {
+        tracer.NoteProcess(process_id, process_cache_.GetFileName(window_source_, process_id));
+    }
+
+    const std::string kPath = GetUserDirectory() + "\\fsb-trace.json";
+    if (tracer.WriteChromeTrace(kPath)) {
+        SetStatus("Trace written to " + kPath);
+        tracer.Reset();
+    } else {
+        SetStatus("Could not write " + kPath);
+    }
+}
+
+void Console::OnWindowsChanged(HWND selected_window) {
+    columns_.Build(windows_);
+    if (search_.active()) {
+        RebuildSearchIndex();
+    }
+    RebuildView(selected_window);
+}
+
+void Console::RebuildView(HWND selected_window) {
+    Bitset filter = columns_.All();
+    if (hide_minimized_) {
+        Bitset minimized = columns_.MatchState(WindowState::Minimized);
+        minimized.Flip();
+        filter &= minimized;
+    }
 
-    std::string title;
-    if (title_buffer[0] == L'\0') {
-        title = "";
+    // While searching the rows are listed by relevance instead of by the sort key.
+    if (search_.active()) {
+        view_rows_.clear();
+        for (uint32_t row : search_.results()) {
+            if (filter.Test(row)) {
+                view_rows_.push_back(row);
+            }
+        }
     } else {
-        title = Utf16ToUtf8(title_buffer);
+        columns_.SortIndex(sort_key_, filter, &view_rows_);
     }
 
-    std::string class_name = Utf16ToUtf8(class_buffer);
-    std::string file_name = GetProcessFileName(process_id);
+    window_list_.SetItemCount(static_cast<int>(view_rows_.size()));
+    if (selected_window == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < view_rows_.size(); ++i) {
+        if (columns_.handle(view_rows_[i]) == selected_window) {
+            window_list_.Select(static_cast<int>(i));
+            break;
+        }
+    }
+}
 
-    ProcessData process_data = {};
-    process_data.attributes_ = window_attributes;
-    process_data.class_name_ = class_name;
-    process_data.file_name_ = file_name;
-    process_data.metrics_ = window_metrics;
-    process_data.process_id_ = process_id;
-    process_data.title_ = title;
-    process_data.window_handle_ = window_handle;
+void Console::RebuildSearchIndex() {
+    // Executable paths come from the process cache, so this costs one lookup per process rather
+    // than a full detail load per window.
+    std::vector<std::string_view> file_names(windows_.size());
+    probe_pool_.ParallelFor(windows_.size(), [this, &file_names](size_t i) {
+        const ProcessData& window = windows_[i];
+        file_names[i] = window.has_details_ ? window.details_.file_name_
+            : process_cache_.GetFileName(window_source_, window.process_id_);
+    });
+
+    const std::string kQuery(search_.query());
+    search_.Build(windows_, file_names);
+    search_.SetQuery(kQuery);
+}
 
-    console->windows_.push_back(process_data);
+bool Console::DispatchSearchKey(int key, ProcessData* process_data) {
+    const HWND kSelected = process_data != nullptr ? process_data->window_handle_ : nullptr;
+    switch (key) {
+        case VK_ESCAPE:
+            searching_ = false;
+            search_.Clear();
+            RebuildView(kSelected);
+            return true;
+        case VK_RETURN:
+            // Keep the results and let the menu select the highlighted window.
+            searching_ = false;
+            return false;
+        case VK_BACK:
+            search_.Pop();
+            RebuildView(kSelected);
+            return true;
+    }
 
-    return 1;
+    if (key < 0x20 || key == 0x7F || (key & kExtendedKey) != 0) {
+        return false;
+    }
+    search_.Push(static_cast<char>(key));
+    RebuildView(nullptr);
+    // The best match is listed first.
+    window_list_.Home();
+    return true;
 }
 
-void Console::RefreshWindows() {
-    windows_.clear();
-    EnumWindows(EnumWindowsCallback, reinterpret_cast<LPARAM>(this));
+ProcessData* Console::SelectedWindow() {
+    if (view_rows_.empty()) {
+        return nullptr;
+    }
+    return &windows_[view_rows_[window_list_.selection()]];
 }
 
-void Console::DispatchKeyPress(char key, ProcessData* process_data) {
-    UNREFERENCED_PARAMETER(process_data);
+void Console::PrefetchDetails(int index) {
+    // Rows right next to the highlighted one are the most likely to be selected next.
+    const int kFirst = std::max(0, index - config_.prefetch_radius_);
+    const int kLast = std::min(static_cast<int>(view_rows_.size()) - 1,
+        index + config_.prefetch_radius_);
+    std::vector<std::pair<HWND, uint32_t>> batch;
+    for (int i = kFirst; i <= kLast; ++i) {
+        const ProcessData& window = windows_[view_rows_[i]];
+        // Stale details are asked for again once the window may answer.
+        if (!window.has_details_ || window.details_.font_stale_) {
+            batch.push_back({window.window_handle_, window.process_id_});
+        }
+    }
+    detail_loader_.Prefetch(batch);
+}
+
+void Console::DispatchKeyPress(int key, ProcessData* process_data) {
+    status_.clear();
+
+    if (showing_errors_) {
+        if (key == VK_ESCAPE || toupper(key) == 'L') {
+            showing_errors_ = false;
+        } else if (toupper(key) == 'Q') {
+            loop_.Quit();
+        }
+        return;
+    }
+
+    switch (key) {
+        case kKeyUp:
+            window_list_.MoveBy(-1);
+            return;
+        case kKeyDown:
+            window_list_.MoveBy(1);
+            return;
+        case kKeyPageUp:
+            window_list_.PageUp();
+            return;
+        case kKeyPageDown:
+            window_list_.PageDown();
+            return;
+        case kKeyHome:
+            window_list_.Home();
+            return;
+        case kKeyEnd:
+            window_list_.End();
+            return;
+    }
+
+    if (searching_ && DispatchSearchKey(key, process_data)) {
+        return;
+    }
+
     switch (toupper(key)) {
         case VK_ESCAPE:
         case 'Q':
-            std::exit(0);
+            loop_.Quit();
             break;
         case 'R':
-            RefreshWindows();
+            UpdateWindows();
             break;
+        case 'S': {
+            // Cycle Z-order -> PID -> class -> title.
+            const HWND kSelected = process_data != nullptr ? process_data->window_handle_ : nullptr;
+            sort_key_ = static_cast<WindowColumns::SortKey>(
+                (static_cast<int>(sort_key_) + 1) % kSortKeyCount);
+            RebuildView(kSelected);
+            break;
+        }
+        case '/':
+            searching_ = true;
+            // An active query keeps its index up to date already.
+            if (!search_.active()) {
+                RebuildSearchIndex();
+            }
+            break;
+        case 'T':
+            DumpTrace();
+            break;
+        case 'L':
+            showing_errors_ = true;
+            break;
+        case 'U':
+            RestoreWindows();
+            break;
+        case 'A': {
+            // Applies the rules to every listed window at once, e.g. to a whole workspace.
+            std::vector<HWND> window_handles;
+            window_handles.reserve(windows_.size());
+            for (const ProcessData& window : windows_) {
+                window_handles.push_back(window.window_handle_);
+            }
+            ApplyRules(window_handles);
+            break;
+        }
+        case 'M': {
+            const HWND kSelected = process_data != nullptr ? process_data->window_handle_ : nullptr;
+            hide_minimized_ = !hide_minimized_;
+            RebuildView(kSelected);
+            break;
+        }
         case VK_RETURN:
+            // Selecting a window is the point where its details are actually needed.
+            if (process_data != nullptr) {
+                detail_loader_.Fill(process_data);
+            }
             menu_section_ = true;
             break;
     }
 }
 
+void Console::DrawMenu() {
+    ScreenBuffer& screen = renderer_.back_buffer();
+    screen.Clear();
+
+    if (showing_errors_) {
+        DrawErrorLog();
+        return;
+    }
+
+    window_list_.SetViewportHeight(std::max(screen.height() - kFooterRows, 0));
+
+    // Only the rows inside the viewport are formatted, so the cost of a frame depends on the
+    // height of the console rather than on the number of windows.
+    for (int i = window_list_.first_visible(); i < window_list_.end_visible(); ++i) {
+        const ProcessData& window = windows_[view_rows_[i]];
+        const int kRow = i - window_list_.first_visible();
+        const CellAttribute kAttribute = i == window_list_.selection() ? CellAttribute::Highlight
+            : CellAttribute::Normal;
+
+        int x = screen.Put(0, kRow, window.title_, kAttribute);
+        x = screen.Put(x, kRow, " [", kAttribute);
+        x = screen.Put(x, kRow, window.class_name_, kAttribute);
+        x = screen.Put(x, kRow, "] (", kAttribute);
+        x = screen.Put(x, kRow, std::to_string(window.process_id_), kAttribute);
+        static_cast<void>(screen.Put(x, kRow, ")", kAttribute));
+        screen.SetRowAttribute(kRow, kAttribute);
+    }
+
+    const int kRulerRow = screen.height() - kFooterRows;
+    screen.Fill(0, kRulerRow, screen.width(), U'=', CellAttribute::Normal);
+
+    // Only show details that are already loaded so painting never waits on another process.
+    ProcessData* selected = SelectedWindow();
+    if (selected != nullptr) {
+        if (!selected->has_details_ || selected->details_.font_stale_) {
+            selected->has_details_ = detail_loader_.TryGet(selected->window_handle_,
+                &selected->details_) || selected->has_details_;
+        }
+        const int kX = screen.Put(0, kRulerRow + 1,
+            selected->has_details_ ? selected->details_.file_name_ : "Loading...",
+            CellAttribute::Dim);
+        if (selected->has_details_ && selected->details_.font_stale_) {
+            static_cast<void>(screen.Put(kX, kRulerRow + 1, "  (not responding)",
+                CellAttribute::Dim));
+        }
+    }
+
+    if (!status_.empty()) {
+        static_cast<void>(screen.Put(0, kRulerRow + 2, status_, CellAttribute::Dim));
+    } else if (searching_ || search_.active()) {
+        const int kX = screen.Put(0, kRulerRow + 2, "/", CellAttribute::Normal);
+        static_cast<void>(screen.Put(kX, kRulerRow + 2, search_.query(),
+            searching_ ? CellAttribute::Highlight : CellAttribute::Normal));
+    } else if (enumerating_) {
+        static_cast<void>(screen.Put(0, kRulerRow + 2,
+            "Loading windows... (" + std::to_string(windows_.size()) + " so far)",
+            CellAttribute::Dim));
+    } else {
+        static_cast<void>(screen.Put(0, kRulerRow + 2, "Controls go here.",
+            CellAttribute::Normal));
+    }
+}
+
+void Console::DrawErrorLog() {
+    ScreenBuffer& screen = renderer_.back_buffer();
+    ErrorLog& log = ErrorLog::Get();
+
+    // Newest at the bottom, like a terminal. Only what fits is formatted.
+    const int kRows = std::max(screen.height() - kFooterRows, 0);
+    const size_t kShown = std::min(error_history_.size(), static_cast<size_t>(kRows));
+    std::string line;
+    for (size_t i = 0; i < kShown; ++i) {
+        line.clear();
+        log.Format(error_history_[error_history_.size() - kShown + i], &line);
+        static_cast<void>(screen.Put(0, static_cast<int>(i), line, CellAttribute::Normal));
+    }
+
+    const int kRulerRow = screen.height() - kFooterRows;
+    screen.Fill(0, kRulerRow, screen.width(), U'=', CellAttribute::Normal);
+    std::string summary = std::to_string(error_history_.size()) + " error(s) recorded";
+    if (log.dropped() != 0) {
+        summary += ", " + std::to_string(log.dropped()) + " lost while the log was full";
+    }
+    static_cast<void>(screen.Put(0, kRulerRow + 1, summary, CellAttribute::Dim));
+    static_cast<void>(screen.Put(0, kRulerRow + 2, "L or Esc to go back.",
+        CellAttribute::Normal));
+}
+
 void Console::ShowMenu() {
     HANDLE console_handle = GetStdHandle(STD_OUTPUT_HANDLE);
     if (console_handle == INVALID_HANDLE_VALUE) {
@@ -365,59 +868,95 @@ void Console::ShowMenu() {
         WIN32_FAILFAST(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode);
     }
 
-    RefreshWindows();
-
-    while (true) {
-        assert(!windows_.empty());
-        bool cursor_result = SetConsoleCursorPosition(console_handle,
-            {0, 0});
-        assert(cursor_result);
+    // Anything still buffered in the C++ streams must reach the console before the first frame.
+    std::cout << std::flush;
+    ConsoleSink sink(console_handle);
+
+    // The empty menu goes on screen before anything slow runs, and the list fills in behind it.
+    enumerating_ = true;
+    Paint(console_handle, sink);
+    StartupProfiler::Get().Mark("first paint");
+
+    // Installed before enumerating, so no window that changes in the meantime is missed.
+    static_cast<void>(window_event_hook_.Install());
+    // Monitor layouts are cached, and this is what tells the cache that the displays changed.
+    const bool kListening = Win32DisplayTopology::Get().ListenForChanges();
+    if (window_event_hook_.installed() || kListening) {
+        waiter_.WatchMessages();
+        loop_.SetHandler(EventSource::WindowMessages, [this]() { OnWindowMessages(); });
+    }
+    if (!window_event_hook_.installed()) {
+        // Without the hook every refresh falls back to a full enumeration.
+        static_cast<void>(loop_.AddTimer(kPollInterval, [this]() {
+            UpdateWindows();
+            render_scheduler_.Invalidate(EventLoop::Clock::now());
+        }, kPollInterval));
+    }
+    StartEnumeration();
+    loop_.Post([this]() { DeferredSetup(); });
 
-        for (size_t i = 0; i < windows_.size(); ++i) {
-            assert(index_section_0_ < windows_.size());
-            if (i == index_section_0_) {
-                std::cout << colors::grey << colors::on_white;
-            } else {
-                std::cout << colors::reset;
-            }
+    loop_.SetIdleHandler([this, console_handle, &sink]() { Paint(console_handle, sink); });
+    loop_.Run();
+}
 
-            std::cout << windows_[i].title_ << " [" << windows_[i].class_name_ << "] (" \
-                      << windows_[i].process_id_ << ")\n";
-            std::cout << colors::reset;
+void Console::Paint(HANDLE console_handle, TerminalSink& sink) {
+    // Probes record failures from any thread. Reading them here keeps the ring from filling up
+    // and the log view current.
+    if (ErrorLog::Get().Drain(&error_history_) != 0) {
+        if (error_history_.size() > kErrorHistory) {
+            error_history_.erase(error_history_.begin(),
+                error_history_.end() - static_cast<ptrdiff_t>(kErrorHistory));
         }
-
-        CONSOLE_SCREEN_BUFFER_INFO info;
-        if (!GetConsoleScreenBufferInfo(console_handle, &info)) {
-            constexpr std::string_view kActionDescription = "get the console screen buffer.";
-            constexpr std::string_view kQualifiedName = "console.cc::fsb::Console::ShowMenu";
-            constexpr std::string_view kExportedOperationName =
-                "Kernel32.dll!GetConsoleScreenBufferInfo";
-            constexpr int kReturnCode = 0;
-            WIN32_ERROR(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode);
-            std::exit(FSB_INVALID_HANDLE);
+        if (showing_errors_) {
+            render_scheduler_.Invalidate(EventLoop::Clock::now());
         }
-
-        int width = info.srWindow.Right \
-            - info.srWindow.Left + 1;
-        int height = info.srWindow.Bottom \
-            - info.srWindow.Top + 1;
-        int cursor_y = info.dwCursorPosition.Y \
-            + info.srWindow.Top;
-
-        int lines_needed = (height - 6) - cursor_y;
-
-        for (int i = 0; i < lines_needed; ++i) {
-            std::cout << "\n";
+    }
+    // However many changes came in, they are painted as one frame, at most once per frame.
+    EventLoop::Clock::duration wait;
+    if (!render_scheduler_.ShouldPaint(EventLoop::Clock::now(), &wait)) {
+        if (render_scheduler_.dirty() && frame_timer_ == 0) {
+            // Only wakes the loop, which paints on its way back to sleep.
+            frame_timer_ = loop_.AddTimer(wait, [this]() { frame_timer_ = 0; });
         }
-
-        std::string row(width, '=');
-        std::cout << row;
-        std::cout << "Controls go here.";
-
-        DispatchKeyPress(static_cast<char>(_getch()), &windows_[index_section_0_]);
+        return;
+    }
+    render_scheduler_.BeginFrame(EventLoop::Clock::now());
+
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (!GetConsoleScreenBufferInfo(console_handle, &info)) {
+        constexpr std::string_view kActionDescription = "get the console screen buffer.";
+        constexpr std::string_view kQualifiedName = "console.cc::fsb::Console::Paint";
+        constexpr std::string_view kExportedOperationName =
+            "Kernel32.dll!GetConsoleScreenBufferInfo";
+        constexpr int kReturnCode = 0;
+        WIN32_ERROR(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode);
+        std::exit(FSB_INVALID_HANDLE);
     }
 
+    const int kWidth = info.srWindow.Right - info.srWindow.Left + 1;
+    const int kHeight = info.srWindow.Bottom - info.srWindow.Top + 1;
+    renderer_.Resize(kWidth, kHeight);
+
+    DrawMenu();
+    static_cast<void>(renderer_.Present(sink));
+    render_scheduler_.EndFrame(EventLoop::Clock::now());
+
+    if (!interactive_ && !enumerating_ && enumeration_generation_ != 0) {
+        interactive_ = true;
+        StartupProfiler& profiler = StartupProfiler::Get();
+        const uint64_t kInteractive = profiler.Mark("interactive");
+        if (profiler.enabled()) {
+            char status[96];
+            static_cast<void>(std::snprintf(status, sizeof(status),
+                "First paint %.1f ms, interactive %.1f ms",
+                static_cast<double>(profiler.Elapsed("first paint")) / 1e6,
+                static_cast<double>(kInteractive) / 1e6));
+            SetStatus(status);
+            render_scheduler_.Invalidate(EventLoop::Clock::now());
+        }
+    }
 
+    PrefetchDetails(window_list_.selection());
 }
 
 } // namespace fsb
\ No newline at end of file
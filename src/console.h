@@ -7,36 +7,170 @@
 
 #include "base_types.h"
 #include "config.h"
+#include "config_watcher.h"
+#include "detail_loader.h"
+#include "error_log.h"
+#include "event_loop.h"
+#include "frame_renderer.h"
+#include "layout_snapshot.h"
+#include "list_view.h"
+#include "probe_pool.h"
+#include "process_cache.h"
+#include "render_scheduler.h"
+#include "rule_engine.h"
+#include "string_pool.h"
+#include "win32_event_waiter.h"
+#include "win32_geometry_backend.h"
+#include "window_columns.h"
+#include "window_event_hook.h"
+#include "window_health.h"
+#include "window_search.h"
+#include "window_source.h"
+#include "window_table.h"
 
 #include <Windows.h>
-#include <conio.h>
+#include <cstdint>
+#include <string>
 #include <string_view>
+#include <unordered_set>
 #include <vector>
 
 namespace fsb {
+//! Flag set on key codes of keys that do not produce a character (arrows, paging keys, etc.), so
+//! they never collide with typed characters.
+constexpr int kExtendedKey = 0x100;
+constexpr int kKeyUp = kExtendedKey | 72;
+constexpr int kKeyDown = kExtendedKey | 80;
+constexpr int kKeyPageUp = kExtendedKey | 73;
+constexpr int kKeyPageDown = kExtendedKey | 81;
+constexpr int kKeyHome = kExtendedKey | 71;
+constexpr int kKeyEnd = kExtendedKey | 79;
+
 class Console {
 public:
-    Console(const Config& config);
+    //! @param window_source Where windows are enumerated and probed. Must outlive the console.
+    //! Must be the live desktop, as its handles go to the window hook and the geometry backend.
+    Console(const Config& config, WindowSource& window_source);
     ~Console();
 
     void ShowMenu();
+    //! @brief Frames painted, coalesced and dropped so far.
+    const RenderStats& render_stats() const { return render_scheduler_.stats(); }
 private:
-    static bool GetWindowAttributes(HWND window_handle, WindowAttributes* window_attributes);
-    static bool GetWindowMetrics(HWND window_handle, WindowMetrics* window_metrics);
-    static std::string GetProcessFileName(uint32_t process_id);
     void ClearConsole();
-    static int EnumWindowsCallback(HWND window_handle, LPARAM message_param);
+    //! @brief Setup the first frame does not need, run once it is on screen.
+    void DeferredSetup();
+    //! @brief Starts enumerating on the pool. The list fills in batch by batch as windows are
+    //! probed, while the menu stays responsive.
+    void StartEnumeration();
+    //! @brief Adds a batch of a streamed enumeration. Batches of a superseded one are dropped.
+    void AppendWindows(std::vector<ProcessData> batch, bool done, uint32_t generation);
+    //! @brief Enumerates every window and replaces the list in one go.
     void RefreshWindows();
-    void DispatchKeyPress(char key, ProcessData* process_data);
+    void UpdateWindows();
+    //! @brief Applies the collected window events once no more arrive for a moment.
+    void ScheduleUpdate();
+    //! @brief Switches to a reloaded config, re-enumerating only if a filter was relaxed.
+    void ApplyConfig(const Config& config);
+    //! @brief Reads every pending console input record and dispatches the key presses.
+    void ReadInput();
+    //! @brief Collects window events, applying them once a burst of them settles.
+    void OnWindowMessages();
+    void OnConfigChanged();
+    //! @brief Reloads the auto-apply rules if the rules file changed.
+    void LoadRules();
+    //! @brief Makes the windows that match a rule borderless in one batch, once per window.
+    void ApplyRules(const std::vector<HWND>& window_handles);
+    //! @brief Puts back every window in the layout snapshot, including those the daemon recorded,
+    //! and empties it.
+    void RestoreWindows();
+    //! @brief Shows a message on the controls line for a few seconds.
+    void SetStatus(std::string status);
+    //! @brief Draws and presents a frame if anything changed since the last one.
+    void Paint(HANDLE console_handle, TerminalSink& sink);
+    //! @brief Writes the recorded enumeration timings next to the config file and starts over.
+    void DumpTrace();
+    //! @brief Re-indexes windows_ after rows were added, removed or re-probed, then rebuilds the
+    //! view.
+    void OnWindowsChanged(HWND selected_window);
+    //! @brief Re-filters and re-sorts the list, keeping selected_window selected if still listed.
+    //! Only reads the columns, so searching and sorting never copy the table again.
+    void RebuildView(HWND selected_window);
+    //! @brief Re-indexes windows_ for searching and re-runs the current query.
+    void RebuildSearchIndex();
+    //! @brief Handles a key typed while the search line has focus. Returns false if the key is
+    //! not a search key.
+    bool DispatchSearchKey(int key, ProcessData* process_data);
+    //! @brief Returns the highlighted window, or nullptr if the list is empty.
+    ProcessData* SelectedWindow();
+    void PrefetchDetails(int index);
+    void DrawMenu();
+    //! @brief Draws the most recent error log records in place of the window list.
+    void DrawErrorLog();
+    void DispatchKeyPress(int key, ProcessData* process_data);
 
     bool clear_console_;
     int refresh_line_;
     bool menu_section_;
-    int index_section_0_;
     int index_section_1_x_;
     int index_section_1_y_;
     Config config_;
-    std::vector<ProcessData> windows_;
+    ConfigWatcher config_watcher_;
+    // Declared before the loader and the pool, whose jobs post back to the loop.
+    Win32EventWaiter waiter_;
+    EventLoop loop_;
+    //! Tracks whether something shown on screen changed and when the next frame may be painted.
+    RenderScheduler render_scheduler_;
+    //! Wakes the loop for a frame held back by the frame rate, 0 if none.
+    EventLoop::TimerId frame_timer_;
+    //! Pending application of collected window events, 0 if none.
+    EventLoop::TimerId update_timer_;
+    EventLoop::TimerId status_timer_;
+    WindowSource& window_source_;
+    //! Class names and executable paths, shared by every refresh.
+    StringPool strings_;
+    ProcessCache process_cache_;
+    //! Timeouts and quarantine for windows that do not answer font queries.
+    HealthTracker health_;
+    // Declared before the pool so queued prefetch jobs are finished before the loader goes away.
+    DetailLoader detail_loader_;
+    ProbePool probe_pool_;
+    //! Whether a streamed enumeration is still adding windows. Window events wait until it is
+    //! done, as they would race the batches still to come.
+    bool enumerating_;
+    //! Incremented by every enumeration, to tell the batches of a superseded one apart.
+    uint32_t enumeration_generation_;
+    //! Whether the first frame with a complete list was drawn.
+    bool interactive_;
+    WindowEventHook window_event_hook_;
+    WindowTable windows_;
+    //! Columnar copy of windows_ used to filter and sort the list.
+    WindowColumns columns_;
+    WindowColumns::SortKey sort_key_;
+    bool hide_minimized_;
+    //! Auto-apply rules, see GetRulesPath.
+    RuleMatcher rules_;
+    //! Contents the current rules were parsed from.
+    std::string rules_contents_;
+    //! Windows a rule was applied to, so the user can still restore them by hand afterwards.
+    std::unordered_set<HWND> ruled_windows_;
+    Win32GeometryBackend geometry_;
+    //! Layouts of the windows fsb changed, as they were before, see GetSnapshotPath.
+    SnapshotWriter snapshot_;
+    WindowSearch search_;
+    //! Whether typed characters go to the search query rather than the menu.
+    bool searching_;
+    //! Rows of windows_ in the order they are listed.
+    std::vector<uint32_t> view_rows_;
+    //! Selection and scroll position of the window list (menu section 0).
+    ListView window_list_;
+    FrameRenderer renderer_;
+    //! One-off message shown on the controls line until it expires or the next key press.
+    std::string status_;
+    //! Records drained from the ErrorLog, oldest first, bounded by kErrorHistory.
+    std::vector<ErrorRecord> error_history_;
+    //! Whether the error log is shown instead of the window list.
+    bool showing_errors_;
 };
 } // namespace fsb
 
@@ -0,0 +1,142 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "daemon.h"
+
+#include "error_log.h"
+#include "win32_display_topology.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fsb {
+namespace {
+//! Delay before window events are applied, so a burst of them is applied once.
+constexpr auto kWindowEventDelay = std::chrono::milliseconds(50);
+//! Interval of full enumerations when the WinEvent hook could not be installed.
+constexpr auto kPollInterval = std::chrono::seconds(2);
+//! Interval at which recorded failures are written to stderr.
+constexpr auto kErrorInterval = std::chrono::seconds(1);
+
+void WriteErrors() {
+    std::vector<ErrorRecord> errors;
+    static_cast<void>(ErrorLog::Get().Drain(&errors));
+    std::string message;
+    for (const ErrorRecord& record : errors) {
+        message.clear();
+        ErrorLog::Get().Format(record, &message);
+        std::fprintf(stderr, "%s\n", message.c_str());
+    }
+}
+} // namespace
+
+Daemon* Daemon::instance_ = nullptr;
+
+Daemon::Daemon(const Config& config, WindowSource& window_source)
+    : loop_(waiter_), pool_(static_cast<size_t>(config.probe_threads_)),
+        window_source_(window_source), server_(window_source_, geometry_, pool_),
+        update_timer_(0) {}
+
+int Daemon::Run() {
+    const std::string kAddress = GetDaemonAddress();
+    // Listening first fails fast when another daemon runs, before anything is enumerated.
+    if (!listener_.Listen(kAddress)) {
+        std::fprintf(stderr, "Could not listen on %s. Is another fsb --daemon running?\n",
+            kAddress.c_str());
+        return 1;
+    }
+
+    // Installed before enumerating, so no window that changes in the meantime is missed.
+    static_cast<void>(window_event_hook_.Install());
+    const bool kListening = Win32DisplayTopology::Get().ListenForChanges();
+    if (window_event_hook_.installed() || kListening) {
+        waiter_.WatchMessages();
+        loop_.SetHandler(EventSource::WindowMessages, [this]() { OnWindowMessages(); });
+    }
+    if (!window_event_hook_.installed()) {
+        static_cast<void>(loop_.AddTimer(kPollInterval, [this]() { server_.Refresh(); },
+            kPollInterval));
+    }
+    server_.Refresh();
+    // Probes keep recording failures, which would otherwise only fill up the log.
+    static_cast<void>(loop_.AddTimer(kErrorInterval, WriteErrors, kErrorInterval));
+
+    const std::string kSnapshotPath = GetSnapshotPath();
+    if (!kSnapshotPath.empty() && snapshot_.Open(kSnapshotPath)) {
+        server_.SetSnapshot(&snapshot_);
+    }
+
+    std::thread server_thread([this]() {
+        server_.Serve(listener_, [this]() { loop_.Post([this]() { loop_.Quit(); }); });
+    });
+    instance_ = this;
+    static_cast<void>(SetConsoleCtrlHandler(OnConsoleControl, TRUE));
+    std::fprintf(stderr, "Listening on %s with %zu windows.\n", kAddress.c_str(),
+        server_.size());
+
+    loop_.Run();
+
+    static_cast<void>(SetConsoleCtrlHandler(OnConsoleControl, FALSE));
+    instance_ = nullptr;
+    server_.StopServing();
+    server_thread.join();
+    return 0;
+}
+
+BOOL WINAPI Daemon::OnConsoleControl(DWORD control_type) {
+    if (instance_ == nullptr || (control_type != CTRL_C_EVENT && control_type != CTRL_BREAK_EVENT
+        && control_type != CTRL_CLOSE_EVENT)) {
+        return FALSE;
+    }
+    // Runs on a thread of its own, so the loop is told to stop rather than stopped here.
+    Daemon* daemon = instance_;
+    daemon->loop_.Post([daemon]() { daemon->loop_.Quit(); });
+    return TRUE;
+}
+
+void Daemon::OnWindowMessages() {
+    window_event_hook_.Pump();
+    if (Win32DisplayTopology::Get().TakeChanged()) {
+        std::fprintf(stderr, "Displays changed, the monitor layout was reloaded.\n");
+    }
+    if (!window_event_hook_.has_pending()) {
+        return;
+    }
+
+    // Restart the delay on every event, so a burst is applied once.
+    loop_.CancelTimer(update_timer_);
+    update_timer_ = loop_.AddTimer(kWindowEventDelay, [this]() {
+        update_timer_ = 0;
+        std::vector<WindowEvent> events;
+        window_event_hook_.Drain(&events);
+        server_.Update(events);
+    });
+}
+
+int RunClient(const std::vector<std::string>& request) {
+    IpcChannel channel;
+    if (!channel.Connect(GetDaemonAddress())) {
+        std::fprintf(stderr, "No fsb daemon is running. Start one with fsb --daemon.\n");
+        return 1;
+    }
+
+    std::string response;
+    if (!channel.Send(EncodeServerRequest(request)) || !channel.Receive(&response)
+        || response.empty()) {
+        std::fprintf(stderr, "The fsb daemon went away before answering.\n");
+        return 1;
+    }
+
+    const bool kOk = response[0] == kResponseOk;
+    std::FILE* output = kOk ? stdout : stderr;
+    static_cast<void>(std::fwrite(response.data() + 1, 1, response.size() - 1, output));
+    if (!kOk) {
+        std::fputc('\n', stderr);
+    }
+    return kOk ? 0 : 1;
+}
+} // namespace fsb
@@ -0,0 +1,68 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_DAEMON_H_
+#define FSB_DAEMON_H_
+
+#include "config.h"
+#include "event_loop.h"
+#include "ipc_channel.h"
+#include "layout_snapshot.h"
+#include "probe_pool.h"
+#include "win32_event_waiter.h"
+#include "win32_geometry_backend.h"
+#include "window_event_hook.h"
+#include "window_server.h"
+#include "window_source.h"
+
+#include <Windows.h>
+
+namespace fsb {
+//! @brief Resident server mode (--daemon): keeps the window table warm and answers clients
+//! (--client) over a named pipe, see WindowServer for the requests.
+//!
+//! The loop thread owns the WinEvent hook and feeds its events into the table, while a second
+//! thread accepts clients and answers them from the table, so a request never waits on an
+//! enumeration.
+class Daemon {
+public:
+    //! @param window_source Where windows are enumerated and probed. Must outlive the daemon.
+    //! Must be the live desktop, as its handles go to the window hook and the geometry backend.
+    Daemon(const Config& config, WindowSource& window_source);
+
+    Daemon(const Daemon&) = delete;
+    Daemon& operator=(const Daemon&) = delete;
+
+    //! @brief Serves until a client sends stop or the console is closed.
+    //!
+    //! @returns Returns the exit code, 1 if another daemon is already listening.
+    int Run();
+
+private:
+    static BOOL WINAPI OnConsoleControl(DWORD control_type);
+    void OnWindowMessages();
+
+    Win32EventWaiter waiter_;
+    EventLoop loop_;
+    ProbePool pool_;
+    WindowSource& window_source_;
+    Win32GeometryBackend geometry_;
+    SnapshotWriter snapshot_;
+    WindowServer server_;
+    WindowEventHook window_event_hook_;
+    IpcListener listener_;
+    EventLoop::TimerId update_timer_;
+
+    //! The daemon the console control handler stops, as the handler takes no user data.
+    static Daemon* instance_;
+};
+
+//! @brief Sends one request to the daemon and writes the response to stdout, or to stderr if it
+//! failed.
+//!
+//! @returns Returns the exit code, 1 if the request failed or no daemon is running.
+int RunClient(const std::vector<std::string>& request);
+} // namespace fsb
+
+#endif // #ifndef FSB_DAEMON_H_
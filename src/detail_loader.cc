@@ -0,0 +1,170 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "detail_loader.h"
+
+#include "trace.h"
+
+#include <chrono>
+#include <memory>
+#include <utility>
+
+namespace fsb {
+DetailLoader::DetailLoader(WindowSource& source, ProcessCache& process_cache,
+    HealthTracker& health, ProbePool& pool)
+    : source_(source), process_cache_(process_cache), health_(health), pool_(pool) {}
+
+void DetailLoader::LoadFont(HWND window_handle, uint32_t process_id, WindowDetails* details) {
+    uint32_t timeout = 0;
+    if (health_.ShouldProbe(process_id, &timeout)) {
+        ScopedTrace font_trace(TracePhase::Font, window_handle);
+        const auto kStart = HealthTracker::Clock::now();
+        const ProbeStatus kStatus = source_.GetWindowFont(window_handle, timeout,
+            &details->font_name_, &details->font_size_);
+        health_.Report(process_id, kStatus, HealthTracker::Clock::now() - kStart);
+
+        if (kStatus == ProbeStatus::Ok) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            last_fonts_[window_handle] = {details->font_name_, details->font_size_};
+            return;
+        }
+        if (kStatus == ProbeStatus::Failed) {
+            return;
+        }
+    }
+
+    details->font_stale_ = true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = last_fonts_.find(window_handle);
+    if (it != last_fonts_.end()) {
+        details->font_name_ = it->second.font_name_;
+        details->font_size_ = it->second.font_size_;
+    } else {
+        details->font_name_.clear();
+        details->font_size_ = 0;
+    }
+}
+
+WindowDetails DetailLoader::Compute(HWND window_handle, uint32_t process_id) {
+    Tracer& tracer = Tracer::Get();
+    const uint64_t kStart = tracer.enabled() ? Tracer::Now() : 0;
+
+    WindowDetails details = {};
+    details.file_name_ = process_cache_.GetFileName(source_, process_id);
+    LoadFont(window_handle, process_id, &details);
+
+    if (kStart != 0) {
+        const uint64_t kEnd = Tracer::Now();
+        tracer.RecordPhase(TracePhase::LoadDetails, kStart, kEnd, window_handle);
+        tracer.NoteProcess(process_id, details.file_name_);
+        tracer.RecordWindow(TracePhase::LoadDetails, window_handle, process_id, {},
+            kEnd - kStart);
+    }
+    return details;
+}
+
+bool DetailLoader::Expired(const std::shared_future<WindowDetails>& details,
+    uint32_t process_id) const {
+    return details.wait_for(std::chrono::seconds(0)) == std::future_status::ready
+        && details.get().font_stale_ && !health_.IsQuarantined(process_id);
+}
+
+WindowDetails DetailLoader::Load(HWND window_handle, uint32_t process_id) {
+    std::shared_future<WindowDetails> pending;
+    std::promise<WindowDetails> promise;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = details_.find(window_handle);
+        if (it != details_.end() && !Expired(it->second, process_id)) {
+            pending = it->second;
+        } else {
+            details_[window_handle] = promise.get_future().share();
+        }
+    }
+    if (pending.valid()) {
+        return pending.get();
+    }
+
+    WindowDetails details = Compute(window_handle, process_id);
+    promise.set_value(details);
+    return details;
+}
+
+bool DetailLoader::TryGet(HWND window_handle, WindowDetails* details) {
+    std::shared_future<WindowDetails> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = details_.find(window_handle);
+        if (it == details_.end()) {
+            return false;
+        }
+        pending = it->second;
+    }
+    if (pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return false;
+    }
+
+    *details = pending.get();
+    return true;
+}
+
+void DetailLoader::Prefetch(const std::vector<std::pair<HWND, uint32_t>>& windows) {
+    struct PendingLoad {
+        HWND window_handle_;
+        uint32_t process_id_;
+        std::shared_ptr<std::promise<WindowDetails>> promise_;
+    };
+
+    std::vector<PendingLoad> loads;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [window_handle, process_id] : windows) {
+            auto it = details_.find(window_handle);
+            if (it != details_.end() && !Expired(it->second, process_id)) {
+                continue;
+            }
+            auto promise = std::make_shared<std::promise<WindowDetails>>();
+            details_[window_handle] = promise->get_future().share();
+            loads.push_back({window_handle, process_id, std::move(promise)});
+        }
+    }
+    if (loads.empty()) {
+        return;
+    }
+
+    // Each batch gets its own timeout budget, so paging through hung windows stays responsive.
+    health_.BeginRound();
+    for (PendingLoad& load : loads) {
+        pool_.Submit([this, load = std::move(load)]() {
+            load.promise_->set_value(Compute(load.window_handle_, load.process_id_));
+            if (ready_callback_) {
+                ready_callback_(load.window_handle_);
+            }
+        });
+    }
+}
+
+void DetailLoader::SetReadyCallback(std::function<void(HWND)> callback) {
+    ready_callback_ = std::move(callback);
+}
+
+void DetailLoader::Fill(ProcessData* process_data) {
+    if (process_data->has_details_ && !process_data->details_.font_stale_) {
+        return;
+    }
+    process_data->details_ = Load(process_data->window_handle_, process_data->process_id_);
+    process_data->has_details_ = true;
+}
+
+void DetailLoader::Forget(HWND window_handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    details_.erase(window_handle);
+    last_fonts_.erase(window_handle);
+}
+
+void DetailLoader::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    details_.clear();
+}
+} // namespace fsb
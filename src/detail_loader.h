@@ -0,0 +1,91 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_DETAIL_LOADER_H_
+#define FSB_DETAIL_LOADER_H_
+
+#include "base_types.h"
+#include "probe_pool.h"
+#include "process_cache.h"
+#include "window_health.h"
+#include "window_source.h"
+
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fsb {
+//! @brief Computes the expensive tier of window data (WindowDetails) on demand.
+//!
+//! Enumeration only fills the cheap fields of ProcessData. The details of a window are loaded the
+//! first time they are needed, either synchronously through Load, or speculatively on the probe
+//! pool through Prefetch so they are usually ready by the time the user moves onto the row.
+//!
+//! Font queries go through a HealthTracker. When it skips a window, or the window does not answer,
+//! the last font the window reported is used instead and marked as stale. Stale details are only
+//! kept until the process is out of quarantine; the next Load or Prefetch asks the window again.
+class DetailLoader {
+public:
+    //! @note The pool must outlive every prefetch job, so it has to be destroyed before the loader.
+    DetailLoader(WindowSource& source, ProcessCache& process_cache, HealthTracker& health,
+        ProbePool& pool);
+
+    //! @brief Returns the details of a window, loading them on the calling thread if no prefetch
+    //! has been started, or waiting for the prefetch if one is in flight.
+    WindowDetails Load(HWND window_handle, uint32_t process_id);
+
+    //! @brief Returns the details of a window if they are already loaded, without blocking.
+    bool TryGet(HWND window_handle, WindowDetails* details);
+
+    //! @brief Starts loading the details of a batch of windows in the background, skipping those
+    //! that are loaded or in flight already.
+    //!
+    //! A batch that starts any load also starts a HealthTracker round, so the windows of one batch
+    //! share one timeout budget.
+    void Prefetch(const std::vector<std::pair<HWND, uint32_t>>& windows);
+
+    //! @brief Sets a callback run on the worker thread each time a prefetch finishes.
+    //!
+    //! @note Must be set before the first prefetch, as workers read it without locking.
+    void SetReadyCallback(std::function<void(HWND)> callback);
+
+    //! @brief Loads the details straight into a ProcessData entry if it does not have them yet.
+    void Fill(ProcessData* process_data);
+
+    //! @brief Forgets the details of a single window, e.g. once it has been destroyed.
+    void Forget(HWND window_handle);
+
+    //! @brief Forgets every loaded detail, e.g. after the window list has been refreshed.
+    //!
+    //! The last known fonts are kept, as they are only used when a window stops answering.
+    void Clear();
+
+private:
+    struct CachedFont {
+        std::string font_name_;
+        uint32_t font_size_;
+    };
+
+    WindowDetails Compute(HWND window_handle, uint32_t process_id);
+    //! Whether a cached result is stale and its process may be asked again. Expects mutex_.
+    bool Expired(const std::shared_future<WindowDetails>& details, uint32_t process_id) const;
+    //! Fills the font of details, from the window itself or from last_fonts_.
+    void LoadFont(HWND window_handle, uint32_t process_id, WindowDetails* details);
+
+    WindowSource& source_;
+    ProcessCache& process_cache_;
+    HealthTracker& health_;
+    ProbePool& pool_;
+    std::function<void(HWND)> ready_callback_;
+    std::mutex mutex_;
+    std::unordered_map<HWND, std::shared_future<WindowDetails>> details_;
+    std::unordered_map<HWND, CachedFont> last_fonts_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_DETAIL_LOADER_H_
@@ -6,9 +6,11 @@
 #define FSB_ERROR_H_
 
 #include "base_types.h"
+#include "error_log.h"
 #include "fsb_string.h"
 
 #include <Windows.h>
+#include <iostream>
 #include <sstream>
 #include <string>
 
@@ -63,6 +65,29 @@ inline void Win32Error(std::string_view actionDescription, int line,
     std::cerr << oss.str();
 }
 
+//! @brief Returns the system message of a Win32 error code, without the trailing line break.
+//!
+//! Meant for ErrorLog::SetDescriber, which formats each code once.
+inline std::string FormatWin32Message(uint32_t code) {
+    wchar_t* buffer = nullptr;
+    const DWORD kLength = FormatMessageW(
+        FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM |
+        FORMAT_MESSAGE_IGNORE_INSERTS,
+        nullptr, code, 0, reinterpret_cast<wchar_t*>(&buffer), 0, nullptr);
+    if (kLength == 0 || buffer == nullptr) {
+        return {};
+    }
+
+    std::wstring_view message(buffer, kLength);
+    while (!message.empty() && (message.back() == L'\r' || message.back() == L'\n'
+        || message.back() == L' ')) {
+        message.remove_suffix(1);
+    }
+    std::string description = Utf16ToUtf8(message);
+    LocalFree(buffer);
+    return description;
+}
+
 inline void FailfastWin32(std::string_view action_description, int line,
     std::string_view qualified_name, std::string_view exported_operation_name,
     int32_t return_code) {
@@ -94,7 +119,9 @@ inline void DumpProcessData(const ProcessData& process_data) {
     std::cout << "Debug process data dump\n";
     std::cout << "Title: " << process_data.title_ << "\n";
     std::cout << "Class Name: " << process_data.class_name_ << "\n";
-    std::cout << "File Name: " << process_data.file_name_ << "\n";
+    if (process_data.has_details_) {
+        std::cout << "File Name: " << process_data.details_.file_name_ << "\n";
+    }
     std::cout << "Process ID: " << process_data.process_id_ << "\n";
     std::cout << "Window Handle: " << process_data.window_handle_ << "\n";
 
@@ -115,10 +142,14 @@ inline void DumpProcessData(const ProcessData& process_data) {
               << ", " << process_data.metrics_.position_.y << ")\n";
     std::cout << "  Size: (" << process_data.metrics_.size_.x
               << ", " << process_data.metrics_.size_.y << ")\n";
-    std::cout << "  Font Name: " << process_data.metrics_.font_name_ << "\n";
-    std::cout << "  Font Size: " << process_data.metrics_.font_size_ << "\n";
     std::cout << "  Style: 0x" << std::hex << process_data.metrics_.style_ << std::dec << "\n";
     std::cout << "  ExStyle: 0x" << std::hex << process_data.metrics_.ex_style_ << std::dec << "\n";
+
+    if (process_data.has_details_) {
+        std::cout << "Window Details:\n";
+        std::cout << "  Font Name: " << process_data.details_.font_name_ << "\n";
+        std::cout << "  Font Size: " << process_data.details_.font_size_ << "\n";
+    }
     std::cout << "\n";
 }
 } // namespace fsb
@@ -129,6 +160,18 @@ inline void DumpProcessData(const ProcessData& process_data) {
 #define WIN32_FAILFAST(action_description, qualified_name, exported_operation_name, return_code) \
     fsb::FailfastWin32(action_description, __LINE__, qualified_name, exported_operation_name, \
                         return_code)
+// Records a failure in the ErrorLog instead of writing it out, for paths that run once per
+// window or from the workers. Same arguments as WIN32_ERROR, plus the window and process the
+// failure was about (nullptr and 0 if none).
+#define WIN32_LOG(action_description, qualified_name, exported_operation_name, return_code, \
+        window_handle, process_id) \
+    do { \
+        const DWORD kFsbLastError = GetLastError(); \
+        static fsb::ErrorSite fsb_error_site(action_description, qualified_name, \
+            exported_operation_name); \
+        static_cast<void>(fsb::ErrorLog::Get().Record(fsb_error_site, kFsbLastError, \
+            static_cast<int32_t>(return_code), window_handle, process_id)); \
+    } while (false)
 #define STL_ERROR(action_description, qualified_name, exported_operation_name, return_code) \
     fsb::StlError(action_description __LINE__, qualified_name, exported_operation_name, \
                    return_code)
@@ -0,0 +1,148 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "error_log.h"
+
+#include "trace.h"
+
+#include <cstdio>
+
+namespace fsb {
+static_assert((ErrorLog::kCapacity & (ErrorLog::kCapacity - 1)) == 0,
+    "The ring capacity must be a power of two.");
+
+ErrorLog::ErrorLog()
+    : origin_(Tracer::Now()),
+      enqueue_position_(0),
+      dequeue_position_(0),
+      dropped_(0),
+      describer_(nullptr) {
+    for (size_t i = 0; i < kCapacity; ++i) {
+        cells_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+}
+
+ErrorLog& ErrorLog::Get() {
+    static ErrorLog log;
+    return log;
+}
+
+bool ErrorLog::Record(ErrorSite& site, uint32_t code, int32_t return_code, HWND window_handle,
+    uint32_t process_id) noexcept {
+    const uint64_t kNow = Tracer::Now() - origin_;
+
+    // Whoever moves the site into a new window restarts its count. Racing records may land in
+    // either window, which only makes the limit approximate.
+    const uint64_t kWindow = kNow / kRateWindow;
+    uint64_t window = site.window_.load(std::memory_order_relaxed);
+    if (window != kWindow
+        && site.window_.compare_exchange_strong(window, kWindow, std::memory_order_relaxed)) {
+        site.window_count_.store(0, std::memory_order_relaxed);
+    }
+    if (site.window_count_.fetch_add(1, std::memory_order_relaxed) >= kMaxPerWindow) {
+        site.suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    for (;;) {
+        cell = &cells_[position & (kCapacity - 1)];
+        const size_t kSequence = cell->sequence_.load(std::memory_order_acquire);
+        const auto kDifference = static_cast<intptr_t>(kSequence) - static_cast<intptr_t>(position);
+        if (kDifference == 0) {
+            if (enqueue_position_.compare_exchange_weak(position, position + 1,
+                    std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (kDifference < 0) {
+            // Full. Nobody has read the log in a while, so the oldest records are the ones kept.
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = enqueue_position_.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->record_ = {&site, kNow, window_handle, process_id, code, return_code,
+        site.suppressed_.exchange(0, std::memory_order_relaxed)};
+    cell->sequence_.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+size_t ErrorLog::Drain(std::vector<ErrorRecord>* records) {
+    size_t count = 0;
+    size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = cells_[position & (kCapacity - 1)];
+        const size_t kSequence = cell.sequence_.load(std::memory_order_acquire);
+        const auto kDifference = static_cast<intptr_t>(kSequence)
+            - static_cast<intptr_t>(position + 1);
+        if (kDifference == 0) {
+            if (dequeue_position_.compare_exchange_weak(position, position + 1,
+                    std::memory_order_relaxed)) {
+                records->push_back(cell.record_);
+                cell.sequence_.store(position + kCapacity, std::memory_order_release);
+                ++position;
+                ++count;
+            }
+        } else if (kDifference < 0) {
+            // Empty, or the next record is still being written.
+            return count;
+        } else {
+            position = dequeue_position_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void ErrorLog::SetDescriber(Describer describer) {
+    std::lock_guard<std::mutex> lock(describe_mutex_);
+    describer_ = describer;
+    descriptions_.clear();
+}
+
+std::string ErrorLog::Describe(uint32_t code) {
+    std::lock_guard<std::mutex> lock(describe_mutex_);
+    auto [it, inserted] = descriptions_.try_emplace(code);
+    if (inserted) {
+        if (describer_ != nullptr) {
+            it->second = describer_(code);
+        }
+        if (it->second.empty()) {
+            it->second = "Error " + std::to_string(code) + ".";
+        }
+    }
+    return it->second;
+}
+
+void ErrorLog::Format(const ErrorRecord& record, std::string* out) {
+    char prefix[48];
+    const int kLength = std::snprintf(prefix, sizeof(prefix), "%10.3f ",
+        static_cast<double>(record.time_) / 1e9);
+    out->append(prefix, static_cast<size_t>(kLength));
+    out->append("Failed to ");
+    out->append(record.site_->action_description_);
+    out->append(" ");
+    out->append(record.site_->exported_operation_name_);
+    out->append(" returned ");
+    out->append(std::to_string(record.return_code_));
+    out->append(": ");
+    out->append(Describe(record.code_));
+
+    if (record.window_handle_ != nullptr || record.process_id_ != 0) {
+        char context[64];
+        const int kContextLength = std::snprintf(context, sizeof(context),
+            " (window %p, process %u)", static_cast<void*>(record.window_handle_),
+            record.process_id_);
+        out->append(context, static_cast<size_t>(kContextLength));
+    }
+    if (record.suppressed_ != 0) {
+        out->append(" [");
+        out->append(std::to_string(record.suppressed_));
+        out->append(" more suppressed]");
+    }
+    out->append(" at ");
+    out->append(record.site_->qualified_name_);
+}
+} // namespace fsb
@@ -0,0 +1,125 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_ERROR_LOG_H_
+#define FSB_ERROR_LOG_H_
+
+#include "base_types.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fsb {
+//! @brief A place in the code that can fail, declared once as a function-local static.
+//!
+//! Holds the descriptions that used to be formatted into every message, and the state of the
+//! site's rate limit, so recording needs neither a lookup nor an allocation.
+struct ErrorSite {
+    constexpr ErrorSite(std::string_view action_description, std::string_view qualified_name,
+        std::string_view exported_operation_name)
+        : action_description_(action_description),
+          qualified_name_(qualified_name),
+          exported_operation_name_(exported_operation_name),
+          window_(0),
+          window_count_(0),
+          suppressed_(0) {}
+
+    std::string_view action_description_;
+    std::string_view qualified_name_;
+    std::string_view exported_operation_name_;
+
+    //! Rate limit window the count is for.
+    std::atomic<uint64_t> window_;
+    std::atomic<uint32_t> window_count_;
+    //! Records dropped by the rate limit since the last one that was kept.
+    std::atomic<uint32_t> suppressed_;
+};
+
+//! @brief A recorded failure. Fixed-size, so it can be copied into the ring without allocating.
+struct ErrorRecord {
+    const ErrorSite* site_;
+    //! Nanoseconds since the log was created.
+    uint64_t time_;
+    HWND window_handle_;
+    uint32_t process_id_;
+    //! Error code of the failed operation, e.g. GetLastError.
+    uint32_t code_;
+    int32_t return_code_;
+    //! Records of the same site dropped by the rate limit right before this one.
+    uint32_t suppressed_;
+};
+
+//! @brief Process-wide log of failures, recorded from any thread and read from the menu.
+//!
+//! Records go into a bounded lock-free ring (one compare-and-swap per record), so a failing
+//! window costs the probe a few atomic operations instead of formatting and writing a message.
+//! Each site keeps at most kMaxPerWindow records per kRateWindow; the rest are counted on the
+//! next record that gets through. Messages are only formatted when read, and the description of
+//! each error code only once.
+class ErrorLog {
+public:
+    static constexpr size_t kCapacity = 1024;
+    static constexpr uint64_t kRateWindow = 1000000000;
+    static constexpr uint32_t kMaxPerWindow = 4;
+
+    //! Returns the message of an error code, e.g. through FormatMessageW.
+    using Describer = std::string (*)(uint32_t code);
+
+    static ErrorLog& Get();
+
+    ErrorLog(const ErrorLog&) = delete;
+    ErrorLog& operator=(const ErrorLog&) = delete;
+
+    //! @brief Records a failure. Never allocates or blocks.
+    //!
+    //! @returns Returns false if the record was rate limited or the ring is full.
+    bool Record(ErrorSite& site, uint32_t code, int32_t return_code,
+        HWND window_handle = nullptr, uint32_t process_id = 0) noexcept;
+
+    //! @brief Moves every record in the ring to the end of records, oldest first.
+    //!
+    //! @returns Returns the number of records moved.
+    size_t Drain(std::vector<ErrorRecord>* records);
+
+    //! @brief Sets how error codes are described. Without one, codes are shown as numbers.
+    void SetDescriber(Describer describer);
+    //! @brief Returns the description of an error code, formatted once and then cached.
+    //!
+    //! Returned by value, as SetDescriber may drop the cache while the caller still holds it.
+    std::string Describe(uint32_t code);
+    //! @brief Appends a one-line message for a record to out.
+    void Format(const ErrorRecord& record, std::string* out);
+
+    //! Records lost because the ring was full.
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Cell {
+        //! Bounded MPMC queue protocol: equals the position when empty, position + 1 when full.
+        std::atomic<size_t> sequence_;
+        ErrorRecord record_;
+    };
+
+    ErrorLog();
+
+    const uint64_t origin_;
+    std::array<Cell, kCapacity> cells_;
+    alignas(64) std::atomic<size_t> enqueue_position_;
+    alignas(64) std::atomic<size_t> dequeue_position_;
+    std::atomic<uint64_t> dropped_;
+
+    std::mutex describe_mutex_;
+    Describer describer_;
+    std::unordered_map<uint32_t, std::string> descriptions_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_ERROR_LOG_H_
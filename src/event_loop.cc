@@ -0,0 +1,130 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "event_loop.h"
+
+#include <algorithm>
+
+namespace fsb {
+EventLoop::EventLoop(EventWaiter& waiter)
+    : waiter_(waiter), next_timer_id_(1), quit_(false), wait_count_(0) {}
+
+void EventLoop::SetHandler(EventSource source, Task handler) {
+    handlers_[static_cast<size_t>(source)] = std::move(handler);
+}
+
+void EventLoop::SetIdleHandler(Task handler) {
+    idle_handler_ = std::move(handler);
+}
+
+bool EventLoop::LaterThan(const TimerEntry& a, const TimerEntry& b) {
+    // Ties fire in the order the timers were added.
+    return a.deadline_ != b.deadline_ ? a.deadline_ > b.deadline_ : a.id_ > b.id_;
+}
+
+EventLoop::TimerId EventLoop::AddTimer(Clock::duration delay, Task task, Clock::duration period) {
+    const TimerId kId = next_timer_id_++;
+    timers_.emplace(kId, Timer{std::move(task), period});
+    timer_heap_.push_back({Clock::now() + delay, kId});
+    std::push_heap(timer_heap_.begin(), timer_heap_.end(), LaterThan);
+    return kId;
+}
+
+void EventLoop::CancelTimer(TimerId id) {
+    // The heap entry is dropped lazily once it reaches the front.
+    timers_.erase(id);
+}
+
+void EventLoop::Post(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(posted_mutex_);
+        posted_.push_back(std::move(task));
+    }
+    waiter_.Wake();
+}
+
+void EventLoop::Quit() {
+    quit_ = true;
+}
+
+void EventLoop::RunPostedTasks() {
+    std::vector<Task> tasks;
+    {
+        std::lock_guard<std::mutex> lock(posted_mutex_);
+        tasks.swap(posted_);
+    }
+    for (Task& task : tasks) {
+        task();
+    }
+}
+
+void EventLoop::RunDueTimers() {
+    const Clock::time_point kNow = Clock::now();
+    while (!timer_heap_.empty() && timer_heap_.front().deadline_ <= kNow && !quit_) {
+        std::pop_heap(timer_heap_.begin(), timer_heap_.end(), LaterThan);
+        const TimerEntry kEntry = timer_heap_.back();
+        timer_heap_.pop_back();
+
+        auto it = timers_.find(kEntry.id_);
+        if (it == timers_.end()) {
+            continue;
+        }
+
+        // The task may add or cancel timers, including itself, so it must not run from inside
+        // the map.
+        Task task;
+        if (it->second.period_ > Clock::duration::zero()) {
+            task = it->second.task_;
+            // A loop that fell behind skips the missed periods rather than firing them in a burst.
+            const Clock::time_point kNext = std::max(kEntry.deadline_ + it->second.period_, kNow);
+            timer_heap_.push_back({kNext, kEntry.id_});
+            std::push_heap(timer_heap_.begin(), timer_heap_.end(), LaterThan);
+        } else {
+            task = std::move(it->second.task_);
+            timers_.erase(it);
+        }
+        task();
+    }
+}
+
+uint32_t EventLoop::NextTimeout() const {
+    if (timer_heap_.empty()) {
+        return EventWaiter::kInfinite;
+    }
+
+    const Clock::duration kRemaining = timer_heap_.front().deadline_ - Clock::now();
+    if (kRemaining <= Clock::duration::zero()) {
+        return 0;
+    }
+    const auto kMilliseconds = std::chrono::ceil<std::chrono::milliseconds>(kRemaining).count();
+    return static_cast<uint32_t>(std::min<int64_t>(kMilliseconds, EventWaiter::kInfinite - 1));
+}
+
+void EventLoop::Run() {
+    quit_ = false;
+    while (!quit_) {
+        RunPostedTasks();
+        RunDueTimers();
+        if (quit_) {
+            break;
+        }
+
+        if (idle_handler_) {
+            idle_handler_();
+        }
+        if (quit_) {
+            break;
+        }
+
+        // Tasks posted after RunPostedTasks leave the waiter woken, so they are not missed here.
+        ++wait_count_;
+        const uint32_t kReady = waiter_.Wait(NextTimeout());
+        for (size_t i = 0; i < handlers_.size() && !quit_; ++i) {
+            if ((kReady & EventWaiter::Bit(static_cast<EventSource>(i))) != 0 && handlers_[i]) {
+                handlers_[i]();
+            }
+        }
+    }
+}
+} // namespace fsb
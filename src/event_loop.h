@@ -0,0 +1,129 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_EVENT_LOOP_H_
+#define FSB_EVENT_LOOP_H_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace fsb {
+//! @brief Things outside the process the event loop can wait on.
+enum class EventSource : uint8_t {
+    //! Console input (keys, resizes) is ready to be read.
+    Input,
+    //! Messages are queued for the thread, e.g. WinEvent hook callbacks waiting to be pumped.
+    WindowMessages,
+    //! The directory of the config file changed.
+    ConfigChanged,
+    Count
+};
+
+//! @brief Blocks the event loop until one of its sources is ready.
+//!
+//! Implemented with MsgWaitForMultipleObjectsEx on Windows (Win32EventWaiter) and with a condition
+//! variable driven by the tests (ScriptedEventWaiter), so the loop itself runs anywhere.
+class EventWaiter {
+public:
+    static constexpr uint32_t kInfinite = UINT32_MAX;
+
+    static constexpr uint32_t Bit(EventSource source) {
+        return uint32_t{1} << static_cast<uint32_t>(source);
+    }
+
+    virtual ~EventWaiter() = default;
+
+    //! @brief Blocks until a source is ready, Wake is called, or the timeout elapses.
+    //!
+    //! @returns Returns the Bit of every source that is ready, 0 after a wake or a timeout.
+    virtual uint32_t Wait(uint32_t timeout_milliseconds) = 0;
+
+    //! @brief Makes the current or the next Wait return early. Safe to call from any thread.
+    virtual void Wake() = 0;
+};
+
+//! @brief Single-threaded loop that dispatches console input, window events, config changes,
+//! timers and tasks posted by worker threads.
+//!
+//! Every handler runs on the thread that calls Run. Between batches of handlers the loop sleeps
+//! in the waiter until the next timer is due, so an idle loop uses no CPU at all. Work done on
+//! other threads reports back by posting a task, which wakes the loop.
+class EventLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Task = std::function<void()>;
+    using TimerId = uint64_t;
+
+    explicit EventLoop(EventWaiter& waiter);
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    //! @brief Sets the handler run whenever source is reported ready.
+    void SetHandler(EventSource source, Task handler);
+    //! @brief Sets the handler run once per iteration, after everything else and right before
+    //! the loop goes back to sleep. Used to redraw once per batch of events.
+    void SetIdleHandler(Task handler);
+
+    //! @brief Runs task after delay, and then every period if it is not zero.
+    //!
+    //! @returns Returns an id for CancelTimer, never 0.
+    TimerId AddTimer(Clock::duration delay, Task task, Clock::duration period = {});
+    //! @brief Cancels a timer. Unknown ids, 0 and timers that already fired are ignored.
+    void CancelTimer(TimerId id);
+
+    //! @brief Queues task to run on the loop thread. Safe to call from any thread.
+    void Post(Task task);
+
+    //! @brief Makes Run return once the current handler finishes.
+    void Quit();
+
+    //! @brief Dispatches events until Quit is called.
+    void Run();
+
+    //! Number of times the loop went to sleep, to check that an idle loop does not spin.
+    uint64_t wait_count() const { return wait_count_; }
+
+private:
+    struct TimerEntry {
+        Clock::time_point deadline_;
+        TimerId id_;
+    };
+
+    struct Timer {
+        Task task_;
+        Clock::duration period_;
+    };
+
+    //! Heap order for timer_heap_, which keeps the earliest deadline at the front.
+    static bool LaterThan(const TimerEntry& a, const TimerEntry& b);
+    void RunPostedTasks();
+    void RunDueTimers();
+    //! Milliseconds until the next timer is due, rounded up, or EventWaiter::kInfinite.
+    uint32_t NextTimeout() const;
+
+    EventWaiter& waiter_;
+    std::array<Task, static_cast<size_t>(EventSource::Count)> handlers_;
+    Task idle_handler_;
+
+    //! Deadlines of pending timers. Cancelled timers stay here until they reach the front.
+    std::vector<TimerEntry> timer_heap_;
+    std::unordered_map<TimerId, Timer> timers_;
+    TimerId next_timer_id_;
+
+    std::mutex posted_mutex_;
+    std::vector<Task> posted_;
+
+    bool quit_;
+    uint64_t wait_count_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_EVENT_LOOP_H_
@@ -0,0 +1,88 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "file_lock.h"
+
+#ifdef _WIN32
+#include <filesystem>
+
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace fsb {
+#ifdef _WIN32
+FileLock::FileLock() : handle_(INVALID_HANDLE_VALUE) {}
+
+bool FileLock::Lock(const std::string& path) {
+    Unlock();
+
+    HANDLE file = CreateFileW(std::filesystem::u8path(path).c_str(),
+        GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    // The whole range, so every process locks the same bytes.
+    OVERLAPPED overlapped = {};
+    if (!LockFileEx(file, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped)) {
+        static_cast<void>(CloseHandle(file));
+        return false;
+    }
+    handle_ = file;
+    return true;
+}
+
+void FileLock::Unlock() {
+    // Closing the handle releases the lock.
+    if (handle_ != INVALID_HANDLE_VALUE) {
+        static_cast<void>(CloseHandle(handle_));
+    }
+    handle_ = INVALID_HANDLE_VALUE;
+}
+
+bool FileLock::locked() const {
+    return handle_ != INVALID_HANDLE_VALUE;
+}
+#else
+FileLock::FileLock() : descriptor_(-1) {}
+
+bool FileLock::Lock(const std::string& path) {
+    Unlock();
+
+    const int kFile = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (kFile < 0) {
+        return false;
+    }
+    while (flock(kFile, LOCK_EX) != 0) {
+        if (errno != EINTR) {
+            static_cast<void>(close(kFile));
+            return false;
+        }
+    }
+    descriptor_ = kFile;
+    return true;
+}
+
+void FileLock::Unlock() {
+    // Closing the descriptor releases the lock.
+    if (descriptor_ >= 0) {
+        static_cast<void>(close(descriptor_));
+    }
+    descriptor_ = -1;
+}
+
+bool FileLock::locked() const {
+    return descriptor_ >= 0;
+}
+#endif
+
+FileLock::~FileLock() {
+    Unlock();
+}
+} // namespace fsb
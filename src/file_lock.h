@@ -0,0 +1,41 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_FILE_LOCK_H_
+#define FSB_FILE_LOCK_H_
+
+#include <string>
+
+namespace fsb {
+//! @brief Exclusive advisory lock on a file, shared between processes.
+//!
+//! The lock file is created if it does not exist and is left behind afterwards. The operating
+//! system releases the lock when the process dies, so a crash never leaves it taken.
+class FileLock {
+public:
+    FileLock();
+    ~FileLock();
+
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+    //! @brief Waits until no other FileLock holds the file, then holds it.
+    //!
+    //! @param path UTF-8 path.
+    //! @returns Returns false if the file cannot be created or locked.
+    bool Lock(const std::string& path);
+    void Unlock();
+
+    bool locked() const;
+
+private:
+#ifdef _WIN32
+    void* handle_;
+#else
+    int descriptor_;
+#endif
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_FILE_LOCK_H_
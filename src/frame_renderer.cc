@@ -0,0 +1,228 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "frame_renderer.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace fsb {
+namespace {
+// Rewriting a few unchanged cells is cheaper than a new cursor move (up to ~10 bytes), so changed
+// spans separated by a gap this small are merged.
+constexpr int kMaxMergeGap = 6;
+
+// Indexed by CellAttribute.
+constexpr std::string_view kAttributeSequences[] = {
+    "\033[0m",        // Normal
+    "\033[0;30;47m",  // Highlight: black on white
+    "\033[0;90m",     // Dim: bright black
+};
+
+constexpr char32_t kReplacementCharacter = 0xFFFD;
+
+//! Decodes one code point from UTF-8 text, advancing position past it.
+char32_t DecodeUtf8(std::string_view text, size_t* position) {
+    const auto kLead = static_cast<unsigned char>(text[*position]);
+    ++*position;
+    if (kLead < 0x80) {
+        return kLead;
+    }
+
+    int length;
+    char32_t code_point;
+    if ((kLead & 0xE0) == 0xC0) {
+        length = 1;
+        code_point = kLead & 0x1F;
+    } else if ((kLead & 0xF0) == 0xE0) {
+        length = 2;
+        code_point = kLead & 0x0F;
+    } else if ((kLead & 0xF8) == 0xF0) {
+        length = 3;
+        code_point = kLead & 0x07;
+    } else {
+        return kReplacementCharacter;
+    }
+
+    for (int i = 0; i < length; ++i) {
+        if (*position >= text.size()
+            || (static_cast<unsigned char>(text[*position]) & 0xC0) != 0x80) {
+            return kReplacementCharacter;
+        }
+        code_point = (code_point << 6) | (static_cast<unsigned char>(text[*position]) & 0x3F);
+        ++*position;
+    }
+    return code_point;
+}
+
+void AppendUtf8(char32_t code_point, std::string* output) {
+    if (code_point < 0x80) {
+        output->push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        output->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        output->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        output->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        output->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        output->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        output->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+void AppendNumber(int value, std::string* output) {
+    char digits[12];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (count > 0) {
+        output->push_back(digits[--count]);
+    }
+}
+} // namespace
+
+void ScreenBuffer::Resize(int width, int height) {
+    width_ = std::max(width, 0);
+    height_ = std::max(height, 0);
+    cells_.assign(static_cast<size_t>(width_) * height_, {U' ', CellAttribute::Normal});
+}
+
+void ScreenBuffer::Clear() {
+    std::fill(cells_.begin(), cells_.end(), Cell{U' ', CellAttribute::Normal});
+}
+
+int ScreenBuffer::Put(int x, int y, std::string_view text, CellAttribute attribute) {
+    if (y < 0 || y >= height_) {
+        return x;
+    }
+
+    size_t position = 0;
+    while (position < text.size() && x < width_) {
+        char32_t code_point = DecodeUtf8(text, &position);
+        // Control characters would move the real cursor and desynchronize the front buffer.
+        if (code_point < 0x20 || code_point == 0x7F) {
+            code_point = U' ';
+        }
+        if (x >= 0) {
+            at(x, y) = {code_point, attribute};
+        }
+        ++x;
+    }
+    return x;
+}
+
+void ScreenBuffer::Fill(int x, int y, int count, char32_t code_point, CellAttribute attribute) {
+    if (y < 0 || y >= height_) {
+        return;
+    }
+    const int kFirst = std::max(x, 0);
+    const int kLast = std::min(x + count, width_);
+    for (int i = kFirst; i < kLast; ++i) {
+        at(i, y) = {code_point, attribute};
+    }
+}
+
+void ScreenBuffer::SetRowAttribute(int y, CellAttribute attribute) {
+    if (y < 0 || y >= height_) {
+        return;
+    }
+    for (int x = 0; x < width_; ++x) {
+        at(x, y).attribute_ = attribute;
+    }
+}
+
+FrameRenderer::FrameRenderer()
+    : full_repaint_(true),
+      last_frame_bytes_(0),
+      last_frame_microseconds_(0),
+      frames_presented_(0),
+      total_bytes_(0) {}
+
+void FrameRenderer::Resize(int width, int height) {
+    if (width == back_.width() && height == back_.height()) {
+        return;
+    }
+    front_.Resize(width, height);
+    back_.Resize(width, height);
+    full_repaint_ = true;
+}
+
+void FrameRenderer::EncodeSpan(int y, int first, int last, CellAttribute* current_attribute) {
+    // CUP is 1-based.
+    output_ += "\033[";
+    AppendNumber(y + 1, &output_);
+    output_.push_back(';');
+    AppendNumber(first + 1, &output_);
+    output_.push_back('H');
+
+    for (int x = first; x <= last; ++x) {
+        const Cell& cell = back_.at(x, y);
+        if (cell.attribute_ != *current_attribute) {
+            output_ += kAttributeSequences[static_cast<size_t>(cell.attribute_)];
+            *current_attribute = cell.attribute_;
+        }
+        AppendUtf8(cell.code_point_, &output_);
+        front_.at(x, y) = cell;
+    }
+}
+
+size_t FrameRenderer::Present(TerminalSink& sink) {
+    const auto kStart = std::chrono::steady_clock::now();
+
+    output_.clear();
+    // The attribute of the terminal is unknown at the start of a frame, so the first span always
+    // sets it explicitly.
+    auto current_attribute = static_cast<CellAttribute>(0xFF);
+
+    if (full_repaint_) {
+        output_ += "\033[0m\033[2J";
+        current_attribute = CellAttribute::Normal;
+    }
+
+    for (int y = 0; y < back_.height(); ++y) {
+        int span_first = -1;
+        int span_last = -1;
+        for (int x = 0; x < back_.width(); ++x) {
+            if (!full_repaint_ && back_.at(x, y) == front_.at(x, y)) {
+                continue;
+            }
+            if (span_first >= 0 && x - span_last > kMaxMergeGap) {
+                EncodeSpan(y, span_first, span_last, &current_attribute);
+                span_first = -1;
+            }
+            if (span_first < 0) {
+                span_first = x;
+            }
+            span_last = x;
+        }
+        if (span_first >= 0) {
+            EncodeSpan(y, span_first, span_last, &current_attribute);
+        }
+    }
+
+    full_repaint_ = false;
+
+    if (!output_.empty()) {
+        // Leave the terminal in a neutral state for anything else that writes to it.
+        if (current_attribute != CellAttribute::Normal) {
+            output_ += kAttributeSequences[static_cast<size_t>(CellAttribute::Normal)];
+        }
+        sink.Write(output_);
+        ++frames_presented_;
+    }
+
+    last_frame_bytes_ = output_.size();
+    total_bytes_ += output_.size();
+    last_frame_microseconds_ = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - kStart).count());
+
+    return last_frame_bytes_;
+}
+} // namespace fsb
@@ -0,0 +1,115 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_FRAME_RENDERER_H_
+#define FSB_FRAME_RENDERER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fsb {
+//! @brief Display attributes of a cell. Each one maps to a fixed SGR escape sequence.
+enum class CellAttribute : uint8_t {
+    Normal,
+    Highlight,
+    Dim
+};
+
+struct Cell {
+    char32_t code_point_;
+    CellAttribute attribute_;
+
+    bool operator==(const Cell& other) const {
+        return code_point_ == other.code_point_ && attribute_ == other.attribute_;
+    }
+    bool operator!=(const Cell& other) const { return !(*this == other); }
+};
+
+//! @brief Destination of rendered frames, e.g. the console output handle.
+class TerminalSink {
+public:
+    virtual ~TerminalSink() = default;
+
+    //! @brief Writes a complete frame. Called at most once per frame.
+    virtual void Write(std::string_view bytes) = 0;
+};
+
+//! @brief Grid of cells the menu is drawn into.
+//!
+//! @note Every code point is assumed to take exactly one column. Wide (East Asian) characters and
+//! combining marks will be misaligned.
+class ScreenBuffer {
+public:
+    ScreenBuffer() : width_(0), height_(0) {}
+
+    void Resize(int width, int height);
+    void Clear();
+
+    //! @brief Writes UTF-8 text starting at (x, y), clipped at the right edge of the row.
+    //! @returns Returns the column after the last cell written.
+    int Put(int x, int y, std::string_view text, CellAttribute attribute);
+
+    //! @brief Fills cells [x, x + count) of a row with one character.
+    void Fill(int x, int y, int count, char32_t code_point, CellAttribute attribute);
+
+    //! @brief Changes the attribute of a whole row without touching its characters.
+    void SetRowAttribute(int y, CellAttribute attribute);
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    const Cell& at(int x, int y) const { return cells_[static_cast<size_t>(y) * width_ + x]; }
+    Cell& at(int x, int y) { return cells_[static_cast<size_t>(y) * width_ + x]; }
+
+private:
+    int width_;
+    int height_;
+    std::vector<Cell> cells_;
+};
+
+//! @brief Double-buffered renderer that only sends the cells that changed since the last frame.
+//!
+//! The menu draws into the back buffer, then Present compares it against the front buffer (what
+//! is currently on screen), encodes the changed spans as cursor moves, SGR attributes and UTF-8
+//! text into one buffer, and hands that buffer to the sink in a single write.
+class FrameRenderer {
+public:
+    FrameRenderer();
+
+    //! @brief Resizes both buffers. A size change forces the next frame to repaint everything.
+    void Resize(int width, int height);
+
+    //! @brief Forces the next frame to repaint everything, e.g. after something else wrote to the
+    //! console.
+    void Invalidate() { full_repaint_ = true; }
+
+    ScreenBuffer& back_buffer() { return back_; }
+
+    //! @brief Sends the differences between the back and front buffers to the sink.
+    //! @returns Returns the number of bytes written. Nothing is written if the frame is unchanged.
+    size_t Present(TerminalSink& sink);
+
+    //! Statistics about the most recent frame and all frames so far.
+    size_t last_frame_bytes() const { return last_frame_bytes_; }
+    uint64_t last_frame_microseconds() const { return last_frame_microseconds_; }
+    uint64_t frames_presented() const { return frames_presented_; }
+    uint64_t total_bytes() const { return total_bytes_; }
+
+private:
+    void EncodeSpan(int y, int first, int last, CellAttribute* current_attribute);
+
+    ScreenBuffer front_;
+    ScreenBuffer back_;
+    bool full_repaint_;
+    std::string output_;
+    size_t last_frame_bytes_;
+    uint64_t last_frame_microseconds_;
+    uint64_t frames_presented_;
+    uint64_t total_bytes_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_FRAME_RENDERER_H_
@@ -5,46 +5,64 @@
 #ifndef FSB_STRING_H_
 #define FSB_STRING_H_
 
-#include "fsb_assert.h"
+#include "utf_transcode.h"
 
-#include <utf8.h>
+#include <string>
 #include <string_view>
 
 namespace fsb {
 //! @brief Converts a UTF-16 string (std::wstring) to a UTF-8 string (std::string).
 //!
-//! This function takes an std::wstring_view (UTF-16), and using the utfcpp library, converts it to
-//! an std::string (UTF-8) type.
+//! This function takes an std::wstring_view (UTF-16), and using the transcoding engine in
+//! utf_transcode.h, converts it to an std::string (UTF-8) type. The output is allocated once, at
+//! its upper bound, and trimmed to the converted size.
 //!
 //! @param input The wide string input to be converted.
 //! @returns Returns the UTF-8 output of the inputted UTF-16 string.
 inline std::string Utf16ToUtf8(std::wstring_view input) {
     const auto* u16buf = reinterpret_cast<const char16_t*>(input.data());
     std::string output;
-    static_cast<void>(utf8::utf16to8(u16buf, u16buf + input.size(),
-        std::back_inserter(output)));
-    FSB_ASSERT(!output.empty(), "Non-null conversion",
-               "Converted strings should never return null");
+    output.resize(Utf8UpperBound(input.size()));
+    output.resize(TranscodeUtf16ToUtf8(u16buf, input.size(), output.data()));
     return output;
 }
 
-//! @brief Converts a UTF-8 string (std::string) to a UTF-16 string (std::wstring).
+//! @brief Converts a UTF-16 string into a caller-supplied buffer.
 //!
-//! This function takes an std::string_view (UTF-8), and using the utfcpp library, converts it to
-//! an std::wstring (UTF-16) type.
+//! Nothing is allocated, so this is suited to hot paths that convert into a stack buffer or a
+//! buffer reused between calls. Like snprintf, nothing is written if the buffer is too small and
+//! the required size is returned instead.
 //!
 //! @param input The wide string input to be converted.
-//! @returns Returns the UTF-8 output of the inputted UTF-16 string.
+//! @param buffer The buffer receiving the UTF-8 output. It is not null-terminated.
+//! @param capacity The size of the buffer, in bytes.
+//! @returns Returns the size of the UTF-8 output, which was only written if it is not larger than
+//! capacity.
+inline size_t Utf16ToUtf8(std::wstring_view input, char* buffer, size_t capacity) {
+    const auto* u16buf = reinterpret_cast<const char16_t*>(input.data());
+    if (capacity < Utf8UpperBound(input.size())) {
+        const size_t kRequired = Utf8Length(u16buf, input.size());
+        if (kRequired > capacity) {
+            return kRequired;
+        }
+    }
+    return TranscodeUtf16ToUtf8(u16buf, input.size(), buffer);
+}
+
+//! @brief Converts a UTF-8 string (std::string) to a UTF-16 string (std::wstring).
+//!
+//! This function takes an std::string_view (UTF-8), and using the transcoding engine in
+//! utf_transcode.h, converts it to an std::wstring (UTF-16) type.
+//!
+//! @param input The UTF-8 string input to be converted.
+//! @returns Returns the UTF-16 output of the inputted UTF-8 string.
 inline std::wstring Utf8ToUtf16(std::string_view input) {
-    const auto* u8buf = reinterpret_cast<const uint8_t*>(input.data());
     std::wstring output;
-    // Cast to void as return value isn't needed
-    static_cast<void>(utf8::utf8to16(u8buf, u8buf + input.size(),
-        std::back_inserter(output)));
-    FSB_ASSERT(!output.empty(), "Non-null conversion",
-               "Converted strings should never return null");
+    output.resize(Utf16UpperBound(input.size()));
+    auto* u16buf = reinterpret_cast<char16_t*>(output.data());
+    output.resize(TranscodeUtf8ToUtf16(input.data(), input.size(), u16buf));
     return output;
 }
 } // namespace fsb
 
-#endif // #ifndef FSB_STRING_H_
\ No newline at end of file
+#endif // #ifndef FSB_STRING_H_
@@ -0,0 +1,61 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_GEOMETRY_BACKEND_H_
+#define FSB_GEOMETRY_BACKEND_H_
+
+#include "base_types.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace fsb {
+//! @brief New position and size of one window in a batch.
+struct WindowMove {
+    HWND window_handle_;
+    SizeVec2 position_;
+    SizeVec2 size_;
+};
+
+//! @brief Abstraction over the calls that change the style and geometry of windows.
+//!
+//! Every change GeometryBatch makes goes through this interface. Win32GeometryBackend changes the
+//! live desktop, while the tests keep the windows in memory (RecordingGeometryBackend) so batches,
+//! including their failures and rollbacks, can be driven on any platform.
+class GeometryBackend {
+public:
+    virtual ~GeometryBackend() = default;
+
+    //! @brief Reads the current position, size and styles of a window.
+    //!
+    //! @returns Returns false if the window no longer exists.
+    virtual bool GetGeometry(HWND window_handle, WindowMetrics* metrics) = 0;
+
+    //! @brief Finds the bounds of a monitor.
+    //!
+    //! @param monitor 1-based index of the monitor in enumeration order, or 0 for the monitor the
+    //! window is mostly on.
+    //! @returns Returns false if the monitor does not exist.
+    virtual bool GetMonitorBounds(HWND window_handle, int monitor, SizeVec2* position,
+        SizeVec2* size) = 0;
+
+    //! @brief Replaces the style and extended style of a window. They take effect on its next
+    //! move.
+    virtual bool SetStyles(HWND window_handle, uint32_t style, uint32_t ex_style) = 0;
+
+    //! @brief Moves and resizes every window at once, redrawing the desktop once. Maximized windows
+    //! are restored first, as they ignore moves otherwise.
+    //!
+    //! @returns Returns false if any window refused. Some of the others may have moved anyway, so
+    //! callers read the geometry back to find out.
+    virtual bool MoveWindows(const std::vector<WindowMove>& moves) = 0;
+
+    virtual bool IsMaximized(HWND window_handle) = 0;
+
+    //! @brief Maximizes a window on the monitor it is on, without activating it.
+    virtual bool Maximize(HWND window_handle) = 0;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_GEOMETRY_BACKEND_H_
@@ -0,0 +1,156 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "geometry_batch.h"
+
+#include <string_view>
+#include <utility>
+
+namespace fsb {
+namespace {
+// Mirror WS_CAPTION | WS_THICKFRAME | WS_SYSMENU | WS_MINIMIZEBOX | WS_MAXIMIZEBOX and
+// WS_EX_DLGMODALFRAME | WS_EX_CLIENTEDGE | WS_EX_STATICEDGE | WS_EX_WINDOWEDGE, so the batch does
+// not depend on Windows.h.
+constexpr uint32_t kFrameStyles = 0x00C00000 | 0x00040000 | 0x00080000 | 0x00020000 | 0x00010000;
+constexpr uint32_t kFrameExStyles = 0x00000001 | 0x00000200 | 0x00020000 | 0x00000100;
+} // namespace
+
+GeometryBatch::GeometryBatch(GeometryBackend& backend) : backend_(backend) {}
+
+const GeometryChange& GeometryBatch::AddBorderless(HWND window_handle, int monitor) {
+    GeometryChange& change = changes_.emplace_back();
+    change.window_handle_ = window_handle;
+    change.before_ = {};
+    change.maximized_ = false;
+    change.status_ = ApplyStatus::Pending;
+    if (!backend_.GetGeometry(window_handle, &change.before_)) {
+        change.status_ = ApplyStatus::Gone;
+        change.after_ = change.before_;
+        return change;
+    }
+
+    change.maximized_ = backend_.IsMaximized(window_handle);
+    change.after_ = change.before_;
+    change.after_.style_ &= ~kFrameStyles;
+    change.after_.ex_style_ &= ~kFrameExStyles;
+    if (!backend_.GetMonitorBounds(window_handle, monitor, &change.after_.position_,
+            &change.after_.size_)) {
+        change.status_ = ApplyStatus::NoMonitor;
+    }
+    return change;
+}
+
+bool GeometryBatch::Commit() {
+    // Styles first. They take effect with the move, so a window that refuses its style has not
+    // changed visibly yet and the batch can stop before anything moves.
+    std::vector<size_t> styled;
+    std::vector<WindowMove> moves;
+    bool failed = false;
+    for (size_t i = 0; i < changes_.size(); ++i) {
+        GeometryChange& change = changes_[i];
+        if (change.status_ != ApplyStatus::Pending) {
+            continue;
+        }
+        if (!backend_.SetStyles(change.window_handle_, change.after_.style_,
+                change.after_.ex_style_)) {
+            change.status_ = ApplyStatus::Failed;
+            failed = true;
+            continue;
+        }
+        styled.push_back(i);
+        moves.push_back({change.window_handle_, change.after_.position_, change.after_.size_});
+    }
+    if (failed) {
+        Rollback(styled);
+        return false;
+    }
+
+    // Which windows moved is only known by reading them back, whatever the batch reported.
+    static_cast<void>(backend_.MoveWindows(moves));
+    for (size_t i : styled) {
+        GeometryChange& change = changes_[i];
+        WindowMetrics current = {};
+        if (backend_.GetGeometry(change.window_handle_, &current)
+            && Matches(current, change.after_)) {
+            change.status_ = ApplyStatus::Applied;
+        } else {
+            change.status_ = ApplyStatus::Failed;
+            failed = true;
+        }
+    }
+    if (failed) {
+        Rollback(styled);
+        return false;
+    }
+    return CountStatus(ApplyStatus::Applied) == changes_.size();
+}
+
+size_t GeometryBatch::CountStatus(ApplyStatus status) const {
+    size_t count = 0;
+    for (const GeometryChange& change : changes_) {
+        count += change.status_ == status ? 1 : 0;
+    }
+    return count;
+}
+
+std::string GeometryBatch::Summary() const {
+    std::string summary = std::to_string(CountStatus(ApplyStatus::Applied)) + " of "
+        + std::to_string(changes_.size()) + " window(s) applied";
+    const std::pair<ApplyStatus, std::string_view> kCounts[] = {
+        {ApplyStatus::Failed, " refused"},
+        {ApplyStatus::RolledBack, " rolled back"},
+        {ApplyStatus::RollbackFailed, " could not be rolled back"},
+        {ApplyStatus::Gone, " closed"},
+        {ApplyStatus::NoMonitor, " without their monitor"},
+    };
+    for (const auto& [status, description] : kCounts) {
+        const size_t kCount = CountStatus(status);
+        if (kCount != 0) {
+            summary += ", " + std::to_string(kCount);
+            summary += description;
+        }
+    }
+    return summary + ".";
+}
+
+bool GeometryBatch::Matches(const WindowMetrics& current, const WindowMetrics& target) {
+    // Windows are free to change styles the batch does not touch, so only the frame is compared.
+    return current.position_.x == target.position_.x && current.position_.y == target.position_.y
+        && current.size_.x == target.size_.x && current.size_.y == target.size_.y
+        && ((current.style_ ^ target.style_) & kFrameStyles) == 0
+        && ((current.ex_style_ ^ target.ex_style_) & kFrameExStyles) == 0;
+}
+
+void GeometryBatch::Rollback(const std::vector<size_t>& rows) {
+    std::vector<WindowMove> moves;
+    moves.reserve(rows.size());
+    for (size_t i : rows) {
+        const GeometryChange& change = changes_[i];
+        static_cast<void>(backend_.SetStyles(change.window_handle_, change.before_.style_,
+            change.before_.ex_style_));
+        moves.push_back({change.window_handle_, change.before_.position_, change.before_.size_});
+    }
+    static_cast<void>(backend_.MoveWindows(moves));
+
+    // Moving restored maximized windows, so they are maximized again the way RestoreLayouts does.
+    for (size_t i : rows) {
+        const GeometryChange& change = changes_[i];
+        if (change.maximized_) {
+            static_cast<void>(backend_.Maximize(change.window_handle_));
+        }
+    }
+
+    for (size_t i : rows) {
+        GeometryChange& change = changes_[i];
+        WindowMetrics current = {};
+        if (!backend_.GetGeometry(change.window_handle_, &current)
+            || !Matches(current, change.before_)
+            || (change.maximized_ && !backend_.IsMaximized(change.window_handle_))) {
+            change.status_ = ApplyStatus::RollbackFailed;
+        } else if (change.status_ != ApplyStatus::Failed) {
+            change.status_ = ApplyStatus::RolledBack;
+        }
+    }
+}
+} // namespace fsb
@@ -0,0 +1,82 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_GEOMETRY_BATCH_H_
+#define FSB_GEOMETRY_BATCH_H_
+
+#include "base_types.h"
+#include "geometry_backend.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fsb {
+enum class ApplyStatus : uint8_t {
+    //! Planned and not committed yet.
+    Pending,
+    Applied,
+    //! The window was closed before the batch was planned.
+    Gone,
+    //! The monitor the window was to cover does not exist.
+    NoMonitor,
+    //! The window refused the change. Whatever did change was put back.
+    Failed,
+    //! The window took the change, but another one in the batch failed, so it was put back.
+    RolledBack,
+    //! The window could not be put back after a failure and is left somewhere in between.
+    RollbackFailed
+};
+
+//! @brief A window of a batch, with its geometry before and after.
+struct GeometryChange {
+    HWND window_handle_;
+    //! What a rollback goes back to.
+    WindowMetrics before_;
+    //! Whether the window was maximized before, so a rollback maximizes it again.
+    bool maximized_;
+    WindowMetrics after_;
+    ApplyStatus status_;
+};
+
+//! @brief Changes the style and geometry of many windows as one transaction.
+//!
+//! Windows are planned first, from their current geometry. Commit then sets every style, moves
+//! every window in a single batch and reads them all back. If any window ended up anywhere but
+//! its target, every window that changed is put back to where it was before, so a batch either
+//! applies as a whole or leaves the desktop as it found it.
+class GeometryBatch {
+public:
+    explicit GeometryBatch(GeometryBackend& backend);
+
+    //! @brief Plans to strip the frame of a window and stretch it over a monitor.
+    //!
+    //! @param monitor 1-based index of the monitor, or 0 for the monitor the window is mostly on.
+    //! @returns Returns the planned change. Its status is Gone or NoMonitor if it cannot be made.
+    const GeometryChange& AddBorderless(HWND window_handle, int monitor);
+
+    //! @brief Applies every pending change.
+    //!
+    //! @returns Returns true if every planned window was applied.
+    bool Commit();
+
+    //! Every planned window, in the order added, with its status once committed.
+    const std::vector<GeometryChange>& changes() const { return changes_; }
+    size_t CountStatus(ApplyStatus status) const;
+    //! @brief Describes the outcome for a status line, e.g. "3 of 4 window(s) applied, 1 closed."
+    std::string Summary() const;
+
+private:
+    //! @brief Whether a window's current geometry matches a target in every way the batch sets.
+    static bool Matches(const WindowMetrics& current, const WindowMetrics& target);
+    //! @brief Moves every window in rows back to its geometry and show state before the batch.
+    void Rollback(const std::vector<size_t>& rows);
+
+    GeometryBackend& backend_;
+    std::vector<GeometryChange> changes_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_GEOMETRY_BATCH_H_
@@ -0,0 +1,317 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "headless.h"
+
+#include "process_cache.h"
+#include "string_pool.h"
+#include "trace.h"
+#include "window_health.h"
+#include "window_probe.h"
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <mutex>
+#include <string>
+
+namespace fsb {
+namespace {
+struct FieldName {
+    std::string_view name_;
+    RecordField field_;
+};
+
+//! Every field, in output order.
+constexpr FieldName kFieldNames[] = {
+    {"handle", RecordField::Handle},
+    {"pid", RecordField::ProcessId},
+    {"class", RecordField::Class},
+    {"title", RecordField::Title},
+    {"state", RecordField::State},
+    {"visible", RecordField::Visible},
+    {"enabled", RecordField::Enabled},
+    {"x", RecordField::X},
+    {"y", RecordField::Y},
+    {"width", RecordField::Width},
+    {"height", RecordField::Height},
+    {"style", RecordField::Style},
+    {"ex_style", RecordField::ExStyle},
+    {"exe", RecordField::Exe},
+    {"font", RecordField::Font},
+    {"font_size", RecordField::FontSize},
+};
+static_assert(std::size(kFieldNames) == static_cast<size_t>(RecordField::Count),
+    "Every record field needs a name.");
+
+constexpr uint32_t kFontFields = FieldBit(RecordField::Font) | FieldBit(RecordField::FontSize);
+
+std::string_view StateName(WindowState state) {
+    switch (state) {
+        case WindowState::Normal:
+            return "normal";
+        case WindowState::Maximized:
+            return "maximized";
+        case WindowState::Minimized:
+            return "minimized";
+    }
+    return "normal";
+}
+
+template <typename T>
+void AppendNumber(T value, std::string* out) {
+    char buffer[24];
+    const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    static_cast<void>(error);
+    out->append(buffer, end);
+}
+
+void AppendJsonString(std::string_view text, std::string* out) {
+    constexpr char kHexDigits[] = "0123456789abcdef";
+    out->push_back('"');
+    for (char c : text) {
+        const auto kByte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out->push_back('\\');
+            out->push_back(c);
+        } else if (kByte < 0x20) {
+            out->append("\\u00");
+            out->push_back(kHexDigits[kByte >> 4]);
+            out->push_back(kHexDigits[kByte & 0xF]);
+        } else {
+            out->push_back(c);
+        }
+    }
+    out->push_back('"');
+}
+
+void AppendCsvString(std::string_view text, std::string* out) {
+    if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out->append(text);
+        return;
+    }
+    out->push_back('"');
+    for (char c : text) {
+        if (c == '"') {
+            out->push_back('"');
+        }
+        out->push_back(c);
+    }
+    out->push_back('"');
+}
+
+void AppendValue(const ProcessData& window, RecordField field, OutputFormat format,
+    std::string* out) {
+    const auto kAppendString = [format, out](std::string_view text) {
+        if (format == OutputFormat::Ndjson) {
+            AppendJsonString(text, out);
+        } else {
+            AppendCsvString(text, out);
+        }
+    };
+
+    switch (field) {
+        case RecordField::Handle:
+            AppendNumber(reinterpret_cast<uintptr_t>(window.window_handle_), out);
+            break;
+        case RecordField::ProcessId:
+            AppendNumber(window.process_id_, out);
+            break;
+        case RecordField::Class:
+            kAppendString(window.class_name_);
+            break;
+        case RecordField::Title:
+            kAppendString(window.title_);
+            break;
+        case RecordField::State:
+            kAppendString(StateName(window.attributes_.state_));
+            break;
+        case RecordField::Visible:
+            out->append(window.attributes_.is_visible_ ? "true" : "false");
+            break;
+        case RecordField::Enabled:
+            out->append(window.attributes_.is_enabled_ ? "true" : "false");
+            break;
+        case RecordField::X:
+            AppendNumber(window.metrics_.position_.x, out);
+            break;
+        case RecordField::Y:
+            AppendNumber(window.metrics_.position_.y, out);
+            break;
+        case RecordField::Width:
+            AppendNumber(window.metrics_.size_.x, out);
+            break;
+        case RecordField::Height:
+            AppendNumber(window.metrics_.size_.y, out);
+            break;
+        case RecordField::Style:
+            AppendNumber(window.metrics_.style_, out);
+            break;
+        case RecordField::ExStyle:
+            AppendNumber(window.metrics_.ex_style_, out);
+            break;
+        case RecordField::Exe:
+            kAppendString(window.details_.file_name_);
+            break;
+        case RecordField::Font:
+            kAppendString(window.details_.font_name_);
+            break;
+        case RecordField::FontSize:
+            AppendNumber(window.details_.font_size_, out);
+            break;
+        case RecordField::Count:
+            break;
+    }
+}
+} // namespace
+
+void AppendRecord(const ProcessData& window, uint32_t fields, OutputFormat format,
+    std::string* out) {
+    bool first = true;
+    if (format == OutputFormat::Ndjson) {
+        out->push_back('{');
+    }
+    for (const FieldName& field_name : kFieldNames) {
+        if ((fields & FieldBit(field_name.field_)) == 0) {
+            continue;
+        }
+        if (!first) {
+            out->push_back(',');
+        }
+        first = false;
+        if (format == OutputFormat::Ndjson) {
+            out->push_back('"');
+            out->append(field_name.name_);
+            out->append("\":");
+        }
+        AppendValue(window, field_name.field_, format, out);
+    }
+    if (format == OutputFormat::Ndjson) {
+        out->push_back('}');
+    }
+    out->push_back('\n');
+}
+
+void AppendCsvHeader(uint32_t fields, std::string* out) {
+    bool first = true;
+    for (const FieldName& field_name : kFieldNames) {
+        if ((fields & FieldBit(field_name.field_)) == 0) {
+            continue;
+        }
+        if (!first) {
+            out->push_back(',');
+        }
+        first = false;
+        out->append(field_name.name_);
+    }
+    out->push_back('\n');
+}
+
+bool ParseRecordFields(std::string_view text, uint32_t* fields) {
+    uint32_t parsed = 0;
+    // Every name up to the last comma and the one after it, so an empty name is an error.
+    for (;;) {
+        const size_t kComma = text.find(',');
+        const std::string_view kName = text.substr(0, kComma);
+
+        bool found = false;
+        for (const FieldName& field_name : kFieldNames) {
+            if (field_name.name_ == kName) {
+                parsed |= FieldBit(field_name.field_);
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+        if (kComma == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(kComma + 1);
+    }
+    *fields = parsed;
+    return true;
+}
+
+HeadlessStats ListWindows(WindowSource& source, ProbePool& pool, const HeadlessOptions& options,
+    std::FILE* output) {
+    const uint64_t kStart = Tracer::Now();
+    HeadlessStats stats = {};
+
+    StringPool strings;
+    ProcessCache process_cache(strings);
+    HealthTracker health;
+    health.BeginRound();
+
+    RuleMatcher filter;
+    if (!options.filter_.empty()) {
+        filter.Compile({Rule{options.filter_, {0}, 0}});
+    }
+    const bool kNeedsFileName = (options.fields_ & FieldBit(RecordField::Exe)) != 0
+        || filter.needs_file_name();
+    const bool kNeedsFont = (options.fields_ & kFontFields) != 0;
+
+    std::atomic<size_t> font_queries(0);
+    // The matcher builds its automaton as it goes, so filtering is serialized.
+    std::mutex filter_mutex;
+
+    const auto kRefine = [&](ProcessData* window) {
+        if (kNeedsFileName) {
+            window->details_.file_name_ = process_cache.GetFileName(source, window->process_id_);
+        }
+        if (!options.filter_.empty()) {
+            std::lock_guard<std::mutex> lock(filter_mutex);
+            if (filter.Match(window->class_name_, window->title_,
+                window->details_.file_name_) < 0) {
+                return false;
+            }
+        }
+        // Filtered windows never get here, so they never pay for a font query.
+        uint32_t timeout = 0;
+        if (kNeedsFont && health.ShouldProbe(window->process_id_, &timeout)) {
+            const auto kFontStart = HealthTracker::Clock::now();
+            const ProbeStatus kStatus = source.GetWindowFont(window->window_handle_, timeout,
+                &window->details_.font_name_, &window->details_.font_size_);
+            health.Report(window->process_id_, kStatus,
+                HealthTracker::Clock::now() - kFontStart);
+            font_queries.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    };
+
+    std::string buffer;
+    if (options.format_ == OutputFormat::Csv) {
+        AppendCsvHeader(options.fields_, &buffer);
+    }
+
+    // Every batch is written right away, so records stream out while the rest are probed.
+    const auto kWrite = [&](std::vector<ProcessData> batch, bool done) {
+        for (const ProcessData& window : batch) {
+            AppendRecord(window, options.fields_, options.format_, &buffer);
+        }
+        stats.records_ += batch.size();
+        // The CSV header alone is only written once it is clear nothing was listed.
+        if (buffer.empty() || (batch.empty() && !done)) {
+            return;
+        }
+
+        static_cast<void>(std::fwrite(buffer.data(), 1, buffer.size(), output));
+        static_cast<void>(std::fflush(output));
+        buffer.clear();
+        if (stats.first_record_ == 0 && stats.records_ != 0) {
+            stats.first_record_ = Tracer::Now() - kStart;
+        }
+    };
+
+    stats.windows_ = StreamWindows(source, strings, pool, options.config_,
+        std::chrono::nanoseconds(0), kRefine, kWrite);
+
+    stats.total_ = Tracer::Now() - kStart;
+    // Every miss opened a process; the other windows of the process reused its path.
+    stats.file_name_queries_ = static_cast<size_t>(process_cache.misses());
+    stats.font_queries_ = font_queries.load();
+    return stats;
+}
+} // namespace fsb
@@ -0,0 +1,105 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_HEADLESS_H_
+#define FSB_HEADLESS_H_
+
+#include "config.h"
+#include "probe_pool.h"
+#include "rule_engine.h"
+#include "window_source.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fsb {
+enum class OutputFormat {
+    //! One JSON object per line.
+    Ndjson,
+    //! A header line, then one comma-separated line per window.
+    Csv
+};
+
+//! @brief Columns of a headless record, in output order.
+enum class RecordField : uint8_t {
+    Handle,
+    ProcessId,
+    Class,
+    Title,
+    State,
+    Visible,
+    Enabled,
+    X,
+    Y,
+    Width,
+    Height,
+    Style,
+    ExStyle,
+    //! Needs a process query per process.
+    Exe,
+    //! Needs a WM_GETFONT round trip per window.
+    Font,
+    FontSize,
+    Count
+};
+
+constexpr uint32_t FieldBit(RecordField field) {
+    return uint32_t{1} << static_cast<uint32_t>(field);
+}
+
+constexpr uint32_t kDefaultRecordFields = FieldBit(RecordField::Handle)
+    | FieldBit(RecordField::ProcessId) | FieldBit(RecordField::Class)
+    | FieldBit(RecordField::Title);
+
+//! @brief Parses a comma-separated list of field names (handle, pid, class, title, state,
+//! visible, enabled, x, y, width, height, style, ex_style, exe, font, font_size).
+//!
+//! @returns Returns false if a name is unknown or the list is empty.
+bool ParseRecordFields(std::string_view text, uint32_t* fields);
+
+//! @brief Appends one line for a window with the selected fields, newline included.
+void AppendRecord(const ProcessData& window, uint32_t fields, OutputFormat format,
+    std::string* out);
+//! @brief Appends the CSV header line naming the selected fields.
+void AppendCsvHeader(uint32_t fields, std::string* out);
+
+struct HeadlessOptions {
+    OutputFormat format_ = OutputFormat::Ndjson;
+    //! FieldBit of every field to write.
+    uint32_t fields_ = kDefaultRecordFields;
+    //! Only windows that match every condition are written. See ParseConditions.
+    std::vector<RuleCondition> filter_;
+    //! Hidden and untitled windows are filtered the same way as in the menu.
+    Config config_ = kDefaultConfig;
+};
+
+struct HeadlessStats {
+    size_t windows_;
+    size_t records_;
+    //! Nanoseconds from the start of the enumeration to the first record written, 0 if none.
+    uint64_t first_record_;
+    uint64_t total_;
+    //! Processes queried for their executable, each once.
+    size_t file_name_queries_;
+    //! Windows queried for their font.
+    size_t font_queries_;
+};
+
+//! @brief Enumerates the windows and writes one record per listed window, without touching the
+//! console.
+//!
+//! Windows are probed in parallel on the pool and written in Z-order as soon as every window
+//! before them is done, so the first records come out while the rest are still being probed.
+//! The expensive tier is only queried when a selected field or the filter needs it: the
+//! executable once per process, and the font per window under a HealthTracker, so hung windows
+//! cost a bounded amount of time and come out with an empty font.
+HeadlessStats ListWindows(WindowSource& source, ProbePool& pool, const HeadlessOptions& options,
+    std::FILE* output);
+} // namespace fsb
+
+#endif // #ifndef FSB_HEADLESS_H_
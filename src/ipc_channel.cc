@@ -0,0 +1,462 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "ipc_channel.h"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#include "fsb_string.h"
+
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace fsb {
+namespace {
+#ifdef _WIN32
+constexpr DWORD kPipeBufferSize = 64 * 1024;
+//! How long a client waits for a busy listener to offer a new pipe instance.
+constexpr DWORD kConnectTimeoutMilliseconds = 1000;
+
+HANDLE CreatePipeInstance(const std::string& address, bool first) {
+    // Only local clients, and only one listener per name: a second daemon fails to start
+    // instead of silently taking turns with the first.
+    return CreateNamedPipeW(Utf8ToUtf16(address).c_str(),
+        PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | (first ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0),
+        PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+        PIPE_UNLIMITED_INSTANCES, kPipeBufferSize, kPipeBufferSize, 0, nullptr);
+}
+#else
+bool MakeAddress(const std::string& address, sockaddr_un* socket_address) {
+    *socket_address = {};
+    socket_address->sun_family = AF_UNIX;
+    if (address.size() >= sizeof(socket_address->sun_path)) {
+        return false;
+    }
+    std::memcpy(socket_address->sun_path, address.c_str(), address.size() + 1);
+    return true;
+}
+#endif
+} // namespace
+
+#ifdef _WIN32
+IpcChannel::IpcChannel()
+    : timeout_(0), handle_(INVALID_HANDLE_VALUE), event_(nullptr), cancelled_(false) {}
+
+IpcChannel::IpcChannel(IpcChannel&& other) noexcept
+    : timeout_(other.timeout_), handle_(std::exchange(other.handle_, INVALID_HANDLE_VALUE)),
+        event_(std::exchange(other.event_, nullptr)),
+        cancelled_(other.cancelled_.exchange(false)) {}
+
+IpcChannel& IpcChannel::operator=(IpcChannel&& other) noexcept {
+    if (this != &other) {
+        Close();
+        if (event_ != nullptr) {
+            static_cast<void>(CloseHandle(event_));
+        }
+        timeout_ = other.timeout_;
+        handle_ = std::exchange(other.handle_, INVALID_HANDLE_VALUE);
+        event_ = std::exchange(other.event_, nullptr);
+        cancelled_.store(other.cancelled_.exchange(false));
+    }
+    return *this;
+}
+
+IpcChannel::~IpcChannel() {
+    Close();
+    if (event_ != nullptr) {
+        static_cast<void>(CloseHandle(event_));
+    }
+}
+
+bool IpcChannel::connected() const {
+    return handle_ != INVALID_HANDLE_VALUE;
+}
+
+bool IpcChannel::Connect(const std::string& address) {
+    Close();
+
+    const std::wstring kName = Utf8ToUtf16(address);
+    for (;;) {
+        HANDLE pipe = CreateFileW(kName.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+            OPEN_EXISTING, FILE_FLAG_OVERLAPPED, nullptr);
+        if (pipe != INVALID_HANDLE_VALUE) {
+            handle_ = pipe;
+            return true;
+        }
+        // Every instance is taken until the listener creates the next one.
+        if (GetLastError() != ERROR_PIPE_BUSY
+            || !WaitNamedPipeW(kName.c_str(), kConnectTimeoutMilliseconds)) {
+            return false;
+        }
+    }
+}
+
+void IpcChannel::Close() {
+    if (handle_ != INVALID_HANDLE_VALUE) {
+        static_cast<void>(CloseHandle(handle_));
+    }
+    handle_ = INVALID_HANDLE_VALUE;
+    cancelled_.store(false, std::memory_order_release);
+}
+
+void IpcChannel::Cancel() {
+    cancelled_.store(true, std::memory_order_release);
+    if (handle_ != INVALID_HANDLE_VALUE) {
+        static_cast<void>(CancelIoEx(handle_, nullptr));
+    }
+}
+
+bool IpcChannel::Transfer(bool write, void* data, size_t size, unsigned long* transferred) {
+    if (cancelled_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    if (event_ == nullptr) {
+        event_ = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (event_ == nullptr) {
+            return false;
+        }
+    }
+
+    OVERLAPPED overlapped = {};
+    overlapped.hEvent = event_;
+    const auto kSize = static_cast<DWORD>(std::min<size_t>(size, MAXDWORD));
+    const BOOL kDone = write ? WriteFile(handle_, data, kSize, nullptr, &overlapped)
+        : ReadFile(handle_, data, kSize, nullptr, &overlapped);
+    if (!kDone) {
+        if (GetLastError() != ERROR_IO_PENDING) {
+            return false;
+        }
+        // A Cancel that ran before the call started could not cancel it, so it is done here.
+        const int kRemaining = RemainingMilliseconds();
+        const DWORD kWait = kRemaining < 0 ? INFINITE : static_cast<DWORD>(kRemaining);
+        if (cancelled_.load(std::memory_order_acquire)
+            || WaitForSingleObject(event_, kWait) != WAIT_OBJECT_0) {
+            static_cast<void>(CancelIoEx(handle_, &overlapped));
+        }
+    }
+    // Waits for a cancelled call as well, as it still writes to overlapped until it ends.
+    return GetOverlappedResult(handle_, &overlapped, transferred, TRUE) != FALSE;
+}
+
+bool IpcChannel::Write(const void* data, size_t size) {
+    // WriteFile only reads the buffer, Transfer just takes it the way ReadFile does.
+    auto* bytes = static_cast<uint8_t*>(const_cast<void*>(data));
+    while (size != 0) {
+        DWORD written = 0;
+        if (!Transfer(true, bytes, size, &written)) {
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool IpcChannel::Read(void* data, size_t size) {
+    auto* bytes = static_cast<uint8_t*>(data);
+    while (size != 0) {
+        DWORD read = 0;
+        if (!Transfer(false, bytes, size, &read) || read == 0) {
+            return false;
+        }
+        bytes += read;
+        size -= read;
+    }
+    return true;
+}
+#else
+IpcChannel::IpcChannel() : timeout_(0), descriptor_(-1) {}
+
+IpcChannel::IpcChannel(IpcChannel&& other) noexcept
+    : timeout_(other.timeout_), descriptor_(std::exchange(other.descriptor_, -1)) {}
+
+IpcChannel& IpcChannel::operator=(IpcChannel&& other) noexcept {
+    if (this != &other) {
+        Close();
+        timeout_ = other.timeout_;
+        descriptor_ = std::exchange(other.descriptor_, -1);
+    }
+    return *this;
+}
+
+IpcChannel::~IpcChannel() {
+    Close();
+}
+
+bool IpcChannel::connected() const {
+    return descriptor_ >= 0;
+}
+
+bool IpcChannel::Connect(const std::string& address) {
+    Close();
+
+    sockaddr_un socket_address;
+    if (!MakeAddress(address, &socket_address)) {
+        return false;
+    }
+    descriptor_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (descriptor_ < 0) {
+        return false;
+    }
+    if (connect(descriptor_, reinterpret_cast<const sockaddr*>(&socket_address),
+        sizeof(socket_address)) != 0) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void IpcChannel::Close() {
+    if (descriptor_ >= 0) {
+        static_cast<void>(close(descriptor_));
+    }
+    descriptor_ = -1;
+}
+
+void IpcChannel::Cancel() {
+    // Wakes a poll or recv that is blocked right now, and fails every later one.
+    if (descriptor_ >= 0) {
+        static_cast<void>(shutdown(descriptor_, SHUT_RDWR));
+    }
+}
+
+bool IpcChannel::Wait(short events) const {
+    for (;;) {
+        pollfd request = {descriptor_, events, 0};
+        const int kReady = poll(&request, 1, RemainingMilliseconds());
+        if (kReady < 0 && errno == EINTR) {
+            continue;
+        }
+        return kReady > 0;
+    }
+}
+
+bool IpcChannel::Write(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size != 0) {
+        if (!Wait(POLLOUT)) {
+            return false;
+        }
+        // A client that went away must not take the daemon down with SIGPIPE.
+        const ssize_t kWritten = send(descriptor_, bytes, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (kWritten < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+            continue;
+        }
+        if (kWritten <= 0) {
+            return false;
+        }
+        bytes += kWritten;
+        size -= static_cast<size_t>(kWritten);
+    }
+    return true;
+}
+
+bool IpcChannel::Read(void* data, size_t size) {
+    auto* bytes = static_cast<uint8_t*>(data);
+    while (size != 0) {
+        if (!Wait(POLLIN)) {
+            return false;
+        }
+        const ssize_t kRead = recv(descriptor_, bytes, size, MSG_DONTWAIT);
+        if (kRead < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+            continue;
+        }
+        if (kRead <= 0) {
+            return false;
+        }
+        bytes += kRead;
+        size -= static_cast<size_t>(kRead);
+    }
+    return true;
+}
+#endif
+
+void IpcChannel::SetTimeout(std::chrono::milliseconds timeout) {
+    timeout_ = timeout;
+}
+
+void IpcChannel::StartDeadline() {
+    deadline_ = Clock::now() + timeout_;
+}
+
+int IpcChannel::RemainingMilliseconds() const {
+    if (timeout_.count() <= 0) {
+        return -1;
+    }
+    const auto kRemaining = std::chrono::ceil<std::chrono::milliseconds>(deadline_ - Clock::now());
+    return static_cast<int>(std::clamp<std::chrono::milliseconds::rep>(kRemaining.count(), 0,
+        timeout_.count()));
+}
+
+bool IpcChannel::Send(std::string_view payload) {
+    if (!connected() || payload.size() > kMaxMessageSize) {
+        return false;
+    }
+    StartDeadline();
+    const auto kSize = static_cast<uint32_t>(payload.size());
+    const uint8_t kHeader[4] = {static_cast<uint8_t>(kSize), static_cast<uint8_t>(kSize >> 8),
+        static_cast<uint8_t>(kSize >> 16), static_cast<uint8_t>(kSize >> 24)};
+    // Small messages go out in one write, so the other end wakes up once.
+    if (payload.size() <= 4096) {
+        char buffer[4 + 4096];
+        std::copy(kHeader, kHeader + 4, buffer);
+        std::copy(payload.begin(), payload.end(), buffer + 4);
+        return Write(buffer, 4 + payload.size());
+    }
+    return Write(kHeader, sizeof(kHeader)) && Write(payload.data(), payload.size());
+}
+
+bool IpcChannel::Receive(std::string* payload) {
+    uint8_t header[4];
+    StartDeadline();
+    if (!connected() || !Read(header, sizeof(header))) {
+        return false;
+    }
+    const uint32_t kSize = uint32_t{header[0]} | uint32_t{header[1]} << 8
+        | uint32_t{header[2]} << 16 | uint32_t{header[3]} << 24;
+    if (kSize > kMaxMessageSize) {
+        return false;
+    }
+    payload->resize(kSize);
+    return kSize == 0 || Read(payload->data(), kSize);
+}
+
+#ifdef _WIN32
+IpcListener::IpcListener()
+    : stopping_(false), pending_(INVALID_HANDLE_VALUE), connect_event_(nullptr) {}
+
+IpcListener::~IpcListener() {
+    if (pending_ != INVALID_HANDLE_VALUE) {
+        static_cast<void>(CloseHandle(pending_));
+    }
+    if (connect_event_ != nullptr) {
+        static_cast<void>(CloseHandle(connect_event_));
+    }
+}
+
+bool IpcListener::Listen(const std::string& address) {
+    address_ = address;
+    connect_event_ = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (connect_event_ == nullptr) {
+        return false;
+    }
+    pending_ = CreatePipeInstance(address, true);
+    return pending_ != INVALID_HANDLE_VALUE;
+}
+
+bool IpcListener::Accept(IpcChannel* channel) {
+    while (!stopping_.load(std::memory_order_acquire) && pending_ != INVALID_HANDLE_VALUE) {
+        // Pipe instances are overlapped, so channels can time out and be cancelled. Accept
+        // itself still waits until a client shows up.
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = connect_event_;
+        bool connected = ConnectNamedPipe(pending_, &overlapped) != FALSE;
+        if (!connected) {
+            // A client that connected between CreateNamedPipeW and here is reported as an error.
+            const DWORD kError = GetLastError();
+            DWORD unused = 0;
+            connected = kError == ERROR_PIPE_CONNECTED || (kError == ERROR_IO_PENDING
+                && GetOverlappedResult(pending_, &overlapped, &unused, TRUE));
+        }
+        if (stopping_.load(std::memory_order_acquire)) {
+            break;
+        }
+        if (!connected) {
+            static_cast<void>(DisconnectNamedPipe(pending_));
+            continue;
+        }
+
+        channel->Close();
+        channel->handle_ = pending_;
+        pending_ = CreatePipeInstance(address_, false);
+        return true;
+    }
+    return false;
+}
+
+void IpcListener::Stop() {
+    stopping_.store(true, std::memory_order_release);
+    // ConnectNamedPipe only returns once a client shows up, so one does.
+    IpcChannel wake;
+    static_cast<void>(wake.Connect(address_));
+}
+#else
+IpcListener::IpcListener() : stopping_(false), descriptor_(-1) {}
+
+IpcListener::~IpcListener() {
+    if (descriptor_ >= 0) {
+        static_cast<void>(close(descriptor_));
+        static_cast<void>(unlink(address_.c_str()));
+    }
+}
+
+bool IpcListener::Listen(const std::string& address) {
+    sockaddr_un socket_address;
+    if (!MakeAddress(address, &socket_address)) {
+        return false;
+    }
+    // A socket file nobody answers on was left behind by a listener that died.
+    IpcChannel probe;
+    if (probe.Connect(address)) {
+        return false;
+    }
+    static_cast<void>(unlink(address.c_str()));
+
+    descriptor_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (descriptor_ < 0) {
+        return false;
+    }
+    if (bind(descriptor_, reinterpret_cast<const sockaddr*>(&socket_address),
+        sizeof(socket_address)) != 0 || chmod(address.c_str(), S_IRUSR | S_IWUSR) != 0
+        || listen(descriptor_, SOMAXCONN) != 0) {
+        static_cast<void>(close(descriptor_));
+        descriptor_ = -1;
+        return false;
+    }
+    address_ = address;
+    return true;
+}
+
+bool IpcListener::Accept(IpcChannel* channel) {
+    while (!stopping_.load(std::memory_order_acquire) && descriptor_ >= 0) {
+        const int kClient = accept4(descriptor_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (stopping_.load(std::memory_order_acquire)) {
+            if (kClient >= 0) {
+                static_cast<void>(close(kClient));
+            }
+            break;
+        }
+        if (kClient < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return false;
+        }
+
+        channel->Close();
+        channel->descriptor_ = kClient;
+        return true;
+    }
+    return false;
+}
+
+void IpcListener::Stop() {
+    stopping_.store(true, std::memory_order_release);
+    // Wakes an accept that is blocked right now.
+    if (descriptor_ >= 0) {
+        static_cast<void>(shutdown(descriptor_, SHUT_RDWR));
+    }
+}
+#endif
+} // namespace fsb
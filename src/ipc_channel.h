@@ -0,0 +1,120 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_IPC_CHANNEL_H_
+#define FSB_IPC_CHANNEL_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace fsb {
+//! @brief One end of a local, connected, two-way channel that carries whole messages.
+//!
+//! Messages are framed as a 4-byte little-endian length followed by the payload. On Windows the
+//! channel is a named pipe, elsewhere a Unix domain socket, with the address being the pipe name
+//! or the socket path. Calls block, for at most the timeout of the channel if it has one.
+class IpcChannel {
+public:
+    //! Larger messages are refused, so a corrupt length cannot allocate gigabytes.
+    static constexpr size_t kMaxMessageSize = size_t{64} << 20;
+
+    IpcChannel();
+    ~IpcChannel();
+
+    IpcChannel(IpcChannel&& other) noexcept;
+    IpcChannel& operator=(IpcChannel&& other) noexcept;
+    IpcChannel(const IpcChannel&) = delete;
+    IpcChannel& operator=(const IpcChannel&) = delete;
+
+    //! @brief Connects to a listener. Returns false if nothing listens on address.
+    bool Connect(const std::string& address);
+    void Close();
+    bool connected() const;
+
+    //! @brief Limits how long each Send and Receive may take as a whole, so a client that
+    //! stalls half-way through a message cannot hold up the other end. Zero waits forever, which
+    //! is the default.
+    void SetTimeout(std::chrono::milliseconds timeout);
+
+    //! @brief Sends one message. Returns false if the other end went away or the timeout passed.
+    bool Send(std::string_view payload);
+    //! @brief Waits for the next message. Returns false if the other end went away, sent a
+    //! malformed frame or the timeout passed.
+    bool Receive(std::string* payload);
+
+    //! @brief Makes the current and every later Send and Receive fail until the channel is
+    //! closed. Safe to call from any thread, but not concurrently with Close.
+    void Cancel();
+
+private:
+    friend class IpcListener;
+
+    using Clock = std::chrono::steady_clock;
+
+    //! Starts the timeout of one Send or Receive.
+    void StartDeadline();
+    //! Milliseconds left until the deadline, or -1 if the channel has no timeout.
+    int RemainingMilliseconds() const;
+    bool Write(const void* data, size_t size);
+    bool Read(void* data, size_t size);
+
+    std::chrono::milliseconds timeout_;
+    Clock::time_point deadline_;
+#ifdef _WIN32
+    //! Runs one overlapped read or write and waits for it until the deadline.
+    bool Transfer(bool write, void* data, size_t size, unsigned long* transferred);
+
+    void* handle_;
+    //! Signals the completion of the overlapped call in flight, created on first use.
+    void* event_;
+    std::atomic<bool> cancelled_;
+#else
+    //! Waits until the socket is ready for events, or the deadline passes.
+    bool Wait(short events) const;
+
+    int descriptor_;
+#endif
+};
+
+//! @brief Accepts connections on a local address, one channel per client.
+class IpcListener {
+public:
+    IpcListener();
+    ~IpcListener();
+
+    IpcListener(const IpcListener&) = delete;
+    IpcListener& operator=(const IpcListener&) = delete;
+
+    //! @brief Starts listening. Returns false if the address is taken, e.g. by another listener
+    //! that is still running.
+    bool Listen(const std::string& address);
+
+    //! @brief Waits for the next client.
+    //!
+    //! @returns Returns false once Stop was called or the listener failed.
+    bool Accept(IpcChannel* channel);
+
+    //! @brief Makes the current and every later Accept return false. Safe to call from any
+    //! thread.
+    void Stop();
+
+private:
+    std::string address_;
+    std::atomic<bool> stopping_;
+#ifdef _WIN32
+    //! Pipe instance waiting for the next client.
+    void* pending_;
+    //! Signals that a client connected to pending_.
+    void* connect_event_;
+#else
+    int descriptor_;
+#endif
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_IPC_CHANNEL_H_
@@ -0,0 +1,343 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "layout_snapshot.h"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+
+namespace fsb {
+namespace {
+constexpr char kMagic[4] = {'F', 'S', 'B', 'L'};
+constexpr uint32_t kMinRecordCapacity = 64;
+constexpr uint32_t kMinStringCapacity = 4096;
+//! Appended to the snapshot path to name the file every writer locks.
+constexpr char kLockSuffix[] = ".lock";
+
+uint32_t Checksum(const SnapshotRecord& record) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&record);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(SnapshotRecord, checksum_); ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+uint32_t GrowCapacity(size_t needed, uint32_t minimum) {
+    uint32_t capacity = minimum;
+    while (capacity < needed * 2) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+} // namespace
+
+bool SnapshotReader::Open(const std::string& path) {
+    Close();
+    if (!file_.Open(path) || file_.size() < sizeof(SnapshotHeader)) {
+        return false;
+    }
+
+    SnapshotHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    const uint64_t kRecordsEnd = sizeof(SnapshotHeader)
+        + uint64_t{header.record_capacity_} * sizeof(SnapshotRecord);
+    if (std::memcmp(header.magic_, kMagic, sizeof(kMagic)) != 0
+        || header.version_ != SnapshotWriter::kVersion
+        || header.record_size_ != sizeof(SnapshotRecord)
+        || header.record_count_ > header.record_capacity_
+        || header.string_size_ > header.string_capacity_
+        || kRecordsEnd + header.string_capacity_ > file_.size()) {
+        Close();
+        return false;
+    }
+
+    // The header and records are multiples of 8 bytes and mappings are page-aligned, so the
+    // records can be read in place.
+    records_ = reinterpret_cast<const SnapshotRecord*>(file_.data() + sizeof(SnapshotHeader));
+    record_count_ = header.record_count_;
+    strings_ = reinterpret_cast<const char*>(file_.data() + kRecordsEnd);
+    string_size_ = header.string_size_;
+    generation_ = header.generation_;
+    return true;
+}
+
+void SnapshotReader::Close() {
+    file_.Close();
+    records_ = nullptr;
+    record_count_ = 0;
+    strings_ = nullptr;
+    string_size_ = 0;
+    generation_ = 0;
+}
+
+bool SnapshotReader::valid(size_t index) const {
+    const SnapshotRecord& record = records_[index];
+    return record.checksum_ == Checksum(record)
+        && uint64_t{record.class_offset_} + record.class_length_ <= string_size_
+        && uint64_t{record.title_offset_} + record.title_length_ <= string_size_;
+}
+
+std::string_view SnapshotReader::class_name(size_t index) const {
+    return std::string_view(strings_ + records_[index].class_offset_,
+        records_[index].class_length_);
+}
+
+std::string_view SnapshotReader::title(size_t index) const {
+    return std::string_view(strings_ + records_[index].title_offset_,
+        records_[index].title_length_);
+}
+
+SnapshotWriter::SnapshotWriter()
+    : record_capacity_(0),
+      string_capacity_(0),
+      flushed_records_(0),
+      flushed_strings_(0),
+      generation_(0),
+      needs_rewrite_(true) {}
+
+bool SnapshotWriter::Open(const std::string& path) {
+    path_ = path;
+    file_.close();
+    if (!lock_.Lock(path_ + kLockSuffix)) {
+        return false;
+    }
+
+    // Records left by a previous run, or written by the other process, are carried over, so
+    // they can still be restored.
+    SnapshotReader reader;
+    static_cast<void>(reader.Open(path));
+    Load(reader);
+    generation_ = reader.generation();
+    reader.Close();
+
+    flushed_records_ = records_.size();
+    flushed_strings_ = strings_.size();
+    needs_rewrite_ = true;
+    const bool kFlushed = FlushLocked();
+    lock_.Unlock();
+    return kFlushed;
+}
+
+void SnapshotWriter::Load(const SnapshotReader& reader) {
+    records_.clear();
+    index_.clear();
+    strings_.clear();
+    string_offsets_.clear();
+    for (size_t i = 0; i < reader.size(); ++i) {
+        if (!reader.valid(i) || index_.count(reader[i].window_handle_) != 0) {
+            continue;
+        }
+        SnapshotRecord record = reader[i];
+        record.class_offset_ = Intern(reader.class_name(i));
+        record.title_offset_ = Intern(reader.title(i));
+        record.checksum_ = Checksum(record);
+        index_.emplace(record.window_handle_, records_.size());
+        records_.push_back(record);
+    }
+}
+
+void SnapshotWriter::Sync() {
+    SnapshotReader reader;
+    const bool kOpened = reader.Open(path_);
+    if (kOpened && reader.generation() == generation_) {
+        return;
+    }
+    // Rewritten whether the file changed or went missing, as the file is no longer what the
+    // incremental flushes expect.
+    needs_rewrite_ = true;
+    if (!kOpened) {
+        return;
+    }
+
+    struct Pending {
+        SnapshotRecord record_;
+        std::string class_name_;
+        std::string title_;
+    };
+    std::vector<Pending> pending;
+    for (size_t i = flushed_records_; i < records_.size(); ++i) {
+        const SnapshotRecord& kRecord = records_[i];
+        pending.push_back({kRecord, strings_.substr(kRecord.class_offset_, kRecord.class_length_),
+            strings_.substr(kRecord.title_offset_, kRecord.title_length_)});
+    }
+
+    Load(reader);
+    generation_ = reader.generation();
+    reader.Close();
+    // A layout the other process recorded first stays, as it is the older one.
+    for (Pending& entry : pending) {
+        if (!index_.try_emplace(entry.record_.window_handle_, records_.size()).second) {
+            continue;
+        }
+        entry.record_.class_offset_ = Intern(entry.class_name_);
+        entry.record_.title_offset_ = Intern(entry.title_);
+        entry.record_.checksum_ = Checksum(entry.record_);
+        records_.push_back(entry.record_);
+    }
+}
+
+uint32_t SnapshotWriter::Intern(std::string_view text) {
+    auto [it, inserted] = string_offsets_.try_emplace(std::string(text),
+        static_cast<uint32_t>(strings_.size()));
+    if (inserted) {
+        strings_.append(text);
+    }
+    return it->second;
+}
+
+bool SnapshotWriter::Add(const ProcessData& window) {
+    const auto kHandle = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(window.window_handle_));
+    if (!index_.try_emplace(kHandle, records_.size()).second) {
+        return false;
+    }
+
+    SnapshotRecord record = {};
+    record.window_handle_ = kHandle;
+    record.process_id_ = window.process_id_;
+    record.x_ = window.metrics_.position_.x;
+    record.y_ = window.metrics_.position_.y;
+    record.width_ = window.metrics_.size_.x;
+    record.height_ = window.metrics_.size_.y;
+    record.style_ = window.metrics_.style_;
+    record.ex_style_ = window.metrics_.ex_style_;
+    record.state_ = static_cast<uint32_t>(window.attributes_.state_);
+    record.class_offset_ = Intern(window.class_name_);
+    record.class_length_ = static_cast<uint32_t>(window.class_name_.size());
+    record.title_offset_ = Intern(window.title_);
+    record.title_length_ = static_cast<uint32_t>(window.title_.size());
+    record.checksum_ = Checksum(record);
+    records_.push_back(record);
+    return true;
+}
+
+bool SnapshotWriter::Flush() {
+    if (path_.empty() || !lock_.Lock(path_ + kLockSuffix)) {
+        return false;
+    }
+    Sync();
+    const bool kFlushed = FlushLocked();
+    lock_.Unlock();
+    return kFlushed;
+}
+
+bool SnapshotWriter::Take(const std::function<void(const SnapshotReader&)>& read) {
+    if (path_.empty() || !lock_.Lock(path_ + kLockSuffix)) {
+        return false;
+    }
+    Sync();
+    SnapshotReader reader;
+    if (!FlushLocked() || !reader.Open(path_)) {
+        lock_.Unlock();
+        return false;
+    }
+    read(reader);
+    // Unmapped before the rewrite, which Windows refuses on a mapped file.
+    reader.Close();
+
+    records_.clear();
+    index_.clear();
+    strings_.clear();
+    string_offsets_.clear();
+    needs_rewrite_ = true;
+    const bool kFlushed = FlushLocked();
+    lock_.Unlock();
+    return kFlushed;
+}
+
+bool SnapshotWriter::FlushLocked() {
+    if (needs_rewrite_ || records_.size() > record_capacity_
+        || strings_.size() > string_capacity_) {
+        return Rewrite();
+    }
+    if (records_.size() == flushed_records_ && strings_.size() == flushed_strings_) {
+        return true;
+    }
+
+    // Strings and records first, so the header never counts anything that is not written yet.
+    const uint64_t kRecordsOffset = sizeof(SnapshotHeader);
+    const uint64_t kStringsOffset = kRecordsOffset
+        + uint64_t{record_capacity_} * sizeof(SnapshotRecord);
+    file_.seekp(static_cast<std::streamoff>(kStringsOffset + flushed_strings_));
+    file_.write(strings_.data() + flushed_strings_,
+        static_cast<std::streamsize>(strings_.size() - flushed_strings_));
+    file_.seekp(static_cast<std::streamoff>(kRecordsOffset
+        + flushed_records_ * sizeof(SnapshotRecord)));
+    file_.write(reinterpret_cast<const char*>(records_.data() + flushed_records_),
+        static_cast<std::streamsize>((records_.size() - flushed_records_)
+            * sizeof(SnapshotRecord)));
+    if (!WriteHeader()) {
+        return false;
+    }
+    flushed_records_ = records_.size();
+    flushed_strings_ = strings_.size();
+    return true;
+}
+
+bool SnapshotWriter::Rewrite() {
+    // Only the strings the records still use are kept.
+    std::string strings;
+    std::unordered_map<std::string, uint32_t> string_offsets;
+    const auto kRelocate = [&](uint32_t* offset, uint32_t length) {
+        auto [it, inserted] = string_offsets.try_emplace(strings_.substr(*offset, length),
+            static_cast<uint32_t>(strings.size()));
+        if (inserted) {
+            strings.append(it->first);
+        }
+        *offset = it->second;
+    };
+    for (SnapshotRecord& record : records_) {
+        kRelocate(&record.class_offset_, record.class_length_);
+        kRelocate(&record.title_offset_, record.title_length_);
+        record.checksum_ = Checksum(record);
+    }
+    strings_ = std::move(strings);
+    string_offsets_ = std::move(string_offsets);
+
+    record_capacity_ = GrowCapacity(records_.size(), kMinRecordCapacity);
+    string_capacity_ = GrowCapacity(strings_.size(), kMinStringCapacity);
+
+    file_.close();
+    file_.open(std::filesystem::u8path(path_),
+        std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+    if (!file_) {
+        return false;
+    }
+
+    // The spare capacity is written as zeros, so later flushes only ever write inside the file.
+    std::vector<char> body(uint64_t{record_capacity_} * sizeof(SnapshotRecord)
+        + string_capacity_);
+    std::memcpy(body.data(), records_.data(), records_.size() * sizeof(SnapshotRecord));
+    std::memcpy(body.data() + uint64_t{record_capacity_} * sizeof(SnapshotRecord),
+        strings_.data(), strings_.size());
+    file_.seekp(sizeof(SnapshotHeader));
+    file_.write(body.data(), static_cast<std::streamsize>(body.size()));
+    if (!WriteHeader()) {
+        return false;
+    }
+
+    flushed_records_ = records_.size();
+    flushed_strings_ = strings_.size();
+    needs_rewrite_ = false;
+    return true;
+}
+
+bool SnapshotWriter::WriteHeader() {
+    SnapshotHeader header = {};
+    std::memcpy(header.magic_, kMagic, sizeof(kMagic));
+    header.version_ = kVersion;
+    header.record_size_ = sizeof(SnapshotRecord);
+    header.record_count_ = static_cast<uint32_t>(records_.size());
+    header.record_capacity_ = record_capacity_;
+    header.string_size_ = static_cast<uint32_t>(strings_.size());
+    header.string_capacity_ = string_capacity_;
+    header.generation_ = ++generation_;
+
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_.flush();
+    return static_cast<bool>(file_);
+}
+} // namespace fsb
@@ -0,0 +1,163 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_LAYOUT_SNAPSHOT_H_
+#define FSB_LAYOUT_SNAPSHOT_H_
+
+#include "base_types.h"
+#include "file_lock.h"
+#include "mapped_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fsb {
+//! @brief First bytes of a snapshot file.
+//!
+//! The file is the header, record_capacity_ fixed-size records and string_capacity_ bytes of
+//! strings, in that order. Spare capacity lets records and strings be added in place. Integers
+//! are little-endian, as written by every platform fsb runs on.
+struct SnapshotHeader {
+    //! "FSBL".
+    char magic_[4];
+    uint16_t version_;
+    uint16_t record_size_;
+    //! Records in use, from the first. Written last, so a record that was only partly written
+    //! before a crash is never counted.
+    uint32_t record_count_;
+    uint32_t record_capacity_;
+    //! Bytes of strings in use.
+    uint32_t string_size_;
+    uint32_t string_capacity_;
+    //! Counts the writes to the file, so a writer can tell another process wrote to it since.
+    uint32_t generation_;
+    uint32_t reserved_;
+};
+static_assert(sizeof(SnapshotHeader) == 32, "The snapshot header is part of the file format.");
+
+//! @brief The layout of one window, as it was before fsb changed it.
+struct SnapshotRecord {
+    uint64_t window_handle_;
+    uint32_t process_id_;
+    int32_t x_;
+    int32_t y_;
+    int32_t width_;
+    int32_t height_;
+    uint32_t style_;
+    uint32_t ex_style_;
+    //! WindowState.
+    uint32_t state_;
+    //! Offsets and lengths into the string section.
+    uint32_t class_offset_;
+    uint32_t class_length_;
+    uint32_t title_offset_;
+    uint32_t title_length_;
+    uint32_t reserved_;
+    //! FNV-1a of every byte before it. Records updated in place are not written atomically, so a
+    //! torn one is told apart by this.
+    uint32_t checksum_;
+};
+static_assert(sizeof(SnapshotRecord) == 64, "The snapshot record is part of the file format.");
+
+//! @brief Reads a snapshot through a memory mapping, without copying it.
+class SnapshotReader {
+public:
+    //! @returns Returns false if the file is missing or is not a snapshot of this version.
+    bool Open(const std::string& path);
+    void Close();
+
+    //! Number of records, including any that fail their checksum. See valid().
+    size_t size() const { return record_count_; }
+    uint32_t generation() const { return generation_; }
+    const SnapshotRecord& operator[](size_t index) const { return records_[index]; }
+    //! @brief Whether a record is intact and its strings are inside the file.
+    bool valid(size_t index) const;
+    std::string_view class_name(size_t index) const;
+    std::string_view title(size_t index) const;
+
+private:
+    MappedFile file_;
+    const SnapshotRecord* records_ = nullptr;
+    size_t record_count_ = 0;
+    const char* strings_ = nullptr;
+    size_t string_size_ = 0;
+    uint32_t generation_ = 0;
+};
+
+//! @brief Keeps the snapshot file up to date as windows are changed.
+//!
+//! Only the first layout recorded for a window is kept, which is the one to go back to. Every
+//! Flush writes just what changed since the last one: the new records, the new strings and the
+//! header. The file is only rewritten as a whole when it runs out of capacity, which also drops
+//! the strings no record uses anymore.
+//!
+//! The menu and the daemon each keep a writer on the same file. Every access to the file holds
+//! an exclusive lock on a file next to it, and a writer that finds the file changed by another
+//! process since its last write reads it again and adds its new records on top, rewriting the
+//! file as a whole.
+class SnapshotWriter {
+public:
+    static constexpr uint16_t kVersion = 1;
+
+    SnapshotWriter();
+
+    //! @brief Opens a snapshot, keeping the records it already has, or creates an empty one.
+    //!
+    //! @returns Returns false if the file cannot be written.
+    bool Open(const std::string& path);
+
+    //! @brief Records the layout of a window unless it already has one.
+    //!
+    //! @returns Returns false if the window already had a layout.
+    bool Add(const ProcessData& window);
+    //! @brief Writes the changes since the last flush to the file.
+    bool Flush();
+    //! @brief Flushes, hands the file to read while no other process can change it, and then
+    //! drops every record in it, e.g. once the layouts were restored.
+    //!
+    //! @returns Returns false if the file cannot be read or written.
+    bool Take(const std::function<void(const SnapshotReader&)>& read);
+
+    size_t size() const { return records_.size(); }
+    bool empty() const { return records_.empty(); }
+
+private:
+    //! Replaces the records with the valid ones of a snapshot file.
+    void Load(const SnapshotReader& reader);
+    //! Reads the file again if another process wrote to it since the last write, keeping the
+    //! records that were not flushed yet. Expects lock_.
+    void Sync();
+    //! Writes what changed since the last flush. Expects lock_.
+    bool FlushLocked();
+    //! Interns a string into the string section and returns its offset.
+    uint32_t Intern(std::string_view text);
+    //! Writes the whole file again, at least twice as large as needed.
+    bool Rewrite();
+    bool WriteHeader();
+
+    std::string path_;
+    FileLock lock_;
+    std::fstream file_;
+    std::vector<SnapshotRecord> records_;
+    std::unordered_map<uint64_t, size_t> index_;
+    std::string strings_;
+    std::unordered_map<std::string, uint32_t> string_offsets_;
+    uint32_t record_capacity_;
+    uint32_t string_capacity_;
+    //! Records and string bytes already in the file.
+    size_t flushed_records_;
+    size_t flushed_strings_;
+    //! Generation of the last write to the file, by this writer or the one it read.
+    uint32_t generation_;
+    bool needs_rewrite_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_LAYOUT_SNAPSHOT_H_
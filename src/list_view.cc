@@ -0,0 +1,60 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "list_view.h"
+
+#include <algorithm>
+
+namespace fsb {
+ListView::ListView(int scroll_margin)
+    : scroll_margin_(std::max(scroll_margin, 0)),
+      item_count_(0),
+      viewport_height_(0),
+      selection_(0),
+      scroll_offset_(0) {}
+
+void ListView::SetItemCount(int item_count) {
+    item_count_ = std::max(item_count, 0);
+    selection_ = std::clamp(selection_, 0, std::max(item_count_ - 1, 0));
+    ScrollToSelection();
+}
+
+void ListView::SetViewportHeight(int viewport_height) {
+    viewport_height_ = std::max(viewport_height, 0);
+    ScrollToSelection();
+}
+
+void ListView::Select(int index) {
+    selection_ = std::clamp(index, 0, std::max(item_count_ - 1, 0));
+    ScrollToSelection();
+}
+
+void ListView::MoveBy(int delta) {
+    Select(selection_ + delta);
+}
+
+int ListView::end_visible() const {
+    return std::min(scroll_offset_ + viewport_height_, item_count_);
+}
+
+void ListView::ScrollToSelection() {
+    if (viewport_height_ == 0 || item_count_ == 0) {
+        scroll_offset_ = 0;
+        return;
+    }
+
+    // The margin can never take more than half of the viewport, or the selection could not fit.
+    const int kMargin = std::min(scroll_margin_, (viewport_height_ - 1) / 2);
+
+    if (selection_ - kMargin < scroll_offset_) {
+        scroll_offset_ = selection_ - kMargin;
+    } else if (selection_ + kMargin >= scroll_offset_ + viewport_height_) {
+        scroll_offset_ = selection_ + kMargin - viewport_height_ + 1;
+    }
+
+    // Never scroll past either end of the list, so a shrinking list does not leave empty rows.
+    const int kMaxOffset = std::max(item_count_ - viewport_height_, 0);
+    scroll_offset_ = std::clamp(scroll_offset_, 0, kMaxOffset);
+}
+} // namespace fsb
@@ -0,0 +1,53 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_LIST_VIEW_H_
+#define FSB_LIST_VIEW_H_
+
+namespace fsb {
+//! @brief Selection and scroll state of a virtualized list.
+//!
+//! The view only knows how many items there are and how many rows fit on screen, so every
+//! operation is constant time no matter how long the list is. Callers only format and draw the
+//! rows in [first_visible(), end_visible()).
+class ListView {
+public:
+    //! @param scroll_margin Number of rows kept between the selection and the edges of the
+    //! viewport while scrolling, when the list is long enough.
+    explicit ListView(int scroll_margin = 2);
+
+    //! @brief Updates the number of items, keeping the selection and scroll offset in range.
+    void SetItemCount(int item_count);
+
+    //! @brief Updates the number of rows available on screen.
+    void SetViewportHeight(int viewport_height);
+
+    void Select(int index);
+    void MoveBy(int delta);
+    void PageUp() { MoveBy(-page_size()); }
+    void PageDown() { MoveBy(page_size()); }
+    void Home() { Select(0); }
+    void End() { Select(item_count_ - 1); }
+
+    int selection() const { return selection_; }
+    int item_count() const { return item_count_; }
+    int viewport_height() const { return viewport_height_; }
+    int first_visible() const { return scroll_offset_; }
+    int end_visible() const;
+
+private:
+    int page_size() const { return viewport_height_ > 1 ? viewport_height_ - 1 : 1; }
+
+    //! Scrolls the minimum amount needed to show the selection with the margin around it.
+    void ScrollToSelection();
+
+    int scroll_margin_;
+    int item_count_;
+    int viewport_height_;
+    int selection_;
+    int scroll_offset_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_LIST_VIEW_H_
@@ -2,15 +2,194 @@
 // Use of this source code is governed by an MIT license that can be
 // found in the LICENSE file.
 
+#include "command_line.h"
 #include "console.h"
 #include "config.h"
+#include "daemon.h"
+#include "error.h"
+#include "error_log.h"
+#include "fsb_string.h"
+#include "headless.h"
+#include "probe_pool.h"
+#include "recording_window_source.h"
+#include "render_scheduler.h"
+#include "replay_window_source.h"
+#include "startup_profiler.h"
+#include "win32_window_source.h"
+#include "window_table.h"
+#include "window_trace.h"
 
-int __stdcall wmain() {
-    fsb::Config config = fsb::ParseConfig();
-    fsb::Console console(config);
+#include <Windows.h>
+#include <cstdio>
+#include <fcntl.h>
+#include <io.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+//! Error reader of the recorder.
+uint32_t ReadLastError() {
+    return GetLastError();
+}
+
+//! The live desktop, recorded into a trace if --record asked for one.
+//!
+//! The console and the daemon move, restyle and hook the windows they list, so they only ever read
+//! the desktop through this. Traces and other stand-ins are for --list alone.
+class LiveWindowSource {
+public:
+    //! @returns Returns false after printing why if the trace cannot be created.
+    bool Open(const fsb::CommandLine& command_line) {
+        if (command_line.record_path_.empty()) {
+            return true;
+        }
+        if (!trace_writer_.Open(command_line.record_path_)) {
+            std::fprintf(stderr, "Cannot create the trace %s.\n",
+                command_line.record_path_.c_str());
+            return false;
+        }
+        recorder_ = std::make_unique<fsb::RecordingWindowSource>(desktop_, trace_writer_,
+            ReadLastError);
+        return true;
+    }
 
-    console.ShowMenu();
+    fsb::WindowSource& get() {
+        return recorder_ != nullptr ? static_cast<fsb::WindowSource&>(*recorder_) : desktop_;
+    }
+
+private:
+    fsb::Win32WindowSource desktop_;
+    // Declared before the recorder, so it is flushed last.
+    fsb::TraceWriter trace_writer_;
+    std::unique_ptr<fsb::RecordingWindowSource> recorder_;
+};
+
+void WriteErrors() {
+    std::vector<fsb::ErrorRecord> errors;
+    static_cast<void>(fsb::ErrorLog::Get().Drain(&errors));
+    std::string message;
+    for (const fsb::ErrorRecord& record : errors) {
+        message.clear();
+        fsb::ErrorLog::Get().Format(record, &message);
+        std::fprintf(stderr, "%s\n", message.c_str());
+    }
+}
+
+//! Runs --list. Nothing here touches the console mode, code pages, cursor or title.
+int RunHeadless(const fsb::CommandLine& command_line, const fsb::Config& config,
+    fsb::WindowSource& source) {
+    // Records are UTF-8 and must reach pipes byte for byte, without newline translation.
+    static_cast<void>(_setmode(_fileno(stdout), _O_BINARY));
+
+    fsb::ProbePool pool(static_cast<size_t>(config.probe_threads_));
+    const fsb::HeadlessStats kStats = fsb::ListWindows(source, pool, command_line.headless_,
+        stdout);
+
+    // Failures are recorded while listing and only written out once it is done.
+    WriteErrors();
+
+    if (command_line.timing_) {
+        const double kTotalMilliseconds = static_cast<double>(kStats.total_) / 1e6;
+        std::fprintf(stderr,
+            "%zu records from %zu windows, first after %.3f ms, total %.3f ms (%.0f records/s), "
+            "%zu executable and %zu font queries\n",
+            kStats.records_, kStats.windows_, static_cast<double>(kStats.first_record_) / 1e6,
+            kTotalMilliseconds,
+            kTotalMilliseconds > 0.0 ? kStats.records_ * 1000.0 / kTotalMilliseconds : 0.0,
+            kStats.file_name_queries_, kStats.font_queries_);
+    }
+    return 0;
+}
 
+//! Runs --replay without --list: replays the refreshes and events of a trace through the
+//! enumeration and window table, and prints how long the recorded calls and the replayed steps
+//! took.
+int RunReplay(const fsb::CommandLine& command_line, const fsb::Config& config) {
+    std::string report;
+    if (!fsb::ReplayTraceFile(command_line.replay_path_, command_line.replay_speed_, config,
+        &report)) {
+        std::fprintf(stderr, "Cannot read the trace %s.\n", command_line.replay_path_.c_str());
+        return 1;
+    }
+    std::printf("%s", report.c_str());
+    WriteErrors();
     return 0;
 }
+} // namespace
 
+int __stdcall wmain(int argc, wchar_t* argv[]) {
+    fsb::StartupProfiler::Get().Mark("main");
+    fsb::ErrorLog::Get().SetDescriber(fsb::FormatWin32Message);
+
+    std::vector<std::string> arguments;
+    for (int i = 1; i < argc; ++i) {
+        arguments.push_back(fsb::Utf16ToUtf8(argv[i]));
+    }
+
+    fsb::CommandLine command_line;
+    std::string error;
+    if (!fsb::ParseCommandLine(arguments, &command_line, &error)) {
+        std::cerr << error << "\n\n" << fsb::CommandLineUsage();
+        return 2;
+    }
+    if (command_line.help_) {
+        std::cout << fsb::CommandLineUsage();
+        return 0;
+    }
+
+    // A client only talks to the daemon, so it does not even read the config.
+    if (command_line.client_) {
+        static_cast<void>(_setmode(_fileno(stdout), _O_BINARY));
+        return fsb::RunClient(command_line.client_request_);
+    }
+
+    fsb::Config config = fsb::ParseConfig();
+    if (!command_line.replay_path_.empty() && !command_line.list_) {
+        return RunReplay(command_line, config);
+    }
+
+    // --replay cannot be combined with --record, so a replayed desktop is never recorded.
+    if (!command_line.replay_path_.empty()) {
+        fsb::ReplayWindowSource source(command_line.replay_speed_);
+        if (!source.Open(command_line.replay_path_)) {
+            std::fprintf(stderr, "Cannot read the trace %s.\n", command_line.replay_path_.c_str());
+            return 1;
+        }
+        return RunHeadless(command_line, config, source);
+    }
+
+    LiveWindowSource live_source;
+    if (!live_source.Open(command_line)) {
+        return 1;
+    }
+    fsb::WindowSource& window_source = live_source.get();
+
+    if (command_line.list_) {
+        return RunHeadless(command_line, config, window_source);
+    }
+    if (command_line.daemon_) {
+        return fsb::Daemon(config, window_source).Run();
+    }
+    fsb::StartupProfiler::Get().Mark("config parsed");
+    fsb::StartupProfiler::Get().SetEnabled(command_line.profile_startup_);
+
+    fsb::RenderStats render_stats = {};
+    {
+        fsb::Console console(config, window_source);
+        fsb::StartupProfiler::Get().Mark("console ready");
+
+        console.ShowMenu();
+        render_stats = console.render_stats();
+    }
+
+    // Printed once the console is restored, so it is not drawn over.
+    if (command_line.profile_startup_) {
+        std::cerr << fsb::StartupProfiler::Get().FormatReport();
+    }
+    if (command_line.frame_stats_) {
+        std::cerr << fsb::FormatRenderStats(render_stats);
+    }
+    return 0;
+}
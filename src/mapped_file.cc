@@ -0,0 +1,108 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "mapped_file.h"
+
+#include <filesystem>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fsb {
+#ifdef _WIN32
+MappedFile::MappedFile() : data_(nullptr), size_(0), mapping_(nullptr) {}
+#else
+MappedFile::MappedFile() : data_(nullptr), size_(0) {}
+#endif
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const std::string& path) {
+    Close();
+
+    // A missing file is the normal case, so failures are not reported.
+    HANDLE file = CreateFileW(std::filesystem::u8path(path).c_str(), GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        static_cast<void>(CloseHandle(file));
+        return false;
+    }
+    // The view keeps the mapping alive, and the mapping the file.
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    static_cast<void>(CloseHandle(file));
+    if (mapping == nullptr) {
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        static_cast<void>(CloseHandle(mapping));
+        return false;
+    }
+
+    mapping_ = mapping;
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data_ != nullptr) {
+        static_cast<void>(UnmapViewOfFile(data_));
+        static_cast<void>(CloseHandle(mapping_));
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mapping_ = nullptr;
+}
+#else
+bool MappedFile::Open(const std::string& path) {
+    Close();
+
+    const int kFile = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (kFile < 0) {
+        return false;
+    }
+
+    struct stat status = {};
+    if (fstat(kFile, &status) != 0 || status.st_size == 0) {
+        static_cast<void>(close(kFile));
+        return false;
+    }
+    // The mapping stays valid once the descriptor is closed.
+    void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE,
+        kFile, 0);
+    static_cast<void>(close(kFile));
+    if (view == MAP_FAILED) {
+        return false;
+    }
+
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = static_cast<size_t>(status.st_size);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data_ != nullptr) {
+        static_cast<void>(munmap(const_cast<uint8_t*>(data_), size_));
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+#endif
+} // namespace fsb
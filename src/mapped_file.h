@@ -0,0 +1,43 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_MAPPED_FILE_H_
+#define FSB_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace fsb {
+//! @brief Read-only view of a whole file mapped into memory.
+//!
+//! Reading through the mapping costs no copy, and pages that are never touched are never read.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    //! @brief Maps a file, unmapping the previous one.
+    //!
+    //! @param path UTF-8 path.
+    //! @returns Returns false if the file does not exist, is empty or cannot be mapped.
+    bool Open(const std::string& path);
+    void Close();
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+#ifdef _WIN32
+    void* mapping_;
+#endif
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_MAPPED_FILE_H_
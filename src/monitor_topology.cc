@@ -0,0 +1,149 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "monitor_topology.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace fsb {
+namespace {
+// Rectangles are half-open, [left, right) by [top, bottom), and computed in 64 bits so windows
+// far off screen cannot overflow.
+int64_t Overlap(int64_t begin_a, int64_t end_a, int64_t begin_b, int64_t end_b) {
+    return std::max<int64_t>(0, std::min(end_a, end_b) - std::max(begin_a, begin_b));
+}
+
+int64_t Gap(int64_t begin_a, int64_t end_a, int64_t begin_b, int64_t end_b) {
+    return std::max<int64_t>({0, begin_b - end_a, begin_a - end_b});
+}
+
+//! Returns the index of the cell containing coordinate, clamped to the cells.
+size_t CellIndex(const std::vector<int32_t>& edges, int64_t coordinate) {
+    const auto kIt = std::upper_bound(edges.begin(), edges.end(), coordinate);
+    const size_t kIndex = kIt == edges.begin() ? 0 : static_cast<size_t>(kIt - edges.begin()) - 1;
+    return std::min(kIndex, edges.size() - 2);
+}
+} // namespace
+
+MonitorTopology::MonitorTopology(std::vector<MonitorInfo> monitors)
+    : monitors_(std::move(monitors)) {
+    if (monitors_.empty()) {
+        return;
+    }
+
+    for (const MonitorInfo& monitor : monitors_) {
+        edges_x_.push_back(monitor.position_.x);
+        edges_x_.push_back(monitor.position_.x + monitor.size_.x);
+        edges_y_.push_back(monitor.position_.y);
+        edges_y_.push_back(monitor.position_.y + monitor.size_.y);
+    }
+    for (std::vector<int32_t>* edges : {&edges_x_, &edges_y_}) {
+        std::sort(edges->begin(), edges->end());
+        edges->erase(std::unique(edges->begin(), edges->end()), edges->end());
+    }
+
+    // Monitors only overlap when mirrored, in which case the first one enumerated wins.
+    const size_t kColumns = edges_x_.size() - 1;
+    const size_t kRows = edges_y_.size() - 1;
+    cells_.assign(kColumns * kRows, -1);
+    for (size_t i = monitors_.size(); i-- > 0;) {
+        const MonitorInfo& kMonitor = monitors_[i];
+        const auto kFirstColumn = static_cast<size_t>(std::lower_bound(edges_x_.begin(),
+            edges_x_.end(), kMonitor.position_.x) - edges_x_.begin());
+        const auto kEndColumn = static_cast<size_t>(std::lower_bound(edges_x_.begin(),
+            edges_x_.end(), kMonitor.position_.x + kMonitor.size_.x) - edges_x_.begin());
+        const auto kFirstRow = static_cast<size_t>(std::lower_bound(edges_y_.begin(),
+            edges_y_.end(), kMonitor.position_.y) - edges_y_.begin());
+        const auto kEndRow = static_cast<size_t>(std::lower_bound(edges_y_.begin(),
+            edges_y_.end(), kMonitor.position_.y + kMonitor.size_.y) - edges_y_.begin());
+        for (size_t row = kFirstRow; row < kEndRow; ++row) {
+            for (size_t column = kFirstColumn; column < kEndColumn; ++column) {
+                cells_[row * kColumns + column] = static_cast<int32_t>(i);
+            }
+        }
+    }
+}
+
+int MonitorTopology::FindMonitor(SizeVec2 position, SizeVec2 size) const {
+    if (monitors_.empty()) {
+        return -1;
+    }
+
+    const int64_t kLeft = position.x;
+    const int64_t kTop = position.y;
+    const int64_t kRight = kLeft + std::max(size.x, 0);
+    const int64_t kBottom = kTop + std::max(size.y, 0);
+    const size_t kColumns = edges_x_.size() - 1;
+
+    // Monitors are few, so the areas fit on the stack for any realistic desktop.
+    constexpr size_t kMaxCounted = 32;
+    int64_t areas[kMaxCounted] = {};
+    int best = -1;
+    int64_t best_area = 0;
+    if (kRight > kLeft && kBottom > kTop && monitors_.size() <= kMaxCounted) {
+        const size_t kFirstColumn = CellIndex(edges_x_, kLeft);
+        const size_t kLastColumn = CellIndex(edges_x_, kRight - 1);
+        const size_t kFirstRow = CellIndex(edges_y_, kTop);
+        const size_t kLastRow = CellIndex(edges_y_, kBottom - 1);
+        for (size_t row = kFirstRow; row <= kLastRow; ++row) {
+            const int64_t kHeight = Overlap(kTop, kBottom, edges_y_[row], edges_y_[row + 1]);
+            for (size_t column = kFirstColumn; column <= kLastColumn; ++column) {
+                const int32_t kMonitor = cells_[row * kColumns + column];
+                if (kMonitor < 0) {
+                    continue;
+                }
+                int64_t& area = areas[kMonitor];
+                area += kHeight * Overlap(kLeft, kRight, edges_x_[column], edges_x_[column + 1]);
+                // Ties go to the monitor enumerated first.
+                if (area > best_area || (area == best_area && area > 0 && kMonitor < best)) {
+                    best_area = area;
+                    best = kMonitor;
+                }
+            }
+        }
+    } else if (kRight > kLeft && kBottom > kTop) {
+        for (size_t i = 0; i < monitors_.size(); ++i) {
+            const MonitorInfo& kMonitor = monitors_[i];
+            const int64_t kArea = Overlap(kLeft, kRight, kMonitor.position_.x,
+                int64_t{kMonitor.position_.x} + kMonitor.size_.x)
+                * Overlap(kTop, kBottom, kMonitor.position_.y,
+                    int64_t{kMonitor.position_.y} + kMonitor.size_.y);
+            if (kArea > best_area) {
+                best_area = kArea;
+                best = static_cast<int>(i);
+            }
+        }
+    }
+    return best >= 0 ? best : FindNearest(position, size);
+}
+
+int MonitorTopology::FindNearest(SizeVec2 position, SizeVec2 size) const {
+    const int64_t kLeft = position.x;
+    const int64_t kTop = position.y;
+    const int64_t kRight = kLeft + std::max(size.x, 0);
+    const int64_t kBottom = kTop + std::max(size.y, 0);
+
+    int best = -1;
+    int64_t best_distance = std::numeric_limits<int64_t>::max();
+    for (size_t i = 0; i < monitors_.size(); ++i) {
+        const MonitorInfo& kMonitor = monitors_[i];
+        const int64_t kDx = Gap(kLeft, kRight, kMonitor.position_.x,
+            int64_t{kMonitor.position_.x} + kMonitor.size_.x);
+        const int64_t kDy = Gap(kTop, kBottom, kMonitor.position_.y,
+            int64_t{kMonitor.position_.y} + kMonitor.size_.y);
+        const int64_t kDistance = kDx * kDx + kDy * kDy;
+        if (kDistance < best_distance) {
+            best_distance = kDistance;
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+uint32_t MonitorTopology::DpiAt(SizeVec2 position, SizeVec2 size) const {
+    const int kMonitor = FindMonitor(position, size);
+    return kMonitor < 0 || monitors_[kMonitor].dpi_ == 0 ? kDefaultDpi : monitors_[kMonitor].dpi_;
+}
+} // namespace fsb
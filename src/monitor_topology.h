@@ -0,0 +1,65 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_MONITOR_TOPOLOGY_H_
+#define FSB_MONITOR_TOPOLOGY_H_
+
+#include "base_types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fsb {
+struct MonitorInfo {
+    SizeVec2 position_;
+    SizeVec2 size_;
+    //! The part of the monitor not covered by the taskbar and docked toolbars.
+    SizeVec2 work_position_;
+    SizeVec2 work_size_;
+    //! Effective DPI, 96 at 100% scaling.
+    uint32_t dpi_;
+    bool primary_;
+};
+
+//! @brief Immutable layout of the monitors, for matching windows to monitors without asking the
+//! window system each time.
+//!
+//! The desktop is cut into a grid along every monitor edge, and each cell records the monitor
+//! covering it. A window is matched by visiting only the cells its rectangle touches, which gives
+//! the area it shares with each monitor exactly, however the monitors are arranged.
+//!
+//! @note Safe to share between threads. A new topology is built when the displays change.
+class MonitorTopology {
+public:
+    static constexpr uint32_t kDefaultDpi = 96;
+
+    MonitorTopology() = default;
+    //! @param monitors In enumeration order, which is the order monitor indices refer to.
+    explicit MonitorTopology(std::vector<MonitorInfo> monitors);
+
+    //! @brief Returns the monitor sharing the largest area with a rectangle, or the nearest one
+    //! if it is on none, like MONITOR_DEFAULTTONEAREST. Returns -1 if there are no monitors.
+    int FindMonitor(SizeVec2 position, SizeVec2 size) const;
+    //! @brief Returns the DPI of the monitor a rectangle is on, or kDefaultDpi if there is none.
+    uint32_t DpiAt(SizeVec2 position, SizeVec2 size) const;
+
+    size_t size() const { return monitors_.size(); }
+    bool empty() const { return monitors_.empty(); }
+    const MonitorInfo& operator[](size_t index) const { return monitors_[index]; }
+
+private:
+    int FindNearest(SizeVec2 position, SizeVec2 size) const;
+
+    std::vector<MonitorInfo> monitors_;
+    //! Sorted, distinct x and y coordinates of every monitor edge. Cell (column, row) spans
+    //! [edges_x_[column], edges_x_[column + 1]) by [edges_y_[row], edges_y_[row + 1]).
+    std::vector<int32_t> edges_x_;
+    std::vector<int32_t> edges_y_;
+    //! Monitor covering each cell, row by row, -1 for gaps between monitors.
+    std::vector<int32_t> cells_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_MONITOR_TOPOLOGY_H_
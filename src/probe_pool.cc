@@ -0,0 +1,105 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "probe_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace fsb {
+namespace {
+// Probes spend most of their time blocked on other processes, so use more threads than cores,
+// but keep an upper bound so a desktop full of hung applications cannot spawn an army of threads.
+constexpr size_t kMinimumThreads = 4;
+constexpr size_t kMaximumThreads = 16;
+} // namespace
+
+ProbePool::ProbePool(size_t thread_count) : stopping_(false) {
+    if (thread_count == 0) {
+        thread_count = std::clamp<size_t>(std::thread::hardware_concurrency() * 2,
+            kMinimumThreads, kMaximumThreads);
+    }
+
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.emplace_back(&ProbePool::WorkerMain, this);
+    }
+}
+
+ProbePool::~ProbePool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    jobs_available_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ProbePool::Submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    jobs_available_.notify_one();
+}
+
+void ProbePool::ParallelFor(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+
+    // Shared between the caller and the helper jobs. Held by shared_ptr as helper jobs that are
+    // dequeued after the caller has returned must still be able to see that nothing is left.
+    struct State {
+        std::atomic<size_t> next_index{0};
+        std::atomic<size_t> remaining{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto state = std::make_shared<State>();
+    state->remaining.store(count);
+
+    auto drain = [state, count, &task]() {
+        size_t index;
+        while ((index = state->next_index.fetch_add(1)) < count) {
+            task(index);
+            if (state->remaining.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finished.notify_all();
+            }
+        }
+    };
+
+    // The caller is one of the participants, so only count - 1 helpers can ever be useful.
+    const size_t kHelpers = std::min(workers_.size(), count - 1);
+    for (size_t i = 0; i < kHelpers; ++i) {
+        Submit(drain);
+    }
+
+    drain();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state]() { return state->remaining.load() == 0; });
+}
+
+void ProbePool::WorkerMain() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobs_available_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+            if (stopping_ && jobs_.empty()) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        job();
+    }
+}
+} // namespace fsb
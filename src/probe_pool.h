@@ -0,0 +1,54 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_PROBE_POOL_H_
+#define FSB_PROBE_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fsb {
+//! @brief Bounded pool of worker threads used to probe windows in parallel.
+//!
+//! Most of the time spent probing a window is spent waiting on another process (WM_GETFONT,
+//! OpenProcess, etc.), so the pool is sized for concurrency rather than for the number of cores.
+//! The number of threads is fixed at construction and never grows, no matter how many windows
+//! need to be probed.
+class ProbePool {
+public:
+    //! @param thread_count Number of worker threads. Zero picks a default based on the hardware.
+    explicit ProbePool(size_t thread_count = 0);
+    ~ProbePool();
+
+    ProbePool(const ProbePool&) = delete;
+    ProbePool& operator=(const ProbePool&) = delete;
+
+    //! @brief Queues a job to be run on one of the workers. Does not wait for it to finish.
+    void Submit(std::function<void()> job);
+
+    //! @brief Runs task(index) for every index in [0, count) and waits for all of them.
+    //!
+    //! The calling thread takes part in the work, so this never deadlocks even if every worker is
+    //! busy with previously submitted jobs.
+    void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+    size_t thread_count() const { return workers_.size(); }
+
+private:
+    void WorkerMain();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> jobs_;
+    std::mutex mutex_;
+    std::condition_variable jobs_available_;
+    bool stopping_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_PROBE_POOL_H_
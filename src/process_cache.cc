@@ -0,0 +1,106 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "process_cache.h"
+
+#include "trace.h"
+
+namespace fsb {
+namespace {
+// Incremental updates only touch the processes of the windows that changed, so entries are kept
+// for a few refreshes before being considered dead.
+constexpr uint64_t kMaxIdleRefreshes = 16;
+} // namespace
+
+ProcessCache::ProcessCache(StringPool& strings)
+    : strings_(strings), generation_(0), hits_(0), misses_(0) {}
+
+void ProcessCache::BeginRefresh() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (generation_ - it->second.generation_ >= kMaxIdleRefreshes) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    ++generation_;
+}
+
+std::string_view ProcessCache::GetFileName(WindowSource& source, uint32_t process_id) {
+    // The first worker to ask for a process in this refresh publishes a future for it and checks
+    // it; the others wait for that answer.
+    std::shared_future<std::string_view> file_name;
+    std::shared_future<std::string_view> previous_file_name;
+    uint64_t previous_start_time = kUnknownStartTime;
+    std::promise<std::string_view> resolved;
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation = generation_;
+        auto it = entries_.find(process_id);
+        if (it != entries_.end() && it->second.generation_ == generation_) {
+            file_name = it->second.file_name_;
+        } else {
+            if (it != entries_.end()) {
+                previous_start_time = it->second.start_time_;
+                previous_file_name = it->second.file_name_;
+            }
+            entries_[process_id] = {kUnknownStartTime, generation_, resolved.get_future().share()};
+        }
+    }
+    if (file_name.valid()) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return file_name.get();
+    }
+
+    // A process seen on an earlier refresh only has its start time checked, which is much cheaper
+    // than resolving the full image path again. Unknown start times never match, as a PID that
+    // was reused would otherwise inherit the previous owner's path.
+    uint64_t start_time = kUnknownStartTime;
+    std::string_view result;
+    bool known = false;
+    if (previous_start_time != kUnknownStartTime) {
+        ScopedTrace trace(TracePhase::ProcessStartTime);
+        static_cast<void>(source.GetProcessInfo(process_id, &start_time, nullptr));
+        known = start_time != kUnknownStartTime && start_time == previous_start_time;
+    }
+
+    if (known) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        result = previous_file_name.get();
+    } else {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        std::string path;
+        {
+            ScopedTrace trace(TracePhase::ProcessFileName);
+            static_cast<void>(source.GetProcessInfo(process_id, &start_time, &path));
+        }
+        result = strings_.InternView(path);
+        if (Tracer::Get().enabled()) {
+            Tracer::Get().NoteProcess(process_id, result);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(process_id);
+        if (it != entries_.end() && it->second.generation_ == generation) {
+            it->second.start_time_ = start_time;
+        }
+    }
+    resolved.set_value(result);
+    return result;
+}
+
+size_t ProcessCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void ProcessCache::ResetStatistics() {
+    hits_.store(0, std::memory_order_relaxed);
+    misses_.store(0, std::memory_order_relaxed);
+}
+} // namespace fsb
@@ -0,0 +1,63 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_PROCESS_CACHE_H_
+#define FSB_PROCESS_CACHE_H_
+
+#include "string_pool.h"
+#include "window_source.h"
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace fsb {
+//! @brief Caches per-process metadata (currently the image path) across windows and refreshes.
+//!
+//! A process is identified by its PID together with its start time, so a PID that has been reused
+//! by a new process never returns the previous owner's path. A process whose start time cannot be
+//! read is resolved again on every refresh. Within one refresh each PID is resolved at most once,
+//! opening the process once; on later refreshes the start time is checked once per PID and the
+//! cached path is reused if the process is still the same instance.
+//!
+//! @note Safe to call from multiple probe workers at once. Workers asking for a process that is
+//! already being resolved wait for that result instead of probing it again.
+class ProcessCache {
+public:
+    //! @param strings Pool the resolved paths are interned into.
+    explicit ProcessCache(StringPool& strings);
+
+    //! @brief Starts a new refresh, so every process is checked against its start time again.
+    //! Processes that have not been seen for a while are dropped.
+    void BeginRefresh();
+
+    //! @brief Returns the image path of a process, resolving it through the source on a miss.
+    std::string_view GetFileName(WindowSource& source, uint32_t process_id);
+
+    uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+    size_t size() const;
+    void ResetStatistics();
+
+private:
+    struct Entry {
+        uint64_t start_time_;
+        //! Refresh in which the entry was last validated.
+        uint64_t generation_;
+        std::shared_future<std::string_view> file_name_;
+    };
+
+    StringPool& strings_;
+    mutable std::mutex mutex_;
+    std::unordered_map<uint32_t, Entry> entries_;
+    uint64_t generation_;
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_PROCESS_CACHE_H_
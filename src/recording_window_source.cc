@@ -0,0 +1,114 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "recording_window_source.h"
+
+namespace fsb {
+namespace {
+uint64_t HandleKey(HWND window_handle) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(window_handle));
+}
+} // namespace
+
+RecordingWindowSource::RecordingWindowSource(WindowSource& source, TraceWriter& writer,
+    ErrorReader error_reader)
+    : source_(source), writer_(writer), error_reader_(error_reader) {}
+
+TraceRecord RecordingWindowSource::Begin(TraceCall call, uint64_t key) const {
+    TraceRecord record = {};
+    record.call_ = call;
+    record.key_ = key;
+    record.time_ = writer_.Now();
+    return record;
+}
+
+void RecordingWindowSource::End(TraceRecord* record, uint8_t result) {
+    // Read before anything else can overwrite it.
+    if (result != 0 && error_reader_ != nullptr) {
+        record->error_code_ = error_reader_();
+    }
+    record->latency_ = writer_.Now() - record->time_;
+    record->result_ = result;
+    writer_.Write(*record);
+}
+
+void RecordingWindowSource::EnumerateWindowHandles(std::vector<HWND>* window_handles) {
+    TraceRecord record = Begin(TraceCall::EnumerateWindowHandles, 0);
+    source_.EnumerateWindowHandles(window_handles);
+    record.window_handles_ = *window_handles;
+    End(&record, 0);
+}
+
+bool RecordingWindowSource::GetWindowAttributes(HWND window_handle,
+    WindowAttributes* window_attributes) {
+    TraceRecord record = Begin(TraceCall::GetWindowAttributes, HandleKey(window_handle));
+    const bool kResult = source_.GetWindowAttributes(window_handle, window_attributes);
+    record.attributes_ = *window_attributes;
+    End(&record, kResult ? 0 : 1);
+    return kResult;
+}
+
+bool RecordingWindowSource::GetWindowMetrics(HWND window_handle,
+    WindowMetrics* window_metrics) {
+    TraceRecord record = Begin(TraceCall::GetWindowMetrics, HandleKey(window_handle));
+    const bool kResult = source_.GetWindowMetrics(window_handle, window_metrics);
+    record.metrics_ = *window_metrics;
+    End(&record, kResult ? 0 : 1);
+    return kResult;
+}
+
+ProbeStatus RecordingWindowSource::GetWindowFont(HWND window_handle,
+    uint32_t timeout_milliseconds, std::string* font_name, uint32_t* font_size) {
+    TraceRecord record = Begin(TraceCall::GetWindowFont, HandleKey(window_handle));
+    const ProbeStatus kStatus = source_.GetWindowFont(window_handle, timeout_milliseconds,
+        font_name, font_size);
+    record.text_ = *font_name;
+    record.value_ = *font_size;
+    End(&record, static_cast<uint8_t>(kStatus));
+    return kStatus;
+}
+
+bool RecordingWindowSource::GetWindowProcessId(HWND window_handle, uint32_t* process_id) {
+    TraceRecord record = Begin(TraceCall::GetWindowProcessId, HandleKey(window_handle));
+    const bool kResult = source_.GetWindowProcessId(window_handle, process_id);
+    record.value_ = *process_id;
+    End(&record, kResult ? 0 : 1);
+    return kResult;
+}
+
+bool RecordingWindowSource::GetWindowTitle(HWND window_handle, std::string* title) {
+    TraceRecord record = Begin(TraceCall::GetWindowTitle, HandleKey(window_handle));
+    const bool kResult = source_.GetWindowTitle(window_handle, title);
+    record.text_ = *title;
+    End(&record, kResult ? 0 : 1);
+    return kResult;
+}
+
+bool RecordingWindowSource::GetWindowClassName(HWND window_handle, std::string* class_name) {
+    TraceRecord record = Begin(TraceCall::GetWindowClassName, HandleKey(window_handle));
+    const bool kResult = source_.GetWindowClassName(window_handle, class_name);
+    record.text_ = *class_name;
+    End(&record, kResult ? 0 : 1);
+    return kResult;
+}
+
+bool RecordingWindowSource::GetProcessInfo(uint32_t process_id, uint64_t* start_time,
+    std::string* file_name) {
+    TraceRecord record = Begin(TraceCall::GetProcessInfo, process_id);
+    const bool kResult = source_.GetProcessInfo(process_id, start_time, file_name);
+    record.value_ = *start_time;
+    if (file_name != nullptr) {
+        record.text_ = *file_name;
+    }
+    End(&record, kResult ? 0 : 1);
+    return kResult;
+}
+
+void RecordingWindowSource::ObserveEvents(const std::vector<WindowEvent>& events) {
+    source_.ObserveEvents(events);
+    TraceRecord record = Begin(TraceCall::WindowEvents, 0);
+    record.events_ = events;
+    End(&record, 0);
+}
+} // namespace fsb
@@ -0,0 +1,57 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_RECORDING_WINDOW_SOURCE_H_
+#define FSB_RECORDING_WINDOW_SOURCE_H_
+
+#include "base_types.h"
+#include "window_source.h"
+#include "window_trace.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fsb {
+//! @brief WindowSource that forwards every call to another source and records it, along with
+//! its answer, latency and error code, into a trace (--record).
+//!
+//! Window events are recorded too, as they reach a WindowTable. ReplayWindowSource plays the
+//! trace back, so what a desktop did can be reproduced away from it.
+//!
+//! @note As thread-safe as the wrapped source.
+class RecordingWindowSource : public WindowSource {
+public:
+    //! Returns the last error of the calling thread, e.g. GetLastError.
+    using ErrorReader = uint32_t (*)();
+
+    //! @param error_reader Optional. Read right after a call fails.
+    RecordingWindowSource(WindowSource& source, TraceWriter& writer,
+        ErrorReader error_reader = nullptr);
+
+    void EnumerateWindowHandles(std::vector<HWND>* window_handles) override;
+    bool GetWindowAttributes(HWND window_handle, WindowAttributes* window_attributes) override;
+    bool GetWindowMetrics(HWND window_handle, WindowMetrics* window_metrics) override;
+    ProbeStatus GetWindowFont(HWND window_handle, uint32_t timeout_milliseconds,
+        std::string* font_name, uint32_t* font_size) override;
+    bool GetWindowProcessId(HWND window_handle, uint32_t* process_id) override;
+    bool GetWindowTitle(HWND window_handle, std::string* title) override;
+    bool GetWindowClassName(HWND window_handle, std::string* class_name) override;
+    bool GetProcessInfo(uint32_t process_id, uint64_t* start_time,
+        std::string* file_name) override;
+    void ObserveEvents(const std::vector<WindowEvent>& events) override;
+
+private:
+    //! Starts a record of a call, timed from now.
+    TraceRecord Begin(TraceCall call, uint64_t key) const;
+    //! Times and writes a record. result is 0 on success.
+    void End(TraceRecord* record, uint8_t result);
+
+    WindowSource& source_;
+    TraceWriter& writer_;
+    ErrorReader error_reader_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_RECORDING_WINDOW_SOURCE_H_
@@ -0,0 +1,99 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "render_scheduler.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+namespace fsb {
+namespace {
+RenderScheduler::Clock::duration FrameInterval(int frames_per_second) {
+    if (frames_per_second <= 0) {
+        return RenderScheduler::Clock::duration::zero();
+    }
+    return std::chrono::duration_cast<RenderScheduler::Clock::duration>(
+        std::chrono::seconds(1)) / frames_per_second;
+}
+
+uint64_t Nanoseconds(RenderScheduler::Clock::duration duration) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+} // namespace
+
+RenderScheduler::RenderScheduler(int frames_per_second)
+    : interval_(FrameInterval(frames_per_second)), dirty_(true), changes_(1), painted_(false),
+        stats_{} {}
+
+void RenderScheduler::SetFrameRate(int frames_per_second) {
+    interval_ = FrameInterval(frames_per_second);
+}
+
+void RenderScheduler::Invalidate(Clock::time_point now) {
+    ++changes_;
+    if (!dirty_) {
+        dirty_ = true;
+        dirty_since_ = now;
+    }
+}
+
+RenderScheduler::Clock::time_point RenderScheduler::NextFrame() const {
+    if (!painted_ || interval_ == Clock::duration::zero()) {
+        return dirty_since_;
+    }
+    return std::max({dirty_since_, frame_start_ + interval_,
+        frame_end_ + (frame_end_ - frame_start_)});
+}
+
+bool RenderScheduler::ShouldPaint(Clock::time_point now, Clock::duration* wait) const {
+    *wait = Clock::duration::zero();
+    if (!dirty_) {
+        return false;
+    }
+    const Clock::time_point kNextFrame = NextFrame();
+    if (now < kNextFrame) {
+        *wait = kNextFrame - now;
+        return false;
+    }
+    return true;
+}
+
+void RenderScheduler::BeginFrame(Clock::time_point now) {
+    // Every slot the frame could have gone out in since the change, but did not.
+    if (painted_ && interval_ != Clock::duration::zero()) {
+        const Clock::time_point kFirstSlot = std::max(dirty_since_, frame_start_ + interval_);
+        if (now > kFirstSlot) {
+            stats_.dropped_ += static_cast<uint64_t>((now - kFirstSlot) / interval_);
+        }
+    }
+    stats_.coalesced_ += changes_ > 1 ? changes_ - 1 : 0;
+    ++stats_.frames_;
+
+    dirty_ = false;
+    changes_ = 0;
+    painted_ = true;
+    frame_start_ = now;
+}
+
+void RenderScheduler::EndFrame(Clock::time_point now) {
+    frame_end_ = now;
+    const uint64_t kPaintTime = Nanoseconds(frame_end_ - frame_start_);
+    stats_.paint_time_ += kPaintTime;
+    stats_.max_paint_time_ = std::max(stats_.max_paint_time_, kPaintTime);
+}
+
+std::string FormatRenderStats(const RenderStats& stats) {
+    char line[192];
+    const double kAverage = stats.frames_ != 0
+        ? static_cast<double>(stats.paint_time_) / static_cast<double>(stats.frames_) / 1e6 : 0.0;
+    std::snprintf(line, sizeof(line),
+        "%" PRIu64 " frames painted, %" PRIu64 " changes coalesced, %" PRIu64
+        " frames dropped, paint %.3f ms on average, %.3f ms at most\n",
+        stats.frames_, stats.coalesced_, stats.dropped_, kAverage,
+        static_cast<double>(stats.max_paint_time_) / 1e6);
+    return line;
+}
+} // namespace fsb
@@ -0,0 +1,86 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_RENDER_SCHEDULER_H_
+#define FSB_RENDER_SCHEDULER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace fsb {
+//! @brief What a RenderScheduler did so far.
+struct RenderStats {
+    //! Frames painted.
+    uint64_t frames_;
+    //! Changes that were merged into a frame another change had already asked for.
+    uint64_t coalesced_;
+    //! Frame slots that went by without a frame while a change was waiting, because the loop was
+    //! busy or painting was falling behind.
+    uint64_t dropped_;
+    //! Nanoseconds spent painting, in total and for the slowest frame.
+    uint64_t paint_time_;
+    uint64_t max_paint_time_;
+};
+
+//! @brief Decides when the menu is painted, so a burst of changes costs one frame.
+//!
+//! Everything that changes what is on screen only marks the view dirty. Whenever the loop is
+//! about to sleep it asks whether to paint, and the answer is yes at most once per frame:
+//! - no sooner than the frame interval after the previous frame started;
+//! - no sooner than the previous frame took after it ended, so painting never takes more than
+//!   half of the loop when frames are slow and input keeps being read in between.
+//!
+//! A frame shows every change made before it started, whatever their number.
+//!
+//! @note Not thread-safe. Used from the loop thread only.
+class RenderScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    //! @param frames_per_second Upper bound of the frame rate, 0 to paint whenever the loop is
+    //! idle. Starts dirty, so the first frame is painted right away.
+    explicit RenderScheduler(int frames_per_second);
+
+    void SetFrameRate(int frames_per_second);
+
+    //! @brief Marks the view as changed at now.
+    void Invalidate(Clock::time_point now);
+    bool dirty() const { return dirty_; }
+
+    //! @brief Returns whether a frame should be painted now.
+    //!
+    //! @param wait Set to the time left until the next frame may be painted when the view is
+    //! dirty but the frame is not due yet, zero otherwise.
+    bool ShouldPaint(Clock::time_point now, Clock::duration* wait) const;
+
+    //! @brief Starts a frame. Clears the dirty mark, so changes made while painting ask for the
+    //! next frame.
+    void BeginFrame(Clock::time_point now);
+    //! @brief Ends the frame started by BeginFrame.
+    void EndFrame(Clock::time_point now);
+
+    const RenderStats& stats() const { return stats_; }
+
+private:
+    //! Earliest time the next frame may start.
+    Clock::time_point NextFrame() const;
+
+    Clock::duration interval_;
+    bool dirty_;
+    //! When the view became dirty.
+    Clock::time_point dirty_since_;
+    //! Invalidate calls since the last frame started.
+    uint64_t changes_;
+    bool painted_;
+    Clock::time_point frame_start_;
+    Clock::time_point frame_end_;
+    RenderStats stats_;
+};
+
+//! @brief Formats frames painted, changes coalesced, frames dropped and paint times as one line.
+std::string FormatRenderStats(const RenderStats& stats);
+} // namespace fsb
+
+#endif // #ifndef FSB_RENDER_SCHEDULER_H_
@@ -0,0 +1,253 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "replay_window_source.h"
+
+#include "trace.h"
+#include "window_probe.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <thread>
+#include <utility>
+
+namespace fsb {
+namespace {
+uint64_t HandleKey(HWND window_handle) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(window_handle));
+}
+
+//! Recorded nanoseconds divided by the speed.
+std::chrono::nanoseconds Scale(uint64_t nanoseconds, double speed) {
+    return std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(nanoseconds) / speed));
+}
+} // namespace
+
+ReplayWindowSource::ReplayWindowSource(double speed) : speed_(speed), misses_(0) {}
+
+bool ReplayWindowSource::Open(const std::string& path) {
+    if (!reader_.Open(path)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (std::unordered_map<uint64_t, Answers>& answers : answers_) {
+        answers.clear();
+    }
+    const std::vector<TraceRecord>& kRecords = reader_.records();
+    for (size_t i = 0; i < kRecords.size(); ++i) {
+        if (kRecords[i].call_ == TraceCall::WindowEvents) {
+            continue;
+        }
+        answers_[static_cast<size_t>(kRecords[i].call_)][kRecords[i].key_].records_.push_back(i);
+    }
+    misses_.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+const TraceRecord* ReplayWindowSource::Take(TraceCall call, uint64_t key) {
+    const TraceRecord* record = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::unordered_map<uint64_t, Answers>& call_answers = answers_[static_cast<size_t>(call)];
+        const auto kAnswers = call_answers.find(key);
+        if (kAnswers != call_answers.end()) {
+            Answers& answers = kAnswers->second;
+            record = &reader_.records()[answers.records_[answers.next_]];
+            if (answers.next_ + 1 < answers.records_.size()) {
+                ++answers.next_;
+            }
+        }
+    }
+
+    if (record == nullptr) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    // Outside the lock, so concurrent probes overlap the way they did when recorded.
+    if (speed_ > 0.0 && record->latency_ != 0) {
+        std::this_thread::sleep_for(Scale(record->latency_, speed_));
+    }
+    return record;
+}
+
+void ReplayWindowSource::EnumerateWindowHandles(std::vector<HWND>* window_handles) {
+    const TraceRecord* record = Take(TraceCall::EnumerateWindowHandles, 0);
+    if (record == nullptr) {
+        window_handles->clear();
+        return;
+    }
+    *window_handles = record->window_handles_;
+}
+
+bool ReplayWindowSource::GetWindowAttributes(HWND window_handle,
+    WindowAttributes* window_attributes) {
+    const TraceRecord* record = Take(TraceCall::GetWindowAttributes, HandleKey(window_handle));
+    if (record == nullptr) {
+        return false;
+    }
+    *window_attributes = record->attributes_;
+    return record->result_ == 0;
+}
+
+bool ReplayWindowSource::GetWindowMetrics(HWND window_handle, WindowMetrics* window_metrics) {
+    const TraceRecord* record = Take(TraceCall::GetWindowMetrics, HandleKey(window_handle));
+    if (record == nullptr) {
+        return false;
+    }
+    *window_metrics = record->metrics_;
+    return record->result_ == 0;
+}
+
+ProbeStatus ReplayWindowSource::GetWindowFont(HWND window_handle, uint32_t timeout_milliseconds,
+    std::string* font_name, uint32_t* font_size) {
+    static_cast<void>(timeout_milliseconds);
+    const TraceRecord* record = Take(TraceCall::GetWindowFont, HandleKey(window_handle));
+    if (record == nullptr) {
+        return ProbeStatus::Failed;
+    }
+    *font_name = record->text_;
+    *font_size = static_cast<uint32_t>(record->value_);
+    return static_cast<ProbeStatus>(record->result_);
+}
+
+bool ReplayWindowSource::GetWindowProcessId(HWND window_handle, uint32_t* process_id) {
+    const TraceRecord* record = Take(TraceCall::GetWindowProcessId, HandleKey(window_handle));
+    if (record == nullptr) {
+        return false;
+    }
+    *process_id = static_cast<uint32_t>(record->value_);
+    return record->result_ == 0;
+}
+
+bool ReplayWindowSource::GetWindowTitle(HWND window_handle, std::string* title) {
+    const TraceRecord* record = Take(TraceCall::GetWindowTitle, HandleKey(window_handle));
+    if (record == nullptr) {
+        return false;
+    }
+    *title = record->text_;
+    return record->result_ == 0;
+}
+
+bool ReplayWindowSource::GetWindowClassName(HWND window_handle, std::string* class_name) {
+    const TraceRecord* record = Take(TraceCall::GetWindowClassName, HandleKey(window_handle));
+    if (record == nullptr) {
+        return false;
+    }
+    *class_name = record->text_;
+    return record->result_ == 0;
+}
+
+bool ReplayWindowSource::GetProcessInfo(uint32_t process_id, uint64_t* start_time,
+    std::string* file_name) {
+    const TraceRecord* record = Take(TraceCall::GetProcessInfo, process_id);
+    *start_time = record == nullptr ? kUnknownStartTime : record->value_;
+    if (file_name != nullptr) {
+        // A call that only asked for the start time recorded no path.
+        *file_name = record == nullptr || record->text_.empty() ? "???" : record->text_;
+    }
+    return record != nullptr && record->result_ == 0;
+}
+
+void ReplayTrace(ReplayWindowSource& source, StringPool& strings, ProbePool& pool,
+    const Config& config, WindowTable* table, std::vector<ReplayStep>* steps) {
+    // Records are written as calls complete, so steps are put back in the order they started.
+    const std::vector<TraceRecord>& kRecords = source.records();
+    std::vector<const TraceRecord*> timeline;
+    for (const TraceRecord& record : kRecords) {
+        if (record.call_ == TraceCall::EnumerateWindowHandles
+            || record.call_ == TraceCall::WindowEvents) {
+            timeline.push_back(&record);
+        }
+    }
+    std::stable_sort(timeline.begin(), timeline.end(),
+        [](const TraceRecord* left, const TraceRecord* right) {
+            return left->time_ < right->time_;
+        });
+
+    steps->clear();
+    steps->reserve(timeline.size());
+    const auto kStart = std::chrono::steady_clock::now();
+    std::vector<ProcessData> windows;
+    for (const TraceRecord* record : timeline) {
+        if (source.speed() > 0.0) {
+            std::this_thread::sleep_until(kStart + Scale(record->time_, source.speed()));
+        }
+
+        const uint64_t kStepStart = Tracer::Now();
+        if (record->call_ == TraceCall::EnumerateWindowHandles) {
+            EnumerateWindows(source, strings, pool, config, &windows);
+            table->Reset(std::move(windows));
+            windows.clear();
+        } else {
+            static_cast<void>(table->Apply(record->events_, source, strings, config));
+        }
+        steps->push_back({record->call_, record->time_, Tracer::Now() - kStepStart,
+            table->size()});
+    }
+}
+
+std::string FormatReplaySummary(const std::vector<ReplayStep>& steps) {
+    std::string summary;
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-24s %8s %10s %10s %10s %12s %12s\n", "step", "count",
+        "p50 ms", "p99 ms", "max ms", "total ms", "slowest at");
+    summary += line;
+    for (const TraceCall kCall : {TraceCall::EnumerateWindowHandles, TraceCall::WindowEvents}) {
+        std::vector<uint64_t> durations;
+        uint64_t total = 0;
+        const ReplayStep* slowest = nullptr;
+        for (const ReplayStep& step : steps) {
+            if (step.call_ != kCall) {
+                continue;
+            }
+            durations.push_back(step.duration_);
+            total += step.duration_;
+            if (slowest == nullptr || step.duration_ > slowest->duration_) {
+                slowest = &step;
+            }
+        }
+        if (durations.empty()) {
+            continue;
+        }
+        std::sort(durations.begin(), durations.end());
+        const size_t kCount = durations.size();
+        const std::string kName(TraceCallName(kCall));
+        std::snprintf(line, sizeof(line), "%-24s %8zu %10.3f %10.3f %10.3f %12.3f %10.3f s\n",
+            kName.c_str(), kCount, static_cast<double>(durations[kCount / 2]) / 1e6,
+            static_cast<double>(durations[kCount * 99 / 100]) / 1e6,
+            static_cast<double>(durations.back()) / 1e6, static_cast<double>(total) / 1e6,
+            static_cast<double>(slowest->time_) / 1e9);
+        summary += line;
+    }
+    return summary;
+}
+
+bool ReplayTraceFile(const std::string& path, double speed, const Config& config,
+    std::string* report) {
+    ReplayWindowSource source(speed);
+    if (!source.Open(path)) {
+        return false;
+    }
+    *report = FormatTraceSummary(source.records());
+    if (source.truncated()) {
+        *report += "The trace ends in the middle of a record, which was skipped.\n";
+    }
+
+    StringPool strings;
+    ProbePool pool(static_cast<size_t>(config.probe_threads_));
+    WindowTable table;
+    std::vector<ReplayStep> steps;
+    ReplayTrace(source, strings, pool, config, &table, &steps);
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "%zu windows at the end, %" PRIu64
+        " calls without a recorded answer\n", table.size(), source.misses());
+    *report += "\n" + FormatReplaySummary(steps) + line;
+    return true;
+}
+} // namespace fsb
@@ -0,0 +1,119 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_REPLAY_WINDOW_SOURCE_H_
+#define FSB_REPLAY_WINDOW_SOURCE_H_
+
+#include "base_types.h"
+#include "config.h"
+#include "probe_pool.h"
+#include "string_pool.h"
+#include "window_source.h"
+#include "window_table.h"
+#include "window_trace.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fsb {
+//! @brief WindowSource that answers from a trace written by RecordingWindowSource.
+//!
+//! Every call is answered with what the same call on the same window or process answered when
+//! recorded, in recorded order, so the enumeration and event paths see the recorded desktop
+//! whichever thread asks first. Once the answers of a call are used up the last one repeats.
+//! Calls take as long as they did when recorded, divided by the speed.
+//!
+//! @note Thread-safe.
+class ReplayWindowSource : public WindowSource {
+public:
+    //! @param speed How many times faster than recorded calls are answered, 0 for at once.
+    explicit ReplayWindowSource(double speed = 1.0);
+
+    //! @brief Loads a trace.
+    //!
+    //! @param path UTF-8 path.
+    //! @returns Returns false if the file cannot be read or is not a trace.
+    bool Open(const std::string& path);
+
+    void EnumerateWindowHandles(std::vector<HWND>* window_handles) override;
+    bool GetWindowAttributes(HWND window_handle, WindowAttributes* window_attributes) override;
+    bool GetWindowMetrics(HWND window_handle, WindowMetrics* window_metrics) override;
+    ProbeStatus GetWindowFont(HWND window_handle, uint32_t timeout_milliseconds,
+        std::string* font_name, uint32_t* font_size) override;
+    bool GetWindowProcessId(HWND window_handle, uint32_t* process_id) override;
+    bool GetWindowTitle(HWND window_handle, std::string* title) override;
+    bool GetWindowClassName(HWND window_handle, std::string* class_name) override;
+    bool GetProcessInfo(uint32_t process_id, uint64_t* start_time,
+        std::string* file_name) override;
+
+    double speed() const { return speed_; }
+    const std::vector<TraceRecord>& records() const { return reader_.records(); }
+    bool truncated() const { return reader_.truncated(); }
+    //! Number of calls the trace had no answer for, which then failed.
+    uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+    struct Answers {
+        //! Indices of the records, in recorded order.
+        std::vector<size_t> records_;
+        size_t next_ = 0;
+    };
+
+    //! Returns the next recorded answer of a call, after waiting for as long as it took, or
+    //! nullptr if there is none.
+    const TraceRecord* Take(TraceCall call, uint64_t key);
+
+    double speed_;
+    TraceReader reader_;
+    std::mutex mutex_;
+    //! Answers per call, by window handle or process ID.
+    std::unordered_map<uint64_t, Answers> answers_[static_cast<size_t>(TraceCall::Count)];
+    std::atomic<uint64_t> misses_;
+};
+
+//! @brief Time one step of a replayed trace took.
+struct ReplayStep {
+    //! EnumerateWindowHandles for a full enumeration, WindowEvents for a batch of events.
+    TraceCall call_;
+    //! When the step started in the trace, in nanoseconds.
+    uint64_t time_;
+    //! How long the step took when replayed, in nanoseconds.
+    uint64_t duration_;
+    //! Rows in the table after the step.
+    size_t windows_;
+};
+
+//! @brief Replays the timeline of a trace through the same paths the menu uses: every recorded
+//! enumeration runs EnumerateWindows and resets the table, every recorded batch of events runs
+//! WindowTable::Apply.
+//!
+//! Steps start at their recorded time divided by the speed of the source, or back to back if it
+//! is 0, so a slow refresh from the field can be profiled as it happened or as fast as possible.
+//!
+//! @param steps Receives one entry per step.
+void ReplayTrace(ReplayWindowSource& source, StringPool& strings, ProbePool& pool,
+    const Config& config, WindowTable* table, std::vector<ReplayStep>* steps);
+
+//! @brief Summarizes replayed steps per kind: count, p50/p99/max and total duration, and the
+//! slowest step with its time in the trace.
+std::string FormatReplaySummary(const std::vector<ReplayStep>& steps);
+
+//! @brief Replays a trace file with ReplayTrace and describes it, which is what --replay does
+//! without --list and what a profiler can be pointed at on any platform.
+//!
+//! @param path UTF-8 path.
+//! @param speed See ReplayWindowSource.
+//! @param report Receives FormatTraceSummary of the recorded calls, FormatReplaySummary of the
+//! replayed steps and the windows and misses at the end.
+//! @returns Returns false if the file cannot be read or is not a trace.
+bool ReplayTraceFile(const std::string& path, double speed, const Config& config,
+    std::string* report);
+} // namespace fsb
+
+#endif // #ifndef FSB_REPLAY_WINDOW_SOURCE_H_
@@ -0,0 +1,434 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "rule_engine.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <utility>
+
+namespace fsb {
+namespace {
+//! Highest monitor index a rule may name.
+constexpr int kMaxMonitor = 64;
+
+struct FieldName {
+    std::string_view name_;
+    RuleField field_;
+};
+
+constexpr FieldName kFieldNames[] = {
+    {"class", RuleField::Class},
+    {"exe", RuleField::Exe},
+    {"path", RuleField::Path},
+    {"title", RuleField::Title},
+};
+
+char ToLower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+void ToLower(std::string_view text, std::string* lowercase) {
+    lowercase->resize(text.size());
+    std::transform(text.begin(), text.end(), lowercase->begin(),
+        [](char c) { return ToLower(c); });
+}
+
+bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+void SkipSpaces(std::string_view* text) {
+    while (!text->empty() && IsSpace(text->front())) {
+        text->remove_prefix(1);
+    }
+}
+
+//! Reads one "key=value" token, where value may be double-quoted. Returns false if malformed.
+bool ReadAssignment(std::string_view* text, std::string_view* key, std::string_view* value) {
+    const size_t kEqualPosition = text->find('=');
+    if (kEqualPosition == std::string_view::npos || kEqualPosition == 0) {
+        return false;
+    }
+    *key = text->substr(0, kEqualPosition);
+    if (std::any_of(key->begin(), key->end(), IsSpace)) {
+        return false;
+    }
+    text->remove_prefix(kEqualPosition + 1);
+
+    if (!text->empty() && text->front() == '"') {
+        const size_t kClose = text->find('"', 1);
+        if (kClose == std::string_view::npos) {
+            return false;
+        }
+        *value = text->substr(1, kClose - 1);
+        text->remove_prefix(kClose + 1);
+    } else {
+        size_t end = 0;
+        while (end < text->size() && !IsSpace((*text)[end])) {
+            ++end;
+        }
+        *value = text->substr(0, end);
+        text->remove_prefix(end);
+    }
+
+    // Tokens must be separated by whitespace.
+    return text->empty() || IsSpace(text->front());
+}
+
+bool ParseField(std::string_view name, RuleField* field) {
+    for (const FieldName& field_name : kFieldNames) {
+        if (field_name.name_ == name) {
+            *field = field_name.field_;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ParseAction(std::string_view text, RuleAction* action) {
+    SkipSpaces(&text);
+    constexpr std::string_view kBorderless = "borderless";
+    if (text.substr(0, kBorderless.size()) != kBorderless) {
+        return false;
+    }
+    text.remove_prefix(kBorderless.size());
+    if (!text.empty() && !IsSpace(text.front())) {
+        return false;
+    }
+
+    action->monitor_ = 0;
+    SkipSpaces(&text);
+    while (!text.empty()) {
+        std::string_view key;
+        std::string_view value;
+        if (!ReadAssignment(&text, &key, &value) || key != "monitor") {
+            return false;
+        }
+        int monitor = 0;
+        const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(),
+            monitor);
+        if (error != std::errc() || end != value.data() + value.size() || monitor < 1
+            || monitor > kMaxMonitor) {
+            return false;
+        }
+        action->monitor_ = monitor;
+        SkipSpaces(&text);
+    }
+    return true;
+}
+
+bool ParseRule(std::string_view line, Rule* rule) {
+    const size_t kArrow = line.find("->");
+    return kArrow != std::string_view::npos && ParseAction(line.substr(kArrow + 2), &rule->action_)
+        && ParseConditions(line.substr(0, kArrow), &rule->conditions_);
+}
+
+bool IsGlob(std::string_view pattern) {
+    return pattern.find_first_of("*?") != std::string_view::npos;
+}
+
+std::string_view BaseName(std::string_view path) {
+    const size_t kSeparator = path.find_last_of("\\/");
+    return kSeparator == std::string_view::npos ? path : path.substr(kSeparator + 1);
+}
+} // namespace
+
+bool ParseConditions(std::string_view text, std::vector<RuleCondition>* conditions) {
+    const size_t kFirst = conditions->size();
+    SkipSpaces(&text);
+    while (!text.empty()) {
+        std::string_view key;
+        std::string_view value;
+        RuleField field;
+        if (!ReadAssignment(&text, &key, &value) || !ParseField(key, &field)) {
+            return false;
+        }
+        RuleCondition condition = {field, {}};
+        ToLower(value, &condition.pattern_);
+        conditions->push_back(std::move(condition));
+        SkipSpaces(&text);
+    }
+    return conditions->size() > kFirst;
+}
+
+size_t ParseRules(std::string_view text, std::vector<Rule>* rules) {
+    constexpr std::string_view kByteOrderMark = "\xEF\xBB\xBF";
+    if (text.substr(0, kByteOrderMark.size()) == kByteOrderMark) {
+        text.remove_prefix(kByteOrderMark.size());
+    }
+
+    size_t invalid_lines = 0;
+    size_t line_number = 0;
+    while (!text.empty()) {
+        const size_t kLineEnd = text.find('\n');
+        std::string_view line = text.substr(0, kLineEnd);
+        text.remove_prefix(kLineEnd == std::string_view::npos ? text.size() : kLineEnd + 1);
+        ++line_number;
+
+        SkipSpaces(&line);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        Rule rule = {};
+        rule.line_ = line_number;
+        if (ParseRule(line, &rule)) {
+            rules->push_back(std::move(rule));
+        } else {
+            ++invalid_lines;
+        }
+    }
+    return invalid_lines;
+}
+
+GlobSet::GlobSet() : has_resting_(false), state_bytes_(0), start_(kUnknown) {}
+
+uint32_t GlobSet::Add(std::string_view pattern) {
+    patterns_.emplace_back(pattern);
+    // The automaton is rebuilt for the new pattern set on the next match.
+    start_ = kUnknown;
+    return static_cast<uint32_t>(patterns_.size() - 1);
+}
+
+void GlobSet::Clear() {
+    patterns_.clear();
+    for (std::vector<Position>& next : resting_next_) {
+        next.clear();
+    }
+    resting_accepts_.clear();
+    has_resting_ = false;
+    states_.clear();
+    state_index_.clear();
+    state_bytes_ = 0;
+    start_ = kUnknown;
+}
+
+void GlobSet::Close(std::vector<Position>* positions) const {
+    const size_t kCount = positions->size();
+    for (size_t i = 0; i < kCount; ++i) {
+        Position position = (*positions)[i];
+        const std::string& pattern = patterns_[position >> 32];
+        while (static_cast<uint32_t>(position) < pattern.size()
+            && pattern[static_cast<uint32_t>(position)] == '*') {
+            ++position;
+            positions->push_back(position);
+        }
+    }
+    std::sort(positions->begin(), positions->end());
+    positions->erase(std::unique(positions->begin(), positions->end()), positions->end());
+}
+
+void GlobSet::IndexResting() {
+    for (std::vector<Position>& next : resting_next_) {
+        next.clear();
+    }
+    resting_accepts_.clear();
+    has_resting_ = false;
+    for (size_t i = 0; i < patterns_.size(); ++i) {
+        const std::string& pattern = patterns_[i];
+        if (pattern.empty() || pattern[0] != '*') {
+            continue;
+        }
+        // A leading run of '*' loops on every byte, so its positions never leave a state.
+        has_resting_ = true;
+        const size_t kOffset = pattern.find_first_not_of('*');
+        const Position kPosition = (static_cast<Position>(i) << 32) | static_cast<uint32_t>(
+            kOffset == std::string::npos ? pattern.size() : kOffset);
+        if (kOffset == std::string::npos) {
+            resting_accepts_.push_back(static_cast<uint32_t>(i));
+        } else if (pattern[kOffset] == '?') {
+            for (std::vector<Position>& next : resting_next_) {
+                next.push_back(kPosition + 1);
+            }
+        } else {
+            resting_next_[static_cast<uint8_t>(pattern[kOffset])].push_back(kPosition + 1);
+        }
+    }
+}
+
+int32_t GlobSet::Intern(const std::vector<Position>& positions) {
+    std::string key(positions.size() * sizeof(Position), '\0');
+    if (!positions.empty()) {
+        std::memcpy(key.data(), positions.data(), key.size());
+    }
+
+    auto [it, inserted] = state_index_.try_emplace(std::move(key),
+        static_cast<int32_t>(states_.size()));
+    if (!inserted) {
+        return it->second;
+    }
+
+    state_bytes_ += it->first.size();
+    State state;
+    state.next_.fill(kUnknown);
+    state.positions_ = &it->first;
+    state.accepts_ = resting_accepts_;
+    for (Position position : positions) {
+        if (static_cast<uint32_t>(position) == patterns_[position >> 32].size()) {
+            state.accepts_.push_back(static_cast<uint32_t>(position >> 32));
+        }
+    }
+    states_.push_back(std::move(state));
+    return it->second;
+}
+
+void GlobSet::ResetStates() {
+    states_.clear();
+    state_index_.clear();
+    state_bytes_ = 0;
+
+    // The empty set always comes first, so it gets the id kDead.
+    static_cast<void>(Intern({}));
+
+    std::vector<Position> start;
+    for (size_t i = 0; i < patterns_.size(); ++i) {
+        if (patterns_[i].empty() || patterns_[i][0] != '*') {
+            start.push_back(static_cast<Position>(i) << 32);
+        }
+    }
+    Close(&start);
+    start_ = Intern(start);
+}
+
+int32_t GlobSet::Step(int32_t state, uint8_t byte) {
+    const int32_t kCached = states_[state].next_[byte];
+    if (kCached != kUnknown) {
+        return kCached;
+    }
+
+    const std::string& packed = *states_[state].positions_;
+    std::vector<Position> next = resting_next_[byte];
+    for (size_t i = 0; i < packed.size(); i += sizeof(Position)) {
+        Position position;
+        std::memcpy(&position, packed.data() + i, sizeof(Position));
+        const std::string& pattern = patterns_[position >> 32];
+        const auto kOffset = static_cast<uint32_t>(position);
+        if (kOffset == pattern.size()) {
+            continue;
+        }
+        const char kSymbol = pattern[kOffset];
+        if (kSymbol == '*') {
+            next.push_back(position);
+        } else if (kSymbol == '?' || kSymbol == static_cast<char>(byte)) {
+            next.push_back(position + 1);
+        }
+    }
+    Close(&next);
+
+    // Starting over invalidates state, so its transition is simply not cached this time.
+    const bool kFull = states_.size() >= kMaxStates || state_bytes_ >= kMaxStateBytes;
+    if (kFull) {
+        ResetStates();
+    }
+    const int32_t kNext = Intern(next);
+    if (!kFull) {
+        states_[state].next_[byte] = kNext;
+    }
+    return kNext;
+}
+
+void GlobSet::Match(std::string_view text, std::vector<uint32_t>* matches) {
+    if (patterns_.empty()) {
+        return;
+    }
+    if (start_ == kUnknown) {
+        IndexResting();
+        ResetStates();
+    }
+
+    int32_t state = start_;
+    for (char c : text) {
+        state = Step(state, static_cast<uint8_t>(c));
+        if (state == kDead && !has_resting_) {
+            return;
+        }
+    }
+    matches->insert(matches->end(), states_[state].accepts_.begin(),
+        states_[state].accepts_.end());
+}
+
+RuleMatcher::RuleMatcher() : needs_file_name_(false) {}
+
+void RuleMatcher::Compile(std::vector<Rule> rules) {
+    rules_ = std::move(rules);
+    for (FieldIndex& field : fields_) {
+        field.literals_.clear();
+        field.globs_.Clear();
+        field.glob_conditions_.clear();
+    }
+    condition_rules_.clear();
+    condition_counts_.assign(rules_.size(), 0);
+    hits_.assign(rules_.size(), 0);
+    needs_file_name_ = false;
+
+    for (size_t i = 0; i < rules_.size(); ++i) {
+        for (const RuleCondition& condition : rules_[i].conditions_) {
+            const auto kConditionId = static_cast<uint32_t>(condition_rules_.size());
+            condition_rules_.push_back(static_cast<uint32_t>(i));
+            ++condition_counts_[i];
+
+            FieldIndex& field = fields_[static_cast<size_t>(condition.field_)];
+            if (IsGlob(condition.pattern_)) {
+                static_cast<void>(field.globs_.Add(condition.pattern_));
+                field.glob_conditions_.push_back(kConditionId);
+            } else {
+                field.literals_[condition.pattern_].push_back(kConditionId);
+            }
+            needs_file_name_ |= condition.field_ == RuleField::Exe
+                || condition.field_ == RuleField::Path;
+        }
+    }
+}
+
+void RuleMatcher::Hit(uint32_t condition, int* best_rule) {
+    const uint32_t kRule = condition_rules_[condition];
+    if (hits_[kRule]++ == 0) {
+        touched_rules_.push_back(kRule);
+    }
+    if (hits_[kRule] == condition_counts_[kRule]
+        && (*best_rule < 0 || kRule < static_cast<uint32_t>(*best_rule))) {
+        *best_rule = static_cast<int>(kRule);
+    }
+}
+
+void RuleMatcher::MatchField(RuleField field, std::string_view text, int* best_rule) {
+    FieldIndex& index = fields_[static_cast<size_t>(field)];
+    if (index.literals_.empty() && index.globs_.size() == 0) {
+        return;
+    }
+
+    ToLower(text, &lowercase_);
+    auto it = index.literals_.find(lowercase_);
+    if (it != index.literals_.end()) {
+        for (uint32_t condition : it->second) {
+            Hit(condition, best_rule);
+        }
+    }
+
+    glob_matches_.clear();
+    index.globs_.Match(lowercase_, &glob_matches_);
+    for (uint32_t pattern : glob_matches_) {
+        Hit(index.glob_conditions_[pattern], best_rule);
+    }
+}
+
+int RuleMatcher::Match(std::string_view class_name, std::string_view title,
+    std::string_view file_name) {
+    int best_rule = -1;
+    MatchField(RuleField::Class, class_name, &best_rule);
+    MatchField(RuleField::Title, title, &best_rule);
+    if (needs_file_name_) {
+        MatchField(RuleField::Exe, BaseName(file_name), &best_rule);
+        MatchField(RuleField::Path, file_name, &best_rule);
+    }
+
+    for (uint32_t rule : touched_rules_) {
+        hits_[rule] = 0;
+    }
+    touched_rules_.clear();
+    return best_rule;
+}
+} // namespace fsb
@@ -0,0 +1,196 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_RULE_ENGINE_H_
+#define FSB_RULE_ENGINE_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fsb {
+//! @brief Window property a rule condition is matched against.
+enum class RuleField : uint8_t {
+    Class,
+    Title,
+    //! File name of the executable, without its directory.
+    Exe,
+    //! Full path of the executable.
+    Path,
+    Count
+};
+
+struct RuleCondition {
+    RuleField field_;
+    //! Case-insensitive glob: '*' matches any run of bytes, '?' a single byte.
+    std::string pattern_;
+};
+
+//! @brief What to do with a window once a rule matches it. Only borderless is supported.
+struct RuleAction {
+    //! 1-based index of the monitor to cover, 0 for the monitor the window is on.
+    int monitor_;
+};
+
+//! @brief A window matches a rule when it matches every one of its conditions.
+struct Rule {
+    std::vector<RuleCondition> conditions_;
+    RuleAction action_;
+    //! Line of the rules file the rule was read from, for messages.
+    size_t line_;
+};
+
+//! @brief Parses whitespace-separated field=pattern conditions, e.g. class=Chrome* exe=chrome.exe.
+//!
+//! @returns Returns false if a condition is malformed or there is none.
+bool ParseConditions(std::string_view text, std::vector<RuleCondition>* conditions);
+
+//! @brief Parses the rules file, one rule per line.
+//!
+//! A rule is a list of field=pattern conditions, an arrow and the action, e.g.
+//!     class=UnityWndClass exe=game.exe -> borderless monitor=2
+//!     title="Half-Life*" -> borderless
+//! Fields are class, title, exe and path. Patterns with spaces are quoted. Blank lines and lines
+//! starting with '#' are skipped. Rules that match the same window apply in file order, so an
+//! "or" is written as two rules with the same action.
+//!
+//! @returns Returns the number of lines that were skipped because they were invalid.
+size_t ParseRules(std::string_view text, std::vector<Rule>* rules);
+
+//! @brief Matches a set of case-insensitive globs against a string all at once.
+//!
+//! Every pattern is compiled into one automaton whose states are built lazily, the first time an
+//! input reaches them, so each byte of input costs one table lookup no matter how many patterns
+//! there are. The state cache is bounded and starts over when full, which keeps pattern sets that
+//! would blow up as a full DFA usable.
+//!
+//! Patterns starting with '*' can begin matching at any byte, so every state would carry their
+//! first position. Those positions are left out of the states and indexed by the byte that moves
+//! them on instead, so building a state only looks at the patterns the byte can advance, not at
+//! every pattern in the set.
+class GlobSet {
+public:
+    //! States kept before the cache starts over.
+    static constexpr size_t kMaxStates = 4096;
+    //! Bytes of position sets kept before the cache starts over. Every state of a large set of
+    //! "*text*" patterns holds a position for each of them.
+    static constexpr size_t kMaxStateBytes = size_t{16} << 20;
+
+    GlobSet();
+
+    //! @brief Adds a lowercase pattern. Returns its id, in order from 0.
+    uint32_t Add(std::string_view pattern);
+    //! @brief Drops every pattern.
+    void Clear();
+
+    //! @brief Appends the id of every pattern that matches the whole of text to matches.
+    //!
+    //! @param text Lowercase input.
+    void Match(std::string_view text, std::vector<uint32_t>* matches);
+
+    size_t size() const { return patterns_.size(); }
+    size_t state_count() const { return states_.size(); }
+
+private:
+    //! Pattern id in the high half, offset into the pattern in the low half.
+    using Position = uint64_t;
+
+    struct State {
+        //! Next state for each input byte, kUnknown until first taken.
+        std::array<int32_t, 256> next_;
+        //! Ids of the patterns that are fully matched in this state.
+        std::vector<uint32_t> accepts_;
+        //! Sorted positions the state stands for besides the resting ones, packed as in
+        //! state_index_.
+        const std::string* positions_;
+    };
+
+    static constexpr int32_t kUnknown = -1;
+    //! Id of the state with no positions besides the resting ones, in which no pattern can match
+    //! anymore unless one starts with '*'.
+    static constexpr int32_t kDead = 0;
+
+    //! Adds the positions that are reachable without input ('*' matching nothing).
+    void Close(std::vector<Position>* positions) const;
+    //! Finds the resting positions of the patterns that start with '*', which every state shares.
+    void IndexResting();
+    //! Returns the id of the state for a closed, sorted set of positions, creating it if needed.
+    int32_t Intern(const std::vector<Position>& positions);
+    int32_t Step(int32_t state, uint8_t byte);
+    void ResetStates();
+
+    std::vector<std::string> patterns_;
+    //! Positions the resting positions move to on each byte, before closing.
+    std::array<std::vector<Position>, 256> resting_next_;
+    //! Patterns the resting positions match by themselves, e.g. "*". Every state accepts them.
+    std::vector<uint32_t> resting_accepts_;
+    bool has_resting_;
+    std::vector<State> states_;
+    //! Position sets packed as bytes, to find existing states. Node-based, so State can point
+    //! into its keys.
+    std::unordered_map<std::string, int32_t> state_index_;
+    size_t state_bytes_;
+    int32_t start_;
+};
+
+//! @brief Finds the first rule that matches a window, at a cost that does not grow with the
+//! number of rules.
+//!
+//! Conditions are grouped by field. Plain patterns go into a hash table per field and patterns
+//! with wildcards into a GlobSet per field, so each window costs one lookup and one pass over the
+//! text of each field. Only the rules of the conditions that matched are then looked at.
+//!
+//! @note Not thread-safe, as matching builds automaton states on the fly.
+class RuleMatcher {
+public:
+    RuleMatcher();
+
+    //! @brief Replaces the rules and compiles them.
+    void Compile(std::vector<Rule> rules);
+
+    //! @brief Returns the index of the first rule that matches, or -1 if none does.
+    //!
+    //! @param file_name Full path of the executable. Only read if needs_file_name() is set.
+    int Match(std::string_view class_name, std::string_view title, std::string_view file_name);
+
+    //! Whether any rule looks at the executable, which costs a process query to find out.
+    bool needs_file_name() const { return needs_file_name_; }
+    bool empty() const { return rules_.empty(); }
+    size_t size() const { return rules_.size(); }
+    const Rule& rule(size_t index) const { return rules_[index]; }
+
+private:
+    struct FieldIndex {
+        //! Condition ids of every plain pattern.
+        std::unordered_map<std::string, std::vector<uint32_t>> literals_;
+        GlobSet globs_;
+        //! Condition id of every GlobSet pattern id.
+        std::vector<uint32_t> glob_conditions_;
+    };
+
+    //! Counts a matched condition towards its rule.
+    void Hit(uint32_t condition, int* best_rule);
+    void MatchField(RuleField field, std::string_view text, int* best_rule);
+
+    std::vector<Rule> rules_;
+    std::array<FieldIndex, static_cast<size_t>(RuleField::Count)> fields_;
+    //! Rule of every condition.
+    std::vector<uint32_t> condition_rules_;
+    //! Number of conditions of every rule.
+    std::vector<uint32_t> condition_counts_;
+    bool needs_file_name_;
+
+    // Scratch space reused by every Match.
+    std::vector<uint32_t> hits_;
+    std::vector<uint32_t> touched_rules_;
+    std::vector<uint32_t> glob_matches_;
+    std::string lowercase_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_RULE_ENGINE_H_
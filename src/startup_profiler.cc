@@ -0,0 +1,53 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "startup_profiler.h"
+
+#include "trace.h"
+
+#include <cstdio>
+
+namespace fsb {
+StartupProfiler::StartupProfiler() : enabled_(false) {}
+
+StartupProfiler& StartupProfiler::Get() {
+    static StartupProfiler profiler;
+    return profiler;
+}
+
+uint64_t StartupProfiler::Mark(std::string_view milestone) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Read under the lock, or two threads could append their milestones out of order.
+    const uint64_t kNow = Tracer::Now();
+    milestones_.push_back({milestone, kNow});
+    return kNow - milestones_.front().time_;
+}
+
+uint64_t StartupProfiler::Elapsed(std::string_view milestone) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Milestone& entry : milestones_) {
+        if (entry.name_ == milestone) {
+            return entry.time_ - milestones_.front().time_;
+        }
+    }
+    return 0;
+}
+
+std::string StartupProfiler::FormatReport() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string report = "Startup (ms since main, ms since previous):\n";
+    uint64_t previous = milestones_.empty() ? 0 : milestones_.front().time_;
+    for (const Milestone& entry : milestones_) {
+        char line[128];
+        const int kLength = std::snprintf(line, sizeof(line), "  %9.3f  %+9.3f  ",
+            static_cast<double>(entry.time_ - milestones_.front().time_) / 1e6,
+            static_cast<double>(entry.time_ - previous) / 1e6);
+        report.append(line, static_cast<size_t>(kLength));
+        report.append(entry.name_);
+        report.push_back('\n');
+        previous = entry.time_;
+    }
+    return report;
+}
+} // namespace fsb
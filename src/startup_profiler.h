@@ -0,0 +1,55 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_STARTUP_PROFILER_H_
+#define FSB_STARTUP_PROFILER_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fsb {
+//! @brief Records the milestones of startup, from entering main to the menu being interactive.
+//!
+//! There are only a handful of milestones, so they are always recorded. Printing them is what is
+//! opt-in (--profile-startup).
+class StartupProfiler {
+public:
+    static StartupProfiler& Get();
+
+    StartupProfiler(const StartupProfiler&) = delete;
+    StartupProfiler& operator=(const StartupProfiler&) = delete;
+
+    bool enabled() const { return enabled_; }
+    void SetEnabled(bool enabled) { enabled_ = enabled; }
+
+    //! @brief Records a milestone. The first one recorded is the origin of every other.
+    //!
+    //! @param milestone Must stay valid for the lifetime of the profiler (a literal).
+    //! @returns Returns the nanoseconds since the origin.
+    uint64_t Mark(std::string_view milestone);
+
+    //! @brief Returns the nanoseconds from the origin to a milestone, or 0 if it was not reached.
+    uint64_t Elapsed(std::string_view milestone) const;
+
+    //! @brief Formats every milestone with its time since the origin and since the previous one.
+    std::string FormatReport() const;
+
+private:
+    struct Milestone {
+        std::string_view name_;
+        uint64_t time_;
+    };
+
+    StartupProfiler();
+
+    bool enabled_;
+    mutable std::mutex mutex_;
+    std::vector<Milestone> milestones_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_STARTUP_PROFILER_H_
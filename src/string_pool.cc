@@ -0,0 +1,95 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "string_pool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+namespace fsb {
+namespace {
+// Enough for a typical desktop's classes and executable paths in a single block.
+constexpr size_t kBlockSize = 16 * 1024;
+} // namespace
+
+StringPool::StringPool()
+    : block_used_(0),
+      block_size_(0),
+      stored_bytes_(0),
+      reserved_bytes_(0),
+      intern_calls_(0) {}
+
+StringId StringPool::Intern(std::string_view value) {
+    intern_calls_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(value);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(value);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+
+    const std::string_view kStored = Store(value);
+    const auto kId = static_cast<StringId>(strings_.size());
+    strings_.push_back(kStored);
+    ids_.emplace(kStored, kId);
+    return kId;
+}
+
+std::string_view StringPool::Store(std::string_view value) {
+    if (value.empty()) {
+        return std::string_view();
+    }
+
+    if (blocks_.empty() || block_size_ - block_used_ < value.size()) {
+        // Strings longer than a block get a block of their own.
+        block_size_ = std::max(kBlockSize, value.size());
+        blocks_.push_back(std::make_unique<char[]>(block_size_));
+        block_used_ = 0;
+        reserved_bytes_ += block_size_;
+    }
+
+    char* destination = blocks_.back().get() + block_used_;
+    std::memcpy(destination, value.data(), value.size());
+    block_used_ += value.size();
+    stored_bytes_ += value.size();
+    return std::string_view(destination, value.size());
+}
+
+std::string_view StringPool::View(StringId id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return id < strings_.size() ? strings_[id] : std::string_view();
+}
+
+size_t StringPool::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return strings_.size();
+}
+
+size_t StringPool::stored_bytes() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return stored_bytes_;
+}
+
+size_t StringPool::reserved_bytes() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return reserved_bytes_;
+}
+
+size_t StringPool::block_allocations() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return blocks_.size();
+}
+
+uint64_t StringPool::intern_calls() const {
+    return intern_calls_.load(std::memory_order_relaxed);
+}
+} // namespace fsb
@@ -0,0 +1,71 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_STRING_POOL_H_
+#define FSB_STRING_POOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fsb {
+using StringId = uint32_t;
+
+//! @brief Interning table that stores each distinct string once.
+//!
+//! A desktop has a few dozen distinct window classes and executables spread over hundreds of
+//! windows, so ProcessData refers to those through views into this pool instead of owning a copy.
+//! Strings are never removed, and the views stay valid for the lifetime of the pool, so one pool
+//! is kept across refreshes.
+//!
+//! @note Safe to use from multiple probe workers at once. Looking up a string that is already
+//! interned only takes a shared lock.
+class StringPool {
+public:
+    StringPool();
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    //! @brief Returns the ID of a string, adding it to the pool if it is new.
+    StringId Intern(std::string_view value);
+
+    //! @brief Returns a view of an interned string that stays valid as long as the pool.
+    std::string_view InternView(std::string_view value) { return View(Intern(value)); }
+
+    std::string_view View(StringId id) const;
+
+    //! Number of distinct strings stored.
+    size_t size() const;
+    //! Bytes of string data stored, excluding block slack.
+    size_t stored_bytes() const;
+    //! Bytes reserved for string data.
+    size_t reserved_bytes() const;
+    //! Number of storage blocks allocated so far.
+    size_t block_allocations() const;
+    //! Number of Intern calls, including those that found an existing string.
+    uint64_t intern_calls() const;
+
+private:
+    //! Copies value into the current storage block, starting a new one if it does not fit.
+    std::string_view Store(std::string_view value);
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string_view, StringId> ids_;
+    std::vector<std::string_view> strings_;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t block_used_;
+    size_t block_size_;
+    size_t stored_bytes_;
+    size_t reserved_bytes_;
+    std::atomic<uint64_t> intern_calls_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_STRING_POOL_H_
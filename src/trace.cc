@@ -0,0 +1,316 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace fsb {
+namespace {
+constexpr std::string_view kPhaseNames[] = {
+    "Enumerate",
+    "ProbeWindow",
+    "Attributes",
+    "Metrics",
+    "ProcessId",
+    "Title",
+    "ClassName",
+    "Font",
+    "ProcessFileName",
+    "ProcessStartTime",
+    "Transcode",
+    "LoadDetails",
+};
+static_assert(std::size(kPhaseNames) == static_cast<size_t>(TracePhase::Count),
+    "Every trace phase needs a name.");
+
+void AppendJsonString(std::string_view text, std::string* out) {
+    out->push_back('"');
+    for (char character : text) {
+        switch (character) {
+            case '"':
+                out->append("\\\"");
+                break;
+            case '\\':
+                out->append("\\\\");
+                break;
+            case '\n':
+                out->append("\\n");
+                break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20) {
+                    char escape[8];
+                    std::snprintf(escape, sizeof(escape), "\\u%04x",
+                        static_cast<unsigned>(static_cast<unsigned char>(character)));
+                    out->append(escape);
+                } else {
+                    out->push_back(character);
+                }
+        }
+    }
+    out->push_back('"');
+}
+
+void AppendAggregates(std::string_view title,
+    std::vector<std::pair<std::string_view, std::pair<uint64_t, uint64_t>>> rows,
+    std::string* out) {
+    // Rows are (name, (total, count)), listed by total time.
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        return a.second.first > b.second.first;
+    });
+
+    char line[512];
+    out->append(title);
+    out->append(":\n");
+    for (size_t i = 0; i < rows.size() && i < Tracer::kTopWindows; ++i) {
+        std::snprintf(line, sizeof(line), "  %10.3f ms %8" PRIu64 " windows  %.*s\n",
+            rows[i].second.first / 1e6, rows[i].second.second,
+            static_cast<int>(rows[i].first.size()), rows[i].first.data());
+        out->append(line);
+    }
+}
+} // namespace
+
+std::string_view TracePhaseName(TracePhase phase) {
+    return kPhaseNames[static_cast<size_t>(phase)];
+}
+
+bool Tracer::SlowerThan(const WindowSample& a, const WindowSample& b) {
+    return a.duration_ > b.duration_;
+}
+
+Tracer::Tracer() : enabled_(false) {
+    Reset();
+}
+
+Tracer& Tracer::Get() {
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::SetEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t Tracer::Now() {
+    static const auto kOrigin = std::chrono::steady_clock::now();
+    // Offset by one so a start time of 0 can mean "not recording".
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - kOrigin).count()) + 1;
+}
+
+Tracer::ThreadBuffer& Tracer::LocalBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto owned = std::make_unique<ThreadBuffer>();
+        owned->thread_id_ = static_cast<uint32_t>(buffers_.size() + 1);
+        owned->next_ = 0;
+        buffer = owned.get();
+        buffers_.push_back(std::move(owned));
+    }
+    return *buffer;
+}
+
+void Tracer::RecordPhase(TracePhase phase, uint64_t start, uint64_t end,
+    HWND window_handle) {
+    const uint64_t kDuration = end - start;
+    phase_totals_[static_cast<size_t>(phase)].fetch_add(kDuration, std::memory_order_relaxed);
+    phase_counts_[static_cast<size_t>(phase)].fetch_add(1, std::memory_order_relaxed);
+
+    ThreadBuffer& buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex_);
+    const Event kEvent = {start, kDuration, window_handle, phase};
+    if (buffer.events_.size() < kMaxEventsPerThread) {
+        buffer.events_.push_back(kEvent);
+    } else {
+        buffer.events_[buffer.next_ % kMaxEventsPerThread] = kEvent;
+    }
+    ++buffer.next_;
+}
+
+void Tracer::RecordWindow(TracePhase phase, HWND window_handle, uint32_t process_id,
+    std::string_view class_name, uint64_t duration) {
+    const uint64_t kMicroseconds = duration / 1000;
+    size_t bucket = 0;
+    while (bucket + 1 < kHistogramBuckets && (kMicroseconds >> (bucket + 1)) != 0) {
+        ++bucket;
+    }
+    histograms_[phase == TracePhase::LoadDetails ? 1 : 0][bucket].fetch_add(1,
+        std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (class_name.empty()) {
+        auto it = class_names_.find(window_handle);
+        class_name = it != class_names_.end() ? it->second : "?";
+    } else {
+        class_names_[window_handle] = class_name;
+    }
+
+    const WindowSample kSample = {duration, window_handle, process_id, class_name, phase};
+    if (slowest_.size() < kTopWindows) {
+        slowest_.push_back(kSample);
+        std::push_heap(slowest_.begin(), slowest_.end(), SlowerThan);
+    } else if (duration > slowest_.front().duration_) {
+        std::pop_heap(slowest_.begin(), slowest_.end(), SlowerThan);
+        slowest_.back() = kSample;
+        std::push_heap(slowest_.begin(), slowest_.end(), SlowerThan);
+    }
+
+    for (Aggregate* aggregate : {&by_class_[class_name], &by_process_[process_id]}) {
+        aggregate->total_ += duration;
+        ++aggregate->count_;
+        aggregate->max_ = std::max(aggregate->max_, duration);
+    }
+}
+
+void Tracer::NoteProcess(uint32_t process_id, std::string_view file_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_names_[process_id] = file_name;
+}
+
+std::vector<uint32_t> Tracer::UnattributedProcesses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<uint32_t> process_ids;
+    for (const auto& [process_id, aggregate] : by_process_) {
+        if (file_names_.count(process_id) == 0) {
+            process_ids.push_back(process_id);
+        }
+    }
+    return process_ids;
+}
+
+void Tracer::Reset() {
+    for (auto& total : phase_totals_) {
+        total.store(0, std::memory_order_relaxed);
+    }
+    for (auto& count : phase_counts_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    for (auto& histogram : histograms_) {
+        for (auto& count : histogram) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex_);
+        buffer->events_.clear();
+        buffer->next_ = 0;
+    }
+    slowest_.clear();
+    by_class_.clear();
+    by_process_.clear();
+    class_names_.clear();
+}
+
+std::string_view Tracer::FileName(uint32_t process_id) const {
+    auto it = file_names_.find(process_id);
+    return it == file_names_.end() ? "?" : it->second;
+}
+
+std::string Tracer::FormatReport() const {
+    std::string report;
+    char line[512];
+
+    report.append("phase                    calls     total ms      avg us\n");
+    for (size_t i = 0; i < static_cast<size_t>(TracePhase::Count); ++i) {
+        const uint64_t kCount = phase_counts_[i].load(std::memory_order_relaxed);
+        if (kCount == 0) {
+            continue;
+        }
+        const uint64_t kTotal = phase_totals_[i].load(std::memory_order_relaxed);
+        std::snprintf(line, sizeof(line), "%-20s %9" PRIu64 " %12.3f %11.1f\n",
+            kPhaseNames[i].data(), kCount, kTotal / 1e6, kTotal / 1e3 / kCount);
+        report.append(line);
+    }
+
+    for (size_t kind = 0; kind < histograms_.size(); ++kind) {
+        report.append(kind == 0 ? "window probe latency:\n" : "detail load latency:\n");
+        for (size_t i = 0; i < kHistogramBuckets; ++i) {
+            const uint64_t kCount = histograms_[kind][i].load(std::memory_order_relaxed);
+            if (kCount != 0) {
+                std::snprintf(line, sizeof(line),
+                    "  %8" PRIu64 " - %8" PRIu64 " us %9" PRIu64 "\n",
+                    i == 0 ? uint64_t{0} : uint64_t{1} << i, (uint64_t{1} << (i + 1)) - 1,
+                    kCount);
+                report.append(line);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<WindowSample> slowest = slowest_;
+    std::sort(slowest.begin(), slowest.end(), SlowerThan);
+    report.append("slowest windows:\n");
+    for (const auto& sample : slowest) {
+        const std::string_view kFileName = FileName(sample.process_id_);
+        std::snprintf(line, sizeof(line), "  %10.3f ms %-11s %p %6u %.*s %.*s\n",
+            sample.duration_ / 1e6, kPhaseNames[static_cast<size_t>(sample.phase_)].data(),
+            static_cast<void*>(sample.window_handle_),
+            sample.process_id_, static_cast<int>(sample.class_name_.size()),
+            sample.class_name_.data(), static_cast<int>(kFileName.size()), kFileName.data());
+        report.append(line);
+    }
+
+    std::vector<std::pair<std::string_view, std::pair<uint64_t, uint64_t>>> rows;
+    for (const auto& [class_name, aggregate] : by_class_) {
+        rows.push_back({class_name, {aggregate.total_, aggregate.count_}});
+    }
+    AppendAggregates("by class", std::move(rows), &report);
+
+    // Processes of the same executable are reported together.
+    std::unordered_map<std::string_view, std::pair<uint64_t, uint64_t>> by_file_name;
+    for (const auto& [process_id, aggregate] : by_process_) {
+        auto& row = by_file_name[FileName(process_id)];
+        row.first += aggregate.total_;
+        row.second += aggregate.count_;
+    }
+    rows.assign(by_file_name.begin(), by_file_name.end());
+    AppendAggregates("by executable", std::move(rows), &report);
+
+    return report;
+}
+
+bool Tracer::WriteChromeTrace(const std::string& path) const {
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    char event[256];
+    bool first = true;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& buffer : buffers_) {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex_);
+            for (const auto& entry : buffer->events_) {
+                const int kLength = std::snprintf(event, sizeof(event),
+                    "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,"
+                    "\"dur\":%.3f,\"args\":{\"hwnd\":\"%p\"}}",
+                    first ? "" : ",\n", kPhaseNames[static_cast<size_t>(entry.phase_)].data(),
+                    buffer->thread_id_, entry.start_ / 1e3, entry.duration_ / 1e3,
+                    static_cast<void*>(entry.window_handle_));
+                json.append(event, static_cast<size_t>(kLength));
+                first = false;
+            }
+        }
+    }
+
+    json.append("],\n\"otherData\":{\"report\":");
+    AppendJsonString(FormatReport(), &json);
+    json.append("}}\n");
+
+    std::ofstream file(std::filesystem::u8path(path), std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    return static_cast<bool>(file);
+}
+} // namespace fsb
@@ -0,0 +1,175 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_TRACE_H_
+#define FSB_TRACE_H_
+
+#include "base_types.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fsb {
+//! @brief Steps of enumerating and probing windows that are timed separately.
+enum class TracePhase : uint8_t {
+    Enumerate,
+    ProbeWindow,
+    Attributes,
+    Metrics,
+    ProcessId,
+    Title,
+    ClassName,
+    Font,
+    ProcessFileName,
+    ProcessStartTime,
+    Transcode,
+    LoadDetails,
+    Count
+};
+
+std::string_view TracePhaseName(TracePhase phase);
+
+//! @brief Process-wide recorder of enumeration timings.
+//!
+//! Disabled by default. While disabled every probe point costs one relaxed atomic load. Once
+//! enabled, it records:
+//! - total time and call count per phase;
+//! - log2 histograms of the per-window latency of the cheap probe and of the detail load;
+//! - the slowest windows, attributed to their class and executable;
+//! - a timeline of every phase on every thread, exported as a Chrome trace
+//!   (chrome://tracing, Perfetto).
+//!
+//! @note Safe to record from any thread. Each thread appends to its own buffer.
+class Tracer {
+public:
+    //! Number of slowest windows kept for the report.
+    static constexpr size_t kTopWindows = 16;
+    //! Histogram bucket i counts probes that took [2^i, 2^(i+1)) microseconds.
+    static constexpr size_t kHistogramBuckets = 24;
+    //! Timeline events kept per thread before the oldest ones are dropped.
+    static constexpr size_t kMaxEventsPerThread = 1 << 16;
+
+    static Tracer& Get();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    void SetEnabled(bool enabled);
+
+    //! @brief Nanoseconds on a monotonic clock shared by every recording.
+    static uint64_t Now();
+
+    void RecordPhase(TracePhase phase, uint64_t start, uint64_t end, HWND window_handle);
+    //! @brief Records how long one window took in total.
+    //!
+    //! @param phase Either TracePhase::ProbeWindow or TracePhase::LoadDetails.
+    //! @param class_name Interned class name, or empty to reuse the one recorded by the probe.
+    void RecordWindow(TracePhase phase, HWND window_handle, uint32_t process_id,
+        std::string_view class_name, uint64_t duration);
+    //! @brief Remembers the executable of a process so slow windows can be attributed to it.
+    //!
+    //! @param file_name Must stay valid for the lifetime of the tracer (an interned string).
+    void NoteProcess(uint32_t process_id, std::string_view file_name);
+
+    //! @brief Returns the processes of recorded windows whose executable has not been noted yet.
+    std::vector<uint32_t> UnattributedProcesses() const;
+
+    //! @brief Drops everything recorded so far.
+    void Reset();
+
+    //! @brief Formats phase totals, the latency histogram and the slowest windows as text.
+    std::string FormatReport() const;
+    //! @brief Writes the timeline as Chrome trace JSON, with the report in "otherData".
+    //!
+    //! @param path UTF-8 path.
+    bool WriteChromeTrace(const std::string& path) const;
+
+private:
+    struct Event {
+        uint64_t start_;
+        uint64_t duration_;
+        HWND window_handle_;
+        TracePhase phase_;
+    };
+
+    struct ThreadBuffer {
+        std::mutex mutex_;
+        uint32_t thread_id_;
+        //! Ring of the most recent events; next_ is the total number ever written.
+        std::vector<Event> events_;
+        size_t next_;
+    };
+
+    struct WindowSample {
+        uint64_t duration_;
+        HWND window_handle_;
+        uint32_t process_id_;
+        std::string_view class_name_;
+        TracePhase phase_;
+    };
+
+    struct Aggregate {
+        uint64_t total_;
+        uint64_t count_;
+        uint64_t max_;
+    };
+
+    Tracer();
+
+    //! Heap order for slowest_, which keeps the fastest of the slow windows at the front.
+    static bool SlowerThan(const WindowSample& a, const WindowSample& b);
+    ThreadBuffer& LocalBuffer();
+    //! Returns the executable noted for a process, or "?".
+    std::string_view FileName(uint32_t process_id) const;
+
+    std::atomic<bool> enabled_;
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(TracePhase::Count)> phase_totals_;
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(TracePhase::Count)> phase_counts_;
+    //! Index 0 is the probe, index 1 the detail load.
+    std::array<std::array<std::atomic<uint64_t>, kHistogramBuckets>, 2> histograms_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    //! Slowest windows, kept as a min-heap on duration.
+    std::vector<WindowSample> slowest_;
+    std::unordered_map<std::string_view, Aggregate> by_class_;
+    std::unordered_map<uint32_t, Aggregate> by_process_;
+    std::unordered_map<uint32_t, std::string_view> file_names_;
+    std::unordered_map<HWND, std::string_view> class_names_;
+};
+
+//! @brief Times the enclosing scope as one phase, if tracing is enabled when it starts.
+class ScopedTrace {
+public:
+    explicit ScopedTrace(TracePhase phase, HWND window_handle = nullptr)
+        : phase_(phase),
+          window_handle_(window_handle),
+          start_(Tracer::Get().enabled() ? Tracer::Now() : 0) {}
+
+    ~ScopedTrace() {
+        if (start_ != 0) {
+            Tracer::Get().RecordPhase(phase_, start_, Tracer::Now(), window_handle_);
+        }
+    }
+
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+private:
+    TracePhase phase_;
+    HWND window_handle_;
+    uint64_t start_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_TRACE_H_
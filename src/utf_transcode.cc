@@ -0,0 +1,280 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "utf_transcode.h"
+
+#include <cstdint>
+
+#if defined(__AVX2__)
+#define FSB_TRANSCODE_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FSB_TRANSCODE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace fsb {
+namespace {
+constexpr char16_t kReplacementCharacter = 0xFFFD;
+
+constexpr bool IsHighSurrogate(char16_t unit) {
+    return unit >= 0xD800 && unit <= 0xDBFF;
+}
+
+constexpr bool IsLowSurrogate(char16_t unit) {
+    return unit >= 0xDC00 && unit <= 0xDFFF;
+}
+
+//! Number of leading code units in [input, input + length) that are ASCII, checked a block at a
+//! time. Only whole blocks are counted, the caller handles the tail.
+size_t CountAsciiUtf16(const char16_t* input, size_t length) {
+    size_t i = 0;
+#if defined(FSB_TRANSCODE_AVX2)
+    const __m256i kNonAsciiMask = _mm256_set1_epi16(static_cast<int16_t>(0xFF80));
+    for (; i + 16 <= length; i += 16) {
+        const __m256i kUnits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        if (!_mm256_testz_si256(kUnits, kNonAsciiMask)) {
+            return i;
+        }
+    }
+#elif defined(FSB_TRANSCODE_SSE2)
+    const __m128i kNonAsciiMask = _mm_set1_epi16(static_cast<int16_t>(0xFF80));
+    for (; i + 8 <= length; i += 8) {
+        const __m128i kUnits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(kUnits, kNonAsciiMask),
+            _mm_setzero_si128())) != 0xFFFF) {
+            return i;
+        }
+    }
+#else
+    static_cast<void>(input);
+    static_cast<void>(length);
+#endif
+    return i;
+}
+
+//! Copies an ASCII run of UTF-16 code units to UTF-8, narrowing a block at a time. Returns the
+//! number of units converted; stops at the first block that contains a non-ASCII unit.
+size_t NarrowAsciiBlocks(const char16_t* input, size_t length, char* output) {
+    size_t i = 0;
+#if defined(FSB_TRANSCODE_AVX2)
+    const __m256i kNonAsciiMask = _mm256_set1_epi16(static_cast<int16_t>(0xFF80));
+    for (; i + 32 <= length; i += 32) {
+        const __m256i kLow = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        const __m256i kHigh = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i + 16));
+        if (!_mm256_testz_si256(_mm256_or_si256(kLow, kHigh), kNonAsciiMask)) {
+            break;
+        }
+        // packus works per 128-bit lane, so the 64-bit quarters have to be put back in order.
+        const __m256i kPacked = _mm256_permute4x64_epi64(_mm256_packus_epi16(kLow, kHigh), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), kPacked);
+    }
+#endif
+#if defined(FSB_TRANSCODE_SSE2)
+    const __m128i kNonAsciiMask128 = _mm_set1_epi16(static_cast<int16_t>(0xFF80));
+    for (; i + 16 <= length; i += 16) {
+        const __m128i kLow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        const __m128i kHigh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 8));
+        const __m128i kMasked = _mm_and_si128(_mm_or_si128(kLow, kHigh), kNonAsciiMask128);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(kMasked, _mm_setzero_si128())) != 0xFFFF) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packus_epi16(kLow, kHigh));
+    }
+#else
+    static_cast<void>(input);
+    static_cast<void>(length);
+    static_cast<void>(output);
+#endif
+    return i;
+}
+
+//! Widens an ASCII run of UTF-8 bytes to UTF-16 a block at a time. Returns the number of bytes
+//! converted; stops at the first block that contains a non-ASCII byte.
+size_t WidenAsciiBlocks(const char* input, size_t length, char16_t* output) {
+    size_t i = 0;
+#if defined(FSB_TRANSCODE_AVX2)
+    for (; i + 32 <= length; i += 32) {
+        const __m256i kBytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        if (_mm256_movemask_epi8(kBytes) != 0) {
+            break;
+        }
+        const __m256i kLow = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(kBytes));
+        const __m256i kHigh = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(kBytes, 1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), kLow);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i + 16), kHigh);
+    }
+#endif
+#if defined(FSB_TRANSCODE_SSE2)
+    for (; i + 16 <= length; i += 16) {
+        const __m128i kBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        if (_mm_movemask_epi8(kBytes) != 0) {
+            break;
+        }
+        const __m128i kZero = _mm_setzero_si128();
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_unpacklo_epi8(kBytes, kZero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i + 8),
+            _mm_unpackhi_epi8(kBytes, kZero));
+    }
+#else
+    static_cast<void>(input);
+    static_cast<void>(length);
+    static_cast<void>(output);
+#endif
+    return i;
+}
+
+//! Converts the code point starting at input[*position] and advances past it.
+char* EncodeOneUtf8(const char16_t* input, size_t length, size_t* position, char* output) {
+    uint32_t code_point = input[*position];
+    ++*position;
+
+    if (code_point < 0x80) {
+        *output++ = static_cast<char>(code_point);
+        return output;
+    }
+    if (code_point < 0x800) {
+        *output++ = static_cast<char>(0xC0 | (code_point >> 6));
+        *output++ = static_cast<char>(0x80 | (code_point & 0x3F));
+        return output;
+    }
+
+    if (IsHighSurrogate(static_cast<char16_t>(code_point)) && *position < length
+        && IsLowSurrogate(input[*position])) {
+        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (input[*position] - 0xDC00);
+        ++*position;
+        *output++ = static_cast<char>(0xF0 | (code_point >> 18));
+        *output++ = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        *output++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        *output++ = static_cast<char>(0x80 | (code_point & 0x3F));
+        return output;
+    }
+
+    if (code_point >= 0xD800 && code_point <= 0xDFFF) {
+        code_point = kReplacementCharacter;
+    }
+    *output++ = static_cast<char>(0xE0 | (code_point >> 12));
+    *output++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    *output++ = static_cast<char>(0x80 | (code_point & 0x3F));
+    return output;
+}
+
+//! Converts the sequence starting at input[*position] and advances past it. An invalid sequence
+//! consumes a single byte and produces U+FFFD.
+char16_t* DecodeOneUtf8(const char* input, size_t length, size_t* position, char16_t* output) {
+    const auto kLead = static_cast<uint8_t>(input[*position]);
+    ++*position;
+
+    if (kLead < 0x80) {
+        *output++ = kLead;
+        return output;
+    }
+
+    size_t continuation_count;
+    uint32_t code_point;
+    uint32_t minimum;
+    if (kLead >= 0xC2 && kLead <= 0xDF) {
+        continuation_count = 1;
+        code_point = kLead & 0x1F;
+        minimum = 0x80;
+    } else if ((kLead & 0xF0) == 0xE0) {
+        continuation_count = 2;
+        code_point = kLead & 0x0F;
+        minimum = 0x800;
+    } else if (kLead >= 0xF0 && kLead <= 0xF4) {
+        continuation_count = 3;
+        code_point = kLead & 0x07;
+        minimum = 0x10000;
+    } else {
+        *output++ = kReplacementCharacter;
+        return output;
+    }
+
+    if (*position + continuation_count > length) {
+        *output++ = kReplacementCharacter;
+        return output;
+    }
+    for (size_t i = 0; i < continuation_count; ++i) {
+        const auto kByte = static_cast<uint8_t>(input[*position + i]);
+        if ((kByte & 0xC0) != 0x80) {
+            *output++ = kReplacementCharacter;
+            return output;
+        }
+        code_point = (code_point << 6) | (kByte & 0x3F);
+    }
+
+    // Overlong forms, encoded surrogates and values past U+10FFFF are all invalid.
+    if (code_point < minimum || code_point > 0x10FFFF
+        || (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+        *output++ = kReplacementCharacter;
+        return output;
+    }
+
+    *position += continuation_count;
+    if (code_point >= 0x10000) {
+        code_point -= 0x10000;
+        *output++ = static_cast<char16_t>(0xD800 + (code_point >> 10));
+        *output++ = static_cast<char16_t>(0xDC00 + (code_point & 0x3FF));
+    } else {
+        *output++ = static_cast<char16_t>(code_point);
+    }
+    return output;
+}
+} // namespace
+
+size_t Utf8Length(const char16_t* input, size_t length) {
+    size_t i = CountAsciiUtf16(input, length);
+    size_t result = i;
+    while (i < length) {
+        const char16_t kUnit = input[i++];
+        if (kUnit < 0x80) {
+            result += 1;
+        } else if (kUnit < 0x800) {
+            result += 2;
+        } else if (IsHighSurrogate(kUnit) && i < length && IsLowSurrogate(input[i])) {
+            result += 4;
+            ++i;
+        } else {
+            result += 3;
+        }
+    }
+    return result;
+}
+
+size_t TranscodeUtf16ToUtf8(const char16_t* input, size_t length, char* output) {
+    char* const kStart = output;
+    size_t i = 0;
+    while (i < length) {
+        const size_t kAsciiRun = NarrowAsciiBlocks(input + i, length - i, output);
+        i += kAsciiRun;
+        output += kAsciiRun;
+
+        // Convert at least one block's worth of units on the scalar path before going back to
+        // the vector path, so mixed text does not keep failing the block check.
+        const size_t kScalarEnd = i + 16 < length ? i + 16 : length;
+        while (i < kScalarEnd) {
+            output = EncodeOneUtf8(input, length, &i, output);
+        }
+    }
+    return static_cast<size_t>(output - kStart);
+}
+
+size_t TranscodeUtf8ToUtf16(const char* input, size_t length, char16_t* output) {
+    char16_t* const kStart = output;
+    size_t i = 0;
+    while (i < length) {
+        const size_t kAsciiRun = WidenAsciiBlocks(input + i, length - i, output);
+        i += kAsciiRun;
+        output += kAsciiRun;
+
+        const size_t kScalarEnd = i + 16 < length ? i + 16 : length;
+        while (i < kScalarEnd) {
+            output = DecodeOneUtf8(input, length, &i, output);
+        }
+    }
+    return static_cast<size_t>(output - kStart);
+}
+} // namespace fsb
@@ -0,0 +1,46 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_UTF_TRANSCODE_H_
+#define FSB_UTF_TRANSCODE_H_
+
+#include <cstddef>
+
+namespace fsb {
+//! @brief Largest number of UTF-8 bytes that length UTF-16 code units can produce.
+//!
+//! A BMP code unit takes at most 3 bytes and a surrogate pair (2 units) takes 4.
+constexpr size_t Utf8UpperBound(size_t utf16_length) {
+    return utf16_length * 3;
+}
+
+//! @brief Largest number of UTF-16 code units that length UTF-8 bytes can produce.
+constexpr size_t Utf16UpperBound(size_t utf8_length) {
+    return utf8_length;
+}
+
+//! @brief Exact number of UTF-8 bytes TranscodeUtf16ToUtf8 produces for the input.
+size_t Utf8Length(const char16_t* input, size_t length);
+
+//! @brief Converts UTF-16 to UTF-8.
+//!
+//! Runs of ASCII are converted with SSE2 (or AVX2 when the compiler targets it), everything else,
+//! including surrogate pairs, goes through a scalar path. Unpaired surrogates are replaced with
+//! U+FFFD instead of failing the whole conversion.
+//!
+//! @param output Must have room for Utf8UpperBound(length) bytes, or for Utf8Length bytes.
+//! @returns Returns the number of bytes written.
+size_t TranscodeUtf16ToUtf8(const char16_t* input, size_t length, char* output);
+
+//! @brief Converts UTF-8 to UTF-16.
+//!
+//! Same structure as TranscodeUtf16ToUtf8. Every byte that does not start a valid, shortest-form
+//! sequence is replaced with U+FFFD.
+//!
+//! @param output Must have room for Utf16UpperBound(length) code units.
+//! @returns Returns the number of code units written.
+size_t TranscodeUtf8ToUtf16(const char* input, size_t length, char16_t* output);
+} // namespace fsb
+
+#endif // #ifndef FSB_UTF_TRANSCODE_H_
@@ -0,0 +1,130 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "win32_display_topology.h"
+
+#include "error.h"
+
+#include <ShellScalingApi.h>
+#include <string_view>
+#include <vector>
+
+namespace fsb {
+namespace {
+constexpr wchar_t kListenerClassName[] = L"FsbDisplayListener";
+
+SizeVec2 Position(const RECT& rect) {
+    return {static_cast<int32_t>(rect.left), static_cast<int32_t>(rect.top)};
+}
+
+SizeVec2 Size(const RECT& rect) {
+    return {static_cast<int32_t>(rect.right - rect.left),
+        static_cast<int32_t>(rect.bottom - rect.top)};
+}
+
+BOOL CALLBACK AddMonitor(HMONITOR monitor, HDC device_context, LPRECT rect, LPARAM data) {
+    UNREFERENCED_PARAMETER(device_context);
+    UNREFERENCED_PARAMETER(rect);
+
+    MONITORINFO monitor_info = {};
+    monitor_info.cbSize = sizeof(monitor_info);
+    if (!GetMonitorInfoW(monitor, &monitor_info)) {
+        return TRUE;
+    }
+
+    UINT dpi_x = 0;
+    UINT dpi_y = 0;
+    if (FAILED(GetDpiForMonitor(monitor, MDT_EFFECTIVE_DPI, &dpi_x, &dpi_y))) {
+        dpi_y = MonitorTopology::kDefaultDpi;
+    }
+
+    auto* monitors = reinterpret_cast<std::vector<MonitorInfo>*>(data);
+    monitors->push_back({Position(monitor_info.rcMonitor), Size(monitor_info.rcMonitor),
+        Position(monitor_info.rcWork), Size(monitor_info.rcWork), static_cast<uint32_t>(dpi_y),
+        (monitor_info.dwFlags & MONITORINFOF_PRIMARY) != 0});
+    return TRUE;
+}
+} // namespace
+
+Win32DisplayTopology& Win32DisplayTopology::Get() {
+    static Win32DisplayTopology topology;
+    return topology;
+}
+
+Win32DisplayTopology::Win32DisplayTopology() : listener_(nullptr), changed_(false) {}
+
+Win32DisplayTopology::~Win32DisplayTopology() {
+    if (listener_ != nullptr) {
+        static_cast<void>(DestroyWindow(listener_));
+    }
+}
+
+std::shared_ptr<const MonitorTopology> Win32DisplayTopology::topology() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (topology_ == nullptr) {
+        topology_ = Enumerate();
+    }
+    return topology_;
+}
+
+void Win32DisplayTopology::Invalidate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    topology_.reset();
+}
+
+std::shared_ptr<const MonitorTopology> Win32DisplayTopology::Enumerate() {
+    std::vector<MonitorInfo> monitors;
+    if (!EnumDisplayMonitors(nullptr, nullptr, AddMonitor, reinterpret_cast<LPARAM>(&monitors))) {
+        constexpr std::string_view kActionDescription = "enumerate the monitors.";
+        constexpr std::string_view kQualifiedName =
+            "win32_display_topology.cc::fsb::Win32DisplayTopology::Enumerate";
+        constexpr std::string_view kExportedOperationName = "User32.dll!EnumDisplayMonitors";
+        constexpr int kReturnCode = 0;
+        WIN32_LOG(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode,
+            nullptr, 0);
+    }
+    return std::make_shared<const MonitorTopology>(std::move(monitors));
+}
+
+bool Win32DisplayTopology::ListenForChanges() {
+    if (listener_ != nullptr) {
+        return true;
+    }
+
+    const HINSTANCE kInstance = GetModuleHandleW(nullptr);
+    WNDCLASSEXW window_class = {};
+    window_class.cbSize = sizeof(window_class);
+    window_class.lpfnWndProc = WindowProcedure;
+    window_class.hInstance = kInstance;
+    window_class.lpszClassName = kListenerClassName;
+    static_cast<void>(RegisterClassExW(&window_class));
+
+    // Message-only windows miss broadcasts, so the listener is an ordinary top-level window that
+    // is never shown.
+    listener_ = CreateWindowExW(WS_EX_TOOLWINDOW, kListenerClassName, L"", WS_POPUP, 0, 0, 0, 0,
+        nullptr, nullptr, kInstance, nullptr);
+    if (listener_ == nullptr) {
+        constexpr std::string_view kActionDescription = "listen for display changes.";
+        constexpr std::string_view kQualifiedName =
+            "win32_display_topology.cc::fsb::Win32DisplayTopology::ListenForChanges";
+        constexpr std::string_view kExportedOperationName = "User32.dll!CreateWindowExW";
+        constexpr int kReturnCode = 0;
+        WIN32_ERROR(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode);
+        return false;
+    }
+    return true;
+}
+
+LRESULT CALLBACK Win32DisplayTopology::WindowProcedure(HWND window_handle, UINT message,
+    WPARAM w_param, LPARAM l_param) {
+    const bool kChanged = message == WM_DISPLAYCHANGE || message == WM_DPICHANGED
+        || (message == WM_SETTINGCHANGE && w_param == SPI_SETWORKAREA);
+    if (kChanged) {
+        Win32DisplayTopology& topology = Get();
+        topology.Invalidate();
+        topology.changed_.store(true, std::memory_order_release);
+    }
+    return DefWindowProcW(window_handle, message, w_param, l_param);
+}
+} // namespace fsb
@@ -0,0 +1,59 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_WIN32_DISPLAY_TOPOLOGY_H_
+#define FSB_WIN32_DISPLAY_TOPOLOGY_H_
+
+#include "monitor_topology.h"
+
+#include <Windows.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace fsb {
+//! @brief Caches the monitor layout of the live desktop, so placing and measuring windows does
+//! not enumerate the monitors every time.
+//!
+//! The layout is read on first use and kept until the displays change. A hidden window listens
+//! for resolution, DPI and work area changes and drops the cached layout when one arrives.
+//!
+//! @note Thread-safe. Topologies handed out stay valid after the cache is dropped.
+class Win32DisplayTopology {
+public:
+    static Win32DisplayTopology& Get();
+
+    Win32DisplayTopology(const Win32DisplayTopology&) = delete;
+    Win32DisplayTopology& operator=(const Win32DisplayTopology&) = delete;
+
+    //! @brief Returns the current layout, enumerating the monitors if it is not cached.
+    std::shared_ptr<const MonitorTopology> topology();
+    //! @brief Drops the cached layout, so the next call to topology() reads it again.
+    void Invalidate();
+
+    //! @brief Creates the window that listens for display changes. Returns false if it could not
+    //! be created, in which case the layout is only read once.
+    //!
+    //! Messages reach it whenever the calling thread pumps messages.
+    bool ListenForChanges();
+
+    //! @brief Returns whether the displays changed since the last call.
+    bool TakeChanged() { return changed_.exchange(false, std::memory_order_acq_rel); }
+
+private:
+    Win32DisplayTopology();
+    ~Win32DisplayTopology();
+
+    static LRESULT CALLBACK WindowProcedure(HWND window_handle, UINT message, WPARAM w_param,
+        LPARAM l_param);
+    static std::shared_ptr<const MonitorTopology> Enumerate();
+
+    std::mutex mutex_;
+    std::shared_ptr<const MonitorTopology> topology_;
+    HWND listener_;
+    std::atomic<bool> changed_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_WIN32_DISPLAY_TOPOLOGY_H_
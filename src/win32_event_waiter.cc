@@ -0,0 +1,70 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "win32_event_waiter.h"
+
+#include "error.h"
+
+#include <string_view>
+
+namespace fsb {
+Win32EventWaiter::Win32EventWaiter()
+    : handles_{}, sources_{}, handle_count_(0), wake_event_(nullptr), watch_messages_(false) {
+    // Auto-reset, so one Wake ends exactly one Wait.
+    wake_event_ = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (wake_event_ == nullptr) {
+        constexpr std::string_view kActionDescription = "create the event loop wake event.";
+        constexpr std::string_view kQualifiedName =
+            "win32_event_waiter.cc::fsb::Win32EventWaiter::Win32EventWaiter";
+        constexpr std::string_view kExportedOperationName = "Kernel32.dll!CreateEventW";
+        constexpr int kReturnCode = 0;
+        WIN32_FAILFAST(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode);
+    }
+    handles_[handle_count_++] = wake_event_;
+}
+
+Win32EventWaiter::~Win32EventWaiter() {
+    static_cast<void>(CloseHandle(wake_event_));
+}
+
+void Win32EventWaiter::Watch(EventSource source, HANDLE handle) {
+    if (handle == nullptr || handle == INVALID_HANDLE_VALUE || handle_count_ == kMaxHandles) {
+        return;
+    }
+    sources_[handle_count_] = source;
+    handles_[handle_count_++] = handle;
+}
+
+uint32_t Win32EventWaiter::Wait(uint32_t timeout_milliseconds) {
+    // MWMO_INPUTAVAILABLE also returns for messages that were already in the queue before the
+    // call, so a message that arrived while a handler ran is not slept through.
+    const DWORD kResult = MsgWaitForMultipleObjectsEx(handle_count_, handles_.data(),
+        timeout_milliseconds == kInfinite ? INFINITE : timeout_milliseconds,
+        watch_messages_ ? QS_ALLINPUT : 0, MWMO_INPUTAVAILABLE);
+
+    if (kResult == WAIT_OBJECT_0 + handle_count_) {
+        return Bit(EventSource::WindowMessages);
+    }
+    if (kResult > WAIT_OBJECT_0 && kResult < WAIT_OBJECT_0 + handle_count_) {
+        return Bit(sources_[kResult - WAIT_OBJECT_0]);
+    }
+    if (kResult == WAIT_FAILED) {
+        constexpr std::string_view kActionDescription = "wait for console input and events.";
+        constexpr std::string_view kQualifiedName =
+            "win32_event_waiter.cc::fsb::Win32EventWaiter::Wait";
+        constexpr std::string_view kExportedOperationName =
+            "User32.dll!MsgWaitForMultipleObjectsEx";
+        constexpr int kReturnCode = -1;
+        // Retrying would spin on the same failure.
+        WIN32_FAILFAST(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode);
+    }
+
+    // The wake event or a timeout.
+    return 0;
+}
+
+void Win32EventWaiter::Wake() {
+    static_cast<void>(SetEvent(wake_event_));
+}
+} // namespace fsb
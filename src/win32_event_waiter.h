@@ -0,0 +1,48 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_WIN32_EVENT_WAITER_H_
+#define FSB_WIN32_EVENT_WAITER_H_
+
+#include "event_loop.h"
+
+#include <Windows.h>
+#include <array>
+#include <cstdint>
+
+namespace fsb {
+//! @brief EventWaiter over kernel handles and the thread's message queue.
+//!
+//! A single MsgWaitForMultipleObjectsEx covers console input, the config change notification,
+//! an event used to wake the loop from worker threads and, optionally, queued messages, which is
+//! how out-of-context WinEvent hooks deliver their callbacks.
+class Win32EventWaiter : public EventWaiter {
+public:
+    Win32EventWaiter();
+    ~Win32EventWaiter();
+
+    Win32EventWaiter(const Win32EventWaiter&) = delete;
+    Win32EventWaiter& operator=(const Win32EventWaiter&) = delete;
+
+    //! @brief Reports source whenever handle is signaled. Null handles are ignored.
+    void Watch(EventSource source, HANDLE handle);
+    //! @brief Reports EventSource::WindowMessages whenever messages are queued for the thread.
+    void WatchMessages() { watch_messages_ = true; }
+
+    uint32_t Wait(uint32_t timeout_milliseconds) override;
+    void Wake() override;
+
+private:
+    //! Every source but WindowMessages, plus the wake event.
+    static constexpr size_t kMaxHandles = static_cast<size_t>(EventSource::Count);
+
+    std::array<HANDLE, kMaxHandles> handles_;
+    std::array<EventSource, kMaxHandles> sources_;
+    DWORD handle_count_;
+    HANDLE wake_event_;
+    bool watch_messages_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_WIN32_EVENT_WAITER_H_
@@ -0,0 +1,122 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "win32_geometry_backend.h"
+
+#include "error.h"
+#include "win32_display_topology.h"
+
+#include <memory>
+#include <string_view>
+
+namespace fsb {
+bool Win32GeometryBackend::GetGeometry(HWND window_handle, WindowMetrics* metrics) {
+    RECT window_rect;
+    if (window_handle == nullptr || !IsWindow(window_handle)
+        || !GetWindowRect(window_handle, &window_rect)) {
+        return false;
+    }
+
+    metrics->position_ = {static_cast<int32_t>(window_rect.left),
+        static_cast<int32_t>(window_rect.top)};
+    metrics->size_ = {static_cast<int32_t>(window_rect.right - window_rect.left),
+        static_cast<int32_t>(window_rect.bottom - window_rect.top)};
+    metrics->style_ = static_cast<uint32_t>(GetWindowLongPtrW(window_handle, GWL_STYLE));
+    metrics->ex_style_ = static_cast<uint32_t>(GetWindowLongPtrW(window_handle, GWL_EXSTYLE));
+    return true;
+}
+
+bool Win32GeometryBackend::GetMonitorBounds(HWND window_handle, int monitor, SizeVec2* position,
+    SizeVec2* size) {
+    const std::shared_ptr<const MonitorTopology> kTopology =
+        Win32DisplayTopology::Get().topology();
+    int index = monitor - 1;
+    if (monitor == 0) {
+        WindowMetrics metrics;
+        if (!GetGeometry(window_handle, &metrics)) {
+            return false;
+        }
+        index = kTopology->FindMonitor(metrics.position_, metrics.size_);
+    }
+    if (index < 0 || static_cast<size_t>(index) >= kTopology->size()) {
+        return false;
+    }
+
+    *position = (*kTopology)[index].position_;
+    *size = (*kTopology)[index].size_;
+    return true;
+}
+
+bool Win32GeometryBackend::SetStyles(HWND window_handle, uint32_t style, uint32_t ex_style) {
+    // The previous value is returned, which may well be 0, so failures only show in the last
+    // error.
+    SetLastError(ERROR_SUCCESS);
+    static_cast<void>(SetWindowLongPtrW(window_handle, GWL_STYLE, static_cast<LONG_PTR>(style)));
+    static_cast<void>(SetWindowLongPtrW(window_handle, GWL_EXSTYLE,
+        static_cast<LONG_PTR>(ex_style)));
+    if (GetLastError() != ERROR_SUCCESS) {
+        constexpr std::string_view kActionDescription = "set the styles of a window.";
+        constexpr std::string_view kQualifiedName =
+            "win32_geometry_backend.cc::fsb::Win32GeometryBackend::SetStyles";
+        constexpr std::string_view kExportedOperationName = "User32.dll!SetWindowLongPtrW";
+        constexpr int kReturnCode = 0;
+        WIN32_LOG(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode,
+            window_handle, 0);
+        return false;
+    }
+    return true;
+}
+
+bool Win32GeometryBackend::MoveWindows(const std::vector<WindowMove>& moves) {
+    if (moves.empty()) {
+        return true;
+    }
+
+    // A maximized window ignores moves until it is restored.
+    for (const WindowMove& move : moves) {
+        if (IsZoomed(move.window_handle_)) {
+            static_cast<void>(ShowWindow(move.window_handle_, SW_SHOWNOACTIVATE));
+        }
+    }
+
+    constexpr UINT kFlags = SWP_FRAMECHANGED | SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOACTIVATE;
+    HDWP batch = BeginDeferWindowPos(static_cast<int>(moves.size()));
+    for (size_t i = 0; i < moves.size() && batch != nullptr; ++i) {
+        const WindowMove& kMove = moves[i];
+        // On failure the batch is freed and nothing in it has moved yet.
+        batch = DeferWindowPos(batch, kMove.window_handle_, nullptr, kMove.position_.x,
+            kMove.position_.y, kMove.size_.x, kMove.size_.y, kFlags);
+    }
+    if (batch != nullptr && EndDeferWindowPos(batch)) {
+        return true;
+    }
+
+    constexpr std::string_view kActionDescription = "move a batch of windows.";
+    constexpr std::string_view kQualifiedName =
+        "win32_geometry_backend.cc::fsb::Win32GeometryBackend::MoveWindows";
+    constexpr std::string_view kExportedOperationName = "User32.dll!EndDeferWindowPos";
+    constexpr int kReturnCode = 0;
+    WIN32_LOG(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode,
+        nullptr, 0);
+
+    // One window that refuses should not hold back the rest, so they are moved one at a time.
+    bool succeeded = true;
+    for (const WindowMove& move : moves) {
+        succeeded = SetWindowPos(move.window_handle_, nullptr, move.position_.x,
+            move.position_.y, move.size_.x, move.size_.y, kFlags) && succeeded;
+    }
+    return succeeded;
+}
+
+bool Win32GeometryBackend::IsMaximized(HWND window_handle) {
+    return IsZoomed(window_handle) != FALSE;
+}
+
+bool Win32GeometryBackend::Maximize(HWND window_handle) {
+    // Returns whether the window was visible before, not whether it worked, so the state is read
+    // back instead.
+    static_cast<void>(ShowWindow(window_handle, SW_MAXIMIZE));
+    return IsZoomed(window_handle) != FALSE;
+}
+} // namespace fsb
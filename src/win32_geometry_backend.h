@@ -0,0 +1,27 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_WIN32_GEOMETRY_BACKEND_H_
+#define FSB_WIN32_GEOMETRY_BACKEND_H_
+
+#include "geometry_backend.h"
+
+#include <Windows.h>
+
+namespace fsb {
+//! @brief GeometryBackend implementation that changes windows on the live Win32 desktop.
+class Win32GeometryBackend : public GeometryBackend {
+public:
+    bool GetGeometry(HWND window_handle, WindowMetrics* metrics) override;
+    bool GetMonitorBounds(HWND window_handle, int monitor, SizeVec2* position,
+        SizeVec2* size) override;
+    bool SetStyles(HWND window_handle, uint32_t style, uint32_t ex_style) override;
+    //! Uses one DeferWindowPos batch, with SWP_FRAMECHANGED so new styles take effect.
+    bool MoveWindows(const std::vector<WindowMove>& moves) override;
+    bool IsMaximized(HWND window_handle) override;
+    bool Maximize(HWND window_handle) override;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_WIN32_GEOMETRY_BACKEND_H_
@@ -0,0 +1,273 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "win32_window_source.h"
+
+#include "error.h"
+#include "fsb_string.h"
+#include "monitor_topology.h"
+#include "trace.h"
+
+#include <string_view>
+
+namespace fsb {
+int Win32WindowSource::EnumWindowsCallback(HWND window_handle, LPARAM message_param) {
+    auto window_handles = reinterpret_cast<std::vector<HWND>*>(message_param);
+    window_handles->push_back(window_handle);
+    return 1;
+}
+
+void Win32WindowSource::EnumerateWindowHandles(std::vector<HWND>* window_handles) {
+    window_handles->clear();
+    if (!EnumWindows(EnumWindowsCallback, reinterpret_cast<LPARAM>(window_handles))) {
+        constexpr std::string_view kActionDescription = "enumerate the top-level windows.";
+        constexpr std::string_view kQualifiedName =
+            "win32_window_source.cc::fsb::Win32WindowSource::EnumerateWindowHandles";
+        constexpr std::string_view kExportedOperationName = "User32.dll!EnumWindows";
+        constexpr int kReturnCode = 0;
+        WIN32_LOG(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode,
+            nullptr, 0);
+    }
+}
+
+bool Win32WindowSource::GetWindowAttributes(HWND window_handle,
+    WindowAttributes* window_attributes) {
+    if (window_handle == nullptr || !IsWindow(window_handle)) {
+        return false;
+    }
+
+    const bool kIsWindowVisible = IsWindowVisible(window_handle);
+
+    const bool kIsWindowEnabled = IsWindowEnabled(window_handle);
+
+    WindowState window_state = WindowState::Normal;
+    WINDOWPLACEMENT window_placement;
+    window_placement.length = sizeof(window_placement);
+
+    if (GetWindowPlacement(window_handle, &window_placement)) {
+        // showCmd is the property used to determine window state.
+        // For example, nCmdShow in the WinMain entry point is the state to show the window in.
+        // I used to think it meant whether to show the CMD window or not, however it means show
+        // command not show command prompt.
+        // It's only real use is this and ShowWindow which is the prefix in the macro SW means.
+        // The values we need here are SW_SHOWMAXIMIZED, SW_SHOWMINIMIZED, SW_SHOWNORMAL and/or
+        // SW_RESTORE (these two mean the same).
+        switch (window_placement.showCmd) {
+            case SW_SHOWMAXIMIZED:
+                window_state = WindowState::Maximized;
+                break;
+            case SW_SHOWMINIMIZED:
+                window_state = WindowState::Minimized;
+                break;
+            default:
+                window_state = WindowState::Normal;
+                break;
+        }
+    } else {
+        constexpr std::string_view kActionDescription = "get the attributes for a window";
+        constexpr std::string_view kQualifiedName =
+            "win32_window_source.cc::fsb::Win32WindowSource::GetWindowAttributes";
+        constexpr std::string_view kExportedOperationName = "User32.dll!GetWindowPlacement";
+        const auto kReturnCode = static_cast<uint32_t>(GetLastError());
+        WIN32_LOG(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode,
+            window_handle, 0);
+        return false;
+    }
+
+    window_attributes->is_enabled_ = kIsWindowEnabled;
+    window_attributes->is_visible_ = kIsWindowVisible;
+    window_attributes->state_ = window_state;
+
+    return true;
+}
+
+bool Win32WindowSource::GetWindowMetrics(HWND window_handle, WindowMetrics* window_metrics) {
+    if (window_handle == nullptr || !IsWindow(window_handle)) {
+        return false;
+    }
+
+    RECT window_rect;
+    if (!GetWindowRect(window_handle, &window_rect)) {
+        constexpr std::string_view kActionDescription = "get the metrics for a window";
+        constexpr std::string_view kQualifiedName =
+            "win32_window_source.cc::fsb::Win32WindowSource::GetWindowMetrics";
+        constexpr std::string_view kExportedOperationName = "User32.dll!GetWindowRect";
+        const auto kReturnCode = static_cast<uint32_t>(GetLastError());
+        WIN32_LOG(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode,
+            window_handle, 0);
+        return false;
+    }
+
+    int x, y, width, height;
+    x = window_rect.left;
+    y = window_rect.top;
+    width = window_rect.right - window_rect.left;
+    height = window_rect.bottom - window_rect.top;
+
+    const uint32_t kStyle = static_cast<uint32_t>(GetWindowLongPtrW(window_handle,
+        GWL_STYLE));
+    const uint32_t kExStyle = static_cast<uint32_t>(GetWindowLongPtrW(window_handle,
+        GWL_EXSTYLE));
+
+    const SizeVec2 kPosition = {x, y};
+    const SizeVec2 kSize = {width, height};
+
+    window_metrics->position_ = kPosition;
+    window_metrics->size_ = kSize;
+    window_metrics->style_ = kStyle;
+    window_metrics->ex_style_ = kExStyle;
+
+    return true;
+}
+
+ProbeStatus Win32WindowSource::GetWindowFont(HWND window_handle, uint32_t timeout_milliseconds,
+    std::string* font_name, uint32_t* font_size) {
+    if (window_handle == nullptr || !IsWindow(window_handle)) {
+        return ProbeStatus::Failed;
+    }
+
+    *font_name = "";
+    *font_size = 0;
+
+    // The font comes back through the result parameter; the return value only reports success.
+    DWORD_PTR result = 0;
+    if (SendMessageTimeoutW(window_handle, WM_GETFONT, 0, 0, SMTO_ABORTIFHUNG,
+        timeout_milliseconds, &result) == 0) {
+        const DWORD kError = GetLastError();
+        // SMTO_ABORTIFHUNG fails right away with no error set when the window is already known
+        // to be hung.
+        return kError == ERROR_TIMEOUT || kError == 0 ? ProbeStatus::TimedOut
+            : ProbeStatus::Failed;
+    }
+    auto font_handle = reinterpret_cast<HFONT>(result);
+
+    LOGFONT log_font = {};
+    if (font_handle != nullptr) {
+        if (GetObjectW(font_handle, sizeof(LOGFONT), &log_font)) {
+            std::wstring buffer = log_font.lfFaceName;
+            *font_name = Utf16ToUtf8(buffer);
+
+            // Fonts are scaled for the DPI of the window itself. The process is per-monitor aware
+            // (see fsb.manifest), so this is the DPI of the monitor the window is on, read without
+            // its rectangle or the shared topology.
+            const UINT kWindowDpi = GetDpiForWindow(window_handle);
+            const int kDpi = kWindowDpi != 0 ? static_cast<int>(kWindowDpi)
+                : static_cast<int>(MonitorTopology::kDefaultDpi);
+
+            // Conversion: font size (in pixels) = lfHeight * 72 / DPI.
+            // 72 in this case is representative of 1 point (pixel) being 1/72 of an inch which is
+            // divided by DPI in case the dots per inch is more than 1/72.
+            if (log_font.lfHeight < 0) {
+                // Normally, negative height means character height in logical units.
+                *font_size = static_cast<uint32_t>(-log_font.lfHeight * 72 / kDpi);
+            } else {
+                // While uncommon, positive height is possible.
+                // Consider calling GetTextMetrics if this conversion is buggy.
+                *font_size = static_cast<uint32_t>(log_font.lfHeight * 72 / kDpi);
+            }
+        }
+    } else {
+        // TODO (jhowell728): Implement logging calls.
+        *font_name = "None";
+        *font_size = 0;
+    }
+
+    return ProbeStatus::Ok;
+}
+
+bool Win32WindowSource::GetWindowProcessId(HWND window_handle, uint32_t* process_id) {
+    if (GetWindowThreadProcessId(window_handle, reinterpret_cast<DWORD*>(process_id)) == 0) {
+        constexpr std::string_view kActionDescription = "get the process ID for a window.";
+        constexpr std::string_view kQualifiedName =
+            "win32_window_source.cc::fsb::Win32WindowSource::GetWindowProcessId";
+        constexpr std::string_view kExportedFunctionName = "User32.dll!GetWindowThreadProcessId";
+        constexpr int kReturnCode = 0;
+        WIN32_LOG(kActionDescription, kQualifiedName, kExportedFunctionName, kReturnCode,
+            window_handle, 0);
+        return false;
+    }
+
+    return true;
+}
+
+bool Win32WindowSource::GetWindowTitle(HWND window_handle, std::string* title) {
+    wchar_t title_buffer[256];
+    if (GetWindowTextW(window_handle, title_buffer, std::size(title_buffer)) == 0) {
+        title_buffer[0] = L'\0';
+        if (const auto kReturnCode = static_cast<uint32_t>(GetLastError());
+            kReturnCode != 0 && kReturnCode != ERROR_SEM_NOT_FOUND
+            && kReturnCode != ERROR_ACCESS_DENIED) {
+            constexpr std::string_view kActionDescription = "get the title of a window.";
+            constexpr std::string_view kQualifiedName =
+                "win32_window_source.cc::fsb::Win32WindowSource::GetWindowTitle";
+            constexpr std::string_view kExportedOperationName = "User32.dll!GetWindowTextW";
+            WIN32_LOG(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode,
+                window_handle, 0);
+        }
+    }
+
+    if (title_buffer[0] == L'\0') {
+        title->clear();
+    } else {
+        ScopedTrace trace(TracePhase::Transcode, window_handle);
+        *title = Utf16ToUtf8(title_buffer);
+    }
+
+    return true;
+}
+
+bool Win32WindowSource::GetWindowClassName(HWND window_handle, std::string* class_name) {
+    wchar_t class_buffer[256];
+    if (GetClassNameW(window_handle, class_buffer, std::size(class_buffer)) == 0) {
+        if (const auto kReturnCode = static_cast<uint32_t>(GetLastError());
+            kReturnCode != 0) {
+            constexpr std::string_view kActionDescription = "get the class name of a window.";
+            constexpr std::string_view kQualifiedName =
+                "win32_window_source.cc::fsb::Win32WindowSource::GetWindowClassName";
+            constexpr std::string_view kExportedOperationName = "User32.dll!GetClassNameW";
+            WIN32_LOG(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode,
+                window_handle, 0);
+        }
+        class_name->clear();
+        return false;
+    }
+
+    ScopedTrace trace(TracePhase::Transcode, window_handle);
+    *class_name = Utf16ToUtf8(class_buffer);
+    return true;
+}
+
+bool Win32WindowSource::GetProcessInfo(uint32_t process_id, uint64_t* start_time,
+    std::string* file_name) {
+    *start_time = kUnknownStartTime;
+    if (file_name != nullptr) {
+        // TODO(jhowell728): Come up with a better unknown file name value
+        *file_name = "???";
+    }
+
+    HANDLE process_handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION,
+        false, process_id);
+    if (!process_handle) {
+        return false;
+    }
+
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (GetProcessTimes(process_handle, &creation_time, &exit_time, &kernel_time, &user_time)) {
+        *start_time = (static_cast<uint64_t>(creation_time.dwHighDateTime) << 32)
+            | creation_time.dwLowDateTime;
+    }
+
+    if (file_name != nullptr) {
+        wchar_t process_file_name[MAX_PATH];
+        uint32_t size = MAX_PATH;
+        if (QueryFullProcessImageNameW(process_handle, 0, process_file_name,
+            reinterpret_cast<DWORD*>(&size))) {
+            *file_name = Utf16ToUtf8(process_file_name);
+        }
+    }
+
+    CloseHandle(process_handle);
+    return true;
+}
+} // namespace fsb
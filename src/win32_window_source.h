@@ -0,0 +1,32 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_WIN32_WINDOW_SOURCE_H_
+#define FSB_WIN32_WINDOW_SOURCE_H_
+
+#include "window_source.h"
+
+#include <Windows.h>
+
+namespace fsb {
+//! @brief WindowSource implementation backed by the live Win32 desktop.
+class Win32WindowSource : public WindowSource {
+public:
+    void EnumerateWindowHandles(std::vector<HWND>* window_handles) override;
+    bool GetWindowAttributes(HWND window_handle, WindowAttributes* window_attributes) override;
+    bool GetWindowMetrics(HWND window_handle, WindowMetrics* window_metrics) override;
+    ProbeStatus GetWindowFont(HWND window_handle, uint32_t timeout_milliseconds,
+        std::string* font_name, uint32_t* font_size) override;
+    bool GetWindowProcessId(HWND window_handle, uint32_t* process_id) override;
+    bool GetWindowTitle(HWND window_handle, std::string* title) override;
+    bool GetWindowClassName(HWND window_handle, std::string* class_name) override;
+    bool GetProcessInfo(uint32_t process_id, uint64_t* start_time,
+        std::string* file_name) override;
+
+private:
+    static int __stdcall EnumWindowsCallback(HWND window_handle, LPARAM message_param);
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_WIN32_WINDOW_SOURCE_H_
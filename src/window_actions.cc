@@ -0,0 +1,73 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_actions.h"
+
+#include "fsb_string.h"
+#include "win32_geometry_backend.h"
+
+#include <iterator>
+#include <vector>
+
+namespace fsb {
+size_t RestoreLayouts(const SnapshotReader& snapshot) {
+    // Handles are reused once a window is closed, so the process and class have to match too.
+    std::vector<size_t> records;
+    records.reserve(snapshot.size());
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        if (!snapshot.valid(i)) {
+            continue;
+        }
+        const SnapshotRecord& kRecord = snapshot[i];
+        const auto kWindowHandle = reinterpret_cast<HWND>(
+            static_cast<uintptr_t>(kRecord.window_handle_));
+        DWORD process_id = 0;
+        wchar_t class_name[256];
+        if (!IsWindow(kWindowHandle)
+            || GetWindowThreadProcessId(kWindowHandle, &process_id) == 0
+            || process_id != kRecord.process_id_
+            || GetClassNameW(kWindowHandle, class_name, static_cast<int>(std::size(class_name)))
+                == 0
+            || Utf16ToUtf8(class_name) != snapshot.class_name(i)) {
+            continue;
+        }
+        records.push_back(i);
+    }
+    if (records.empty()) {
+        return 0;
+    }
+
+    // Styles first, the move applies them.
+    Win32GeometryBackend backend;
+    std::vector<WindowMove> moves;
+    moves.reserve(records.size());
+    for (size_t i : records) {
+        const SnapshotRecord& kRecord = snapshot[i];
+        const auto kWindowHandle = reinterpret_cast<HWND>(
+            static_cast<uintptr_t>(kRecord.window_handle_));
+        static_cast<void>(backend.SetStyles(kWindowHandle, kRecord.style_, kRecord.ex_style_));
+        // A minimized window's rectangle is off screen, so only its style and state come back.
+        if (kRecord.state_ == static_cast<uint32_t>(WindowState::Minimized)) {
+            static_cast<void>(SetWindowPos(kWindowHandle, nullptr, 0, 0, 0, 0, SWP_FRAMECHANGED
+                | SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOACTIVATE));
+        } else {
+            moves.push_back({kWindowHandle, {kRecord.x_, kRecord.y_},
+                {kRecord.width_, kRecord.height_}});
+        }
+    }
+    static_cast<void>(backend.MoveWindows(moves));
+
+    for (size_t i : records) {
+        const SnapshotRecord& kRecord = snapshot[i];
+        const auto kWindowHandle = reinterpret_cast<HWND>(
+            static_cast<uintptr_t>(kRecord.window_handle_));
+        if (kRecord.state_ == static_cast<uint32_t>(WindowState::Maximized)) {
+            static_cast<void>(ShowWindow(kWindowHandle, SW_MAXIMIZE));
+        } else if (kRecord.state_ == static_cast<uint32_t>(WindowState::Minimized)) {
+            static_cast<void>(ShowWindow(kWindowHandle, SW_SHOWMINNOACTIVE));
+        }
+    }
+    return records.size();
+}
+} // namespace fsb
@@ -0,0 +1,24 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_WINDOW_ACTIONS_H_
+#define FSB_WINDOW_ACTIONS_H_
+
+#include "layout_snapshot.h"
+
+#include <Windows.h>
+#include <cstddef>
+
+namespace fsb {
+//! @brief Puts every window of a snapshot back the way it was recorded, in one batched move.
+//!
+//! Records of windows that were closed, or whose handle now belongs to another process or class,
+//! are skipped. Styles are set first, then every window is moved and resized at once, so the
+//! desktop is redrawn once rather than once per window.
+//!
+//! @returns Returns the number of windows that were restored.
+size_t RestoreLayouts(const SnapshotReader& snapshot);
+} // namespace fsb
+
+#endif // #ifndef FSB_WINDOW_ACTIONS_H_
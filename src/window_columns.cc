@@ -0,0 +1,176 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_columns.h"
+
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace fsb {
+Bitset::Bitset(size_t size, bool value)
+    : words_((size + 63) / 64, value ? ~uint64_t{0} : 0), size_(size) {
+    TrimTail();
+}
+
+Bitset& Bitset::operator&=(const Bitset& other) {
+    for (size_t i = 0; i < words_.size() && i < other.words_.size(); ++i) {
+        words_[i] &= other.words_[i];
+    }
+    return *this;
+}
+
+Bitset& Bitset::operator|=(const Bitset& other) {
+    for (size_t i = 0; i < words_.size() && i < other.words_.size(); ++i) {
+        words_[i] |= other.words_[i];
+    }
+    return *this;
+}
+
+void Bitset::Flip() {
+    for (auto& word : words_) {
+        word = ~word;
+    }
+    TrimTail();
+}
+
+size_t Bitset::Count() const {
+    size_t count = 0;
+    for (uint64_t word : words_) {
+#ifdef _MSC_VER
+        count += static_cast<size_t>(__popcnt64(word));
+#else
+        count += static_cast<size_t>(__builtin_popcountll(word));
+#endif
+    }
+    return count;
+}
+
+size_t Bitset::CountTrailingZeros(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return index;
+#else
+    return static_cast<size_t>(__builtin_ctzll(bits));
+#endif
+}
+
+void Bitset::TrimTail() {
+    if (size_ % 64 != 0 && !words_.empty()) {
+        words_.back() &= (uint64_t{1} << (size_ % 64)) - 1;
+    }
+}
+
+void WindowColumns::Build(const WindowTable& table) {
+    const size_t kCount = table.size();
+
+    handles_.resize(kCount);
+    process_ids_.resize(kCount);
+    styles_.resize(kCount);
+    ex_styles_.resize(kCount);
+    states_.resize(kCount);
+    class_names_.resize(kCount);
+    visible_ = Bitset(kCount);
+    enabled_ = Bitset(kCount);
+    title_data_.clear();
+    title_offsets_.resize(kCount + 1);
+
+    for (size_t i = 0; i < kCount; ++i) {
+        const ProcessData& window = table[i];
+        handles_[i] = window.window_handle_;
+        process_ids_[i] = window.process_id_;
+        styles_[i] = window.metrics_.style_;
+        ex_styles_[i] = window.metrics_.ex_style_;
+        states_[i] = static_cast<uint8_t>(window.attributes_.state_);
+        class_names_[i] = window.class_name_;
+        if (window.attributes_.is_visible_) {
+            visible_.Set(i);
+        }
+        if (window.attributes_.is_enabled_) {
+            enabled_.Set(i);
+        }
+        title_offsets_[i] = static_cast<uint32_t>(title_data_.size());
+        title_data_ += window.title_;
+    }
+    title_offsets_[kCount] = static_cast<uint32_t>(title_data_.size());
+}
+
+Bitset WindowColumns::MatchMasked(const std::vector<uint32_t>& column, uint32_t mask,
+    uint32_t value) {
+    Bitset result(column.size());
+    auto& words = result.words();
+
+    // Build each 64-bit word in a register, which the compiler can vectorize.
+    for (size_t word = 0; word < words.size(); ++word) {
+        const size_t kBase = word * 64;
+        const size_t kEnd = std::min(kBase + 64, column.size());
+        uint64_t bits = 0;
+        for (size_t i = kBase; i < kEnd; ++i) {
+            bits |= static_cast<uint64_t>((column[i] & mask) == value) << (i - kBase);
+        }
+        words[word] = bits;
+    }
+    return result;
+}
+
+Bitset WindowColumns::MatchStyle(uint32_t mask, uint32_t value) const {
+    return MatchMasked(styles_, mask, value);
+}
+
+Bitset WindowColumns::MatchExStyle(uint32_t mask, uint32_t value) const {
+    return MatchMasked(ex_styles_, mask, value);
+}
+
+Bitset WindowColumns::MatchState(WindowState state) const {
+    Bitset result(states_.size());
+    auto& words = result.words();
+    const auto kState = static_cast<uint8_t>(state);
+
+    for (size_t word = 0; word < words.size(); ++word) {
+        const size_t kBase = word * 64;
+        const size_t kEnd = std::min(kBase + 64, states_.size());
+        uint64_t bits = 0;
+        for (size_t i = kBase; i < kEnd; ++i) {
+            bits |= static_cast<uint64_t>(states_[i] == kState) << (i - kBase);
+        }
+        words[word] = bits;
+    }
+    return result;
+}
+
+std::string_view WindowColumns::title(size_t row) const {
+    return std::string_view(title_data_).substr(title_offsets_[row],
+        title_offsets_[row + 1] - title_offsets_[row]);
+}
+
+void WindowColumns::SortIndex(SortKey key, const Bitset& filter,
+    std::vector<uint32_t>* order) const {
+    order->clear();
+    order->reserve(filter.Count());
+    filter.ForEach([order](size_t row) { order->push_back(static_cast<uint32_t>(row)); });
+
+    switch (key) {
+        case SortKey::ZOrder:
+            break;
+        case SortKey::ProcessId:
+            std::stable_sort(order->begin(), order->end(), [this](uint32_t a, uint32_t b) {
+                return process_ids_[a] < process_ids_[b];
+            });
+            break;
+        case SortKey::ClassName:
+            std::stable_sort(order->begin(), order->end(), [this](uint32_t a, uint32_t b) {
+                return class_names_[a] < class_names_[b];
+            });
+            break;
+        case SortKey::Title:
+            std::stable_sort(order->begin(), order->end(), [this](uint32_t a, uint32_t b) {
+                return title(a) < title(b);
+            });
+            break;
+    }
+}
+} // namespace fsb
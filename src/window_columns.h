@@ -0,0 +1,115 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_WINDOW_COLUMNS_H_
+#define FSB_WINDOW_COLUMNS_H_
+
+#include "base_types.h"
+#include "window_table.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fsb {
+//! @brief Fixed-size set of bits, one per row of a WindowColumns table.
+class Bitset {
+public:
+    Bitset() : size_(0) {}
+    explicit Bitset(size_t size, bool value = false);
+
+    void Set(size_t index) { words_[index >> 6] |= uint64_t{1} << (index & 63); }
+    void Reset(size_t index) { words_[index >> 6] &= ~(uint64_t{1} << (index & 63)); }
+    bool Test(size_t index) const { return (words_[index >> 6] >> (index & 63)) & 1; }
+
+    Bitset& operator&=(const Bitset& other);
+    Bitset& operator|=(const Bitset& other);
+    //! @brief Flips every bit in place.
+    void Flip();
+
+    size_t Count() const;
+    size_t size() const { return size_; }
+
+    //! @brief Calls function(index) for every set bit, in increasing order.
+    template <typename Function>
+    void ForEach(Function function) const {
+        for (size_t word = 0; word < words_.size(); ++word) {
+            uint64_t bits = words_[word];
+            while (bits != 0) {
+                function((word << 6) + CountTrailingZeros(bits));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    std::vector<uint64_t>& words() { return words_; }
+    const std::vector<uint64_t>& words() const { return words_; }
+
+private:
+    static size_t CountTrailingZeros(uint64_t bits);
+    //! Clears the unused bits of the last word so counts and iteration stay exact.
+    void TrimTail();
+
+    std::vector<uint64_t> words_;
+    size_t size_;
+};
+
+//! @brief Column-oriented copy of the window table for filtering and sorting.
+//!
+//! Hot fields (handle, PID, styles, state) each live in their own array and boolean attributes are
+//! stored as bitsets, so predicates run as tight loops that only touch the column they test.
+//! Titles are packed into one character buffer, and class names stay interned views. Sorting
+//! permutes an index array and never moves the rows themselves.
+class WindowColumns {
+public:
+    enum class SortKey {
+        //! Order the windows were enumerated in, which is their Z-order.
+        ZOrder,
+        ProcessId,
+        ClassName,
+        Title
+    };
+
+    //! @brief Rebuilds every column from the table.
+    void Build(const WindowTable& table);
+
+    size_t size() const { return handles_.size(); }
+
+    //! Bitset with every row set, as the starting point of a filter.
+    Bitset All() const { return Bitset(size(), true); }
+    Bitset MatchVisible() const { return visible_; }
+    Bitset MatchEnabled() const { return enabled_; }
+    //! Rows whose style has the bits in mask equal to value.
+    Bitset MatchStyle(uint32_t mask, uint32_t value) const;
+    Bitset MatchExStyle(uint32_t mask, uint32_t value) const;
+    Bitset MatchState(WindowState state) const;
+
+    //! @brief Fills order with the rows set in filter, sorted by key. Ties keep their Z-order.
+    void SortIndex(SortKey key, const Bitset& filter, std::vector<uint32_t>* order) const;
+
+    HWND handle(size_t row) const { return handles_[row]; }
+    uint32_t process_id(size_t row) const { return process_ids_[row]; }
+    std::string_view title(size_t row) const;
+    std::string_view class_name(size_t row) const { return class_names_[row]; }
+
+private:
+    static Bitset MatchMasked(const std::vector<uint32_t>& column, uint32_t mask, uint32_t value);
+
+    std::vector<HWND> handles_;
+    std::vector<uint32_t> process_ids_;
+    std::vector<uint32_t> styles_;
+    std::vector<uint32_t> ex_styles_;
+    std::vector<uint8_t> states_;
+    Bitset visible_;
+    Bitset enabled_;
+    //! Title of row i is title_data_[title_offsets_[i], title_offsets_[i + 1]).
+    std::string title_data_;
+    std::vector<uint32_t> title_offsets_;
+    std::vector<std::string_view> class_names_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_WINDOW_COLUMNS_H_
@@ -0,0 +1,106 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_event_hook.h"
+
+#include "error.h"
+
+#include <string_view>
+
+namespace fsb {
+WindowEventHook* WindowEventHook::instance_ = nullptr;
+
+WindowEventHook::WindowEventHook() : hook_(nullptr) {}
+
+WindowEventHook::~WindowEventHook() {
+    if (hook_ != nullptr) {
+        static_cast<void>(UnhookWinEvent(hook_));
+        instance_ = nullptr;
+    }
+}
+
+bool WindowEventHook::Install() {
+    if (hook_ != nullptr) {
+        return true;
+    }
+
+    // EVENT_OBJECT_CREATE through EVENT_OBJECT_NAMECHANGE covers create, destroy, show, hide,
+    // location and name changes, along with a few events that are filtered out in the callback.
+    hook_ = SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_NAMECHANGE, nullptr, EventCallback,
+        0, 0, WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+    if (hook_ == nullptr) {
+        constexpr std::string_view kActionDescription = "listen for window changes.";
+        constexpr std::string_view kQualifiedName =
+            "window_event_hook.cc::fsb::WindowEventHook::Install";
+        constexpr std::string_view kExportedOperationName = "User32.dll!SetWinEventHook";
+        constexpr int kReturnCode = 0;
+        WIN32_ERROR(kActionDescription, kQualifiedName, kExportedOperationName, kReturnCode);
+        return false;
+    }
+
+    instance_ = this;
+    return true;
+}
+
+void WindowEventHook::Pump() {
+    // Out-of-context events are only delivered while this thread pumps messages.
+    MSG message;
+    while (PeekMessageW(&message, nullptr, 0, 0, PM_REMOVE)) {
+        static_cast<void>(TranslateMessage(&message));
+        static_cast<void>(DispatchMessageW(&message));
+    }
+}
+
+void WindowEventHook::Drain(std::vector<WindowEvent>* events) {
+    Pump();
+
+    events->clear();
+    events->swap(pending_);
+}
+
+void CALLBACK WindowEventHook::EventCallback(HWINEVENTHOOK hook, DWORD event,
+    HWND window_handle, LONG object_id, LONG child_id, DWORD event_thread, DWORD event_time) {
+    UNREFERENCED_PARAMETER(hook);
+    UNREFERENCED_PARAMETER(event_thread);
+    UNREFERENCED_PARAMETER(event_time);
+
+    // Only events about the window itself matter, not its caret, cursor, scroll bars, etc.
+    if (instance_ == nullptr || window_handle == nullptr || object_id != OBJID_WINDOW
+        || child_id != CHILDID_SELF) {
+        return;
+    }
+
+    WindowEventType type;
+    switch (event) {
+        case EVENT_OBJECT_CREATE:
+            type = WindowEventType::Created;
+            break;
+        case EVENT_OBJECT_DESTROY:
+            type = WindowEventType::Destroyed;
+            break;
+        case EVENT_OBJECT_SHOW:
+            type = WindowEventType::Shown;
+            break;
+        case EVENT_OBJECT_HIDE:
+            type = WindowEventType::Hidden;
+            break;
+        case EVENT_OBJECT_NAMECHANGE:
+            type = WindowEventType::TitleChanged;
+            break;
+        case EVENT_OBJECT_LOCATIONCHANGE:
+            type = WindowEventType::Moved;
+            break;
+        default:
+            return;
+    }
+
+    // Destroyed windows can no longer be queried, the table ignores handles it does not know.
+    if (type != WindowEventType::Destroyed
+        && GetAncestor(window_handle, GA_ROOT) != window_handle) {
+        return;
+    }
+
+    instance_->pending_.push_back({type, window_handle});
+}
+} // namespace fsb
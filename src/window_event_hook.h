@@ -0,0 +1,50 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_WINDOW_EVENT_HOOK_H_
+#define FSB_WINDOW_EVENT_HOOK_H_
+
+#include "window_table.h"
+
+#include <Windows.h>
+#include <vector>
+
+namespace fsb {
+//! @brief Collects top-level window events from the system through SetWinEventHook.
+//!
+//! The hook is out-of-context, so events are delivered to the thread that installed it whenever
+//! that thread pumps messages. Drain pumps the pending messages and hands back what was collected.
+//!
+//! @note Only one hook may be installed at a time, as WinEvent callbacks carry no user data.
+class WindowEventHook {
+public:
+    WindowEventHook();
+    ~WindowEventHook();
+
+    WindowEventHook(const WindowEventHook&) = delete;
+    WindowEventHook& operator=(const WindowEventHook&) = delete;
+
+    //! @brief Installs the hook. Returns false if the system refused it.
+    bool Install();
+    bool installed() const { return hook_ != nullptr; }
+
+    //! @brief Pumps pending messages so their events are collected, without handing them back.
+    void Pump();
+    bool has_pending() const { return !pending_.empty(); }
+
+    //! @brief Pumps pending messages and moves every collected event into events.
+    void Drain(std::vector<WindowEvent>* events);
+
+private:
+    static void CALLBACK EventCallback(HWINEVENTHOOK hook, DWORD event, HWND window_handle,
+        LONG object_id, LONG child_id, DWORD event_thread, DWORD event_time);
+
+    HWINEVENTHOOK hook_;
+    std::vector<WindowEvent> pending_;
+
+    static WindowEventHook* instance_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_WINDOW_EVENT_HOOK_H_
@@ -0,0 +1,132 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_health.h"
+
+#include <algorithm>
+
+namespace fsb {
+namespace {
+//! Weight of the newest sample in the average response time.
+constexpr double kResponseWeight = 0.2;
+//! Processes not probed for this long are forgotten, which also covers PID reuse.
+constexpr auto kForgetAfter = std::chrono::minutes(10);
+} // namespace
+
+HealthTracker::HealthTracker(const HealthOptions& options)
+    : options_(options), budget_(options.round_budget_), skipped_(0), timeouts_(0) {}
+
+void HealthTracker::BeginRound() {
+    const Clock::time_point kNow = Clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    budget_ = options_.round_budget_;
+    for (auto it = processes_.begin(); it != processes_.end();) {
+        if (kNow - it->second.last_probe_ > kForgetAfter && kNow >= it->second.quarantined_until_) {
+            it = processes_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool HealthTracker::ShouldProbe(uint32_t process_id, uint32_t* timeout_milliseconds) {
+    const Clock::time_point kNow = Clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = processes_.try_emplace(process_id,
+        ProcessHealth{0.0, 0, 0, 0, Clock::time_point(), kNow});
+    ProcessHealth& health = it->second;
+
+    // A process that just timed out gets one probe at a time until it answers again, so its other
+    // windows do not all wait out the same hang in parallel.
+    const bool kSuspect = health.consecutive_timeouts_ > 0 && health.in_flight_ > 0;
+    if (kNow < health.quarantined_until_ || kSuspect) {
+        ++skipped_;
+        return false;
+    }
+
+    uint32_t timeout = options_.max_timeout_;
+    if (health.average_response_ > 0.0 && health.consecutive_timeouts_ == 0) {
+        const auto kTypical = static_cast<uint32_t>(health.average_response_ / 1000.0 + 1.0);
+        timeout = std::clamp(kTypical * options_.timeout_factor_, options_.min_timeout_,
+            options_.max_timeout_);
+    }
+
+    // Probes already in flight may still overrun the budget by one timeout each, which bounds
+    // the overrun by the number of probe workers rather than by the number of hung windows.
+    if (budget_ <= 0) {
+        ++skipped_;
+        return false;
+    }
+    timeout = std::min<uint32_t>(timeout, static_cast<uint32_t>(budget_));
+
+    health.last_probe_ = kNow;
+    ++health.in_flight_;
+    *timeout_milliseconds = timeout;
+    return true;
+}
+
+void HealthTracker::Report(uint32_t process_id, ProbeStatus status, Clock::duration elapsed) {
+    const Clock::time_point kNow = Clock::now();
+    const auto kElapsedMicroseconds = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Charge what was actually spent waiting; answering windows cost next to nothing.
+    budget_ -= static_cast<int64_t>(kElapsedMicroseconds / 1000.0);
+
+    ProcessHealth& health = processes_[process_id];
+    if (health.in_flight_ > 0) {
+        --health.in_flight_;
+    }
+    if (status != ProbeStatus::TimedOut) {
+        // A plain failure (window gone, access denied) still says the process is answering.
+        health.average_response_ = health.average_response_ == 0.0 ? kElapsedMicroseconds
+            : health.average_response_ + kResponseWeight
+                * (kElapsedMicroseconds - health.average_response_);
+        health.consecutive_timeouts_ = 0;
+        if (health.quarantines_ > 0 && kNow >= health.quarantined_until_) {
+            --health.quarantines_;
+        }
+        return;
+    }
+
+    ++timeouts_;
+    ++health.consecutive_timeouts_;
+    // A process that was quarantined before goes straight back on its first new timeout.
+    if (health.consecutive_timeouts_ >= options_.quarantine_after_ || health.quarantines_ > 0) {
+        const uint32_t kShift = std::min<uint32_t>(health.quarantines_, 16);
+        const uint64_t kBackoff = std::min<uint64_t>(
+            static_cast<uint64_t>(options_.base_backoff_) << kShift, options_.max_backoff_);
+        health.quarantined_until_ = kNow + std::chrono::milliseconds(kBackoff);
+        ++health.quarantines_;
+        health.consecutive_timeouts_ = 0;
+    }
+}
+
+bool HealthTracker::IsQuarantined(uint32_t process_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = processes_.find(process_id);
+    return it != processes_.end() && Clock::now() < it->second.quarantined_until_;
+}
+
+uint64_t HealthTracker::skipped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return skipped_;
+}
+
+uint64_t HealthTracker::timeouts() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timeouts_;
+}
+
+size_t HealthTracker::quarantined_count() const {
+    const Clock::time_point kNow = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(std::count_if(processes_.begin(), processes_.end(),
+        [kNow](const auto& entry) { return kNow < entry.second.quarantined_until_; }));
+}
+} // namespace fsb
@@ -0,0 +1,97 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_WINDOW_HEALTH_H_
+#define FSB_WINDOW_HEALTH_H_
+
+#include "window_source.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace fsb {
+//! @brief Tuning of HealthTracker. Times are in milliseconds.
+struct HealthOptions {
+    //! Timeout for processes that have not answered yet, and the upper bound for every timeout.
+    uint32_t max_timeout_ = 100;
+    uint32_t min_timeout_ = 10;
+    //! Timeouts are this many times the typical response time of the process.
+    uint32_t timeout_factor_ = 4;
+    //! Consecutive timeouts before a process is quarantined.
+    uint32_t quarantine_after_ = 2;
+    //! First quarantine period. Each further quarantine doubles it, up to max_backoff_.
+    uint32_t base_backoff_ = 5000;
+    uint32_t max_backoff_ = 300000;
+    //! Time the probes of one round may spend waiting, whatever the number of hung windows. Probes
+    //! already in flight when it runs out may overrun it by one timeout each.
+    uint32_t round_budget_ = 250;
+};
+
+//! @brief Learns how quickly each process answers cross-process queries and keeps hung ones
+//! from stalling the probes.
+//!
+//! A window hangs because the thread that owns it stops pumping messages, which usually takes the
+//! whole process with it, so health is tracked per process. For each process the tracker keeps an
+//! exponentially weighted average of its response time:
+//! - Known-fast processes get a timeout a few times their average instead of the full 100 ms.
+//! - Processes that time out repeatedly are quarantined. Their probes are skipped and callers
+//!   show cached values. The quarantine period doubles every time the process reoffends.
+//! - Time spent waiting is charged against a per-round budget. Once the budget is spent, the
+//!   remaining probes of the round are skipped, which bounds the worst case of a round however
+//!   many hung applications are open.
+//!
+//! @note Safe to use from multiple probe workers at once.
+class HealthTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit HealthTracker(const HealthOptions& options = {});
+
+    //! @brief Starts a new round (a refresh or a frame) with a fresh timeout budget, and forgets
+    //! processes that have not been probed for a long time.
+    void BeginRound();
+
+    //! @brief Decides whether a window of a process should be probed now.
+    //!
+    //! @param timeout_milliseconds Receives the timeout to use for the probe.
+    //! @returns Returns false if the process is quarantined or the round's budget is spent.
+    bool ShouldProbe(uint32_t process_id, uint32_t* timeout_milliseconds);
+
+    //! @brief Reports the outcome of a probe that ShouldProbe allowed.
+    void Report(uint32_t process_id, ProbeStatus status, Clock::duration elapsed);
+
+    bool IsQuarantined(uint32_t process_id) const;
+
+    //! Number of probes skipped so far because of quarantine or budget.
+    uint64_t skipped() const;
+    //! Number of probes that timed out so far.
+    uint64_t timeouts() const;
+    size_t quarantined_count() const;
+
+private:
+    struct ProcessHealth {
+        //! Average response time in microseconds, 0 until the first answer.
+        double average_response_;
+        uint32_t consecutive_timeouts_;
+        uint32_t quarantines_;
+        //! Probes allowed by ShouldProbe and not reported yet.
+        uint32_t in_flight_;
+        Clock::time_point quarantined_until_;
+        Clock::time_point last_probe_;
+    };
+
+    HealthOptions options_;
+    mutable std::mutex mutex_;
+    std::unordered_map<uint32_t, ProcessHealth> processes_;
+    //! Milliseconds of timeout still available in this round.
+    int64_t budget_;
+    uint64_t skipped_;
+    uint64_t timeouts_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_WINDOW_HEALTH_H_
@@ -0,0 +1,182 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_probe.h"
+
+#include "trace.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace fsb {
+namespace {
+// Mirrors WS_EX_TOOLWINDOW so the probe does not depend on Windows.h.
+constexpr uint32_t kExStyleToolWindow = 0x00000080;
+
+enum class ProbeResult : uint8_t {
+    Pending,
+    Listed,
+    Skipped
+};
+} // namespace
+
+bool ProbeWindow(WindowSource& source, StringPool& strings, HWND window_handle,
+    const Config& config, ProcessData* process_data) {
+    if (window_handle == nullptr) {
+        return false;
+    }
+
+    Tracer& tracer = Tracer::Get();
+    const uint64_t kStart = tracer.enabled() ? Tracer::Now() : 0;
+
+    // Failures are reported by the source. A window whose attributes or metrics could not be read
+    // is still listed with zeroed values, as long as it passes the filters.
+    WindowAttributes window_attributes = {};
+    {
+        ScopedTrace trace(TracePhase::Attributes, window_handle);
+        static_cast<void>(source.GetWindowAttributes(window_handle, &window_attributes));
+    }
+
+    if (!window_attributes.is_visible_ && config.hide_hidden_windows_) {
+        return false;
+    }
+
+    WindowMetrics window_metrics = {};
+    {
+        ScopedTrace trace(TracePhase::Metrics, window_handle);
+        static_cast<void>(source.GetWindowMetrics(window_handle, &window_metrics));
+    }
+
+    if (window_metrics.ex_style_ & kExStyleToolWindow) {
+        return false;
+    }
+
+    uint32_t process_id = 0;
+    {
+        ScopedTrace trace(TracePhase::ProcessId, window_handle);
+        if (!source.GetWindowProcessId(window_handle, &process_id)) {
+            return false;
+        }
+    }
+
+    std::string title;
+    {
+        ScopedTrace trace(TracePhase::Title, window_handle);
+        static_cast<void>(source.GetWindowTitle(window_handle, &title));
+    }
+
+    if (title.empty() && config.hide_blank_title_windows_) {
+        return false;
+    }
+
+    std::string class_name;
+    {
+        ScopedTrace trace(TracePhase::ClassName, window_handle);
+        static_cast<void>(source.GetWindowClassName(window_handle, &class_name));
+    }
+
+    process_data->attributes_ = window_attributes;
+    process_data->class_name_ = strings.InternView(class_name);
+    process_data->metrics_ = std::move(window_metrics);
+    process_data->process_id_ = process_id;
+    process_data->title_ = std::move(title);
+    process_data->window_handle_ = window_handle;
+    process_data->has_details_ = false;
+
+    // Only listed windows are attributed; the filtered ones are cheap and would drown them out.
+    if (kStart != 0) {
+        const uint64_t kEnd = Tracer::Now();
+        tracer.RecordPhase(TracePhase::ProbeWindow, kStart, kEnd, window_handle);
+        tracer.RecordWindow(TracePhase::ProbeWindow, window_handle, process_id,
+            process_data->class_name_, kEnd - kStart);
+    }
+
+    return true;
+}
+
+void EnumerateWindows(WindowSource& source, StringPool& strings, ProbePool& pool,
+    const Config& config, std::vector<ProcessData>* windows) {
+    ScopedTrace trace(TracePhase::Enumerate);
+
+    std::vector<HWND> window_handles;
+    source.EnumerateWindowHandles(&window_handles);
+
+    windows->clear();
+    windows->resize(window_handles.size());
+
+    // Plain array rather than std::vector<bool> so workers never share a byte.
+    std::unique_ptr<bool[]> listed(new bool[window_handles.size()]());
+
+    pool.ParallelFor(window_handles.size(), [&](size_t index) {
+        listed[index] = ProbeWindow(source, strings, window_handles[index], config,
+            &(*windows)[index]);
+    });
+
+    // Compact the listed windows to the front, keeping their Z-order.
+    size_t listed_count = 0;
+    for (size_t i = 0; i < window_handles.size(); ++i) {
+        if (!listed[i]) {
+            continue;
+        }
+        if (listed_count != i) {
+            (*windows)[listed_count] = std::move((*windows)[i]);
+        }
+        ++listed_count;
+    }
+    windows->resize(listed_count);
+}
+
+size_t StreamWindows(WindowSource& source, StringPool& strings, ProbePool& pool,
+    const Config& config, std::chrono::nanoseconds batch_interval,
+    const std::function<bool(ProcessData*)>& refine,
+    const std::function<void(std::vector<ProcessData> batch, bool done)>& on_batch) {
+    using Clock = std::chrono::steady_clock;
+    ScopedTrace trace(TracePhase::Enumerate);
+
+    std::vector<HWND> window_handles;
+    source.EnumerateWindowHandles(&window_handles);
+
+    std::vector<ProcessData> windows(window_handles.size());
+    std::unique_ptr<ProbeResult[]> results(new ProbeResult[window_handles.size()]());
+
+    std::mutex mutex;
+    size_t next_window = 0;
+    std::vector<ProcessData> batch;
+    bool handed_over = false;
+    Clock::time_point last_batch;
+
+    pool.ParallelFor(window_handles.size(), [&](size_t index) {
+        ProcessData& window = windows[index];
+        const bool kListed = ProbeWindow(source, strings, window_handles[index], config, &window)
+            && (!refine || refine(&window));
+
+        std::lock_guard<std::mutex> lock(mutex);
+        results[index] = kListed ? ProbeResult::Listed : ProbeResult::Skipped;
+        while (next_window < window_handles.size()
+            && results[next_window] != ProbeResult::Pending) {
+            if (results[next_window] == ProbeResult::Listed) {
+                batch.push_back(std::move(windows[next_window]));
+            }
+            ++next_window;
+        }
+
+        // The last batch is handed over by the calling thread, with done set.
+        if (batch.empty() || next_window == window_handles.size()) {
+            return;
+        }
+        const Clock::time_point kNow = Clock::now();
+        if (handed_over && kNow - last_batch < batch_interval) {
+            return;
+        }
+        on_batch(std::move(batch), false);
+        batch.clear();
+        handed_over = true;
+        last_batch = kNow;
+    });
+
+    on_batch(std::move(batch), true);
+    return window_handles.size();
+}
+} // namespace fsb
@@ -0,0 +1,63 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_WINDOW_PROBE_H_
+#define FSB_WINDOW_PROBE_H_
+
+#include "base_types.h"
+#include "config.h"
+#include "probe_pool.h"
+#include "string_pool.h"
+#include "window_source.h"
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace fsb {
+//! @brief Probes a single window and fills in the cheap tier of its process data.
+//!
+//! Only calls that are answered by the window manager itself are made here. The expensive tier
+//! (WindowDetails) is left for DetailLoader.
+//!
+//! @param source The window system to query.
+//! @param strings Pool the class name is interned into.
+//! @param window_handle The window to probe.
+//! @param config The user configuration, used to filter out hidden and untitled windows.
+//! @param process_data Receives the probed data. Only meaningful if the function returns true.
+//! @returns Returns true if the window should be listed, false if it was filtered out or could
+//! not be probed.
+bool ProbeWindow(WindowSource& source, StringPool& strings, HWND window_handle,
+    const Config& config, ProcessData* process_data);
+
+//! @brief Enumerates and probes every top-level window.
+//!
+//! Enumeration happens in two phases: a cheap pass that only collects the window handles, followed
+//! by a parallel pass on the probe pool that fills one ProcessData slot per handle in place. The
+//! windows that survive the filters are then compacted into the output in their original Z-order.
+//!
+//! @param windows Receives the listed windows. Any previous content is replaced.
+void EnumerateWindows(WindowSource& source, StringPool& strings, ProbePool& pool,
+    const Config& config, std::vector<ProcessData>* windows);
+
+//! @brief Enumerates and probes every top-level window like EnumerateWindows, but hands the listed
+//! windows over in batches while the rest are still being probed.
+//!
+//! Batches keep the Z-order: a window is handed over once every window before it is done. The
+//! first batch goes out as soon as it has a window, later ones at most every batch_interval,
+//! which keeps the consumer from being flooded with single windows.
+//!
+//! @param refine Optional. Runs on the worker right after a window passed ProbeWindow, e.g. to
+//! load more data or filter further. Returning false drops the window.
+//! @param on_batch Receives every batch. Called one call at a time, from pool threads and from
+//! the calling thread, which makes the last call with done set once every window is probed.
+//! @returns Returns the number of top-level windows that were probed.
+size_t StreamWindows(WindowSource& source, StringPool& strings, ProbePool& pool,
+    const Config& config, std::chrono::nanoseconds batch_interval,
+    const std::function<bool(ProcessData*)>& refine,
+    const std::function<void(std::vector<ProcessData> batch, bool done)>& on_batch);
+} // namespace fsb
+
+#endif // #ifndef FSB_WINDOW_PROBE_H_
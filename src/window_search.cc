@@ -0,0 +1,237 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_search.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace fsb {
+namespace {
+constexpr char kFieldSeparator = '\x1f';
+// Substring matches score in [kMinSubstringScore, kMaxScore], scattered matches below that.
+constexpr int kMinSubstringScore = 500;
+constexpr int kMaxScore = 1300;
+
+char ToLower(char character) {
+    return character >= 'A' && character <= 'Z' ? static_cast<char>(character - 'A' + 'a')
+        : character;
+}
+
+bool IsWordCharacter(char character) {
+    return (character >= 'a' && character <= 'z') || (character >= '0' && character <= '9')
+        || (static_cast<unsigned char>(character) & 0x80) != 0;
+}
+
+//! Letters and digits get a bit each; every other byte shares the remaining 28 bits.
+uint64_t CharacterBit(char character) {
+    const auto kByte = static_cast<unsigned char>(character);
+    if (kByte >= 'a' && kByte <= 'z') {
+        return uint64_t{1} << (kByte - 'a');
+    }
+    if (kByte >= '0' && kByte <= '9') {
+        return uint64_t{1} << (26 + kByte - '0');
+    }
+    return uint64_t{1} << (36 + kByte % 28);
+}
+
+uint64_t CharacterMask(std::string_view text) {
+    uint64_t mask = 0;
+    for (char character : text) {
+        mask |= CharacterBit(character);
+    }
+    return mask;
+}
+
+bool IsWordStart(std::string_view text, size_t position) {
+    return position == 0 || !IsWordCharacter(text[position - 1]);
+}
+} // namespace
+
+void WindowSearch::Build(const WindowTable& table,
+    const std::vector<std::string_view>& file_names) {
+    const size_t kCount = table.size();
+
+    text_.clear();
+    text_offsets_.resize(kCount + 1);
+    title_lengths_.resize(kCount);
+    masks_.resize(kCount);
+
+    for (size_t i = 0; i < kCount; ++i) {
+        const ProcessData& window = table[i];
+        const size_t kBegin = text_.size();
+        text_offsets_[i] = static_cast<uint32_t>(kBegin);
+        title_lengths_[i] = static_cast<uint32_t>(window.title_.size());
+
+        text_ += window.title_;
+        text_ += kFieldSeparator;
+        text_ += window.class_name_;
+        if (i < file_names.size() && !file_names[i].empty()) {
+            text_ += kFieldSeparator;
+            text_ += file_names[i];
+        }
+        std::transform(text_.begin() + kBegin, text_.end(), text_.begin() + kBegin, ToLower);
+        masks_[i] = CharacterMask(std::string_view(text_).substr(kBegin));
+    }
+    text_offsets_[kCount] = static_cast<uint32_t>(text_.size());
+
+    query_.clear();
+    levels_.clear();
+}
+
+void WindowSearch::Push(char character) {
+    query_ += ToLower(character);
+    Narrow(levels_.empty() ? nullptr : &levels_.back());
+}
+
+void WindowSearch::Pop() {
+    if (query_.empty()) {
+        return;
+    }
+    query_.pop_back();
+    levels_.pop_back();
+}
+
+void WindowSearch::SetQuery(std::string_view query) {
+    query_.clear();
+    levels_.clear();
+    for (char character : query) {
+        Push(character);
+    }
+}
+
+const std::vector<uint32_t>& WindowSearch::results() const {
+    static const std::vector<uint32_t> kNoResults;
+    return levels_.empty() ? kNoResults : levels_.back().ranked_;
+}
+
+std::string_view WindowSearch::text(size_t row) const {
+    return std::string_view(text_).substr(text_offsets_[row],
+        text_offsets_[row + 1] - text_offsets_[row]);
+}
+
+void WindowSearch::Narrow(const Level* previous) {
+    const uint64_t kQueryMask = CharacterMask(query_);
+    const char kCharacter = query_.back();
+    const size_t kLength = query_.size();
+
+    Level level;
+    std::vector<int> scores;
+    if (previous != nullptr) {
+        level.matches_.reserve(previous->matches_.size());
+        level.states_.reserve(previous->matches_.size());
+        scores.reserve(previous->matches_.size());
+    }
+
+    // Moves the greedy subsequence alignment on to the query character at found.
+    auto advance = [&](uint32_t row, std::string_view text, size_t found, MatchState* state) {
+        if (state->previous_ != kNoPosition && found == state->previous_ + 1) {
+            state->scatter_score_ += 8;
+        }
+        if (IsWordStart(text, found)) {
+            state->scatter_score_ += 6;
+        }
+        if (found < title_lengths_[row]) {
+            state->scatter_score_ += 1;
+        }
+        state->previous_ = static_cast<uint32_t>(found);
+        state->next_ = static_cast<uint32_t>(found + 1);
+    };
+
+    // Aligns the whole query inside the first field from begin on that holds all of it.
+    auto realign = [&](uint32_t row, std::string_view text, size_t begin, MatchState* state) {
+        while (begin <= text.size()) {
+            const size_t kFieldEnd = std::min(text.find(kFieldSeparator, begin), text.size());
+            state->next_ = static_cast<uint32_t>(begin);
+            state->previous_ = kNoPosition;
+            state->scatter_score_ = 0;
+            size_t found = begin;
+            for (char character : query_) {
+                found = text.find(character, state->next_);
+                if (found >= kFieldEnd) {
+                    break;
+                }
+                advance(row, text, found, state);
+            }
+            if (found < kFieldEnd) {
+                return true;
+            }
+            begin = kFieldEnd + 1;
+        }
+        return false;
+    };
+
+    // Extends the match of the previous query by one character. Both the left-most substring and
+    // the greedy subsequence alignment only ever move forward, so this is a short search from
+    // where the previous keystroke stopped rather than a rescan of the row. An alignment must stay
+    // inside one field; only when it would run into the next does the query start over there.
+    auto extend = [&](uint32_t row, MatchState state) {
+        if ((kQueryMask & ~masks_[row]) != 0) {
+            return;
+        }
+        const std::string_view kText = text(row);
+
+        const size_t kFound = kText.find(kCharacter, state.next_);
+        const size_t kFieldEnd = std::min(kText.find(kFieldSeparator, state.next_), kText.size());
+        if (kFound < kFieldEnd) {
+            advance(row, kText, kFound, &state);
+        } else if (!realign(row, kText, kFieldEnd + 1, &state)) {
+            return;
+        }
+
+        if (state.substring_ != kNoPosition) {
+            const size_t kEnd = state.substring_ + kLength - 1;
+            if (kEnd >= kText.size() || kText[kEnd] != kCharacter) {
+                const size_t kSubstring = kText.find(query_, state.substring_ + 1);
+                state.substring_ = kSubstring == std::string_view::npos ? kNoPosition
+                    : static_cast<uint32_t>(kSubstring);
+            }
+        }
+
+        int score = std::min(state.scatter_score_, kMinSubstringScore - 1);
+        if (state.substring_ != kNoPosition) {
+            score = 1000 - static_cast<int>(std::min<uint32_t>(state.substring_,
+                1000 - kMinSubstringScore));
+            if (IsWordStart(kText, state.substring_)) {
+                score += 200;
+            }
+            if (state.substring_ + kLength <= title_lengths_[row]) {
+                score += 100;
+            }
+        }
+
+        level.matches_.push_back(row);
+        level.states_.push_back(state);
+        scores.push_back(score);
+    };
+
+    if (previous == nullptr) {
+        // The empty query is a substring of every row, at position 0.
+        const MatchState kStart = {0, 0, kNoPosition, 0};
+        for (uint32_t row = 0; row < masks_.size(); ++row) {
+            extend(row, kStart);
+        }
+    } else {
+        for (size_t i = 0; i < previous->matches_.size(); ++i) {
+            extend(previous->matches_[i], previous->states_[i]);
+        }
+    }
+
+    // Scores are small integers, so a counting sort ranks 10k rows in a fraction of what a
+    // comparison sort takes, and it keeps ties in table order for free.
+    std::vector<uint32_t> starts(kMaxScore + 2, 0);
+    for (int score : scores) {
+        ++starts[kMaxScore - score + 1];
+    }
+    for (size_t i = 1; i < starts.size(); ++i) {
+        starts[i] += starts[i - 1];
+    }
+    level.ranked_.resize(scores.size());
+    for (size_t i = 0; i < scores.size(); ++i) {
+        level.ranked_[starts[kMaxScore - scores[i]]++] = level.matches_[i];
+    }
+
+    levels_.push_back(std::move(level));
+}
+} // namespace fsb
@@ -0,0 +1,86 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_WINDOW_SEARCH_H_
+#define FSB_WINDOW_SEARCH_H_
+
+#include "window_table.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fsb {
+//! @brief Incremental fuzzy search over window titles, classes and executables.
+//!
+//! A row matches when the query is a case-insensitive subsequence of its title, class name or
+//! executable path. Every row keeps a 64-bit mask of the characters it contains, so the first
+//! keystroke rejects most rows with a single AND. Each later keystroke only has to look at the rows
+//! that matched the previous query, because anything matching "abc" also matches "ab". The matches
+//! of every query prefix are kept on a stack, so deleting a character is a pop.
+//!
+//! Results are ranked by how well they match. Substring matches rank above scattered ones, and
+//! matches at the start of a word or inside the title get a bonus. Ties keep their Z-order.
+class WindowSearch {
+public:
+    //! @brief Indexes the rows of table. Clears the query.
+    //!
+    //! @param file_names Executable path of each row, or an empty view if it is unknown.
+    void Build(const WindowTable& table, const std::vector<std::string_view>& file_names);
+
+    //! @brief Appends a character to the query and narrows the previous results.
+    void Push(char character);
+    //! @brief Removes the last character of the query and restores the results it had.
+    void Pop();
+    //! @brief Runs query from scratch, e.g. after the index was rebuilt.
+    void SetQuery(std::string_view query);
+    void Clear() { SetQuery({}); }
+
+    std::string_view query() const { return query_; }
+    bool active() const { return !query_.empty(); }
+    //! Matching rows of the table, best match first. Empty while there is no query.
+    const std::vector<uint32_t>& results() const;
+
+    size_t size() const { return masks_.size(); }
+
+private:
+    static constexpr uint32_t kNoPosition = UINT32_MAX;
+
+    //! Where the query matched in one row, so the next keystroke can continue from there.
+    struct MatchState {
+        //! Left-most position of the query as a substring, or kNoPosition.
+        uint32_t substring_;
+        //! Position after the last character of the greedy subsequence match.
+        uint32_t next_;
+        //! Position of the last character of the greedy subsequence match, or kNoPosition.
+        uint32_t previous_;
+        int scatter_score_;
+    };
+
+    //! Matches of one query prefix.
+    struct Level {
+        //! Matching rows in table order, which is what the next keystroke narrows.
+        std::vector<uint32_t> matches_;
+        std::vector<MatchState> states_;
+        //! The same rows, best match first.
+        std::vector<uint32_t> ranked_;
+    };
+
+    std::string_view text(size_t row) const;
+    //! Builds the level for query_ from the matches of the previous level, or from every row.
+    void Narrow(const Level* previous);
+
+    //! Lower-cased "title\x1fclass\x1fexecutable" of every row, packed back to back.
+    std::string text_;
+    std::vector<uint32_t> text_offsets_;
+    std::vector<uint32_t> title_lengths_;
+    std::vector<uint64_t> masks_;
+    std::string query_;
+    std::vector<Level> levels_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_WINDOW_SEARCH_H_
@@ -0,0 +1,392 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_server.h"
+
+#include "geometry_batch.h"
+#include "rule_engine.h"
+#include "window_probe.h"
+
+#include <charconv>
+#include <utility>
+
+namespace fsb {
+namespace {
+constexpr uint32_t kFontFields = FieldBit(RecordField::Font) | FieldBit(RecordField::FontSize);
+
+//! Parses a window handle as written in the handle field, or in hex with a 0x prefix.
+bool ParseWindowHandle(std::string_view text, HWND* window_handle) {
+    int base = 10;
+    if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        text.remove_prefix(2);
+        base = 16;
+    }
+    uintptr_t value = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value,
+        base);
+    if (error != std::errc() || end != text.data() + text.size() || value == 0) {
+        return false;
+    }
+    *window_handle = reinterpret_cast<HWND>(value);
+    return true;
+}
+} // namespace
+
+bool ParseServerRequest(const std::vector<std::string>& arguments, ServerRequest* request,
+    std::string* error) {
+    if (arguments.empty()) {
+        *error = "Missing request, expected list, query, apply or stop.";
+        return false;
+    }
+
+    request->options_ = {};
+    request->window_handle_ = nullptr;
+    request->monitor_ = 0;
+    const std::string_view kCommand = arguments[0];
+    if (kCommand == "list") {
+        request->command_ = ServerCommand::List;
+    } else if (kCommand == "query") {
+        request->command_ = ServerCommand::Query;
+    } else if (kCommand == "apply") {
+        request->command_ = ServerCommand::Apply;
+    } else if (kCommand == "stop") {
+        request->command_ = ServerCommand::Stop;
+    } else {
+        *error = "Unknown request " + arguments[0] + ", expected list, query, apply or stop.";
+        return false;
+    }
+
+    for (size_t i = 1; i < arguments.size(); ++i) {
+        std::string_view name = arguments[i];
+        std::string_view value;
+        bool has_value = false;
+        const size_t kEqualPosition = name.find('=');
+        if (kEqualPosition != std::string_view::npos) {
+            value = name.substr(kEqualPosition + 1);
+            name = name.substr(0, kEqualPosition);
+            has_value = true;
+        }
+
+        // Reads the value of an option that takes one.
+        const auto kTakeValue = [&]() {
+            if (!has_value && i + 1 < arguments.size()) {
+                value = arguments[++i];
+                has_value = true;
+            }
+            if (!has_value) {
+                *error = std::string(name) + " needs a value.";
+            }
+            return has_value;
+        };
+
+        const bool kTakesHandle = request->command_ == ServerCommand::Query
+            || request->command_ == ServerCommand::Apply;
+        if (kTakesHandle && request->window_handle_ == nullptr && name.substr(0, 2) != "--") {
+            if (!ParseWindowHandle(arguments[i], &request->window_handle_)) {
+                *error = "Invalid window handle " + arguments[i] + ".";
+                return false;
+            }
+        } else if (request->command_ == ServerCommand::Stop) {
+            *error = "stop takes no options.";
+            return false;
+        } else if (name == "--all") {
+            request->options_.config_.hide_hidden_windows_ = false;
+            request->options_.config_.hide_blank_title_windows_ = false;
+        } else if (name == "--format" && request->command_ != ServerCommand::Apply) {
+            if (!kTakeValue()) {
+                return false;
+            }
+            if (value == "ndjson") {
+                request->options_.format_ = OutputFormat::Ndjson;
+            } else if (value == "csv") {
+                request->options_.format_ = OutputFormat::Csv;
+            } else {
+                *error = "Unknown format " + std::string(value) + ", expected ndjson or csv.";
+                return false;
+            }
+        } else if (name == "--fields" && request->command_ != ServerCommand::Apply) {
+            if (!kTakeValue()) {
+                return false;
+            }
+            if (!ParseRecordFields(value, &request->options_.fields_)) {
+                *error = "Invalid field list " + std::string(value) + ".";
+                return false;
+            }
+        } else if (name == "--filter" && request->command_ != ServerCommand::Query) {
+            if (!kTakeValue()) {
+                return false;
+            }
+            if (!ParseConditions(value, &request->options_.filter_)) {
+                *error = "Invalid filter " + std::string(value) + ".";
+                return false;
+            }
+        } else if (name == "--monitor" && request->command_ == ServerCommand::Apply) {
+            if (!kTakeValue()) {
+                return false;
+            }
+            const auto [end, parse_error] = std::from_chars(value.data(),
+                value.data() + value.size(), request->monitor_);
+            if (parse_error != std::errc() || end != value.data() + value.size()
+                || request->monitor_ < 0) {
+                *error = "Invalid monitor " + std::string(value) + ".";
+                return false;
+            }
+        } else {
+            *error = "Unknown option " + arguments[i] + " for " + arguments[0] + ".";
+            return false;
+        }
+    }
+
+    if (request->command_ == ServerCommand::Query && request->window_handle_ == nullptr) {
+        *error = "query needs a window handle.";
+        return false;
+    }
+    // Apply changes windows, so it never defaults to all of them.
+    if (request->command_ == ServerCommand::Apply && request->window_handle_ == nullptr
+        && request->options_.filter_.empty()) {
+        *error = "apply needs a window handle or a filter.";
+        return false;
+    }
+    return true;
+}
+
+std::string EncodeServerRequest(const std::vector<std::string>& arguments) {
+    std::string message;
+    for (const std::string& argument : arguments) {
+        message.append(argument);
+        message.push_back('\0');
+    }
+    return message;
+}
+
+std::vector<std::string> DecodeServerRequest(std::string_view message) {
+    std::vector<std::string> arguments;
+    while (!message.empty()) {
+        const size_t kEnd = message.find('\0');
+        arguments.emplace_back(message.substr(0, kEnd));
+        message.remove_prefix(kEnd == std::string_view::npos ? message.size() : kEnd + 1);
+    }
+    return arguments;
+}
+
+WindowServer::WindowServer(WindowSource& source, GeometryBackend& geometry, ProbePool& pool)
+    : source_(source), geometry_(geometry), pool_(pool), snapshot_(nullptr),
+        config_(kDefaultConfig), request_timeout_(kRequestTimeout), listener_(nullptr),
+        channel_(nullptr), stopping_(false), process_cache_(strings_) {
+    config_.hide_hidden_windows_ = false;
+    config_.hide_blank_title_windows_ = false;
+}
+
+void WindowServer::SetSnapshot(SnapshotWriter* snapshot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_ = snapshot;
+}
+
+void WindowServer::Refresh() {
+    // Probed outside the lock, so requests keep being answered from the old table meanwhile.
+    // The pool is thread-safe on its own.
+    std::vector<ProcessData> windows;
+    EnumerateWindows(source_, strings_, pool_, config_, &windows);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    windows_.Reset(std::move(windows));
+}
+
+void WindowServer::Update(const std::vector<WindowEvent>& events) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    static_cast<void>(windows_.Apply(events, source_, strings_, config_));
+}
+
+size_t WindowServer::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return windows_.size();
+}
+
+std::string WindowServer::Handle(std::string_view message, bool* stop) {
+    *stop = false;
+    ServerRequest request;
+    std::string error;
+    if (!ParseServerRequest(DecodeServerRequest(message), &request, &error)) {
+        return kResponseError + error;
+    }
+
+    std::string response(1, kResponseOk);
+    switch (request.command_) {
+        case ServerCommand::List:
+        case ServerCommand::Query:
+            List(request, &response);
+            break;
+        case ServerCommand::Apply:
+            Apply(request, &response);
+            break;
+        case ServerCommand::Stop:
+            *stop = true;
+            response += "Stopping.\n";
+            break;
+    }
+    return response;
+}
+
+bool WindowServer::Listed(const ProcessData& window, const Config& config) {
+    return (window.attributes_.is_visible_ || !config.hide_hidden_windows_)
+        && (!window.title_.empty() || !config.hide_blank_title_windows_);
+}
+
+bool WindowServer::Refine(const HeadlessOptions& options, RuleMatcher& filter,
+    ProcessData* window) {
+    if ((options.fields_ & FieldBit(RecordField::Exe)) != 0 || filter.needs_file_name()) {
+        window->details_.file_name_ = process_cache_.GetFileName(source_, window->process_id_);
+    }
+    if (!filter.empty()
+        && filter.Match(window->class_name_, window->title_, window->details_.file_name_) < 0) {
+        return false;
+    }
+
+    uint32_t timeout = 0;
+    if ((options.fields_ & kFontFields) != 0
+        && health_.ShouldProbe(window->process_id_, &timeout)) {
+        const auto kFontStart = HealthTracker::Clock::now();
+        const ProbeStatus kStatus = source_.GetWindowFont(window->window_handle_, timeout,
+            &window->details_.font_name_, &window->details_.font_size_);
+        health_.Report(window->process_id_, kStatus, HealthTracker::Clock::now() - kFontStart);
+    }
+    return true;
+}
+
+void WindowServer::List(const ServerRequest& request, std::string* response) {
+    const HeadlessOptions& kOptions = request.options_;
+    RuleMatcher filter;
+    if (!kOptions.filter_.empty()) {
+        filter.Compile({Rule{kOptions.filter_, {0}, 0}});
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    process_cache_.BeginRefresh();
+    health_.BeginRound();
+    if (kOptions.format_ == OutputFormat::Csv) {
+        AppendCsvHeader(kOptions.fields_, response);
+    }
+
+    if (request.command_ == ServerCommand::Query) {
+        const int kRow = windows_.Find(request.window_handle_);
+        if (kRow < 0) {
+            *response = kResponseError + std::string("No such window.");
+            return;
+        }
+        ProcessData& window = windows_[static_cast<size_t>(kRow)];
+        static_cast<void>(Refine(kOptions, filter, &window));
+        AppendRecord(window, kOptions.fields_, kOptions.format_, response);
+        return;
+    }
+
+    for (ProcessData& window : windows_) {
+        if (Listed(window, kOptions.config_) && Refine(kOptions, filter, &window)) {
+            AppendRecord(window, kOptions.fields_, kOptions.format_, response);
+        }
+    }
+}
+
+void WindowServer::Apply(const ServerRequest& request, std::string* response) {
+    RuleMatcher filter;
+    if (!request.options_.filter_.empty()) {
+        filter.Compile({Rule{request.options_.filter_, {0}, 0}});
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    process_cache_.BeginRefresh();
+
+    GeometryBatch batch(geometry_);
+    bool snapshot_changed = false;
+    for (ProcessData& window : windows_) {
+        if (request.window_handle_ != nullptr && window.window_handle_ != request.window_handle_) {
+            continue;
+        }
+        if (!Listed(window, request.options_.config_)
+            || !Refine(request.options_, filter, &window)) {
+            continue;
+        }
+
+        const GeometryChange& kChange = batch.AddBorderless(window.window_handle_,
+            request.monitor_);
+        if (kChange.status_ != ApplyStatus::Pending || snapshot_ == nullptr) {
+            continue;
+        }
+        // The batch read the geometry right before the change, which is what the window goes
+        // back to.
+        ProcessData layout = window;
+        layout.metrics_ = kChange.before_;
+        snapshot_changed = snapshot_->Add(layout) || snapshot_changed;
+    }
+    if (batch.changes().empty()) {
+        *response = kResponseError + std::string("No window matches.");
+        return;
+    }
+
+    // Written before the change, so the layouts survive the daemon going away half-way.
+    if (snapshot_changed) {
+        static_cast<void>(snapshot_->Flush());
+    }
+    static_cast<void>(batch.Commit());
+    response->append(batch.Summary());
+    response->push_back('\n');
+}
+
+void WindowServer::SetRequestTimeout(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(serve_mutex_);
+    request_timeout_ = timeout;
+}
+
+void WindowServer::Serve(IpcListener& listener, const std::function<void()>& on_stop) {
+    {
+        std::lock_guard<std::mutex> lock(serve_mutex_);
+        if (stopping_) {
+            return;
+        }
+        listener_ = &listener;
+    }
+
+    IpcChannel channel;
+    std::string message;
+    bool stop = false;
+    while (!stop && listener.Accept(&channel)) {
+        {
+            // A StopServing that ran since Accept returned has no channel to cancel yet.
+            std::lock_guard<std::mutex> lock(serve_mutex_);
+            if (stopping_) {
+                break;
+            }
+            channel.SetTimeout(request_timeout_);
+            channel_ = &channel;
+        }
+        if (channel.Receive(&message)) {
+            static_cast<void>(channel.Send(Handle(message, &stop)));
+        }
+        {
+            std::lock_guard<std::mutex> lock(serve_mutex_);
+            channel_ = nullptr;
+        }
+        channel.Close();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(serve_mutex_);
+        listener_ = nullptr;
+    }
+    if (stop) {
+        listener.Stop();
+        on_stop();
+    }
+}
+
+void WindowServer::StopServing() {
+    std::lock_guard<std::mutex> lock(serve_mutex_);
+    stopping_ = true;
+    if (listener_ != nullptr) {
+        listener_->Stop();
+    }
+    if (channel_ != nullptr) {
+        channel_->Cancel();
+    }
+}
+} // namespace fsb
@@ -0,0 +1,153 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_WINDOW_SERVER_H_
+#define FSB_WINDOW_SERVER_H_
+
+#include "geometry_backend.h"
+#include "headless.h"
+#include "ipc_channel.h"
+#include "layout_snapshot.h"
+#include "probe_pool.h"
+#include "process_cache.h"
+#include "string_pool.h"
+#include "window_health.h"
+#include "window_source.h"
+#include "window_table.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fsb {
+//! First byte of every response, followed by the records or a status line.
+constexpr char kResponseOk = '+';
+//! First byte of a response to a request that failed, followed by the reason.
+constexpr char kResponseError = '-';
+
+enum class ServerCommand {
+    //! Records of every listed window that matches the filter.
+    List,
+    //! The record of one window, by handle.
+    Query,
+    //! Makes every listed window that matches borderless, as one GeometryBatch.
+    Apply,
+    //! Stops the server.
+    Stop
+};
+
+struct ServerRequest {
+    ServerCommand command_;
+    //! Format, fields, filter and hidden/untitled filtering, as for --list.
+    HeadlessOptions options_;
+    //! Window of query, and of apply when set.
+    HWND window_handle_;
+    //! Monitor of apply, see RuleAction.
+    int monitor_;
+};
+
+//! @brief Parses a request, given as arguments like a command line:
+//!     list [--format ndjson|csv] [--fields LIST] [--filter CONDITIONS] [--all]
+//!     query HANDLE [--format ndjson|csv] [--fields LIST]
+//!     apply (HANDLE | --filter CONDITIONS) [--monitor N] [--all]
+//!     stop
+//!
+//! @param error Receives a message naming the offending argument when parsing fails.
+bool ParseServerRequest(const std::vector<std::string>& arguments, ServerRequest* request,
+    std::string* error);
+
+//! @brief Packs request arguments into one message, separated by NUL bytes.
+std::string EncodeServerRequest(const std::vector<std::string>& arguments);
+std::vector<std::string> DecodeServerRequest(std::string_view message);
+
+//! @brief Keeps the window table of a long-running process warm and answers requests from it.
+//!
+//! The table is filled by one full enumeration and then kept current with window events, so a
+//! request costs a walk over the rows in memory rather than an enumeration. It holds hidden and
+//! untitled windows too, which each request filters out unless asked not to. Executable paths
+//! are cached per process across requests. Fonts are cross-process calls and are only queried
+//! when a request selects them.
+//!
+//! @note Thread-safe. Requests, refreshes and updates are serialized on one mutex.
+class WindowServer {
+public:
+    //! How long a client may take to send its request and read the response by default.
+    static constexpr std::chrono::milliseconds kRequestTimeout{5000};
+
+    WindowServer(WindowSource& source, GeometryBackend& geometry, ProbePool& pool);
+
+    WindowServer(const WindowServer&) = delete;
+    WindowServer& operator=(const WindowServer&) = delete;
+
+    //! @brief Layouts are recorded here before apply changes a window, so they can be restored
+    //! from the menu. Optional.
+    void SetSnapshot(SnapshotWriter* snapshot);
+
+    //! @brief Replaces the table with a full enumeration.
+    void Refresh();
+    //! @brief Applies a batch of window events to the table.
+    void Update(const std::vector<WindowEvent>& events);
+
+    //! @brief Answers one encoded request.
+    //!
+    //! @param stop Set when the request asked the server to stop.
+    //! @returns Returns the response, starting with kResponseOk or kResponseError.
+    std::string Handle(std::string_view message, bool* stop);
+
+    //! @brief Sets how long Serve waits on one client, see kRequestTimeout. Zero waits forever.
+    void SetRequestTimeout(std::chrono::milliseconds timeout);
+
+    //! @brief Answers requests from every client of listener, one request per connection, until
+    //! the listener stops, a client asks to stop or StopServing is called.
+    //!
+    //! A client that does not send its whole request, or read the whole response, within the
+    //! request timeout is dropped, so it cannot keep the others waiting for long.
+    //!
+    //! @param on_stop Called once a stop request was answered.
+    void Serve(IpcListener& listener, const std::function<void()>& on_stop);
+    //! @brief Stops the listener of Serve and drops the client it is talking to, so Serve returns
+    //! right away. Serve returns at once if it is called afterwards. Safe to call from any
+    //! thread.
+    void StopServing();
+
+    size_t size() const;
+
+private:
+    void List(const ServerRequest& request, std::string* response);
+    void Apply(const ServerRequest& request, std::string* response);
+    //! Whether a row passes the hidden and untitled filters of a request.
+    static bool Listed(const ProcessData& window, const Config& config);
+    //! Loads what the fields or the filter of a request need and returns whether the window
+    //! matches the filter.
+    bool Refine(const HeadlessOptions& options, RuleMatcher& filter, ProcessData* window);
+
+    WindowSource& source_;
+    GeometryBackend& geometry_;
+    ProbePool& pool_;
+    SnapshotWriter* snapshot_;
+    //! Lists every window the source reports, for requests to filter.
+    Config config_;
+
+    //! Guards what StopServing reaches into, separate from mutex_ so it never waits on a request.
+    std::mutex serve_mutex_;
+    std::chrono::milliseconds request_timeout_;
+    IpcListener* listener_;
+    //! Client Serve is talking to, null between clients.
+    IpcChannel* channel_;
+    bool stopping_;
+
+    mutable std::mutex mutex_;
+    StringPool strings_;
+    ProcessCache process_cache_;
+    HealthTracker health_;
+    WindowTable windows_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_WINDOW_SERVER_H_
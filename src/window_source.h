@@ -0,0 +1,96 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_WINDOW_SOURCE_H_
+#define FSB_WINDOW_SOURCE_H_
+
+#include "base_types.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fsb {
+//! @brief Start time of a process that could not be read. It never matches another start time,
+//! not even itself, so such a process is never taken for an earlier one with the same PID.
+constexpr uint64_t kUnknownStartTime = 0;
+
+//! @brief Outcome of a call that has to wait on another process.
+enum class ProbeStatus {
+    Ok,
+    Failed,
+    //! The window did not answer in time, usually because its thread is hung.
+    TimedOut
+};
+
+enum class WindowEventType {
+    Created,
+    Destroyed,
+    Shown,
+    Hidden,
+    TitleChanged,
+    Moved
+};
+
+//! @brief A change to a single top-level window, as reported by the window system.
+struct WindowEvent {
+    WindowEventType type_;
+    HWND window_handle_;
+};
+
+//! @brief Abstraction over the window system queried while enumerating windows.
+//!
+//! Every call the enumeration and probing code makes into the window system goes through this
+//! interface. The Win32 implementation (Win32WindowSource) talks to the live desktop, while other
+//! implementations can serve windows from memory so the enumeration pipeline can be driven on any
+//! platform.
+//!
+//! @note Implementations must be safe to call concurrently from multiple threads for different
+//! window handles, as the probe pass runs on a worker pool.
+class WindowSource {
+public:
+    virtual ~WindowSource() = default;
+
+    //! @brief Collects the handles of every top-level window, in Z-order.
+    //!
+    //! This is the cheap first pass of enumeration and must not probe the windows themselves.
+    virtual void EnumerateWindowHandles(std::vector<HWND>* window_handles) = 0;
+
+    virtual bool GetWindowAttributes(HWND window_handle, WindowAttributes* window_attributes) = 0;
+    virtual bool GetWindowMetrics(HWND window_handle, WindowMetrics* window_metrics) = 0;
+
+    //! @brief Reads the font used by a window. This is a cross-process call and may block on a
+    //! hung window, so it is only made when the details of a window are needed.
+    //!
+    //! @param timeout_milliseconds How long to wait for the window to answer.
+    virtual ProbeStatus GetWindowFont(HWND window_handle, uint32_t timeout_milliseconds,
+        std::string* font_name, uint32_t* font_size) = 0;
+    virtual bool GetWindowProcessId(HWND window_handle, uint32_t* process_id) = 0;
+
+    //! @brief Reads the title of a window. A window without a title yields an empty string and
+    //! still returns true.
+    virtual bool GetWindowTitle(HWND window_handle, std::string* title) = 0;
+    virtual bool GetWindowClassName(HWND window_handle, std::string* class_name) = 0;
+
+    //! @brief Reads the creation time of a process and, optionally, its full image path, through
+    //! one open of the process. Together with the PID the start time identifies one process
+    //! instance, as PIDs are reused once a process exits.
+    //!
+    //! @param start_time Receives an opaque, monotonically increasing timestamp, or
+    //! kUnknownStartTime if it cannot be read.
+    //! @param file_name Receives the image path, or "???" if it cannot be read. May be null when
+    //! only the start time is needed.
+    //! @return False if the process could not be opened at all.
+    virtual bool GetProcessInfo(uint32_t process_id, uint64_t* start_time,
+        std::string* file_name) = 0;
+
+    //! @brief Called with every batch of window events before it is applied to a WindowTable,
+    //! so a source can keep track of the event path too. Does nothing by default.
+    virtual void ObserveEvents(const std::vector<WindowEvent>& events) {
+        static_cast<void>(events);
+    }
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_WINDOW_SOURCE_H_
@@ -0,0 +1,230 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_table.h"
+
+#include "window_probe.h"
+
+#include <algorithm>
+#include <string>
+
+namespace fsb {
+namespace {
+//! What has to be re-read for one window once all of its events in a batch are merged.
+struct PendingUpdate {
+    HWND window_handle_;
+    bool destroyed_;
+    //! The handle was destroyed and then reused by a new window, so the listed row is stale.
+    bool replaced_;
+    bool full_probe_;
+    bool title_;
+    bool metrics_;
+};
+} // namespace
+
+void WindowTable::Reset(std::vector<ProcessData> windows) {
+    rows_ = std::move(windows);
+    index_.clear();
+    index_.reserve(rows_.size());
+    for (size_t i = 0; i < rows_.size(); ++i) {
+        index_[rows_[i].window_handle_] = i;
+    }
+}
+
+size_t WindowTable::Append(std::vector<ProcessData> windows) {
+    const size_t kPreviousSize = rows_.size();
+    rows_.reserve(rows_.size() + windows.size());
+    for (ProcessData& window : windows) {
+        if (index_.try_emplace(window.window_handle_, rows_.size()).second) {
+            rows_.push_back(std::move(window));
+        }
+    }
+    return rows_.size() - kPreviousSize;
+}
+
+size_t WindowTable::Apply(const std::vector<WindowEvent>& events, WindowSource& source,
+    StringPool& strings, const Config& config, std::vector<HWND>* removed,
+    std::vector<HWND>* probed) {
+    if (probed != nullptr) {
+        probed->clear();
+    }
+    source.ObserveEvents(events);
+
+    // Merge the events per window, keeping the order in which windows first appeared.
+    std::vector<PendingUpdate> updates;
+    std::unordered_map<HWND, size_t> update_index;
+    for (const auto& event : events) {
+        auto [it, inserted] = update_index.try_emplace(event.window_handle_, updates.size());
+        if (inserted) {
+            updates.push_back({event.window_handle_, false, false, false, false, false});
+        }
+
+        PendingUpdate& update = updates[it->second];
+        switch (event.type_) {
+            case WindowEventType::Destroyed:
+                update.destroyed_ = true;
+                update.full_probe_ = false;
+                break;
+            case WindowEventType::Created:
+                // A handle can be reused by a new window once the old one is gone.
+                update.replaced_ = update.replaced_ || update.destroyed_;
+                update.destroyed_ = false;
+                update.full_probe_ = true;
+                break;
+            case WindowEventType::Shown:
+            case WindowEventType::Hidden:
+                update.full_probe_ = !update.destroyed_;
+                break;
+            case WindowEventType::TitleChanged:
+                update.title_ = true;
+                break;
+            case WindowEventType::Moved:
+                update.metrics_ = true;
+                break;
+        }
+    }
+
+    size_t changed = 0;
+    std::vector<size_t> remove_rows;
+    std::vector<HWND> replaced;
+    for (const auto& update : updates) {
+        const int kRow = Find(update.window_handle_);
+
+        if (update.destroyed_) {
+            if (kRow >= 0) {
+                remove_rows.push_back(static_cast<size_t>(kRow));
+            }
+            continue;
+        }
+
+        // A new title can make a previously untitled window eligible for the list.
+        const bool kNeedsFullProbe = update.full_probe_
+            || (kRow < 0 && update.title_ && config.hide_blank_title_windows_);
+
+        if (kNeedsFullProbe) {
+            ProcessData process_data = {};
+            if (!ProbeWindow(source, strings, update.window_handle_, config, &process_data)) {
+                if (kRow >= 0) {
+                    remove_rows.push_back(static_cast<size_t>(kRow));
+                }
+                continue;
+            }
+
+            if (kRow >= 0) {
+                rows_[kRow] = std::move(process_data);
+                if (update.replaced_) {
+                    replaced.push_back(update.window_handle_);
+                }
+            } else {
+                index_[update.window_handle_] = rows_.size();
+                rows_.push_back(std::move(process_data));
+            }
+            if (probed != nullptr) {
+                probed->push_back(update.window_handle_);
+            }
+            ++changed;
+            continue;
+        }
+
+        if (kRow < 0) {
+            continue;
+        }
+
+        ProcessData& row = rows_[kRow];
+        if (update.metrics_) {
+            // Minimizing and maximizing also move the window, and change its state.
+            static_cast<void>(source.GetWindowAttributes(update.window_handle_,
+                &row.attributes_));
+            if (!row.attributes_.is_visible_ && config.hide_hidden_windows_) {
+                remove_rows.push_back(static_cast<size_t>(kRow));
+                continue;
+            }
+            static_cast<void>(source.GetWindowMetrics(update.window_handle_, &row.metrics_));
+        }
+        if (update.title_) {
+            std::string title;
+            static_cast<void>(source.GetWindowTitle(update.window_handle_, &title));
+            if (title.empty() && config.hide_blank_title_windows_) {
+                remove_rows.push_back(static_cast<size_t>(kRow));
+                continue;
+            }
+            row.title_ = std::move(title);
+            if (probed != nullptr) {
+                probed->push_back(update.window_handle_);
+            }
+        }
+        ++changed;
+    }
+
+    if (removed != nullptr) {
+        removed->assign(replaced.begin(), replaced.end());
+        for (size_t row : remove_rows) {
+            removed->push_back(rows_[row].window_handle_);
+        }
+    }
+
+    changed += remove_rows.size();
+    RemoveRows(remove_rows);
+    return changed;
+}
+
+size_t WindowTable::RemoveFiltered(const Config& config, std::vector<HWND>* removed) {
+    std::vector<size_t> remove_rows;
+    for (size_t i = 0; i < rows_.size(); ++i) {
+        const ProcessData& row = rows_[i];
+        if ((!row.attributes_.is_visible_ && config.hide_hidden_windows_)
+            || (row.title_.empty() && config.hide_blank_title_windows_)) {
+            remove_rows.push_back(i);
+        }
+    }
+
+    if (removed != nullptr) {
+        removed->clear();
+        for (size_t row : remove_rows) {
+            removed->push_back(rows_[row].window_handle_);
+        }
+    }
+
+    RemoveRows(remove_rows);
+    return remove_rows.size();
+}
+
+int WindowTable::Find(HWND window_handle) const {
+    auto it = index_.find(window_handle);
+    if (it == index_.end()) {
+        return -1;
+    }
+    return static_cast<int>(it->second);
+}
+
+void WindowTable::RemoveRows(const std::vector<size_t>& remove_rows) {
+    if (remove_rows.empty()) {
+        return;
+    }
+
+    std::vector<size_t> sorted_rows = remove_rows;
+    std::sort(sorted_rows.begin(), sorted_rows.end());
+    sorted_rows.erase(std::unique(sorted_rows.begin(), sorted_rows.end()), sorted_rows.end());
+
+    for (size_t row : sorted_rows) {
+        index_.erase(rows_[row].window_handle_);
+    }
+
+    // Only the rows after the first removed one move, so only their index entries are rewritten.
+    size_t write = sorted_rows.front();
+    size_t next_removed = 0;
+    for (size_t read = sorted_rows.front(); read < rows_.size(); ++read) {
+        if (next_removed < sorted_rows.size() && sorted_rows[next_removed] == read) {
+            ++next_removed;
+            continue;
+        }
+        if (write != read) {
+            rows_[write] = std::move(rows_[read]);
+        }
+        index_[rows_[write].window_handle_] = write;
+        ++write;
+    }
+    rows_.resize(write);
+}
+} // namespace fsb
@@ -0,0 +1,82 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_WINDOW_TABLE_H_
+#define FSB_WINDOW_TABLE_H_
+
+#include "base_types.h"
+#include "config.h"
+#include "string_pool.h"
+#include "window_source.h"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace fsb {
+//! @brief Persistent table of the listed windows, keyed by window handle.
+//!
+//! The table is built once from a full enumeration and then kept up to date by applying window
+//! events, which only re-probe the windows they affect. Rows keep their relative order across
+//! updates and new windows are appended at the end.
+class WindowTable {
+public:
+    //! @brief Replaces the whole table, e.g. with the result of a full enumeration.
+    void Reset(std::vector<ProcessData> windows);
+
+    //! @brief Adds the windows of an enumeration that is still in progress at the end.
+    //!
+    //! Windows that are already listed, e.g. because a window event added them first, are
+    //! skipped.
+    //!
+    //! @returns Returns the number of rows that were added.
+    size_t Append(std::vector<ProcessData> windows);
+
+    //! @brief Applies a batch of window events, after handing them to WindowSource::ObserveEvents.
+    //!
+    //! Events are coalesced per window first, so a window that is created, renamed and moved in
+    //! the same batch is only probed once. Windows that no longer pass the filters in config are
+    //! removed, and windows that now pass them are added.
+    //!
+    //! @param removed Optional. Receives the handles of the rows that were removed, including
+    //! handles that were destroyed and reused by a new window within the batch.
+    //! @param probed Optional. Receives the handles of the rows that were added, re-probed or
+    //! retitled, i.e. whose class or title may have changed. A reused handle is in both lists, so
+    //! whatever was kept for the old window is dropped before the new one is handled.
+    //! @returns Returns the number of rows that were added, removed or updated.
+    size_t Apply(const std::vector<WindowEvent>& events, WindowSource& source,
+        StringPool& strings, const Config& config, std::vector<HWND>* removed = nullptr,
+        std::vector<HWND>* probed = nullptr);
+
+    //! @brief Removes the rows that no longer pass the filters in config, without probing.
+    //!
+    //! Only handles filters that became stricter. Windows a looser filter would now admit were
+    //! never probed, so that needs a full enumeration instead.
+    //!
+    //! @param removed Optional. Receives the handles of the rows that were removed.
+    //! @returns Returns the number of rows that were removed.
+    size_t RemoveFiltered(const Config& config, std::vector<HWND>* removed = nullptr);
+
+    //! @brief Returns the row of a window, or -1 if the window is not listed.
+    int Find(HWND window_handle) const;
+
+    size_t size() const { return rows_.size(); }
+    bool empty() const { return rows_.empty(); }
+    ProcessData& operator[](size_t index) { return rows_[index]; }
+    const ProcessData& operator[](size_t index) const { return rows_[index]; }
+    std::vector<ProcessData>::iterator begin() { return rows_.begin(); }
+    std::vector<ProcessData>::iterator end() { return rows_.end(); }
+    std::vector<ProcessData>::const_iterator begin() const { return rows_.begin(); }
+    std::vector<ProcessData>::const_iterator end() const { return rows_.end(); }
+
+private:
+    //! @brief Removes every row flagged in remove_rows with a single compaction pass.
+    void RemoveRows(const std::vector<size_t>& remove_rows);
+
+    std::vector<ProcessData> rows_;
+    std::unordered_map<HWND, size_t> index_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_WINDOW_TABLE_H_
@@ -0,0 +1,437 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_trace.h"
+
+#include "mapped_file.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+
+namespace fsb {
+namespace {
+constexpr size_t kHeaderSize = 16;
+
+constexpr std::string_view kCallNames[] = {
+    "EnumerateWindowHandles",
+    "GetWindowAttributes",
+    "GetWindowMetrics",
+    "GetWindowFont",
+    "GetWindowProcessId",
+    "GetWindowTitle",
+    "GetWindowClassName",
+    "GetProcessInfo",
+    "WindowEvents",
+};
+static_assert(std::size(kCallNames) == static_cast<size_t>(TraceCall::Count),
+    "Every trace call needs a name.");
+
+void PutVarint(uint64_t value, std::string* out) {
+    while (value >= 0x80) {
+        out->push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out->push_back(static_cast<char>(value));
+}
+
+void PutSigned(int64_t value, std::string* out) {
+    PutVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63), out);
+}
+
+void PutString(std::string_view text, std::string* out) {
+    PutVarint(text.size(), out);
+    out->append(text);
+}
+
+uint64_t HandleValue(HWND window_handle) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(window_handle));
+}
+
+HWND HandleFrom(uint64_t value) {
+    return reinterpret_cast<HWND>(static_cast<uintptr_t>(value));
+}
+
+//! Bounds-checked cursor over the bytes of a trace.
+class TraceInput {
+public:
+    TraceInput(const uint8_t* data, size_t size) : data_(data), end_(data + size) {}
+
+    bool empty() const { return data_ == end_; }
+    size_t remaining() const { return static_cast<size_t>(end_ - data_); }
+
+    bool Byte(uint8_t* value) {
+        if (data_ == end_) {
+            return false;
+        }
+        *value = *data_++;
+        return true;
+    }
+
+    bool Varint(uint64_t* value) {
+        *value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = 0;
+            if (!Byte(&byte)) {
+                return false;
+            }
+            *value |= uint64_t{byte & 0x7Fu} << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Signed(int64_t* value) {
+        uint64_t encoded = 0;
+        if (!Varint(&encoded)) {
+            return false;
+        }
+        *value = static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1);
+        return true;
+    }
+
+    bool String(std::string* text) {
+        uint64_t size = 0;
+        if (!Varint(&size) || size > remaining()) {
+            return false;
+        }
+        text->assign(reinterpret_cast<const char*>(data_), static_cast<size_t>(size));
+        data_ += size;
+        return true;
+    }
+
+    //! Reads a count of items that take at least one byte each, so a corrupt count cannot
+    //! allocate more than the file holds.
+    bool Count(size_t* count) {
+        uint64_t value = 0;
+        if (!Varint(&value) || value > remaining()) {
+            return false;
+        }
+        *count = static_cast<size_t>(value);
+        return true;
+    }
+
+private:
+    const uint8_t* data_;
+    const uint8_t* end_;
+};
+
+bool ReadRecord(TraceInput& input, uint64_t* time, TraceRecord* record) {
+    uint8_t call = 0;
+    uint64_t error_code = 0;
+    int64_t time_delta = 0;
+    if (!input.Byte(&call) || call >= static_cast<uint8_t>(TraceCall::Count)
+        || !input.Byte(&record->result_) || !input.Varint(&error_code)
+        || !input.Signed(&time_delta) || !input.Varint(&record->latency_)
+        || !input.Varint(&record->key_)) {
+        return false;
+    }
+    record->call_ = static_cast<TraceCall>(call);
+    record->error_code_ = static_cast<uint32_t>(error_code);
+    *time += static_cast<uint64_t>(time_delta);
+    record->time_ = *time;
+
+    switch (record->call_) {
+        case TraceCall::EnumerateWindowHandles: {
+            size_t count = 0;
+            if (!input.Count(&count)) {
+                return false;
+            }
+            record->window_handles_.resize(count);
+            uint64_t previous = 0;
+            for (HWND& window_handle : record->window_handles_) {
+                int64_t delta = 0;
+                if (!input.Signed(&delta)) {
+                    return false;
+                }
+                previous += static_cast<uint64_t>(delta);
+                window_handle = HandleFrom(previous);
+            }
+            return true;
+        }
+        case TraceCall::GetWindowAttributes: {
+            uint8_t flags = 0;
+            uint8_t state = 0;
+            if (!input.Byte(&flags) || !input.Byte(&state)) {
+                return false;
+            }
+            record->attributes_.is_visible_ = (flags & 1) != 0;
+            record->attributes_.is_enabled_ = (flags & 2) != 0;
+            record->attributes_.state_ = static_cast<WindowState>(state);
+            return true;
+        }
+        case TraceCall::GetWindowMetrics: {
+            int64_t values[4] = {};
+            uint64_t style = 0;
+            uint64_t ex_style = 0;
+            for (int64_t& value : values) {
+                if (!input.Signed(&value)) {
+                    return false;
+                }
+            }
+            if (!input.Varint(&style) || !input.Varint(&ex_style)) {
+                return false;
+            }
+            record->metrics_.position_ = {static_cast<int32_t>(values[0]),
+                static_cast<int32_t>(values[1])};
+            record->metrics_.size_ = {static_cast<int32_t>(values[2]),
+                static_cast<int32_t>(values[3])};
+            record->metrics_.style_ = static_cast<uint32_t>(style);
+            record->metrics_.ex_style_ = static_cast<uint32_t>(ex_style);
+            return true;
+        }
+        case TraceCall::GetWindowFont:
+            return input.String(&record->text_) && input.Varint(&record->value_);
+        case TraceCall::GetWindowProcessId:
+            return input.Varint(&record->value_);
+        case TraceCall::GetWindowTitle:
+        case TraceCall::GetWindowClassName:
+            return input.String(&record->text_);
+        case TraceCall::GetProcessInfo:
+            return input.Varint(&record->value_) && input.String(&record->text_);
+        case TraceCall::WindowEvents: {
+            size_t count = 0;
+            if (!input.Count(&count)) {
+                return false;
+            }
+            record->events_.resize(count);
+            for (WindowEvent& event : record->events_) {
+                uint8_t type = 0;
+                uint64_t window_handle = 0;
+                if (!input.Byte(&type) || !input.Varint(&window_handle)) {
+                    return false;
+                }
+                event.type_ = static_cast<WindowEventType>(type);
+                event.window_handle_ = HandleFrom(window_handle);
+            }
+            return true;
+        }
+        case TraceCall::Count:
+            break;
+    }
+    return false;
+}
+} // namespace
+
+std::string_view TraceCallName(TraceCall call) {
+    return static_cast<size_t>(call) < std::size(kCallNames)
+        ? kCallNames[static_cast<size_t>(call)] : "Unknown";
+}
+
+TraceWriter::TraceWriter() : start_(0), last_time_(0), record_count_(0), failed_(false) {}
+
+TraceWriter::~TraceWriter() {
+    Close();
+}
+
+bool TraceWriter::Open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.close();
+    file_.clear();
+    file_.open(std::filesystem::u8path(path), std::ios::binary | std::ios::trunc);
+    buffer_.clear();
+    record_count_ = 0;
+    last_time_ = 0;
+    failed_ = !file_.is_open();
+    if (failed_) {
+        return false;
+    }
+
+    char header[kHeaderSize] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    for (size_t i = 0; i < 4; ++i) {
+        header[4 + i] = static_cast<char>(kVersion >> (8 * i));
+    }
+    buffer_.append(header, sizeof(header));
+    start_ = Tracer::Now();
+    return true;
+}
+
+bool TraceWriter::Flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return FlushLocked();
+}
+
+bool TraceWriter::FlushLocked() {
+    if (!file_.is_open() || failed_) {
+        return false;
+    }
+    file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    file_.flush();
+    buffer_.clear();
+    failed_ = !file_.good();
+    return !failed_;
+}
+
+void TraceWriter::Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    static_cast<void>(FlushLocked());
+    file_.close();
+}
+
+uint64_t TraceWriter::Now() const {
+    return Tracer::Now() - start_;
+}
+
+uint64_t TraceWriter::record_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return record_count_;
+}
+
+void TraceWriter::Write(const TraceRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open() || failed_) {
+        return;
+    }
+
+    // Times are deltas against the previous record, which may have started later.
+    std::string& out = buffer_;
+    out.push_back(static_cast<char>(record.call_));
+    out.push_back(static_cast<char>(record.result_));
+    PutVarint(record.error_code_, &out);
+    PutSigned(static_cast<int64_t>(record.time_ - last_time_), &out);
+    last_time_ = record.time_;
+    PutVarint(record.latency_, &out);
+    PutVarint(record.key_, &out);
+
+    switch (record.call_) {
+        case TraceCall::EnumerateWindowHandles: {
+            PutVarint(record.window_handles_.size(), &out);
+            uint64_t previous = 0;
+            for (HWND window_handle : record.window_handles_) {
+                PutSigned(static_cast<int64_t>(HandleValue(window_handle) - previous), &out);
+                previous = HandleValue(window_handle);
+            }
+            break;
+        }
+        case TraceCall::GetWindowAttributes:
+            out.push_back(static_cast<char>((record.attributes_.is_visible_ ? 1 : 0)
+                | (record.attributes_.is_enabled_ ? 2 : 0)));
+            out.push_back(static_cast<char>(record.attributes_.state_));
+            break;
+        case TraceCall::GetWindowMetrics:
+            PutSigned(record.metrics_.position_.x, &out);
+            PutSigned(record.metrics_.position_.y, &out);
+            PutSigned(record.metrics_.size_.x, &out);
+            PutSigned(record.metrics_.size_.y, &out);
+            PutVarint(record.metrics_.style_, &out);
+            PutVarint(record.metrics_.ex_style_, &out);
+            break;
+        case TraceCall::GetWindowFont:
+            PutString(record.text_, &out);
+            PutVarint(record.value_, &out);
+            break;
+        case TraceCall::GetWindowProcessId:
+            PutVarint(record.value_, &out);
+            break;
+        case TraceCall::GetWindowTitle:
+        case TraceCall::GetWindowClassName:
+            PutString(record.text_, &out);
+            break;
+        case TraceCall::GetProcessInfo:
+            PutVarint(record.value_, &out);
+            PutString(record.text_, &out);
+            break;
+        case TraceCall::WindowEvents:
+            PutVarint(record.events_.size(), &out);
+            for (const WindowEvent& event : record.events_) {
+                out.push_back(static_cast<char>(event.type_));
+                PutVarint(HandleValue(event.window_handle_), &out);
+            }
+            break;
+        case TraceCall::Count:
+            break;
+    }
+
+    ++record_count_;
+    if (buffer_.size() >= kFlushSize) {
+        static_cast<void>(FlushLocked());
+    }
+}
+
+bool TraceReader::Open(const std::string& path) {
+    records_.clear();
+    truncated_ = false;
+
+    MappedFile file;
+    if (!file.Open(path) || file.size() < kHeaderSize
+        || std::memcmp(file.data(), TraceWriter::kMagic, sizeof(TraceWriter::kMagic)) != 0) {
+        return false;
+    }
+    uint32_t version = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        version |= uint32_t{file.data()[4 + i]} << (8 * i);
+    }
+    if (version != TraceWriter::kVersion) {
+        return false;
+    }
+
+    TraceInput input(file.data() + kHeaderSize, file.size() - kHeaderSize);
+    uint64_t time = 0;
+    while (!input.empty()) {
+        TraceRecord record = {};
+        if (!ReadRecord(input, &time, &record)) {
+            truncated_ = true;
+            break;
+        }
+        records_.push_back(std::move(record));
+    }
+    return true;
+}
+
+std::string FormatTraceSummary(const std::vector<TraceRecord>& records) {
+    std::array<std::vector<uint64_t>, static_cast<size_t>(TraceCall::Count)> latencies;
+    std::array<size_t, static_cast<size_t>(TraceCall::Count)> failures = {};
+    std::map<uint32_t, size_t> error_codes;
+    uint64_t duration = 0;
+    for (const TraceRecord& record : records) {
+        latencies[static_cast<size_t>(record.call_)].push_back(record.latency_);
+        failures[static_cast<size_t>(record.call_)] += record.result_ != 0 ? 1 : 0;
+        if (record.error_code_ != 0) {
+            ++error_codes[record.error_code_];
+        }
+        duration = std::max(duration, record.time_ + record.latency_);
+    }
+
+    std::string summary;
+    char line[160];
+    std::snprintf(line, sizeof(line), "%zu records over %.3f ms\n", records.size(),
+        static_cast<double>(duration) / 1e6);
+    summary += line;
+    std::snprintf(line, sizeof(line), "%-24s %8s %8s %10s %10s %10s %12s\n", "call", "count",
+        "failed", "p50 us", "p99 us", "max us", "total ms");
+    summary += line;
+    for (size_t i = 0; i < latencies.size(); ++i) {
+        std::vector<uint64_t>& call_latencies = latencies[i];
+        if (call_latencies.empty()) {
+            continue;
+        }
+        std::sort(call_latencies.begin(), call_latencies.end());
+        uint64_t total = 0;
+        for (uint64_t latency : call_latencies) {
+            total += latency;
+        }
+        const size_t kCount = call_latencies.size();
+        const std::string kName(TraceCallName(static_cast<TraceCall>(i)));
+        std::snprintf(line, sizeof(line), "%-24s %8zu %8zu %10.1f %10.1f %10.1f %12.3f\n",
+            kName.c_str(), kCount, failures[i],
+            static_cast<double>(call_latencies[kCount / 2]) / 1e3,
+            static_cast<double>(call_latencies[kCount * 99 / 100]) / 1e3,
+            static_cast<double>(call_latencies.back()) / 1e3, static_cast<double>(total) / 1e6);
+        summary += line;
+    }
+    for (const auto& [error_code, count] : error_codes) {
+        std::snprintf(line, sizeof(line), "error 0x%08" PRIX32 ": %zu\n", error_code, count);
+        summary += line;
+    }
+    return summary;
+}
+} // namespace fsb
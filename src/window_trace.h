@@ -0,0 +1,136 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_WINDOW_TRACE_H_
+#define FSB_WINDOW_TRACE_H_
+
+#include "base_types.h"
+#include "window_source.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fsb {
+//! @brief What a trace record captured: a WindowSource call, or a batch of window events.
+enum class TraceCall : uint8_t {
+    EnumerateWindowHandles,
+    GetWindowAttributes,
+    GetWindowMetrics,
+    GetWindowFont,
+    GetWindowProcessId,
+    GetWindowTitle,
+    GetWindowClassName,
+    GetProcessInfo,
+    WindowEvents,
+    Count
+};
+
+std::string_view TraceCallName(TraceCall call);
+
+//! @brief One call into the window system and everything it answered.
+//!
+//! Only the fields of the call are meaningful, e.g. metrics_ for GetWindowMetrics.
+struct TraceRecord {
+    TraceCall call_;
+    //! 0 if the call succeeded, otherwise 1, or the ProbeStatus of GetWindowFont.
+    uint8_t result_;
+    //! Last error right after a failed call, 0 otherwise.
+    uint32_t error_code_;
+    //! Nanoseconds from the start of the trace to the start of the call.
+    uint64_t time_;
+    //! Nanoseconds the call took.
+    uint64_t latency_;
+    //! Window handle, or process ID for the process calls.
+    uint64_t key_;
+    //! Window handles of EnumerateWindowHandles.
+    std::vector<HWND> window_handles_;
+    std::vector<WindowEvent> events_;
+    WindowAttributes attributes_;
+    WindowMetrics metrics_;
+    //! Title, class name, file name or font name. Empty if GetProcessInfo was not asked for the
+    //! file name.
+    std::string text_;
+    //! Process ID, font size or process start time.
+    uint64_t value_;
+};
+
+//! @brief Writes a compact binary trace of window system activity.
+//!
+//! A trace is a 16-byte header followed by one record after another. Integers are LEB128
+//! varints, signed ones zigzag-encoded and handles delta-encoded against the previous handle of
+//! the same enumeration, so a record is usually a few bytes plus its strings. Records are
+//! buffered and written in large chunks.
+//!
+//! @note Thread-safe. Records from concurrent probes are written in the order they completed.
+class TraceWriter {
+public:
+    static constexpr char kMagic[4] = {'F', 'S', 'B', 'T'};
+    static constexpr uint32_t kVersion = 2;
+
+    TraceWriter();
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    //! @brief Creates the trace file, replacing any previous one. The trace starts now.
+    //!
+    //! @param path UTF-8 path.
+    bool Open(const std::string& path);
+    //! @brief Writes out the buffered records.
+    bool Flush();
+    void Close();
+
+    //! @brief Nanoseconds since the trace started, for TraceRecord::time_.
+    uint64_t Now() const;
+    //! @brief Appends a record.
+    void Write(const TraceRecord& record);
+
+    uint64_t record_count() const;
+
+private:
+    //! Bytes buffered before they are written out.
+    static constexpr size_t kFlushSize = 256 * 1024;
+
+    bool FlushLocked();
+
+    mutable std::mutex mutex_;
+    std::ofstream file_;
+    std::string buffer_;
+    uint64_t start_;
+    //! Time of the last record written, which the next one is encoded against.
+    uint64_t last_time_;
+    uint64_t record_count_;
+    bool failed_;
+};
+
+//! @brief Reads back a trace written by TraceWriter.
+class TraceReader {
+public:
+    //! @brief Reads the whole trace.
+    //!
+    //! @returns Returns false if the file cannot be read or is not a trace. A trace cut short,
+    //! e.g. because the process died, keeps every complete record.
+    bool Open(const std::string& path);
+
+    const std::vector<TraceRecord>& records() const { return records_; }
+    //! Whether the file ended in the middle of a record.
+    bool truncated() const { return truncated_; }
+
+private:
+    std::vector<TraceRecord> records_;
+    bool truncated_ = false;
+};
+
+//! @brief Summarizes a trace per call: count, failures and latency percentiles, followed by how
+//! often each error code was seen.
+std::string FormatTraceSummary(const std::vector<TraceRecord>& records);
+} // namespace fsb
+
+#endif // #ifndef FSB_WINDOW_TRACE_H_
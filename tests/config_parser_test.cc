@@ -0,0 +1,81 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+namespace fsb {
+namespace {
+bool operator==(const Config& left, const Config& right) {
+    return left.hide_hidden_windows_ == right.hide_hidden_windows_
+        && left.hide_blank_title_windows_ == right.hide_blank_title_windows_
+        && left.probe_threads_ == right.probe_threads_
+        && left.prefetch_radius_ == right.prefetch_radius_ && left.max_fps_ == right.max_fps_
+        && left.trace_ == right.trace_;
+}
+
+struct ParseCase {
+    std::string_view text_;
+    Config expected_;
+    size_t invalid_lines_;
+};
+
+constexpr Config kDefaults = kDefaultConfig;
+
+//! One case per rule of the format, each starting from the defaults.
+const ParseCase kCases[] = {
+    {"", kDefaults, 0},
+    {"\n\n# hide_hidden_windows=false\n   \n", kDefaults, 0},
+    {"hide_hidden_windows=false", {false, true, 0, 2, 60, false}, 0},
+    {"hide_blank_title_windows = no\n", {true, false, 0, 2, 60, false}, 0},
+    {"\thide_hidden_windows\t=\toff\r\n", {false, true, 0, 2, 60, false}, 0},
+    {"trace=yes\ntrace=0\ntrace=on", {true, true, 0, 2, 60, true}, 0},
+    {"trace=1\r\nmax_fps=0\r\n", {true, true, 0, 2, 0, true}, 0},
+    {"\xEF\xBB\xBFprobe_threads=8", {true, true, 8, 2, 60, false}, 0},
+    {"prefetch_radius=64\nmax_fps=1000", {true, true, 0, 64, 1000, false}, 0},
+    // The last valid value of a key wins, and an invalid one keeps what was there.
+    {"prefetch_radius=5\nprefetch_radius=65", {true, true, 0, 5, 60, false}, 1},
+    {"probe_threads=-1\nprobe_threads=4x\nprobe_threads=\nprobe_threads= 3", {true, true, 3, 2,
+        60, false}, 3},
+    {"max_fps=+5\nmax_fps=0x10\nmax_fps=99999999999", kDefaults, 3},
+    {"trace=True\ntrace=2\ntrace", kDefaults, 3},
+    {"Trace=true\ntrac=true\ntraces=true\n=true\n==", kDefaults, 5},
+    // Only a line starting with '#' is a comment.
+    {"trace=true # on\nmax_fps=30#", kDefaults, 2},
+    {"# BOM only at the start\n\xEF\xBB\xBFtrace=true", kDefaults, 1},
+};
+} // namespace
+
+TEST(ConfigParserTest, AppliesEveryCase) {
+    for (const ParseCase& kCase : kCases) {
+        Config config = kDefaultConfig;
+        EXPECT_EQ(ParseConfigText(kCase.text_, &config), kCase.invalid_lines_) << kCase.text_;
+        EXPECT_TRUE(config == kCase.expected_) << kCase.text_;
+    }
+}
+
+TEST(ConfigParserTest, StartsFromTheGivenConfig) {
+    Config config = {false, false, 7, 9, 30, true};
+    EXPECT_EQ(ParseConfigText("max_fps=120\nbogus=1\n", &config), 1u);
+    EXPECT_TRUE(config == (Config{false, false, 7, 9, 120, true}));
+}
+
+TEST(ConfigParserTest, CutOffFileKeepsItsWholeLines) {
+    // The largest file ReadConfigFile accepts, cut at any byte.
+    std::string text;
+    while (text.size() < (size_t{1} << 20)) {
+        text += "# comment\nhide_hidden_windows=false\nprefetch_radius=3\n";
+    }
+    for (size_t cut : {text.size(), text.size() - 1, text.size() - 3}) {
+        Config config = kDefaultConfig;
+        const size_t kInvalid = ParseConfigText(std::string_view(text).substr(0, cut), &config);
+        EXPECT_FALSE(config.hide_hidden_windows_);
+        EXPECT_LE(kInvalid, 1u);
+    }
+}
+} // namespace fsb
@@ -0,0 +1,95 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "detail_loader.h"
+
+#include "fake_window_source.h"
+#include "probe_pool.h"
+#include "process_cache.h"
+#include "string_pool.h"
+#include "window_health.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+namespace fsb {
+namespace {
+HealthOptions QuickQuarantine() {
+    HealthOptions options;
+    options.quarantine_after_ = 1;
+    options.base_backoff_ = 50;
+    options.max_backoff_ = 50;
+    return options;
+}
+
+class DetailLoaderTest : public testing::Test {
+protected:
+    DetailLoaderTest() : cache_(strings_), health_(QuickQuarantine()),
+        loader_(source_, cache_, health_, pool_), pool_(2) {
+        source_.SetProcess(1, {10, "C:\\app.exe"});
+        source_.AddWindow(FakeHandle(1));
+    }
+
+    FakeWindowSource source_;
+    StringPool strings_;
+    ProcessCache cache_;
+    HealthTracker health_;
+    DetailLoader loader_;
+    // Destroyed first, so no prefetch outlives the loader.
+    ProbePool pool_;
+};
+} // namespace
+
+TEST_F(DetailLoaderTest, AnsweredFontsAreCached) {
+    const WindowDetails kDetails = loader_.Load(FakeHandle(1), 1);
+    EXPECT_EQ(kDetails.file_name_, "C:\\app.exe");
+    EXPECT_EQ(kDetails.font_name_, "Segoe UI");
+    EXPECT_FALSE(kDetails.font_stale_);
+
+    static_cast<void>(loader_.Load(FakeHandle(1), 1));
+    loader_.Prefetch({{FakeHandle(1), 1}});
+    EXPECT_EQ(source_.font_reads(), 1);
+}
+
+TEST_F(DetailLoaderTest, StaleFontsAreAskedAgainAfterQuarantine) {
+    static_cast<void>(loader_.Load(FakeHandle(1), 1));
+    source_.window(FakeHandle(1))->font_status_ = ProbeStatus::TimedOut;
+    loader_.Forget(FakeHandle(1));
+    // Forget drops the last known font too, so the timed out window has none to show.
+    WindowDetails details = loader_.Load(FakeHandle(1), 1);
+    EXPECT_TRUE(details.font_stale_);
+    EXPECT_TRUE(health_.IsQuarantined(1));
+
+    // While quarantined the stale result is served without asking the window.
+    source_.window(FakeHandle(1))->font_status_ = ProbeStatus::Ok;
+    details = loader_.Load(FakeHandle(1), 1);
+    EXPECT_TRUE(details.font_stale_);
+    EXPECT_EQ(source_.font_reads(), 2);
+
+    while (health_.IsQuarantined(1)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    details = loader_.Load(FakeHandle(1), 1);
+    EXPECT_FALSE(details.font_stale_);
+    EXPECT_EQ(details.font_name_, "Segoe UI");
+    EXPECT_EQ(source_.font_reads(), 3);
+}
+
+TEST_F(DetailLoaderTest, PrefetchedStaleFontsAreReloaded) {
+    source_.window(FakeHandle(1))->font_status_ = ProbeStatus::TimedOut;
+    loader_.Prefetch({{FakeHandle(1), 1}});
+    EXPECT_TRUE(loader_.Load(FakeHandle(1), 1).font_stale_);
+
+    source_.window(FakeHandle(1))->font_status_ = ProbeStatus::Ok;
+    while (health_.IsQuarantined(1)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    loader_.Prefetch({{FakeHandle(1), 1}});
+    const WindowDetails kDetails = loader_.Load(FakeHandle(1), 1);
+    EXPECT_FALSE(kDetails.font_stale_);
+    EXPECT_EQ(source_.font_reads(), 2);
+}
+} // namespace fsb
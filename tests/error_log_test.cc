@@ -0,0 +1,217 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "error_log.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+//! Allocations made by the current thread while counting_allocations is set.
+thread_local bool counting_allocations = false;
+thread_local size_t allocation_count = 0;
+} // namespace
+
+// Counts allocations, so the test can check that recording makes none.
+void* operator new(size_t size) {
+    if (counting_allocations) {
+        ++allocation_count;
+    }
+    if (void* memory = std::malloc(size != 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t size) noexcept {
+    static_cast<void>(size);
+    std::free(memory);
+}
+
+namespace fsb {
+namespace {
+std::vector<ErrorRecord> DrainAll() {
+    std::vector<ErrorRecord> records;
+    static_cast<void>(ErrorLog::Get().Drain(&records));
+    return records;
+}
+
+//! Empties the log and waits for the next rate limit window, so the test has a whole one to
+//! itself.
+void StartInNewWindow() {
+    ErrorSite site("align the test", "StartInNewWindow", "Record");
+    static_cast<void>(DrainAll());
+    ASSERT_TRUE(ErrorLog::Get().Record(site, 0, 0));
+    const std::vector<ErrorRecord> kRecords = DrainAll();
+    ASSERT_EQ(kRecords.size(), 1u);
+    const uint64_t kLeft = ErrorLog::kRateWindow - kRecords[0].time_ % ErrorLog::kRateWindow;
+    std::this_thread::sleep_for(std::chrono::nanoseconds(kLeft) + std::chrono::milliseconds(1));
+}
+
+std::string DescribeAsTest(uint32_t code) {
+    return "Test error " + std::to_string(code) + ".";
+}
+} // namespace
+
+TEST(ErrorLogTest, RateLimitsEachSite) {
+    ErrorSite first("read the title", "ErrorLogTest::First", "GetWindowTextW");
+    ErrorSite second("read the class", "ErrorLogTest::Second", "GetClassNameW");
+    StartInNewWindow();
+    ErrorLog& log = ErrorLog::Get();
+    for (uint32_t i = 0; i < ErrorLog::kMaxPerWindow; ++i) {
+        EXPECT_TRUE(log.Record(first, i, -1));
+    }
+    EXPECT_FALSE(log.Record(first, 99, -1));
+    EXPECT_FALSE(log.Record(first, 99, -1));
+    EXPECT_TRUE(log.Record(second, 7, 0, reinterpret_cast<HWND>(16), 42));
+
+    const std::vector<ErrorRecord> kRecords = DrainAll();
+    ASSERT_EQ(kRecords.size(), ErrorLog::kMaxPerWindow + 1);
+    for (uint32_t i = 0; i < ErrorLog::kMaxPerWindow; ++i) {
+        EXPECT_EQ(kRecords[i].site_, &first);
+        EXPECT_EQ(kRecords[i].code_, i);
+        EXPECT_EQ(kRecords[i].return_code_, -1);
+        EXPECT_EQ(kRecords[i].suppressed_, 0u);
+    }
+    EXPECT_EQ(kRecords.back().site_, &second);
+    EXPECT_EQ(kRecords.back().window_handle_, reinterpret_cast<HWND>(16));
+    EXPECT_EQ(kRecords.back().process_id_, 42u);
+    EXPECT_EQ(first.suppressed_.load(), 2u);
+}
+
+TEST(ErrorLogTest, NextWindowCarriesTheSuppressedCount) {
+    ErrorSite site("open the process", "ErrorLogTest::Site", "OpenProcess");
+    StartInNewWindow();
+    ErrorLog& log = ErrorLog::Get();
+    for (uint32_t i = 0; i < ErrorLog::kMaxPerWindow + 3; ++i) {
+        EXPECT_EQ(log.Record(site, 5, 0), i < ErrorLog::kMaxPerWindow);
+    }
+
+    std::this_thread::sleep_for(std::chrono::nanoseconds(ErrorLog::kRateWindow));
+    EXPECT_TRUE(log.Record(site, 5, 0));
+    EXPECT_TRUE(log.Record(site, 5, 0));
+    const std::vector<ErrorRecord> kRecords = DrainAll();
+    ASSERT_EQ(kRecords.size(), ErrorLog::kMaxPerWindow + 2);
+    EXPECT_GE(kRecords[ErrorLog::kMaxPerWindow].time_ / ErrorLog::kRateWindow,
+        kRecords[0].time_ / ErrorLog::kRateWindow + 1);
+    EXPECT_EQ(kRecords[ErrorLog::kMaxPerWindow].suppressed_, 3u);
+    EXPECT_EQ(kRecords[ErrorLog::kMaxPerWindow + 1].suppressed_, 0u);
+    EXPECT_EQ(site.suppressed_.load(), 0u);
+
+    log.SetDescriber(DescribeAsTest);
+    std::string message;
+    log.Format(kRecords[ErrorLog::kMaxPerWindow], &message);
+    log.SetDescriber(nullptr);
+    EXPECT_NE(message.find("Failed to open the process OpenProcess returned 0: Test error 5."),
+        std::string::npos) << message;
+    EXPECT_NE(message.find(" [3 more suppressed] at ErrorLogTest::Site"), std::string::npos)
+        << message;
+}
+
+TEST(ErrorLogTest, FullRingDropsAndCounts) {
+    // Enough sites to fill the ring without hitting the rate limit.
+    std::deque<ErrorSite> sites;
+    for (size_t i = 0; i <= ErrorLog::kCapacity / ErrorLog::kMaxPerWindow; ++i) {
+        sites.emplace_back("fill the ring", "ErrorLogTest::Fill", "Record");
+    }
+    static_cast<void>(DrainAll());
+    ErrorLog& log = ErrorLog::Get();
+    const uint64_t kDropped = log.dropped();
+    for (size_t i = 0; i < ErrorLog::kCapacity; ++i) {
+        ASSERT_TRUE(log.Record(sites[i / ErrorLog::kMaxPerWindow], static_cast<uint32_t>(i), 0));
+    }
+    EXPECT_FALSE(log.Record(sites.back(), 0, 0));
+    EXPECT_FALSE(log.Record(sites.back(), 0, 0));
+    EXPECT_EQ(log.dropped(), kDropped + 2);
+
+    // The oldest records are the ones kept, and reading makes room again.
+    const std::vector<ErrorRecord> kRecords = DrainAll();
+    ASSERT_EQ(kRecords.size(), ErrorLog::kCapacity);
+    for (size_t i = 0; i < kRecords.size(); ++i) {
+        EXPECT_EQ(kRecords[i].code_, i);
+    }
+    EXPECT_TRUE(log.Record(sites.back(), 1, 0));
+    EXPECT_EQ(DrainAll().size(), 1u);
+}
+
+TEST(ErrorLogTest, RecordsFromManyThreads) {
+    constexpr size_t kThreads = 8;
+    constexpr size_t kSitesPerThread = 16;
+    constexpr uint32_t kRecordsPerThread = 20000;
+    std::deque<ErrorSite> sites;
+    for (size_t i = 0; i < kThreads * kSitesPerThread; ++i) {
+        sites.emplace_back("record concurrently", "ErrorLogTest::Thread", "Record");
+    }
+    static_cast<void>(DrainAll());
+    ErrorLog& log = ErrorLog::Get();
+
+    // A reader drains while the threads record, as the menu does.
+    std::atomic<bool> done(false);
+    std::vector<ErrorRecord> records;
+    std::thread reader([&]() {
+        while (!done.load()) {
+            static_cast<void>(log.Drain(&records));
+        }
+        static_cast<void>(log.Drain(&records));
+    });
+
+    std::atomic<size_t> accepted(0);
+    std::atomic<size_t> allocations(0);
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < kThreads; ++thread) {
+        threads.emplace_back([&, thread]() {
+            size_t thread_accepted = 0;
+            allocation_count = 0;
+            counting_allocations = true;
+            for (uint32_t i = 0; i < kRecordsPerThread; ++i) {
+                ErrorSite& site = sites[thread * kSitesPerThread + i % kSitesPerThread];
+                thread_accepted += log.Record(site, i, 0, nullptr,
+                    static_cast<uint32_t>(thread)) ? 1 : 0;
+            }
+            counting_allocations = false;
+            accepted += thread_accepted;
+            allocations += allocation_count;
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    done.store(true);
+    reader.join();
+
+    EXPECT_EQ(allocations.load(), 0u);
+    EXPECT_GT(accepted.load(), 0u);
+    ASSERT_EQ(records.size(), accepted.load());
+    // Every thread's records come out in the order it made them.
+    std::vector<int64_t> last_code(kThreads, -1);
+    for (const ErrorRecord& record : records) {
+        ASSERT_LT(record.process_id_, kThreads);
+        EXPECT_EQ(record.site_,
+            &sites[record.process_id_ * kSitesPerThread + record.code_ % kSitesPerThread]);
+        EXPECT_GT(static_cast<int64_t>(record.code_), last_code[record.process_id_]);
+        last_code[record.process_id_] = record.code_;
+    }
+}
+
+TEST(ErrorLogTest, DescriptionsOutliveTheDescriber) {
+    ErrorLog& log = ErrorLog::Get();
+    log.SetDescriber(DescribeAsTest);
+    const std::string kDescription = log.Describe(5);
+    log.SetDescriber(nullptr);
+    EXPECT_EQ(kDescription, "Test error 5.");
+    EXPECT_EQ(log.Describe(5), "Error 5.");
+}
+} // namespace fsb
@@ -0,0 +1,109 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "event_loop.h"
+
+#include "scripted_event_waiter.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <thread>
+
+namespace fsb {
+TEST(EventLoopTest, DispatchesInputTimersAndPostedTasks) {
+    ScriptedEventWaiter waiter;
+    EventLoop loop(waiter);
+    std::deque<char> input;
+    std::string log;
+    int idle_calls = 0;
+    loop.SetIdleHandler([&]() { ++idle_calls; });
+    loop.SetHandler(EventSource::Input, [&]() {
+        while (!input.empty()) {
+            const char kKey = input.front();
+            input.pop_front();
+            log += kKey;
+            if (kKey == 'q') {
+                loop.Quit();
+            }
+        }
+    });
+
+    int ticks = 0;
+    const EventLoop::TimerId kPeriodic = loop.AddTimer(std::chrono::milliseconds(5),
+        [&]() { ++ticks; }, std::chrono::milliseconds(5));
+    const EventLoop::TimerId kCancelled = loop.AddTimer(std::chrono::milliseconds(1),
+        [&]() { log += 'X'; });
+    loop.CancelTimer(kCancelled);
+    static_cast<void>(loop.AddTimer(std::chrono::milliseconds(30), [&]() {
+        log += 'T';
+        loop.CancelTimer(kPeriodic);
+    }));
+
+    std::thread worker([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        loop.Post([&]() { log += 'P'; });
+        // Keys are queued on the loop thread, the way the console reads them.
+        loop.Post([&]() {
+            input.insert(input.end(), {'a', 'b', 'q'});
+            waiter.Signal(EventSource::Input);
+        });
+    });
+    loop.Run();
+    worker.join();
+
+    EXPECT_EQ(log, "TPabq");
+    EXPECT_GE(ticks, 3);
+    EXPECT_GT(idle_calls, 0);
+}
+
+TEST(EventLoopTest, IdleLoopSleeps) {
+    ScriptedEventWaiter waiter;
+    EventLoop loop(waiter);
+
+    uint64_t idle_waits = 0;
+    std::thread worker([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        loop.Post([&]() {
+            const uint64_t kBefore = loop.wait_count();
+            static_cast<void>(loop.AddTimer(std::chrono::milliseconds(100), [&, kBefore]() {
+                idle_waits = loop.wait_count() - kBefore;
+                loop.Quit();
+            }));
+        });
+    });
+    loop.Run();
+    worker.join();
+
+    // Nothing but the timer is pending, so the loop sleeps once or twice rather than spinning.
+    EXPECT_LE(idle_waits, 3u);
+}
+
+TEST(EventLoopTest, SignalsAreReportedOnce) {
+    ScriptedEventWaiter waiter;
+    EventLoop loop(waiter);
+    int config_changes = 0;
+    int messages = 0;
+    loop.SetHandler(EventSource::ConfigChanged, [&]() { ++config_changes; });
+    loop.SetHandler(EventSource::WindowMessages, [&]() {
+        if (++messages == 2) {
+            loop.Quit();
+        }
+    });
+
+    waiter.Signal(EventSource::ConfigChanged);
+    waiter.Signal(EventSource::WindowMessages);
+    std::thread worker([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        waiter.Signal(EventSource::WindowMessages);
+    });
+    loop.Run();
+    worker.join();
+
+    EXPECT_EQ(config_changes, 1);
+    EXPECT_EQ(messages, 2);
+}
+} // namespace fsb
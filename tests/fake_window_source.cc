@@ -0,0 +1,117 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "fake_window_source.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace fsb {
+void FakeWindowSource::AddWindow(HWND window_handle, FakeWindow window) {
+    RemoveWindow(window_handle);
+    z_order_.push_back(window_handle);
+    windows_[window_handle] = std::move(window);
+}
+
+void FakeWindowSource::RemoveWindow(HWND window_handle) {
+    z_order_.erase(std::remove(z_order_.begin(), z_order_.end(), window_handle), z_order_.end());
+    windows_.erase(window_handle);
+}
+
+FakeWindow* FakeWindowSource::window(HWND window_handle) {
+    auto it = windows_.find(window_handle);
+    return it == windows_.end() ? nullptr : &it->second;
+}
+
+void FakeWindowSource::SetProcess(uint32_t process_id, FakeProcess process) {
+    processes_[process_id] = std::move(process);
+}
+
+const FakeWindow* FakeWindowSource::Lookup(HWND window_handle) const {
+    auto it = windows_.find(window_handle);
+    return it == windows_.end() ? nullptr : &it->second;
+}
+
+void FakeWindowSource::EnumerateWindowHandles(std::vector<HWND>* window_handles) {
+    // EnumWindows goes from the top of the z-order down.
+    window_handles->assign(z_order_.rbegin(), z_order_.rend());
+}
+
+bool FakeWindowSource::GetWindowAttributes(HWND window_handle,
+    WindowAttributes* window_attributes) {
+    const FakeWindow* window = Lookup(window_handle);
+    if (window == nullptr) {
+        return false;
+    }
+    *window_attributes = window->attributes_;
+    return true;
+}
+
+bool FakeWindowSource::GetWindowMetrics(HWND window_handle, WindowMetrics* window_metrics) {
+    const FakeWindow* window = Lookup(window_handle);
+    if (window == nullptr) {
+        return false;
+    }
+    *window_metrics = window->metrics_;
+    return true;
+}
+
+ProbeStatus FakeWindowSource::GetWindowFont(HWND window_handle, uint32_t timeout_milliseconds,
+    std::string* font_name, uint32_t* font_size) {
+    static_cast<void>(timeout_milliseconds);
+    font_reads_.fetch_add(1, std::memory_order_relaxed);
+    const FakeWindow* window = Lookup(window_handle);
+    if (window == nullptr) {
+        return ProbeStatus::Failed;
+    }
+    if (window->font_status_ == ProbeStatus::Ok) {
+        *font_name = window->font_name_;
+        *font_size = window->font_size_;
+    }
+    return window->font_status_;
+}
+
+bool FakeWindowSource::GetWindowProcessId(HWND window_handle, uint32_t* process_id) {
+    const FakeWindow* window = Lookup(window_handle);
+    if (window == nullptr) {
+        return false;
+    }
+    *process_id = window->process_id_;
+    return true;
+}
+
+bool FakeWindowSource::GetWindowTitle(HWND window_handle, std::string* title) {
+    const FakeWindow* window = Lookup(window_handle);
+    if (window == nullptr) {
+        title->clear();
+        return false;
+    }
+    *title = window->title_;
+    return true;
+}
+
+bool FakeWindowSource::GetWindowClassName(HWND window_handle, std::string* class_name) {
+    const FakeWindow* window = Lookup(window_handle);
+    if (window == nullptr) {
+        class_name->clear();
+        return false;
+    }
+    *class_name = window->class_name_;
+    return true;
+}
+
+bool FakeWindowSource::GetProcessInfo(uint32_t process_id, uint64_t* start_time,
+    std::string* file_name) {
+    process_opens_.fetch_add(1, std::memory_order_relaxed);
+    if (file_name != nullptr) {
+        path_reads_.fetch_add(1, std::memory_order_relaxed);
+    }
+    auto it = processes_.find(process_id);
+    *start_time = it == processes_.end() ? kUnknownStartTime : it->second.start_time_;
+    if (file_name != nullptr) {
+        *file_name = it == processes_.end() ? "???" : it->second.file_name_;
+    }
+    return it != processes_.end();
+}
+} // namespace fsb
@@ -0,0 +1,85 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_FAKE_WINDOW_SOURCE_H_
+#define FSB_FAKE_WINDOW_SOURCE_H_
+
+#include "base_types.h"
+#include "window_source.h"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fsb {
+//! @brief A window of FakeWindowSource. Visible, titled and normal unless a test says otherwise.
+struct FakeWindow {
+    uint32_t process_id_ = 1;
+    std::string title_ = "Window";
+    std::string class_name_ = "FakeWindow";
+    WindowAttributes attributes_ = {true, true, WindowState::Normal};
+    WindowMetrics metrics_ = {};
+    ProbeStatus font_status_ = ProbeStatus::Ok;
+    std::string font_name_ = "Segoe UI";
+    uint32_t font_size_ = 9;
+};
+
+struct FakeProcess {
+    uint64_t start_time_ = 1;
+    std::string file_name_;
+};
+
+//! @brief Small mutable window system for tests, where windows and processes are edited directly
+//! between calls.
+//!
+//! @note Calls may be made from several threads, but the desktop must not be edited while they are
+//! in flight.
+class FakeWindowSource : public WindowSource {
+public:
+    //! @brief Adds a window on top of the z-order, or replaces the window behind the handle.
+    void AddWindow(HWND window_handle, FakeWindow window = {});
+    void RemoveWindow(HWND window_handle);
+    //! @brief Returns the window behind a handle, or nullptr, to edit it in place.
+    FakeWindow* window(HWND window_handle);
+    void SetProcess(uint32_t process_id, FakeProcess process);
+
+    void EnumerateWindowHandles(std::vector<HWND>* window_handles) override;
+    bool GetWindowAttributes(HWND window_handle, WindowAttributes* window_attributes) override;
+    bool GetWindowMetrics(HWND window_handle, WindowMetrics* window_metrics) override;
+    ProbeStatus GetWindowFont(HWND window_handle, uint32_t timeout_milliseconds,
+        std::string* font_name, uint32_t* font_size) override;
+    bool GetWindowProcessId(HWND window_handle, uint32_t* process_id) override;
+    bool GetWindowTitle(HWND window_handle, std::string* title) override;
+    bool GetWindowClassName(HWND window_handle, std::string* class_name) override;
+    bool GetProcessInfo(uint32_t process_id, uint64_t* start_time,
+        std::string* file_name) override;
+
+    //! Number of GetWindowFont calls so far.
+    int font_reads() const { return font_reads_.load(std::memory_order_relaxed); }
+    //! Number of GetProcessInfo calls so far, i.e. how often a process was opened.
+    int process_opens() const { return process_opens_.load(std::memory_order_relaxed); }
+    //! Number of GetProcessInfo calls that asked for the image path.
+    int path_reads() const { return path_reads_.load(std::memory_order_relaxed); }
+
+private:
+    const FakeWindow* Lookup(HWND window_handle) const;
+
+    //! Handles from the bottom to the top of the z-order.
+    std::vector<HWND> z_order_;
+    std::map<HWND, FakeWindow> windows_;
+    std::map<uint32_t, FakeProcess> processes_;
+    std::atomic<int> font_reads_{0};
+    std::atomic<int> process_opens_{0};
+    std::atomic<int> path_reads_{0};
+};
+
+//! @brief Makes a window handle out of a small number, for fakes and tests.
+inline HWND FakeHandle(uintptr_t value) {
+    return reinterpret_cast<HWND>(value * 4);
+}
+} // namespace fsb
+
+#endif // #ifndef FSB_FAKE_WINDOW_SOURCE_H_
@@ -0,0 +1,194 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "frame_renderer.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fsb {
+namespace {
+constexpr int kWidth = 40;
+constexpr int kHeight = 12;
+
+//! Terminal that understands exactly what FrameRenderer writes: CUP, SGR, ED and UTF-8 text.
+class TerminalModel : public TerminalSink {
+public:
+    TerminalModel() { screen_.Resize(kWidth, kHeight); }
+
+    void Write(std::string_view bytes) override {
+        ++writes_;
+        last_ = std::string(bytes);
+        size_t i = 0;
+        while (i < bytes.size()) {
+            if (bytes[i] == '\033') {
+                i = Escape(bytes, i);
+                continue;
+            }
+            // Put decodes one code point, so the length of its UTF-8 sequence is handed over.
+            const auto kLead = static_cast<unsigned char>(bytes[i]);
+            const size_t kLength = kLead < 0x80 ? 1 : kLead < 0xE0 ? 2 : kLead < 0xF0 ? 3 : 4;
+            static_cast<void>(screen_.Put(x_, y_, bytes.substr(i, kLength), attribute_));
+            ++x_;
+            i += kLength;
+        }
+    }
+
+    const ScreenBuffer& screen() const { return screen_; }
+    int writes() const { return writes_; }
+    const std::string& last() const { return last_; }
+
+private:
+    size_t Escape(std::string_view bytes, size_t i) {
+        const size_t kEnd = bytes.find_first_of("HmJ", i);
+        const std::string kParameters(bytes.substr(i + 2, kEnd - i - 2));
+        switch (bytes[kEnd]) {
+            case 'H':
+                y_ = std::stoi(kParameters) - 1;
+                x_ = std::stoi(kParameters.substr(kParameters.find(';') + 1)) - 1;
+                break;
+            case 'm':
+                attribute_ = kParameters == "0;30;47" ? CellAttribute::Highlight
+                    : kParameters == "0;90" ? CellAttribute::Dim : CellAttribute::Normal;
+                break;
+            case 'J':
+                screen_.Clear();
+                break;
+        }
+        return kEnd + 1;
+    }
+
+    ScreenBuffer screen_;
+    int x_ = 0;
+    int y_ = 0;
+    CellAttribute attribute_ = CellAttribute::Normal;
+    int writes_ = 0;
+    std::string last_;
+};
+
+bool SameScreen(const ScreenBuffer& expected, const ScreenBuffer& actual) {
+    for (int y = 0; y < expected.height(); ++y) {
+        for (int x = 0; x < expected.width(); ++x) {
+            if (expected.at(x, y) != actual.at(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//! Menu-like frame: one line per row, the selected one highlighted.
+void DrawList(int selection, ScreenBuffer* screen) {
+    screen->Clear();
+    for (int y = 0; y < kHeight; ++y) {
+        const CellAttribute kAttribute = y == selection ? CellAttribute::Highlight
+            : CellAttribute::Normal;
+        static_cast<void>(screen->Put(0, y, "Window ünïcødé " + std::to_string(y), kAttribute));
+        screen->SetRowAttribute(y, kAttribute);
+    }
+}
+} // namespace
+
+TEST(FrameRendererTest, UnchangedFrameWritesNothing) {
+    FrameRenderer renderer;
+    renderer.Resize(kWidth, kHeight);
+    TerminalModel terminal;
+    DrawList(0, &renderer.back_buffer());
+    EXPECT_GT(renderer.Present(terminal), 0u);
+
+    DrawList(0, &renderer.back_buffer());
+    EXPECT_EQ(renderer.Present(terminal), 0u);
+    EXPECT_EQ(terminal.writes(), 1);
+    EXPECT_EQ(renderer.frames_presented(), 1u);
+}
+
+TEST(FrameRendererTest, OneCellCostsOneCursorMove) {
+    FrameRenderer renderer;
+    renderer.Resize(kWidth, kHeight);
+    TerminalModel terminal;
+    static_cast<void>(renderer.Present(terminal));
+
+    static_cast<void>(renderer.back_buffer().Put(4, 2, "x", CellAttribute::Normal));
+    EXPECT_EQ(renderer.Present(terminal), 11u);
+    EXPECT_EQ(terminal.last(), "\033[3;5H\033[0mx");
+
+    // Highlighted text ends with a reset, so nothing else writes in its colors.
+    static_cast<void>(renderer.back_buffer().Put(0, 0, "é", CellAttribute::Highlight));
+    EXPECT_EQ(renderer.Present(terminal), 22u);
+    EXPECT_EQ(terminal.last(), "\033[1;1H\033[0;30;47m\xC3\xA9\033[0m");
+}
+
+TEST(FrameRendererTest, CloseChangesShareACursorMove) {
+    FrameRenderer renderer;
+    renderer.Resize(kWidth, kHeight);
+    TerminalModel terminal;
+    static_cast<void>(renderer.Present(terminal));
+
+    // A few unchanged cells between them are cheaper to rewrite than a second move.
+    static_cast<void>(renderer.back_buffer().Put(0, 0, "a", CellAttribute::Normal));
+    static_cast<void>(renderer.back_buffer().Put(6, 0, "b", CellAttribute::Normal));
+    EXPECT_EQ(renderer.Present(terminal), 17u);
+    EXPECT_EQ(terminal.last(), "\033[1;1H\033[0ma     b");
+
+    static_cast<void>(renderer.back_buffer().Put(0, 0, "c", CellAttribute::Normal));
+    static_cast<void>(renderer.back_buffer().Put(7, 0, "d", CellAttribute::Normal));
+    static_cast<void>(renderer.Present(terminal));
+    EXPECT_EQ(terminal.last(), "\033[1;1H\033[0mc\033[1;8Hd");
+}
+
+TEST(FrameRendererTest, MovingTheSelectionRewritesTwoRows) {
+    FrameRenderer renderer;
+    renderer.Resize(kWidth, kHeight);
+    TerminalModel terminal;
+    DrawList(3, &renderer.back_buffer());
+    const size_t kFullFrame = renderer.Present(terminal);
+
+    DrawList(4, &renderer.back_buffer());
+    const size_t kMove = renderer.Present(terminal);
+    EXPECT_TRUE(SameScreen(renderer.back_buffer(), terminal.screen()));
+    // Two rows of up to two bytes per cell, plus a cursor move and an attribute each.
+    EXPECT_LE(kMove, 2u * (2 * kWidth + 20));
+    EXPECT_LT(kMove * 4, kFullFrame);
+}
+
+TEST(FrameRendererTest, TerminalMatchesEveryRandomFrame) {
+    FrameRenderer renderer;
+    renderer.Resize(kWidth, kHeight);
+    TerminalModel terminal;
+    std::mt19937 random(7);
+    const std::vector<std::string> kTexts = {"a", "bc", "ünï", "日本", "€", "\t", "😀"};
+    ScreenBuffer& back = renderer.back_buffer();
+
+    for (int frame = 0; frame < 500; ++frame) {
+        const int kEdits = static_cast<int>(random() % 12);
+        for (int i = 0; i < kEdits; ++i) {
+            const int kX = static_cast<int>(random() % (kWidth + 4)) - 2;
+            const int kY = static_cast<int>(random() % kHeight);
+            const auto kAttribute = static_cast<CellAttribute>(random() % 3);
+            switch (random() % 4) {
+                case 0:
+                    static_cast<void>(back.Put(kX, kY, kTexts[random() % kTexts.size()],
+                        kAttribute));
+                    break;
+                case 1:
+                    back.Fill(kX, kY, static_cast<int>(random() % 20), U'=', kAttribute);
+                    break;
+                case 2:
+                    back.SetRowAttribute(kY, kAttribute);
+                    break;
+                default:
+                    if (random() % 20 == 0) {
+                        renderer.Invalidate();
+                    }
+                    break;
+            }
+        }
+        static_cast<void>(renderer.Present(terminal));
+        ASSERT_TRUE(SameScreen(back, terminal.screen())) << "frame " << frame;
+    }
+}
+} // namespace fsb
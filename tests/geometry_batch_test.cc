@@ -0,0 +1,136 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "geometry_batch.h"
+
+#include "fake_window_source.h"
+#include "recording_geometry_backend.h"
+
+#include <gtest/gtest.h>
+
+namespace fsb {
+namespace {
+constexpr uint32_t kFramedStyle = 0x14CF0000;
+constexpr uint32_t kFramedExStyle = 0x00000100;
+constexpr SizeVec2 kSecondMonitor = {1920, 0};
+
+WindowMetrics Framed(int i) {
+    return {{(i * 13) % 1800, (i * 7) % 900}, {640, 480}, kFramedStyle, kFramedExStyle};
+}
+
+void SetUpDesktop(RecordingGeometryBackend* backend, int window_count) {
+    backend->AddMonitor({0, 0}, {1920, 1080});
+    backend->AddMonitor(kSecondMonitor, {2560, 1440});
+    for (int i = 0; i < window_count; ++i) {
+        backend->SetWindow(FakeHandle(i + 1), Framed(i));
+    }
+}
+
+size_t CountCalls(const RecordingGeometryBackend& backend, GeometryCall::Type type) {
+    size_t count = 0;
+    for (const GeometryCall& call : backend.calls()) {
+        count += call.type_ == type ? 1 : 0;
+    }
+    return count;
+}
+
+//! Whether every window of the desktop is back to where SetUpDesktop put it.
+bool Untouched(RecordingGeometryBackend& backend, int window_count) {
+    for (int i = 0; i < window_count; ++i) {
+        WindowMetrics current = {};
+        const WindowMetrics kBefore = Framed(i);
+        if (!backend.GetGeometry(FakeHandle(i + 1), &current)
+            || current.position_.x != kBefore.position_.x || current.size_.x != kBefore.size_.x
+            || current.style_ != kBefore.style_ || current.ex_style_ != kBefore.ex_style_) {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+TEST(GeometryBatchTest, CommitsEveryWindowInOneMove) {
+    RecordingGeometryBackend backend;
+    SetUpDesktop(&backend, 10);
+    GeometryBatch batch(backend);
+    for (int i = 0; i < 10; ++i) {
+        static_cast<void>(batch.AddBorderless(FakeHandle(i + 1), i % 3 == 0 ? 2 : 0));
+    }
+    EXPECT_EQ(batch.AddBorderless(FakeHandle(99), 0).status_, ApplyStatus::Gone);
+    EXPECT_EQ(batch.AddBorderless(FakeHandle(2), 5).status_, ApplyStatus::NoMonitor);
+
+    EXPECT_FALSE(batch.Commit());
+    EXPECT_EQ(batch.CountStatus(ApplyStatus::Applied), 10u);
+    EXPECT_EQ(CountCalls(backend, GeometryCall::Type::MoveWindows), 1u);
+    EXPECT_EQ(batch.Summary(), "10 of 12 window(s) applied, 1 closed, 1 without their monitor.");
+
+    WindowMetrics current = {};
+    ASSERT_TRUE(backend.GetGeometry(FakeHandle(1), &current));
+    EXPECT_EQ(current.position_.x, kSecondMonitor.x);
+    EXPECT_EQ(current.size_.x, 2560);
+    EXPECT_EQ(current.style_ & 0x00C00000u, 0u);
+    EXPECT_EQ(current.ex_style_, 0u);
+}
+
+TEST(GeometryBatchTest, RefusedMoveRollsBackTheBatch) {
+    RecordingGeometryBackend backend;
+    SetUpDesktop(&backend, 10);
+    backend.RefuseMoves(FakeHandle(5));
+    GeometryBatch batch(backend);
+    for (int i = 0; i < 10; ++i) {
+        static_cast<void>(batch.AddBorderless(FakeHandle(i + 1), 0));
+    }
+
+    EXPECT_FALSE(batch.Commit());
+    EXPECT_EQ(batch.CountStatus(ApplyStatus::Failed), 1u);
+    EXPECT_EQ(batch.CountStatus(ApplyStatus::RolledBack), 9u);
+    EXPECT_TRUE(Untouched(backend, 10));
+}
+
+TEST(GeometryBatchTest, RefusedStyleStopsBeforeAnythingMoves) {
+    RecordingGeometryBackend backend;
+    SetUpDesktop(&backend, 10);
+    backend.RefuseStyles(FakeHandle(8));
+    GeometryBatch batch(backend);
+    for (int i = 0; i < 10; ++i) {
+        static_cast<void>(batch.AddBorderless(FakeHandle(i + 1), 0));
+    }
+
+    EXPECT_FALSE(batch.Commit());
+    EXPECT_EQ(batch.CountStatus(ApplyStatus::Failed), 1u);
+    EXPECT_EQ(batch.CountStatus(ApplyStatus::RolledBack), 9u);
+    EXPECT_TRUE(Untouched(backend, 10));
+    // Only the rollback moves anything, and nothing has left its place by then.
+    EXPECT_EQ(CountCalls(backend, GeometryCall::Type::MoveWindows), 1u);
+}
+
+TEST(GeometryBatchTest, RollbackMaximizesAgain) {
+    RecordingGeometryBackend backend;
+    SetUpDesktop(&backend, 3);
+    backend.SetMaximized(FakeHandle(1));
+    backend.RefuseMoves(FakeHandle(3));
+    GeometryBatch batch(backend);
+    for (int i = 0; i < 3; ++i) {
+        static_cast<void>(batch.AddBorderless(FakeHandle(i + 1), 2));
+    }
+    EXPECT_TRUE(batch.changes()[0].maximized_);
+
+    EXPECT_FALSE(batch.Commit());
+    EXPECT_EQ(batch.changes()[0].status_, ApplyStatus::RolledBack);
+    EXPECT_TRUE(backend.IsMaximized(FakeHandle(1)));
+    EXPECT_FALSE(backend.IsMaximized(FakeHandle(2)));
+    EXPECT_EQ(CountCalls(backend, GeometryCall::Type::Maximize), 1u);
+}
+
+TEST(GeometryBatchTest, CommittedMaximizedWindowIsRestored) {
+    RecordingGeometryBackend backend;
+    SetUpDesktop(&backend, 1);
+    backend.SetMaximized(FakeHandle(1));
+    GeometryBatch batch(backend);
+    static_cast<void>(batch.AddBorderless(FakeHandle(1), 2));
+
+    EXPECT_TRUE(batch.Commit());
+    EXPECT_FALSE(backend.IsMaximized(FakeHandle(1)));
+}
+} // namespace fsb
@@ -0,0 +1,206 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "headless.h"
+
+#include "fake_window_source.h"
+#include "probe_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace fsb {
+namespace {
+ProcessData Window(std::string title, std::string_view class_name) {
+    ProcessData window = {};
+    window.window_handle_ = FakeHandle(3);
+    window.process_id_ = 42;
+    window.title_ = std::move(title);
+    window.class_name_ = class_name;
+    window.attributes_ = {true, false, WindowState::Maximized};
+    window.metrics_ = {{-8, 10}, {1920, 1080}, 0x14cf0000u, 0x100u};
+    window.details_.file_name_ = "C:\\Apps\\app.exe";
+    return window;
+}
+
+//! Runs ListWindows into a temporary file and returns what it wrote.
+std::string List(WindowSource& source, const HeadlessOptions& options, HeadlessStats* stats) {
+    ProbePool pool(2);
+    std::FILE* output = std::tmpfile();
+    if (output == nullptr) {
+        ADD_FAILURE() << "Cannot create a temporary file.";
+        return {};
+    }
+    *stats = ListWindows(source, pool, options, output);
+    std::rewind(output);
+    std::string text;
+    char buffer[4096];
+    for (size_t read; (read = std::fread(buffer, 1, sizeof(buffer), output)) != 0;) {
+        text.append(buffer, read);
+    }
+    static_cast<void>(std::fclose(output));
+    return text;
+}
+
+class HeadlessTest : public testing::Test {
+protected:
+    void SetUp() override {
+        // Two processes with three windows each, every other one of class Match.
+        for (uintptr_t i = 1; i <= 6; ++i) {
+            FakeWindow window;
+            window.process_id_ = i <= 3 ? 10 : 20;
+            window.title_ = "Window " + std::to_string(i);
+            window.class_name_ = i % 2 == 0 ? "Match" : "Other";
+            source_.AddWindow(FakeHandle(i), window);
+        }
+        source_.SetProcess(10, {1, "C:\\Apps\\ten.exe"});
+        source_.SetProcess(20, {2, "C:\\Apps\\twenty.exe"});
+    }
+
+    FakeWindowSource source_;
+};
+} // namespace
+
+TEST(HeadlessRecordTest, EscapesJsonStrings) {
+    const ProcessData kWindow = Window("Say \"hi\", C:\\dir\n\t\x01\x1f \xc3\xa9", "Cls");
+    std::string out;
+    AppendRecord(kWindow, FieldBit(RecordField::Title), OutputFormat::Ndjson, &out);
+    EXPECT_EQ(out, "{\"title\":\"Say \\\"hi\\\", C:\\\\dir\\u000a\\u0009\\u0001\\u001f "
+        "\xc3\xa9\"}\n");
+}
+
+TEST(HeadlessRecordTest, QuotesCsvFieldsThatNeedIt) {
+    const struct {
+        std::string title_;
+        std::string expected_;
+    } kCases[] = {
+        {"plain title", "plain title"},
+        {"a, b", "\"a, b\""},
+        {"say \"hi\"", "\"say \"\"hi\"\"\""},
+        {"two\nlines", "\"two\nlines\""},
+        {"carriage\rreturn", "\"carriage\rreturn\""},
+        // Tabs and other control characters need no quotes in CSV.
+        {"tab\there", "tab\there"},
+        {"", ""},
+    };
+    for (const auto& kCase : kCases) {
+        std::string out;
+        AppendRecord(Window(kCase.title_, "Cls"), FieldBit(RecordField::Title)
+            | FieldBit(RecordField::ProcessId), OutputFormat::Csv, &out);
+        EXPECT_EQ(out, "42," + kCase.expected_ + "\n") << kCase.title_;
+    }
+}
+
+TEST(HeadlessRecordTest, WritesEveryFieldInOrder) {
+    const ProcessData kWindow = Window("Title", "Cls");
+    constexpr uint32_t kEvery = (uint32_t{1} << static_cast<uint32_t>(RecordField::Count)) - 1;
+    std::string header;
+    AppendCsvHeader(kEvery, &header);
+    EXPECT_EQ(header, "handle,pid,class,title,state,visible,enabled,x,y,width,height,style,"
+        "ex_style,exe,font,font_size\n");
+
+    std::string csv;
+    AppendRecord(kWindow, kEvery, OutputFormat::Csv, &csv);
+    EXPECT_EQ(csv, "12,42,Cls,Title,maximized,true,false,-8,10,1920,1080,349110272,256,"
+        "C:\\Apps\\app.exe,,0\n");
+
+    std::string json;
+    AppendRecord(kWindow, FieldBit(RecordField::Handle) | FieldBit(RecordField::State)
+        | FieldBit(RecordField::Visible) | FieldBit(RecordField::X), OutputFormat::Ndjson, &json);
+    EXPECT_EQ(json, "{\"handle\":12,\"state\":\"maximized\",\"visible\":true,\"x\":-8}\n");
+}
+
+TEST(HeadlessRecordTest, ParsesFieldLists) {
+    uint32_t fields = 0;
+    ASSERT_TRUE(ParseRecordFields("title", &fields));
+    EXPECT_EQ(fields, FieldBit(RecordField::Title));
+    // Order and repetition do not matter, the output order is fixed.
+    ASSERT_TRUE(ParseRecordFields("font_size,pid,ex_style,pid", &fields));
+    EXPECT_EQ(fields, FieldBit(RecordField::FontSize) | FieldBit(RecordField::ProcessId)
+        | FieldBit(RecordField::ExStyle));
+    ASSERT_TRUE(ParseRecordFields("handle,pid,class,title,state,visible,enabled,x,y,width,"
+        "height,style,ex_style,exe,font,font_size", &fields));
+    EXPECT_EQ(fields, (uint32_t{1} << static_cast<uint32_t>(RecordField::Count)) - 1);
+
+    // A failed parse leaves the fields alone.
+    fields = kDefaultRecordFields;
+    for (std::string_view kInvalid : {"", ",", "title,", "title,,pid", "Title", "pid,nope",
+        " title"}) {
+        EXPECT_FALSE(ParseRecordFields(kInvalid, &fields)) << kInvalid;
+        EXPECT_EQ(fields, kDefaultRecordFields) << kInvalid;
+    }
+}
+
+TEST_F(HeadlessTest, ListsInZOrder) {
+    HeadlessOptions options;
+    options.format_ = OutputFormat::Csv;
+    options.fields_ = FieldBit(RecordField::Handle) | FieldBit(RecordField::Title);
+    HeadlessStats stats = {};
+    EXPECT_EQ(List(source_, options, &stats), "handle,title\n24,Window 6\n20,Window 5\n"
+        "16,Window 4\n12,Window 3\n8,Window 2\n4,Window 1\n");
+    EXPECT_EQ(stats.windows_, 6u);
+    EXPECT_EQ(stats.records_, 6u);
+    EXPECT_GT(stats.first_record_, 0u);
+    EXPECT_LE(stats.first_record_, stats.total_);
+    EXPECT_EQ(stats.file_name_queries_, 0u);
+    EXPECT_EQ(stats.font_queries_, 0u);
+    EXPECT_EQ(source_.process_opens(), 0);
+}
+
+TEST_F(HeadlessTest, ReadsEachExecutableOnce) {
+    HeadlessOptions options;
+    options.fields_ = FieldBit(RecordField::Exe);
+    HeadlessStats stats = {};
+    const std::string kOutput = List(source_, options, &stats);
+    EXPECT_EQ(stats.records_, 6u);
+    EXPECT_EQ(stats.file_name_queries_, 2u);
+    EXPECT_EQ(source_.path_reads(), 2);
+    EXPECT_NE(kOutput.find("{\"exe\":\"C:\\\\Apps\\\\twenty.exe\"}\n"), std::string::npos)
+        << kOutput;
+}
+
+TEST_F(HeadlessTest, FilteredWindowsAreNotProbed) {
+    HeadlessOptions options;
+    options.fields_ = FieldBit(RecordField::Title) | FieldBit(RecordField::Font);
+    ASSERT_TRUE(ParseConditions("class=Match", &options.filter_));
+    HeadlessStats stats = {};
+    EXPECT_EQ(List(source_, options, &stats),
+        "{\"title\":\"Window 6\",\"font\":\"Segoe UI\"}\n"
+        "{\"title\":\"Window 4\",\"font\":\"Segoe UI\"}\n"
+        "{\"title\":\"Window 2\",\"font\":\"Segoe UI\"}\n");
+    EXPECT_EQ(stats.windows_, 6u);
+    EXPECT_EQ(stats.records_, 3u);
+    EXPECT_EQ(stats.font_queries_, 3u);
+    EXPECT_EQ(source_.font_reads(), 3);
+    // Nothing asked for the executable.
+    EXPECT_EQ(stats.file_name_queries_, 0u);
+    EXPECT_EQ(source_.process_opens(), 0);
+}
+
+TEST_F(HeadlessTest, ExecutableFilterReadsOnlyTheExecutable) {
+    HeadlessOptions options;
+    options.format_ = OutputFormat::Csv;
+    options.fields_ = FieldBit(RecordField::Title) | FieldBit(RecordField::FontSize);
+    ASSERT_TRUE(ParseConditions("exe=twenty.exe", &options.filter_));
+    HeadlessStats stats = {};
+    EXPECT_EQ(List(source_, options, &stats),
+        "title,font_size\nWindow 6,9\nWindow 5,9\nWindow 4,9\n");
+    EXPECT_EQ(stats.file_name_queries_, 2u);
+    EXPECT_EQ(stats.font_queries_, 3u);
+    EXPECT_EQ(source_.font_reads(), 3);
+}
+
+TEST_F(HeadlessTest, NothingListedWritesTheHeaderOnly) {
+    HeadlessOptions options;
+    options.format_ = OutputFormat::Csv;
+    ASSERT_TRUE(ParseConditions("class=Nothing", &options.filter_));
+    HeadlessStats stats = {};
+    EXPECT_EQ(List(source_, options, &stats), "handle,pid,class,title\n");
+    EXPECT_EQ(stats.records_, 0u);
+    EXPECT_EQ(stats.first_record_, 0u);
+}
+} // namespace fsb
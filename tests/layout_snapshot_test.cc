@@ -0,0 +1,209 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "layout_snapshot.h"
+
+#include "fake_window_source.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <string_view>
+
+namespace fsb {
+namespace {
+//! Class names are views, normally into the StringPool, so they need to outlive the windows.
+constexpr std::string_view kClassNames[] = {"Class0", "Class1", "Class2"};
+
+ProcessData Layout(int i) {
+    ProcessData window = {};
+    window.window_handle_ = FakeHandle(i);
+    window.process_id_ = static_cast<uint32_t>(100 + i);
+    window.class_name_ = kClassNames[i % 3];
+    window.title_ = "Title " + std::to_string(i);
+    window.metrics_ = {{i, -i}, {640 + i, 480}, 0x14CF0000, 0x00000100};
+    window.attributes_ = {true, true, WindowState::Normal};
+    return window;
+}
+
+//! Handles of every valid record in the file.
+std::set<uint64_t> ReadHandles(const std::string& path) {
+    std::set<uint64_t> handles;
+    SnapshotReader reader;
+    if (reader.Open(path)) {
+        for (size_t i = 0; i < reader.size(); ++i) {
+            if (reader.valid(i)) {
+                handles.insert(reader[i].window_handle_);
+            }
+        }
+    }
+    return handles;
+}
+
+uint64_t Handle(int i) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(FakeHandle(i)));
+}
+
+class LayoutSnapshotTest : public testing::Test {
+protected:
+    void SetUp() override {
+        path_ = testing::TempDir() + "fsb-"
+            + testing::UnitTest::GetInstance()->current_test_info()->name() + ".fsb-layouts";
+        static_cast<void>(std::remove(path_.c_str()));
+    }
+
+    void TearDown() override {
+        static_cast<void>(std::remove(path_.c_str()));
+        static_cast<void>(std::remove((path_ + ".lock").c_str()));
+    }
+
+    std::string path_;
+};
+} // namespace
+
+TEST_F(LayoutSnapshotTest, RecordsRoundTrip) {
+    SnapshotWriter writer;
+    ASSERT_TRUE(writer.Open(path_));
+    // Enough flushes of a few windows each to outgrow the capacity several times.
+    for (int i = 0; i < 500; ++i) {
+        ProcessData window = Layout(i);
+        window.attributes_.state_ = static_cast<WindowState>(i % 3);
+        window.title_ += std::string(static_cast<size_t>(i % 40), 'x');
+        EXPECT_TRUE(writer.Add(window));
+        if (i % 7 == 0) {
+            ASSERT_TRUE(writer.Flush());
+        }
+    }
+    ASSERT_TRUE(writer.Flush());
+
+    SnapshotReader reader;
+    ASSERT_TRUE(reader.Open(path_));
+    ASSERT_EQ(reader.size(), 500u);
+    for (int i = 0; i < 500; ++i) {
+        const SnapshotRecord& kRecord = reader[static_cast<size_t>(i)];
+        ASSERT_TRUE(reader.valid(static_cast<size_t>(i)));
+        EXPECT_EQ(kRecord.window_handle_, Handle(i));
+        EXPECT_EQ(kRecord.process_id_, static_cast<uint32_t>(100 + i));
+        EXPECT_EQ(kRecord.x_, i);
+        EXPECT_EQ(kRecord.y_, -i);
+        EXPECT_EQ(kRecord.width_, 640 + i);
+        EXPECT_EQ(kRecord.height_, 480);
+        EXPECT_EQ(kRecord.style_, 0x14CF0000u);
+        EXPECT_EQ(kRecord.ex_style_, 0x00000100u);
+        EXPECT_EQ(kRecord.state_, static_cast<uint32_t>(i % 3));
+        EXPECT_EQ(reader.class_name(static_cast<size_t>(i)), kClassNames[i % 3]);
+        EXPECT_EQ(reader.title(static_cast<size_t>(i)),
+            "Title " + std::to_string(i) + std::string(static_cast<size_t>(i % 40), 'x'));
+    }
+}
+
+TEST_F(LayoutSnapshotTest, TornRecordIsDropped) {
+    {
+        SnapshotWriter writer;
+        ASSERT_TRUE(writer.Open(path_));
+        for (int i = 0; i < 10; ++i) {
+            EXPECT_TRUE(writer.Add(Layout(i)));
+        }
+        ASSERT_TRUE(writer.Flush());
+    }
+
+    // A write of record 5 that stopped half way: its first bytes are new, the rest old.
+    std::FILE* file = std::fopen(path_.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(std::fseek(file, static_cast<long>(sizeof(SnapshotHeader)
+        + 5 * sizeof(SnapshotRecord) + offsetof(SnapshotRecord, x_)), SEEK_SET), 0);
+    const int32_t kTornX = 12345;
+    ASSERT_EQ(std::fwrite(&kTornX, sizeof(kTornX), 1, file), 1u);
+    ASSERT_EQ(std::fclose(file), 0);
+
+    SnapshotReader reader;
+    ASSERT_TRUE(reader.Open(path_));
+    ASSERT_EQ(reader.size(), 10u);
+    for (size_t i = 0; i < reader.size(); ++i) {
+        EXPECT_EQ(reader.valid(i), i != 5) << "record " << i;
+    }
+    reader.Close();
+
+    // A writer keeps the intact records only, so the window can be recorded again.
+    SnapshotWriter writer;
+    ASSERT_TRUE(writer.Open(path_));
+    EXPECT_EQ(writer.size(), 9u);
+    EXPECT_TRUE(writer.Add(Layout(5)));
+    EXPECT_FALSE(writer.Add(Layout(6)));
+    ASSERT_TRUE(writer.Flush());
+    EXPECT_EQ(ReadHandles(path_).size(), 10u);
+}
+
+TEST_F(LayoutSnapshotTest, WritersOnOneFileKeepEachOthersRecords) {
+    SnapshotWriter menu;
+    SnapshotWriter daemon;
+    ASSERT_TRUE(menu.Open(path_));
+    ASSERT_TRUE(daemon.Open(path_));
+
+    EXPECT_TRUE(menu.Add(Layout(1)));
+    ASSERT_TRUE(menu.Flush());
+    EXPECT_TRUE(daemon.Add(Layout(2)));
+    ASSERT_TRUE(daemon.Flush());
+    EXPECT_TRUE(menu.Add(Layout(3)));
+    ASSERT_TRUE(menu.Flush());
+
+    EXPECT_EQ(ReadHandles(path_), (std::set<uint64_t>{Handle(1), Handle(2), Handle(3)}));
+    EXPECT_EQ(menu.size(), 3u);
+}
+
+TEST_F(LayoutSnapshotTest, FirstLayoutWinsAcrossWriters) {
+    SnapshotWriter menu;
+    SnapshotWriter daemon;
+    ASSERT_TRUE(menu.Open(path_));
+    ASSERT_TRUE(daemon.Open(path_));
+
+    ProcessData later = Layout(1);
+    later.metrics_.position_ = {999, 999};
+    EXPECT_TRUE(daemon.Add(Layout(1)));
+    ASSERT_TRUE(daemon.Flush());
+    EXPECT_TRUE(menu.Add(later));
+    ASSERT_TRUE(menu.Flush());
+
+    SnapshotReader reader;
+    ASSERT_TRUE(reader.Open(path_));
+    ASSERT_EQ(reader.size(), 1u);
+    EXPECT_EQ(reader[0].x_, 1);
+}
+
+TEST_F(LayoutSnapshotTest, TakeEmptiesTheFileForEveryWriter) {
+    SnapshotWriter menu;
+    SnapshotWriter daemon;
+    ASSERT_TRUE(menu.Open(path_));
+    ASSERT_TRUE(daemon.Open(path_));
+    EXPECT_TRUE(daemon.Add(Layout(1)));
+    ASSERT_TRUE(daemon.Flush());
+    EXPECT_TRUE(menu.Add(Layout(2)));
+
+    // The menu sees the daemon's record, and its own unflushed one.
+    size_t taken = 0;
+    ASSERT_TRUE(menu.Take([&](const SnapshotReader& reader) { taken = reader.size(); }));
+    EXPECT_EQ(taken, 2u);
+    EXPECT_TRUE(ReadHandles(path_).empty());
+
+    // The daemon must not write its stale records back.
+    EXPECT_TRUE(daemon.Add(Layout(3)));
+    ASSERT_TRUE(daemon.Flush());
+    EXPECT_EQ(ReadHandles(path_), (std::set<uint64_t>{Handle(3)}));
+}
+
+TEST_F(LayoutSnapshotTest, DeletedFileIsWrittenAgain) {
+    SnapshotWriter writer;
+    ASSERT_TRUE(writer.Open(path_));
+    EXPECT_TRUE(writer.Add(Layout(1)));
+    ASSERT_TRUE(writer.Flush());
+
+    ASSERT_EQ(std::remove(path_.c_str()), 0);
+    EXPECT_TRUE(writer.Add(Layout(2)));
+    ASSERT_TRUE(writer.Flush());
+    EXPECT_EQ(ReadHandles(path_), (std::set<uint64_t>{Handle(1), Handle(2)}));
+}
+} // namespace fsb
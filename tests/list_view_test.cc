@@ -0,0 +1,162 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "list_view.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace fsb {
+namespace {
+//! A view of 100 items, 10 rows on screen and the default margin of 2.
+ListView MakeView(int item_count = 100, int viewport_height = 10) {
+    ListView view;
+    view.SetItemCount(item_count);
+    view.SetViewportHeight(viewport_height);
+    return view;
+}
+
+//! Checks the selection and the visible rows at once.
+void ExpectView(const ListView& view, int selection, int first_visible, int end_visible) {
+    EXPECT_EQ(view.selection(), selection);
+    EXPECT_EQ(view.first_visible(), first_visible);
+    EXPECT_EQ(view.end_visible(), end_visible);
+}
+} // namespace
+
+TEST(ListViewTest, KeepsTheMarginWhileScrolling) {
+    ListView view = MakeView();
+    ExpectView(view, 0, 0, 10);
+
+    // Down: the view starts to follow when the selection is two rows from the bottom, and stops at
+    // the end of the list, where the margin gives way.
+    for (int selection = 1; selection < 100; ++selection) {
+        view.MoveBy(1);
+        const int kOffset = std::clamp(selection + 2 - 9, 0, 90);
+        ASSERT_EQ(view.selection(), selection);
+        ASSERT_EQ(view.first_visible(), kOffset) << selection;
+    }
+    ExpectView(view, 99, 90, 100);
+
+    // Up: nothing scrolls until the selection is two rows from the top.
+    for (int selection = 98; selection >= 0; --selection) {
+        view.MoveBy(-1);
+        const int kOffset = std::clamp(selection - 2, 0, 90);
+        ASSERT_EQ(view.selection(), selection);
+        ASSERT_EQ(view.first_visible(), kOffset) << selection;
+    }
+    ExpectView(view, 0, 0, 10);
+
+    // Selecting far away scrolls just enough to keep the margin below the selection.
+    view.Select(50);
+    ExpectView(view, 50, 43, 53);
+    view.Select(45);
+    ExpectView(view, 45, 43, 53);
+    view.Select(44);
+    ExpectView(view, 44, 42, 52);
+}
+
+TEST(ListViewTest, MarginShrinksWithTheViewport) {
+    // A margin that would not leave room for the selection takes at most half the viewport.
+    ListView view(5);
+    view.SetItemCount(100);
+    view.SetViewportHeight(5);
+    view.Select(10);
+    ExpectView(view, 10, 8, 13);
+    view.SetViewportHeight(1);
+    ExpectView(view, 10, 10, 11);
+    view.MoveBy(1);
+    ExpectView(view, 11, 11, 12);
+
+    // No margin at all.
+    ListView flush(0);
+    flush.SetItemCount(100);
+    flush.SetViewportHeight(10);
+    flush.Select(9);
+    ExpectView(flush, 9, 0, 10);
+    flush.MoveBy(1);
+    ExpectView(flush, 10, 1, 11);
+}
+
+TEST(ListViewTest, PagesStopAtTheEdges) {
+    ListView view = MakeView();
+    // A page keeps one row of the previous one in view.
+    view.PageUp();
+    ExpectView(view, 0, 0, 10);
+    view.PageDown();
+    ExpectView(view, 9, 2, 12);
+    for (int i = 0; i < 20; ++i) {
+        view.PageDown();
+    }
+    ExpectView(view, 99, 90, 100);
+    view.PageUp();
+    ExpectView(view, 90, 88, 98);
+    view.End();
+    ExpectView(view, 99, 90, 100);
+    view.End();
+    ExpectView(view, 99, 90, 100);
+    view.Home();
+    ExpectView(view, 0, 0, 10);
+    view.MoveBy(-1);
+    ExpectView(view, 0, 0, 10);
+
+    // A list shorter than the viewport never scrolls.
+    ListView short_list = MakeView(4);
+    short_list.PageDown();
+    ExpectView(short_list, 3, 0, 4);
+    short_list.PageUp();
+    ExpectView(short_list, 0, 0, 4);
+
+    // Neither does an empty one, or one that has no room on screen.
+    for (ListView nothing_shown : {MakeView(0), MakeView(100, 0)}) {
+        nothing_shown.PageDown();
+        nothing_shown.End();
+        nothing_shown.MoveBy(3);
+        EXPECT_EQ(nothing_shown.first_visible(), 0);
+        EXPECT_EQ(nothing_shown.end_visible(), 0);
+    }
+    ListView empty = MakeView(0);
+    empty.End();
+    EXPECT_EQ(empty.selection(), 0);
+
+    // A viewport of one row still pages one item at a time.
+    ListView one_row = MakeView(100, 1);
+    one_row.PageDown();
+    ExpectView(one_row, 1, 1, 2);
+    one_row.End();
+    one_row.PageUp();
+    ExpectView(one_row, 98, 98, 99);
+}
+
+TEST(ListViewTest, ShrinkingTheListClampsTheSelection) {
+    ListView view = MakeView();
+    view.Select(80);
+    ExpectView(view, 80, 73, 83);
+
+    // The selection moves to the last item, and the view to the end of the list.
+    view.SetItemCount(50);
+    ExpectView(view, 49, 40, 50);
+    view.SetItemCount(5);
+    ExpectView(view, 4, 0, 5);
+    view.SetItemCount(0);
+    ExpectView(view, 0, 0, 0);
+    view.SetItemCount(100);
+    ExpectView(view, 0, 0, 10);
+
+    // A selection still in the list stays, but the view does not leave empty rows below the end.
+    view.Select(20);
+    ExpectView(view, 20, 13, 23);
+    view.SetItemCount(25);
+    ExpectView(view, 20, 13, 23);
+    view.SetItemCount(21);
+    ExpectView(view, 20, 11, 21);
+
+    // Nor does a taller viewport.
+    view.SetViewportHeight(30);
+    ExpectView(view, 20, 0, 21);
+    view.SetViewportHeight(10);
+    ExpectView(view, 20, 11, 21);
+}
+} // namespace fsb
@@ -0,0 +1,147 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "monitor_topology.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace fsb {
+namespace {
+MonitorInfo Monitor(SizeVec2 position, SizeVec2 size, uint32_t dpi = 96) {
+    const bool kPrimary = position.x == 0 && position.y == 0;
+    return {position, size, position, {size.x, size.y - 40}, dpi, kPrimary};
+}
+
+int64_t Overlap(int64_t begin_a, int64_t end_a, int64_t begin_b, int64_t end_b) {
+    return std::max<int64_t>(0, std::min(end_a, end_b) - std::max(begin_a, begin_b));
+}
+
+int64_t Gap(int64_t begin_a, int64_t end_a, int64_t begin_b, int64_t end_b) {
+    return std::max<int64_t>({0, begin_b - end_a, begin_a - end_b});
+}
+
+//! Area against every monitor, then distance to every monitor, first enumerated on ties.
+int BruteForceMonitor(const std::vector<MonitorInfo>& monitors, SizeVec2 position, SizeVec2 size) {
+    const int64_t kLeft = position.x;
+    const int64_t kTop = position.y;
+    const int64_t kRight = kLeft + std::max(size.x, 0);
+    const int64_t kBottom = kTop + std::max(size.y, 0);
+    int best = -1;
+    int64_t best_area = 0;
+    for (size_t i = 0; i < monitors.size(); ++i) {
+        const MonitorInfo& kMonitor = monitors[i];
+        const int64_t kArea = Overlap(kLeft, kRight, kMonitor.position_.x,
+            int64_t{kMonitor.position_.x} + kMonitor.size_.x)
+            * Overlap(kTop, kBottom, kMonitor.position_.y,
+                int64_t{kMonitor.position_.y} + kMonitor.size_.y);
+        if (kArea > best_area) {
+            best_area = kArea;
+            best = static_cast<int>(i);
+        }
+    }
+    if (best >= 0) {
+        return best;
+    }
+    int64_t best_distance = std::numeric_limits<int64_t>::max();
+    for (size_t i = 0; i < monitors.size(); ++i) {
+        const MonitorInfo& kMonitor = monitors[i];
+        const int64_t kDx = Gap(kLeft, kRight, kMonitor.position_.x,
+            int64_t{kMonitor.position_.x} + kMonitor.size_.x);
+        const int64_t kDy = Gap(kTop, kBottom, kMonitor.position_.y,
+            int64_t{kMonitor.position_.y} + kMonitor.size_.y);
+        if (kDx * kDx + kDy * kDy < best_distance) {
+            best_distance = kDx * kDx + kDy * kDy;
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+//! Columns of one or two monitors side by side, of mixed sizes, offsets and gaps, in a random
+//! enumeration order. Monitors never overlap, as on any desktop that does not mirror.
+std::vector<MonitorInfo> RandomLayout(std::mt19937& random, size_t columns) {
+    std::vector<MonitorInfo> monitors;
+    int32_t x = -static_cast<int32_t>(random() % 4000);
+    for (size_t column = 0; column < columns; ++column) {
+        const auto kWidth = static_cast<int32_t>(800 + random() % 3000);
+        const auto kHeight = static_cast<int32_t>(600 + random() % 1600);
+        const int32_t kY = static_cast<int32_t>(random() % 1200) - 600;
+        monitors.push_back(Monitor({x, kY}, {kWidth, kHeight}, 96 + 24 * (random() % 4)));
+        if (random() % 3 == 0) {
+            // A narrower monitor stacked on top, flush or with a gap.
+            const auto kAboveWidth = static_cast<int32_t>(640 + random() % (kWidth - 639));
+            const auto kAboveHeight = static_cast<int32_t>(480 + random() % 1000);
+            const int32_t kAboveY = kY - kAboveHeight - static_cast<int32_t>(random() % 2) * 50;
+            monitors.push_back(Monitor({x + static_cast<int32_t>(random() % (kWidth
+                - kAboveWidth + 1)), kAboveY}, {kAboveWidth, kAboveHeight}));
+        }
+        x += kWidth + (random() % 3 == 0 ? static_cast<int32_t>(random() % 300) : 0);
+    }
+    std::shuffle(monitors.begin(), monitors.end(), random);
+    return monitors;
+}
+
+void ExpectBruteForce(std::mt19937& random, const std::vector<MonitorInfo>& monitors,
+    int queries) {
+    const MonitorTopology kTopology(monitors);
+    for (int i = 0; i < queries; ++i) {
+        // Windows on, across, between and far off the monitors, including empty ones.
+        const SizeVec2 kPosition = {static_cast<int32_t>(random() % 40000) - 20000,
+            static_cast<int32_t>(random() % 8000) - 4000};
+        const SizeVec2 kSize = {static_cast<int32_t>(random() % 5000) - 100,
+            static_cast<int32_t>(random() % 3000) - 100};
+        ASSERT_EQ(kTopology.FindMonitor(kPosition, kSize),
+            BruteForceMonitor(monitors, kPosition, kSize))
+            << "window " << kPosition.x << "," << kPosition.y << " " << kSize.x << "x" << kSize.y;
+    }
+}
+} // namespace
+
+TEST(MonitorTopologyTest, TwoMonitorsSideBySide) {
+    const MonitorTopology kTopology({Monitor({0, 0}, {1920, 1080}),
+        Monitor({1920, -200}, {2560, 1440}, 144)});
+    EXPECT_EQ(kTopology.FindMonitor({100, 100}, {800, 600}), 0);
+    EXPECT_EQ(kTopology.FindMonitor({2000, 0}, {800, 600}), 1);
+    // Mostly on the right, and an even split going to the monitor enumerated first.
+    EXPECT_EQ(kTopology.FindMonitor({1800, 100}, {400, 300}), 1);
+    EXPECT_EQ(kTopology.FindMonitor({1820, 100}, {200, 300}), 0);
+    // Off every monitor the nearest one wins, and an empty window still has a position.
+    EXPECT_EQ(kTopology.FindMonitor({-500, 500}, {100, 100}), 0);
+    EXPECT_EQ(kTopology.FindMonitor({5000, -1000}, {0, 0}), 1);
+    EXPECT_EQ(kTopology.FindMonitor({1000, 1200}, {-5, -5}), 0);
+
+    EXPECT_EQ(kTopology.DpiAt({2000, 0}, {800, 600}), 144u);
+    EXPECT_EQ(MonitorTopology().FindMonitor({0, 0}, {1, 1}), -1);
+    EXPECT_EQ(MonitorTopology().DpiAt({0, 0}, {1, 1}), MonitorTopology::kDefaultDpi);
+}
+
+TEST(MonitorTopologyTest, MirroredMonitorGoesToTheFirstEnumerated) {
+    const MonitorTopology kTopology({Monitor({0, 0}, {1920, 1080}),
+        Monitor({0, 0}, {1920, 1080}, 120), Monitor({1920, 0}, {1920, 1080})});
+    EXPECT_EQ(kTopology.FindMonitor({0, 0}, {1920, 1080}), 0);
+    EXPECT_EQ(kTopology.DpiAt({0, 0}, {100, 100}), 96u);
+    EXPECT_EQ(kTopology.FindMonitor({1800, 0}, {400, 100}), 2);
+}
+
+TEST(MonitorTopologyTest, MatchesBruteForceOnRandomLayouts) {
+    std::mt19937 random(22);
+    for (int layout = 0; layout < 300; ++layout) {
+        ExpectBruteForce(random, RandomLayout(random, 1 + random() % 6), 2000);
+    }
+}
+
+TEST(MonitorTopologyTest, MatchesBruteForceBeyondTheCountedMonitors) {
+    // More monitors than FindMonitor keeps areas for on the stack.
+    std::mt19937 random(23);
+    for (int layout = 0; layout < 5; ++layout) {
+        ExpectBruteForce(random, RandomLayout(random, 40), 2000);
+    }
+}
+} // namespace fsb
@@ -0,0 +1,62 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "process_cache.h"
+
+#include "fake_window_source.h"
+#include "string_pool.h"
+
+#include <gtest/gtest.h>
+
+namespace fsb {
+TEST(ProcessCacheTest, ResolvesEachProcessWithOneOpen) {
+    FakeWindowSource source;
+    source.SetProcess(4, {100, "C:\\a.exe"});
+    StringPool strings;
+    ProcessCache cache(strings);
+
+    cache.BeginRefresh();
+    EXPECT_EQ(cache.GetFileName(source, 4), "C:\\a.exe");
+    EXPECT_EQ(cache.GetFileName(source, 4), "C:\\a.exe");
+    EXPECT_EQ(source.process_opens(), 1);
+
+    // A later refresh only checks the start time.
+    cache.BeginRefresh();
+    EXPECT_EQ(cache.GetFileName(source, 4), "C:\\a.exe");
+    EXPECT_EQ(source.process_opens(), 2);
+    EXPECT_EQ(source.path_reads(), 1);
+}
+
+TEST(ProcessCacheTest, ReusedProcessIdIsResolvedAgain) {
+    FakeWindowSource source;
+    source.SetProcess(4, {100, "C:\\a.exe"});
+    StringPool strings;
+    ProcessCache cache(strings);
+
+    cache.BeginRefresh();
+    EXPECT_EQ(cache.GetFileName(source, 4), "C:\\a.exe");
+    source.SetProcess(4, {200, "C:\\b.exe"});
+    cache.BeginRefresh();
+    EXPECT_EQ(cache.GetFileName(source, 4), "C:\\b.exe");
+}
+
+TEST(ProcessCacheTest, UnknownStartTimesNeverMatch) {
+    FakeWindowSource source;
+    source.SetProcess(4, {kUnknownStartTime, "C:\\a.exe"});
+    StringPool strings;
+    ProcessCache cache(strings);
+
+    cache.BeginRefresh();
+    EXPECT_EQ(cache.GetFileName(source, 4), "C:\\a.exe");
+    source.SetProcess(4, {kUnknownStartTime, "C:\\b.exe"});
+    cache.BeginRefresh();
+    EXPECT_EQ(cache.GetFileName(source, 4), "C:\\b.exe");
+    EXPECT_EQ(source.path_reads(), 2);
+
+    // A start time that could not be read the first time is not compared with a readable one.
+    source.SetProcess(4, {300, "C:\\c.exe"});
+    cache.BeginRefresh();
+    EXPECT_EQ(cache.GetFileName(source, 4), "C:\\c.exe");
+}
+} // namespace fsb
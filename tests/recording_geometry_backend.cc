@@ -0,0 +1,131 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "recording_geometry_backend.h"
+
+namespace fsb {
+void RecordingGeometryBackend::AddMonitor(SizeVec2 position, SizeVec2 size) {
+    monitors_.push_back({position, size});
+}
+
+void RecordingGeometryBackend::SetWindow(HWND window_handle, const WindowMetrics& metrics) {
+    windows_[window_handle] = metrics;
+}
+
+void RecordingGeometryBackend::SetMaximized(HWND window_handle) {
+    const auto kIt = windows_.find(window_handle);
+    if (kIt == windows_.end()) {
+        return;
+    }
+    static_cast<void>(FindMonitor(window_handle, 0, &kIt->second.position_,
+        &kIt->second.size_));
+    maximized_.insert(window_handle);
+}
+
+void RecordingGeometryBackend::RemoveWindow(HWND window_handle) {
+    windows_.erase(window_handle);
+    maximized_.erase(window_handle);
+}
+
+void RecordingGeometryBackend::RefuseStyles(HWND window_handle) {
+    refuse_styles_.insert(window_handle);
+}
+
+void RecordingGeometryBackend::RefuseMoves(HWND window_handle) {
+    refuse_moves_.insert(window_handle);
+}
+
+bool RecordingGeometryBackend::GetGeometry(HWND window_handle, WindowMetrics* metrics) {
+    calls_.push_back({GeometryCall::Type::GetGeometry, window_handle, 1});
+    const auto kIt = windows_.find(window_handle);
+    if (kIt == windows_.end()) {
+        return false;
+    }
+    *metrics = kIt->second;
+    return true;
+}
+
+bool RecordingGeometryBackend::GetMonitorBounds(HWND window_handle, int monitor,
+    SizeVec2* position, SizeVec2* size) {
+    calls_.push_back({GeometryCall::Type::GetMonitorBounds, window_handle, 1});
+    return FindMonitor(window_handle, monitor, position, size);
+}
+
+bool RecordingGeometryBackend::FindMonitor(HWND window_handle, int monitor, SizeVec2* position,
+    SizeVec2* size) const {
+    if (monitors_.empty() || monitor < 0 || static_cast<size_t>(monitor) > monitors_.size()) {
+        return false;
+    }
+
+    size_t index = static_cast<size_t>(monitor) - 1;
+    if (monitor == 0) {
+        // The monitor the window's center is on, or the first one if it is on none.
+        index = 0;
+        const auto kIt = windows_.find(window_handle);
+        if (kIt != windows_.end()) {
+            const int64_t kX = int64_t{kIt->second.position_.x} + kIt->second.size_.x / 2;
+            const int64_t kY = int64_t{kIt->second.position_.y} + kIt->second.size_.y / 2;
+            for (size_t i = 0; i < monitors_.size(); ++i) {
+                const Monitor& kMonitor = monitors_[i];
+                if (kX >= kMonitor.position_.x && kX < kMonitor.position_.x + kMonitor.size_.x
+                    && kY >= kMonitor.position_.y
+                    && kY < kMonitor.position_.y + kMonitor.size_.y) {
+                    index = i;
+                    break;
+                }
+            }
+        }
+    }
+    *position = monitors_[index].position_;
+    *size = monitors_[index].size_;
+    return true;
+}
+
+bool RecordingGeometryBackend::SetStyles(HWND window_handle, uint32_t style, uint32_t ex_style) {
+    calls_.push_back({GeometryCall::Type::SetStyles, window_handle, 1});
+    const auto kIt = windows_.find(window_handle);
+    if (kIt == windows_.end() || refuse_styles_.count(window_handle) != 0) {
+        return false;
+    }
+    kIt->second.style_ = style;
+    kIt->second.ex_style_ = ex_style;
+    return true;
+}
+
+bool RecordingGeometryBackend::MoveWindows(const std::vector<WindowMove>& moves) {
+    calls_.push_back({GeometryCall::Type::MoveWindows,
+        moves.empty() ? nullptr : moves.front().window_handle_, moves.size()});
+    // Like EndDeferWindowPos, a window that refuses fails the batch without holding back the
+    // others.
+    bool succeeded = true;
+    for (const WindowMove& move : moves) {
+        const auto kIt = windows_.find(move.window_handle_);
+        if (kIt == windows_.end() || refuse_moves_.count(move.window_handle_) != 0) {
+            succeeded = false;
+            continue;
+        }
+        // Like Win32GeometryBackend, a maximized window is restored before it moves.
+        maximized_.erase(move.window_handle_);
+        kIt->second.position_ = move.position_;
+        kIt->second.size_ = move.size_;
+    }
+    return succeeded;
+}
+
+bool RecordingGeometryBackend::IsMaximized(HWND window_handle) {
+    calls_.push_back({GeometryCall::Type::IsMaximized, window_handle, 1});
+    return maximized_.count(window_handle) != 0;
+}
+
+bool RecordingGeometryBackend::Maximize(HWND window_handle) {
+    calls_.push_back({GeometryCall::Type::Maximize, window_handle, 1});
+    const auto kIt = windows_.find(window_handle);
+    if (kIt == windows_.end() || refuse_moves_.count(window_handle) != 0
+        || !FindMonitor(window_handle, 0, &kIt->second.position_, &kIt->second.size_)) {
+        return false;
+    }
+    maximized_.insert(window_handle);
+    return true;
+}
+} // namespace fsb
@@ -0,0 +1,84 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_RECORDING_GEOMETRY_BACKEND_H_
+#define FSB_RECORDING_GEOMETRY_BACKEND_H_
+
+#include "base_types.h"
+#include "geometry_backend.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace fsb {
+//! @brief A call made into a RecordingGeometryBackend.
+struct GeometryCall {
+    enum class Type : uint8_t {
+        GetGeometry,
+        GetMonitorBounds,
+        SetStyles,
+        MoveWindows,
+        IsMaximized,
+        Maximize
+    };
+
+    Type type_;
+    //! The window of the call. For MoveWindows, the first window of the batch.
+    HWND window_handle_;
+    //! Number of windows in a MoveWindows batch, 1 otherwise.
+    size_t count_;
+};
+
+//! @brief In-memory GeometryBackend that records every call made into it.
+//!
+//! Windows and monitors are set up by the caller. Windows can be told to refuse style changes or
+//! moves, the way some applications do, to drive the failure and rollback paths of GeometryBatch.
+//!
+//! @note Not thread-safe.
+class RecordingGeometryBackend : public GeometryBackend {
+public:
+    //! @brief Adds a monitor. Monitors are numbered from 1 in the order they are added.
+    void AddMonitor(SizeVec2 position, SizeVec2 size);
+    void SetWindow(HWND window_handle, const WindowMetrics& metrics);
+    //! @brief Maximizes a window: it covers the monitor it is on until it is moved.
+    void SetMaximized(HWND window_handle);
+    void RemoveWindow(HWND window_handle);
+    //! @brief Makes every later SetStyles on the window fail.
+    void RefuseStyles(HWND window_handle);
+    //! @brief Makes the window stay put in every later move, failing the batch it is in.
+    void RefuseMoves(HWND window_handle);
+
+    bool GetGeometry(HWND window_handle, WindowMetrics* metrics) override;
+    bool GetMonitorBounds(HWND window_handle, int monitor, SizeVec2* position,
+        SizeVec2* size) override;
+    bool SetStyles(HWND window_handle, uint32_t style, uint32_t ex_style) override;
+    bool MoveWindows(const std::vector<WindowMove>& moves) override;
+    bool IsMaximized(HWND window_handle) override;
+    bool Maximize(HWND window_handle) override;
+
+    const std::vector<GeometryCall>& calls() const { return calls_; }
+    void ClearCalls() { calls_.clear(); }
+
+private:
+    struct Monitor {
+        SizeVec2 position_;
+        SizeVec2 size_;
+    };
+
+    //! Finds the bounds of a monitor like GetMonitorBounds, without recording a call.
+    bool FindMonitor(HWND window_handle, int monitor, SizeVec2* position, SizeVec2* size) const;
+
+    std::vector<Monitor> monitors_;
+    std::unordered_map<HWND, WindowMetrics> windows_;
+    std::unordered_set<HWND> refuse_styles_;
+    std::unordered_set<HWND> refuse_moves_;
+    std::unordered_set<HWND> maximized_;
+    std::vector<GeometryCall> calls_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_RECORDING_GEOMETRY_BACKEND_H_
@@ -0,0 +1,140 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "render_scheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+namespace fsb {
+namespace {
+using namespace std::chrono_literals;
+using Clock = RenderScheduler::Clock;
+
+//! Interval of a 60 fps cap, exactly as the scheduler computes it.
+constexpr Clock::duration kInterval = std::chrono::duration_cast<Clock::duration>(1s) / 60;
+
+//! Paints the first frame, which every scheduler starts out dirty for, from start to end.
+void PaintFirstFrame(RenderScheduler* scheduler, Clock::time_point start, Clock::time_point end) {
+    Clock::duration wait;
+    ASSERT_TRUE(scheduler->ShouldPaint(start, &wait));
+    scheduler->BeginFrame(start);
+    scheduler->EndFrame(end);
+}
+} // namespace
+
+TEST(RenderSchedulerTest, CapsTheFrameRate) {
+    RenderScheduler scheduler(60);
+    const Clock::time_point kStart = Clock::now();
+    PaintFirstFrame(&scheduler, kStart, kStart + 1ms);
+
+    Clock::duration wait;
+    EXPECT_FALSE(scheduler.ShouldPaint(kStart + 1ms, &wait));
+    EXPECT_EQ(wait, Clock::duration::zero());
+
+    // A change right after the frame waits out the rest of the interval.
+    scheduler.Invalidate(kStart + 2ms);
+    EXPECT_TRUE(scheduler.dirty());
+    EXPECT_FALSE(scheduler.ShouldPaint(kStart + 2ms, &wait));
+    EXPECT_EQ(wait, kInterval - 2ms);
+    EXPECT_FALSE(scheduler.ShouldPaint(kStart + kInterval - 1ns, &wait));
+    EXPECT_EQ(wait, 1ns);
+    EXPECT_TRUE(scheduler.ShouldPaint(kStart + kInterval, &wait));
+    EXPECT_EQ(wait, Clock::duration::zero());
+
+    // A change long after the last frame is painted at once.
+    scheduler.BeginFrame(kStart + kInterval);
+    scheduler.EndFrame(kStart + kInterval + 1ms);
+    scheduler.Invalidate(kStart + 1s);
+    EXPECT_TRUE(scheduler.ShouldPaint(kStart + 1s, &wait));
+}
+
+TEST(RenderSchedulerTest, ZeroFramesPerSecondPaintsWheneverIdle) {
+    RenderScheduler scheduler(0);
+    const Clock::time_point kStart = Clock::now();
+    // Even after a slow frame.
+    PaintFirstFrame(&scheduler, kStart, kStart + 25ms);
+
+    Clock::duration wait;
+    scheduler.Invalidate(kStart + 25ms);
+    EXPECT_TRUE(scheduler.ShouldPaint(kStart + 25ms, &wait));
+    EXPECT_EQ(wait, Clock::duration::zero());
+
+    // Changing the rate applies to the next frame.
+    scheduler.BeginFrame(kStart + 25ms);
+    scheduler.EndFrame(kStart + 26ms);
+    scheduler.SetFrameRate(60);
+    scheduler.Invalidate(kStart + 26ms);
+    EXPECT_FALSE(scheduler.ShouldPaint(kStart + 26ms, &wait));
+    EXPECT_EQ(wait, kInterval - 1ms);
+}
+
+TEST(RenderSchedulerTest, SlowFramesBackOffByTheirPaintTime) {
+    RenderScheduler scheduler(60);
+    const Clock::time_point kStart = Clock::now();
+    PaintFirstFrame(&scheduler, kStart, kStart + 25ms);
+
+    // The next frame waits as long after this one ended as it took, not just the interval.
+    Clock::duration wait;
+    scheduler.Invalidate(kStart + 25ms);
+    EXPECT_FALSE(scheduler.ShouldPaint(kStart + 25ms, &wait));
+    EXPECT_EQ(wait, 25ms);
+    EXPECT_FALSE(scheduler.ShouldPaint(kStart + 49ms, &wait));
+    EXPECT_TRUE(scheduler.ShouldPaint(kStart + 50ms, &wait));
+
+    scheduler.BeginFrame(kStart + 50ms);
+    scheduler.EndFrame(kStart + 52ms);
+    EXPECT_EQ(scheduler.stats().paint_time_, 27000000u);
+    EXPECT_EQ(scheduler.stats().max_paint_time_, 25000000u);
+}
+
+TEST(RenderSchedulerTest, CountsFramesCoalescedAndDropped) {
+    RenderScheduler scheduler(60);
+    const Clock::time_point kStart = Clock::now();
+    // The dirty mark the scheduler starts with is one change, painted in the first frame.
+    PaintFirstFrame(&scheduler, kStart, kStart + 1ms);
+    EXPECT_EQ(scheduler.stats().frames_, 1u);
+    EXPECT_EQ(scheduler.stats().coalesced_, 0u);
+
+    // Three changes, one frame, painted in the first slot it could go out in.
+    scheduler.Invalidate(kStart + 2ms);
+    scheduler.Invalidate(kStart + 3ms);
+    scheduler.Invalidate(kStart + 4ms);
+    scheduler.BeginFrame(kStart + kInterval);
+    scheduler.EndFrame(kStart + kInterval + 1ms);
+    EXPECT_EQ(scheduler.stats().frames_, 2u);
+    EXPECT_EQ(scheduler.stats().coalesced_, 2u);
+    EXPECT_EQ(scheduler.stats().dropped_, 0u);
+
+    // A change made while painting is the next frame's, not this one's.
+    scheduler.Invalidate(kStart + kInterval + 2ms);
+    EXPECT_TRUE(scheduler.dirty());
+
+    // The loop was busy for three more slots before it got around to the frame.
+    scheduler.BeginFrame(kStart + 5 * kInterval + 1ms);
+    scheduler.EndFrame(kStart + 5 * kInterval + 2ms);
+    EXPECT_EQ(scheduler.stats().frames_, 3u);
+    EXPECT_EQ(scheduler.stats().coalesced_, 2u);
+    EXPECT_EQ(scheduler.stats().dropped_, 3u);
+    EXPECT_FALSE(scheduler.dirty());
+
+    // Nothing is dropped without a cap, as there are no slots to miss.
+    scheduler.SetFrameRate(0);
+    scheduler.Invalidate(kStart + 6 * kInterval);
+    scheduler.BeginFrame(kStart + 100 * kInterval);
+    EXPECT_EQ(scheduler.stats().dropped_, 3u);
+}
+
+TEST(RenderSchedulerTest, FormatsTheStats) {
+    RenderStats stats = {};
+    stats.frames_ = 4;
+    stats.coalesced_ = 10;
+    stats.dropped_ = 1;
+    stats.paint_time_ = 8000000;
+    stats.max_paint_time_ = 5000000;
+    EXPECT_EQ(FormatRenderStats(stats), "4 frames painted, 10 changes coalesced, 1 frames dropped, "
+        "paint 2.000 ms on average, 5.000 ms at most\n");
+}
+} // namespace fsb
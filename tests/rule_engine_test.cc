@@ -0,0 +1,179 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "rule_engine.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fsb {
+namespace {
+//! Backtracking glob, straight from the definition.
+bool GlobMatches(std::string_view pattern, std::string_view text) {
+    if (pattern.empty()) {
+        return text.empty();
+    }
+    if (pattern.front() == '*') {
+        return GlobMatches(pattern.substr(1), text)
+            || (!text.empty() && GlobMatches(pattern, text.substr(1)));
+    }
+    return !text.empty() && (pattern.front() == '?' || pattern.front() == text.front())
+        && GlobMatches(pattern.substr(1), text.substr(1));
+}
+
+std::string Lower(std::string_view text) {
+    std::string lowercase(text);
+    for (char& character : lowercase) {
+        if (character >= 'A' && character <= 'Z') {
+            character = static_cast<char>(character - 'A' + 'a');
+        }
+    }
+    return lowercase;
+}
+
+std::string RandomText(std::mt19937& random, std::string_view alphabet, size_t max_length) {
+    std::string text;
+    for (size_t length = random() % (max_length + 1); length > 0; --length) {
+        text.push_back(alphabet[random() % alphabet.size()]);
+    }
+    return text;
+}
+
+struct Window {
+    std::string class_name_;
+    std::string title_;
+    std::string file_name_;
+};
+
+//! Index of the first rule whose conditions all match, one glob at a time.
+int ReferenceMatch(const std::vector<Rule>& rules, const Window& window) {
+    const size_t kSeparator = window.file_name_.find_last_of("\\/");
+    const std::string kExe = kSeparator == std::string::npos ? window.file_name_
+        : window.file_name_.substr(kSeparator + 1);
+    for (size_t i = 0; i < rules.size(); ++i) {
+        bool matches = true;
+        for (const RuleCondition& condition : rules[i].conditions_) {
+            const std::string* kText[] = {&window.class_name_, &window.title_, &kExe,
+                &window.file_name_};
+            matches = matches && GlobMatches(condition.pattern_,
+                Lower(*kText[static_cast<size_t>(condition.field_)]));
+        }
+        if (matches) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+} // namespace
+
+TEST(RuleEngineTest, ParsesRules) {
+    std::vector<Rule> rules;
+    EXPECT_EQ(ParseRules("# games\n"
+        "class=UnityWndClass exe=Game.exe -> borderless monitor=2\r\n"
+        "\n"
+        "title=\"Half-Life*\" -> borderless\n"
+        "title=\"unterminated -> borderless\n"
+        "class=a -> borderless monitor=65\n"
+        "colour=red -> borderless\n"
+        "class=a -> windowed\n"
+        "-> borderless\n", &rules), 5u);
+    ASSERT_EQ(rules.size(), 2u);
+    ASSERT_EQ(rules[0].conditions_.size(), 2u);
+    EXPECT_EQ(rules[0].conditions_[0].field_, RuleField::Class);
+    EXPECT_EQ(rules[0].conditions_[0].pattern_, "unitywndclass");
+    EXPECT_EQ(rules[0].conditions_[1].field_, RuleField::Exe);
+    EXPECT_EQ(rules[0].conditions_[1].pattern_, "game.exe");
+    EXPECT_EQ(rules[0].action_.monitor_, 2);
+    EXPECT_EQ(rules[0].line_, 2u);
+    EXPECT_EQ(rules[1].conditions_[0].pattern_, "half-life*");
+    EXPECT_EQ(rules[1].action_.monitor_, 0);
+}
+
+TEST(RuleEngineTest, GlobSetMatchesLikeBacktracking) {
+    std::mt19937 random(16);
+    for (int round = 0; round < 300; ++round) {
+        GlobSet globs;
+        std::vector<std::string> patterns;
+        for (size_t count = 1 + random() % 12; count > 0; --count) {
+            patterns.push_back(RandomText(random, "ab*?", 6));
+            ASSERT_EQ(globs.Add(patterns.back()), patterns.size() - 1);
+        }
+        // Texts over the alphabet of the patterns, plus a byte none of them names.
+        for (int i = 0; i < 200; ++i) {
+            const std::string kText = RandomText(random, "abc", 8);
+            std::vector<uint32_t> matches;
+            globs.Match(kText, &matches);
+            std::sort(matches.begin(), matches.end());
+            std::vector<uint32_t> expected;
+            for (uint32_t id = 0; id < patterns.size(); ++id) {
+                if (GlobMatches(patterns[id], kText)) {
+                    expected.push_back(id);
+                }
+            }
+            ASSERT_EQ(matches, expected) << "round " << round << " text " << kText;
+        }
+    }
+}
+
+TEST(RuleEngineTest, GlobSetStartsOverWhenTheCacheIsFull) {
+    // Hundreds of "*text*" patterns make more states than the cache holds.
+    GlobSet globs;
+    std::vector<std::string> patterns;
+    std::mt19937 random(17);
+    for (int i = 0; i < 500; ++i) {
+        patterns.push_back("*" + RandomText(random, "abcd", 3) + "?" + RandomText(random, "cd", 2)
+            + "*");
+        static_cast<void>(globs.Add(patterns.back()));
+    }
+    bool started_over = false;
+    for (int i = 0; i < 1000 && !started_over; ++i) {
+        const size_t kStates = globs.state_count();
+        const std::string kText = RandomText(random, "abcde", 40);
+        std::vector<uint32_t> matches;
+        globs.Match(kText, &matches);
+        std::sort(matches.begin(), matches.end());
+        std::vector<uint32_t> expected;
+        for (uint32_t id = 0; id < patterns.size(); ++id) {
+            if (GlobMatches(patterns[id], kText)) {
+                expected.push_back(id);
+            }
+        }
+        ASSERT_EQ(matches, expected) << "text " << kText;
+        ASSERT_LE(globs.state_count(), GlobSet::kMaxStates);
+        started_over |= globs.state_count() < kStates;
+    }
+    EXPECT_TRUE(started_over);
+}
+
+TEST(RuleEngineTest, RuleMatcherFindsTheFirstMatchingRule) {
+    std::mt19937 random(18);
+    for (int round = 0; round < 50; ++round) {
+        // Literals and globs on every field, one to three conditions a rule.
+        std::string text;
+        constexpr const char* kFields[] = {"class", "title", "exe", "path"};
+        for (size_t count = 1 + random() % 40; count > 0; --count) {
+            for (size_t conditions = 1 + random() % 3; conditions > 0; --conditions) {
+                text += std::string(kFields[random() % 4]) + "=\""
+                    + RandomText(random, random() % 2 == 0 ? "aB" : "aB*?\\", 5) + "\" ";
+            }
+            text += "-> borderless\n";
+        }
+        std::vector<Rule> rules;
+        ParseRules(text, &rules);
+        RuleMatcher matcher;
+        matcher.Compile(rules);
+
+        for (int i = 0; i < 200; ++i) {
+            const Window kWindow = {RandomText(random, "abAB", 4), RandomText(random, "ab", 5),
+                RandomText(random, "aB\\", 6)};
+            ASSERT_EQ(matcher.Match(kWindow.class_name_, kWindow.title_, kWindow.file_name_),
+                ReferenceMatch(rules, kWindow)) << "round " << round << "\n" << text;
+        }
+    }
+}
+} // namespace fsb
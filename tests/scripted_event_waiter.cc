@@ -0,0 +1,43 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "scripted_event_waiter.h"
+
+#include <chrono>
+
+namespace fsb {
+ScriptedEventWaiter::ScriptedEventWaiter() : signaled_(0), woken_(false) {}
+
+void ScriptedEventWaiter::Signal(EventSource source) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        signaled_ |= Bit(source);
+    }
+    ready_.notify_one();
+}
+
+void ScriptedEventWaiter::Wake() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        woken_ = true;
+    }
+    ready_.notify_one();
+}
+
+uint32_t ScriptedEventWaiter::Wait(uint32_t timeout_milliseconds) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const auto kReady = [this]() { return signaled_ != 0 || woken_; };
+    if (timeout_milliseconds == kInfinite) {
+        ready_.wait(lock, kReady);
+    } else {
+        static_cast<void>(ready_.wait_for(lock, std::chrono::milliseconds(timeout_milliseconds),
+            kReady));
+    }
+
+    const uint32_t kSignaled = signaled_;
+    signaled_ = 0;
+    woken_ = false;
+    return kSignaled;
+}
+} // namespace fsb
@@ -0,0 +1,38 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_SCRIPTED_EVENT_WAITER_H_
+#define FSB_SCRIPTED_EVENT_WAITER_H_
+
+#include "event_loop.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace fsb {
+//! @brief EventWaiter whose sources are signaled by code rather than by the system.
+//!
+//! Lets the event loop be driven off-desktop: a script (or another thread) signals sources the
+//! way console input or window events would, and the loop sleeps on a condition variable in
+//! between, so idle behavior can be checked the same way as on Windows.
+class ScriptedEventWaiter : public EventWaiter {
+public:
+    ScriptedEventWaiter();
+
+    //! @brief Marks source as ready until the next Wait reports it. Safe to call from any thread.
+    void Signal(EventSource source);
+
+    uint32_t Wait(uint32_t timeout_milliseconds) override;
+    void Wake() override;
+
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    uint32_t signaled_;
+    bool woken_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_SCRIPTED_EVENT_WAITER_H_
@@ -0,0 +1,105 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "startup_profiler.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fsb {
+namespace {
+struct ReportLine {
+    double since_origin_;
+    double since_previous_;
+    std::string name_;
+};
+
+//! Parses the milestones of a report, checking each line as it goes.
+std::vector<ReportLine> ParseReport(const std::string& report) {
+    std::vector<ReportLine> lines;
+    size_t position = report.find('\n');
+    EXPECT_EQ(report.substr(0, position), "Startup (ms since main, ms since previous):");
+    while (position != std::string::npos && position + 1 < report.size()) {
+        const size_t kStart = position + 1;
+        position = report.find('\n', kStart);
+        const std::string kLine = report.substr(kStart, position - kStart);
+        ReportLine line = {};
+        int name_start = 0;
+        if (std::sscanf(kLine.c_str(), " %lf %lf %n", &line.since_origin_, &line.since_previous_,
+            &name_start) != 2) {
+            ADD_FAILURE() << kLine;
+            return lines;
+        }
+        line.name_ = kLine.substr(static_cast<size_t>(name_start));
+        lines.push_back(std::move(line));
+    }
+    return lines;
+}
+
+//! Checks that every milestone comes after the previous one, by exactly its own delta.
+void ExpectInOrder(const std::vector<ReportLine>& lines) {
+    ASSERT_FALSE(lines.empty());
+    EXPECT_EQ(lines[0].since_origin_, 0.0);
+    EXPECT_EQ(lines[0].since_previous_, 0.0);
+    for (size_t i = 1; i < lines.size(); ++i) {
+        ASSERT_GE(lines[i].since_previous_, 0.0) << lines[i].name_;
+        ASSERT_GE(lines[i].since_origin_, lines[i - 1].since_origin_) << lines[i].name_;
+        // Both are rounded to the microsecond.
+        ASSERT_NEAR(lines[i].since_previous_,
+            lines[i].since_origin_ - lines[i - 1].since_origin_, 0.0011) << lines[i].name_;
+    }
+}
+} // namespace
+
+TEST(StartupProfilerTest, ReportsMilestonesInOrder) {
+    StartupProfiler& profiler = StartupProfiler::Get();
+    const char* const kNames[] = {"test started", "test slept", "test slept again"};
+    std::vector<uint64_t> elapsed;
+    for (const char* name : kNames) {
+        elapsed.push_back(profiler.Mark(name));
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_GE(elapsed[1], elapsed[0] + 2000000);
+    EXPECT_GE(elapsed[2], elapsed[1] + 2000000);
+    for (size_t i = 0; i < elapsed.size(); ++i) {
+        EXPECT_EQ(profiler.Elapsed(kNames[i]), elapsed[i]) << kNames[i];
+    }
+    EXPECT_EQ(profiler.Elapsed("never reached"), 0u);
+
+    const std::vector<ReportLine> kLines = ParseReport(profiler.FormatReport());
+    ExpectInOrder(kLines);
+    ASSERT_GE(kLines.size(), 3u);
+    for (size_t i = 0; i < 3; ++i) {
+        const ReportLine& line = kLines[kLines.size() - 3 + i];
+        EXPECT_EQ(line.name_, kNames[i]);
+        EXPECT_NEAR(line.since_origin_, static_cast<double>(elapsed[i]) / 1e6, 0.0006);
+    }
+    EXPECT_GE(kLines.back().since_previous_, 2.0);
+}
+
+TEST(StartupProfilerTest, MarksFromManyThreadsStayInOrder) {
+    constexpr size_t kThreads = 8;
+    constexpr size_t kMarksPerThread = 2000;
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < kThreads; ++thread) {
+        threads.emplace_back([]() {
+            for (size_t i = 0; i < kMarksPerThread; ++i) {
+                static_cast<void>(StartupProfiler::Get().Mark("concurrent mark"));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    const std::vector<ReportLine> kLines = ParseReport(StartupProfiler::Get().FormatReport());
+    ASSERT_GE(kLines.size(), kThreads * kMarksPerThread);
+    ExpectInOrder(kLines);
+}
+} // namespace fsb
@@ -0,0 +1,86 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "string_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fsb {
+TEST(StringPoolTest, StoresEachStringOnce) {
+    StringPool pool;
+    const StringId kChrome = pool.Intern("Chrome_WidgetWin_1");
+    EXPECT_EQ(pool.Intern(std::string("Chrome_WidgetWin_1")), kChrome);
+    EXPECT_NE(pool.Intern("CASCADIA_HOSTING_WINDOW_CLASS"), kChrome);
+    EXPECT_EQ(pool.InternView("Chrome_WidgetWin_1").data(), pool.View(kChrome).data());
+    EXPECT_EQ(pool.InternView(""), "");
+
+    EXPECT_EQ(pool.size(), 3u);
+    EXPECT_EQ(pool.stored_bytes(), 18u + 29u);
+    EXPECT_EQ(pool.intern_calls(), 5u);
+    EXPECT_EQ(pool.View(1000), "");
+}
+
+TEST(StringPoolTest, ViewsSurviveNewBlocks) {
+    StringPool pool;
+    std::vector<std::string_view> views;
+    const auto kPath = [](int i) {
+        return "C:\\Program Files\\App" + std::to_string(i) + "\\app.exe";
+    };
+    for (int i = 0; i < 5000; ++i) {
+        views.push_back(pool.InternView(kPath(i)));
+    }
+    // A full block is only left with room when the next path does not fit. The last one is
+    // still being filled.
+    const size_t kBlocks = pool.block_allocations();
+    const size_t kReserved = pool.reserved_bytes();
+    EXPECT_GT(kBlocks, 2u);
+    EXPECT_LT(kReserved - pool.stored_bytes(),
+        (kBlocks - 1) * kPath(5000).size() + kReserved / kBlocks);
+
+    // A string larger than a block gets a block of its own.
+    const std::string kLarge(100000, 'x');
+    views.push_back(pool.InternView(kLarge));
+    EXPECT_EQ(pool.block_allocations(), kBlocks + 1);
+    EXPECT_EQ(pool.reserved_bytes(), kReserved + kLarge.size());
+
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_EQ(views[static_cast<size_t>(i)], kPath(i));
+    }
+    EXPECT_EQ(views.back(), kLarge);
+}
+
+TEST(StringPoolTest, ConcurrentInternsAgree) {
+    StringPool pool;
+    constexpr int kThreads = 4;
+    constexpr int kStrings = 2000;
+    std::vector<std::vector<StringId>> ids(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&pool, &ids, t]() {
+            for (int i = 0; i < kStrings; ++i) {
+                // Every thread walks the same strings from a different starting point.
+                const int kString = (i + t * 500) % kStrings;
+                const StringId kId = pool.Intern("class" + std::to_string(kString));
+                ids[static_cast<size_t>(t)].push_back(kId);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(pool.size(), static_cast<size_t>(kStrings));
+    for (int t = 0; t < kThreads; ++t) {
+        for (int i = 0; i < kStrings; ++i) {
+            const int kString = (i + t * 500) % kStrings;
+            ASSERT_EQ(pool.View(ids[static_cast<size_t>(t)][static_cast<size_t>(i)]),
+                "class" + std::to_string(kString));
+        }
+    }
+}
+} // namespace fsb
@@ -0,0 +1,250 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "synthetic_window_source.h"
+
+#include <algorithm>
+#include <random>
+#include <string_view>
+#include <thread>
+
+namespace fsb {
+namespace {
+// Style bits mirrored from WinUser.h so the source does not depend on Windows.h.
+constexpr uint32_t kStyleOverlappedWindow = 0x00CF0000;
+constexpr uint32_t kStylePopup = 0x80000000;
+constexpr uint32_t kExStyleToolWindow = 0x00000080;
+constexpr uint32_t kExStyleAppWindow = 0x00040000;
+
+//! One kind of application, and how its windows look.
+struct AppProfile {
+    std::string_view file_name_;
+    std::string_view class_name_;
+    //! Appended to the generated title, e.g. " - Google Chrome".
+    std::string_view title_suffix_;
+    std::string_view font_name_;
+    //! Relative number of windows of this kind.
+    int weight_;
+    //! Invisible message and helper windows, which are usually untitled.
+    bool helper_;
+};
+
+constexpr AppProfile kAppProfiles[] = {
+    {"C:\\Program Files\\Google\\Chrome\\Application\\chrome.exe", "Chrome_WidgetWin_1",
+        " - Google Chrome", "Segoe UI", 18, false},
+    {"C:\\Program Files (x86)\\Microsoft\\Edge\\Application\\msedge.exe", "Chrome_WidgetWin_1",
+        " - Microsoft\xE2\x80\x8B Edge", "Segoe UI", 8, false},
+    {"C:\\Users\\user\\AppData\\Local\\Programs\\Microsoft VS Code\\Code.exe",
+        "Chrome_WidgetWin_1", " - Visual Studio Code", "Segoe UI", 6, false},
+    {"C:\\Windows\\explorer.exe", "CabinetWClass", "", "Segoe UI", 6, false},
+    {"C:\\Windows\\System32\\notepad.exe", "Notepad", " - Notepad", "Consolas", 4, false},
+    {"C:\\Program Files\\WindowsApps\\Microsoft.WindowsTerminal\\WindowsTerminal.exe",
+        "CASCADIA_HOSTING_WINDOW_CLASS", " - Terminal", "Cascadia Mono", 4, false},
+    {"C:\\Program Files (x86)\\Steam\\steamapps\\common\\Game\\Game-Win64-Shipping.exe",
+        "UnrealWindow", "", "Tahoma", 2, false},
+    {"D:\\Games\\Indie\\indie.exe", "UnityWndClass", "", "Arial", 2, false},
+    {"C:\\Windows\\System32\\svchost.exe", "WorkerW", "", "Segoe UI", 20, true},
+    {"C:\\Windows\\System32\\ApplicationFrameHost.exe", "ApplicationFrameWindow", "",
+        "Segoe UI", 10, true},
+    {"C:\\Program Files\\Common Files\\Helper\\helper.exe", "MSCTFIME UI", "", "MS Shell Dlg",
+        20, true},
+};
+
+constexpr std::string_view kTitleWords[] = {
+    "Untitled", "Document", "Project", "report", "Inbox", "Settings", "main.cc", "README.md",
+    "Dashboard", "Pull request", "Issue", "Meeting notes", "Budget 2025", "Downloads",
+    "R\xC3\xA9sum\xC3\xA9", "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E",
+    "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82", "\xF0\x9F\x8E\xAE Stream",
+    "build log", "localhost:8080", "YouTube", "Wiki", "Spreadsheet", "Music",
+};
+
+std::string MakeTitle(std::mt19937& random, const AppProfile& profile) {
+    std::uniform_int_distribution<size_t> word_count(1, 6);
+    std::uniform_int_distribution<size_t> word(0, std::size(kTitleWords) - 1);
+
+    std::string title;
+    for (size_t i = word_count(random); i > 0; --i) {
+        if (!title.empty()) {
+            title += ' ';
+        }
+        title += kTitleWords[word(random)];
+    }
+    title += profile.title_suffix_;
+    return title;
+}
+} // namespace
+
+SyntheticWindowSource::SyntheticWindowSource(const SyntheticOptions& options)
+    : options_(options), call_count_(0) {
+    std::mt19937 random(options.seed_);
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+    std::vector<int> weights;
+    for (const auto& profile : kAppProfiles) {
+        weights.push_back(profile.weight_);
+    }
+    std::discrete_distribution<size_t> pick_profile(weights.begin(), weights.end());
+    std::uniform_int_distribution<int32_t> coordinate(-32, 2560);
+    std::uniform_int_distribution<int32_t> extent(200, 1920);
+    std::uniform_int_distribution<uint32_t> font_size(9, 16);
+
+    // Processes that already own a window, per profile, so most windows share a process.
+    std::vector<std::vector<uint32_t>> profile_processes(std::size(kAppProfiles));
+    uint32_t next_process_id = 1000;
+    uint64_t next_start_time = 133'000'000'000'000'000;
+
+    windows_.reserve(options.window_count_);
+    index_.reserve(options.window_count_);
+    for (size_t i = 0; i < options.window_count_; ++i) {
+        const size_t kProfile = pick_profile(random);
+        const AppProfile& profile = kAppProfiles[kProfile];
+
+        auto& processes = profile_processes[kProfile];
+        uint32_t process_id = 0;
+        if (!processes.empty() && chance(random) < 0.85) {
+            process_id = processes[random() % processes.size()];
+        } else {
+            process_id = next_process_id;
+            next_process_id += 4 * (1 + random() % 16);
+            next_start_time += 10'000'000 * (1 + random() % 600);
+            processes.push_back(process_id);
+            processes_[process_id] = {std::string(profile.file_name_), next_start_time,
+                chance(random) < options.hung_fraction_};
+        }
+
+        Window window = {};
+        // Handles only need to be unique and non-null; real ones are small even numbers too.
+        window.window_handle_ = reinterpret_cast<HWND>(static_cast<uintptr_t>(0x10000 + i * 4));
+        window.process_id_ = process_id;
+        window.class_name_ = std::string(profile.class_name_);
+
+        const double kHiddenChance = profile.helper_ ? 0.95 : options.hidden_fraction_;
+        window.attributes_.is_visible_ = chance(random) >= kHiddenChance;
+        window.attributes_.is_enabled_ = chance(random) >= 0.02;
+        const double kState = chance(random);
+        window.attributes_.state_ = kState < 0.1 ? WindowState::Minimized
+            : kState < 0.25 ? WindowState::Maximized : WindowState::Normal;
+
+        const bool kBlank = profile.helper_ ? chance(random) < 0.8
+            : chance(random) < options.blank_title_fraction_;
+        if (!kBlank) {
+            window.title_ = MakeTitle(random, profile);
+        }
+
+        window.metrics_.position_ = {coordinate(random), coordinate(random)};
+        window.metrics_.size_ = {extent(random), extent(random)};
+        window.metrics_.style_ = profile.helper_ ? kStylePopup : kStyleOverlappedWindow;
+        window.metrics_.ex_style_ = chance(random) < options.tool_window_fraction_
+            ? kExStyleToolWindow : kExStyleAppWindow;
+
+        window.font_name_ = std::string(profile.font_name_);
+        window.font_size_ = font_size(random);
+        window.hung_ = processes_[process_id].hung_;
+
+        index_[window.window_handle_] = windows_.size();
+        windows_.push_back(std::move(window));
+    }
+}
+
+const SyntheticWindowSource::Window* SyntheticWindowSource::Lookup(HWND window_handle) {
+    call_count_.fetch_add(1, std::memory_order_relaxed);
+    if (options_.call_latency_.count() > 0) {
+        std::this_thread::sleep_for(options_.call_latency_);
+    }
+
+    auto it = index_.find(window_handle);
+    return it == index_.end() ? nullptr : &windows_[it->second];
+}
+
+const SyntheticWindowSource::Process* SyntheticWindowSource::LookupProcess(uint32_t process_id) {
+    call_count_.fetch_add(1, std::memory_order_relaxed);
+    if (options_.process_latency_.count() > 0) {
+        std::this_thread::sleep_for(options_.process_latency_);
+    }
+
+    auto it = processes_.find(process_id);
+    return it == processes_.end() ? nullptr : &it->second;
+}
+
+void SyntheticWindowSource::EnumerateWindowHandles(std::vector<HWND>* window_handles) {
+    call_count_.fetch_add(1, std::memory_order_relaxed);
+    window_handles->clear();
+    window_handles->reserve(windows_.size());
+    for (const auto& window : windows_) {
+        window_handles->push_back(window.window_handle_);
+    }
+}
+
+bool SyntheticWindowSource::GetWindowAttributes(HWND window_handle,
+    WindowAttributes* window_attributes) {
+    const Window* window = Lookup(window_handle);
+    if (window == nullptr) {
+        return false;
+    }
+    *window_attributes = window->attributes_;
+    return true;
+}
+
+bool SyntheticWindowSource::GetWindowMetrics(HWND window_handle, WindowMetrics* window_metrics) {
+    const Window* window = Lookup(window_handle);
+    if (window == nullptr) {
+        return false;
+    }
+    *window_metrics = window->metrics_;
+    return true;
+}
+
+ProbeStatus SyntheticWindowSource::GetWindowFont(HWND window_handle,
+    uint32_t timeout_milliseconds, std::string* font_name, uint32_t* font_size) {
+    const Window* window = Lookup(window_handle);
+    if (window == nullptr) {
+        return ProbeStatus::Failed;
+    }
+    if (window->hung_) {
+        std::this_thread::sleep_for(std::min<std::chrono::microseconds>(options_.hung_latency_,
+            std::chrono::milliseconds(timeout_milliseconds)));
+        return ProbeStatus::TimedOut;
+    }
+    *font_name = window->font_name_;
+    *font_size = window->font_size_;
+    return ProbeStatus::Ok;
+}
+
+bool SyntheticWindowSource::GetWindowProcessId(HWND window_handle, uint32_t* process_id) {
+    const Window* window = Lookup(window_handle);
+    if (window == nullptr) {
+        return false;
+    }
+    *process_id = window->process_id_;
+    return true;
+}
+
+bool SyntheticWindowSource::GetWindowTitle(HWND window_handle, std::string* title) {
+    const Window* window = Lookup(window_handle);
+    if (window == nullptr) {
+        return false;
+    }
+    *title = window->title_;
+    return true;
+}
+
+bool SyntheticWindowSource::GetWindowClassName(HWND window_handle, std::string* class_name) {
+    const Window* window = Lookup(window_handle);
+    if (window == nullptr) {
+        return false;
+    }
+    *class_name = window->class_name_;
+    return true;
+}
+
+bool SyntheticWindowSource::GetProcessInfo(uint32_t process_id, uint64_t* start_time,
+    std::string* file_name) {
+    const Process* process = LookupProcess(process_id);
+    *start_time = process == nullptr ? kUnknownStartTime : process->start_time_;
+    if (file_name != nullptr) {
+        *file_name = process == nullptr ? "???" : process->file_name_;
+    }
+    return process != nullptr;
+}
+} // namespace fsb
@@ -0,0 +1,101 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#ifndef FSB_SYNTHETIC_WINDOW_SOURCE_H_
+#define FSB_SYNTHETIC_WINDOW_SOURCE_H_
+
+#include "base_types.h"
+#include "window_source.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fsb {
+//! @brief Shape of the desktop generated by SyntheticWindowSource.
+struct SyntheticOptions {
+    size_t window_count_ = 500;
+    uint32_t seed_ = 1;
+    //! Fraction of application windows that are hidden. Helper windows, which make up most of the
+    //! top-level windows on a real desktop, are almost always hidden regardless.
+    double hidden_fraction_ = 0.2;
+    double blank_title_fraction_ = 0.25;
+    double tool_window_fraction_ = 0.05;
+    //! Processes whose UI thread does not pump messages, so WM_GETFONT times out on every window
+    //! they own.
+    double hung_fraction_ = 0.01;
+    //! Added to every per-window call, standing in for the cross-process round trip.
+    std::chrono::microseconds call_latency_{0};
+    //! Added to every process query (OpenProcess and friends).
+    std::chrono::microseconds process_latency_{0};
+    //! How long a hung window takes to fail a font query, capped by the timeout of the call.
+    std::chrono::microseconds hung_latency_{100000};
+};
+
+//! @brief In-memory window system with a generated desktop.
+//!
+//! Windows are drawn from a weighted set of application profiles (browsers, editors, shells,
+//! games, helper windows), so titles, class names and executable paths repeat roughly the way they
+//! do on a real desktop, including non-ASCII titles. Latency can be injected per call and a
+//! fraction of windows can be marked as hung, which lets the enumeration, probing, rendering and
+//! transcoding paths be measured and exercised on any platform.
+//!
+//! @note The desktop is immutable once generated, so the source is safe to use from any number of
+//! threads.
+class SyntheticWindowSource : public WindowSource {
+public:
+    explicit SyntheticWindowSource(const SyntheticOptions& options = {});
+
+    void EnumerateWindowHandles(std::vector<HWND>* window_handles) override;
+    bool GetWindowAttributes(HWND window_handle, WindowAttributes* window_attributes) override;
+    bool GetWindowMetrics(HWND window_handle, WindowMetrics* window_metrics) override;
+    ProbeStatus GetWindowFont(HWND window_handle, uint32_t timeout_milliseconds,
+        std::string* font_name, uint32_t* font_size) override;
+    bool GetWindowProcessId(HWND window_handle, uint32_t* process_id) override;
+    bool GetWindowTitle(HWND window_handle, std::string* title) override;
+    bool GetWindowClassName(HWND window_handle, std::string* class_name) override;
+    bool GetProcessInfo(uint32_t process_id, uint64_t* start_time,
+        std::string* file_name) override;
+
+    size_t window_count() const { return windows_.size(); }
+    size_t process_count() const { return processes_.size(); }
+    //! Number of calls made into the source so far, across all threads.
+    uint64_t call_count() const { return call_count_.load(std::memory_order_relaxed); }
+
+private:
+    struct Window {
+        HWND window_handle_;
+        uint32_t process_id_;
+        std::string title_;
+        std::string class_name_;
+        WindowAttributes attributes_;
+        WindowMetrics metrics_;
+        std::string font_name_;
+        uint32_t font_size_;
+        bool hung_;
+    };
+
+    struct Process {
+        std::string file_name_;
+        uint64_t start_time_;
+        bool hung_;
+    };
+
+    //! Returns the window behind a handle after paying the per-call latency, or nullptr.
+    const Window* Lookup(HWND window_handle);
+    const Process* LookupProcess(uint32_t process_id);
+
+    SyntheticOptions options_;
+    std::vector<Window> windows_;
+    std::unordered_map<HWND, size_t> index_;
+    std::unordered_map<uint32_t, Process> processes_;
+    std::atomic<uint64_t> call_count_;
+};
+} // namespace fsb
+
+#endif // #ifndef FSB_SYNTHETIC_WINDOW_SOURCE_H_
@@ -0,0 +1,254 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "trace.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace fsb {
+namespace {
+HWND Handle(uintptr_t value) {
+    return reinterpret_cast<HWND>(value * 4);
+}
+
+//! Lines of the report that follow a heading, up to the next line that is not indented.
+std::vector<std::string> Section(const std::string& report, std::string_view heading) {
+    std::vector<std::string> lines;
+    size_t position = report.find(std::string(heading) + ":\n");
+    if (position == std::string::npos) {
+        return lines;
+    }
+    position += heading.size() + 2;
+    while (position < report.size() && report[position] == ' ') {
+        const size_t kEnd = report.find('\n', position);
+        lines.push_back(report.substr(position, kEnd - position));
+        position = kEnd + 1;
+    }
+    return lines;
+}
+
+//! Histogram of a report section, by the lower bound of each bucket in microseconds.
+std::map<uint64_t, uint64_t> Histogram(const std::string& report, std::string_view heading) {
+    std::map<uint64_t, uint64_t> buckets;
+    for (const std::string& line : Section(report, heading)) {
+        unsigned long long low = 0;
+        unsigned long long high = 0;
+        unsigned long long count = 0;
+        EXPECT_EQ(std::sscanf(line.c_str(), " %llu - %llu us %llu", &low, &high, &count), 3)
+            << line;
+        buckets[low] = count;
+    }
+    return buckets;
+}
+
+//! Checks that text is one JSON value, just enough to tell that a trace viewer can load it.
+class JsonChecker {
+public:
+    explicit JsonChecker(std::string_view text) : text_(text), position_(0) {}
+
+    bool Check() {
+        return Value() && (Skip(), position_ == text_.size());
+    }
+
+private:
+    void Skip() {
+        while (position_ < text_.size() && (text_[position_] == ' ' || text_[position_] == '\n'
+            || text_[position_] == '\t' || text_[position_] == '\r')) {
+            ++position_;
+        }
+    }
+
+    bool Take(char character) {
+        Skip();
+        if (position_ < text_.size() && text_[position_] == character) {
+            ++position_;
+            return true;
+        }
+        return false;
+    }
+
+    bool String() {
+        if (!Take('"')) {
+            return false;
+        }
+        while (position_ < text_.size()) {
+            const auto kCharacter = static_cast<unsigned char>(text_[position_++]);
+            if (kCharacter == '"') {
+                return true;
+            }
+            if (kCharacter < 0x20) {
+                return false;
+            }
+            if (kCharacter == '\\') {
+                if (position_ >= text_.size()) {
+                    return false;
+                }
+                const char kEscape = text_[position_++];
+                if (kEscape == 'u') {
+                    position_ += 4;
+                } else if (std::string_view("\"\\/bfnrt").find(kEscape) == std::string::npos) {
+                    return false;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool Value() {
+        Skip();
+        if (position_ >= text_.size()) {
+            return false;
+        }
+        const char kFirst = text_[position_];
+        if (kFirst == '"') {
+            return String();
+        }
+        if (kFirst == '{' || kFirst == '[') {
+            const char kClose = kFirst == '{' ? '}' : ']';
+            ++position_;
+            if (Take(kClose)) {
+                return true;
+            }
+            do {
+                if (kFirst == '{' && (!String() || !Take(':'))) {
+                    return false;
+                }
+                if (!Value()) {
+                    return false;
+                }
+            } while (Take(','));
+            return Take(kClose);
+        }
+        const size_t kStart = position_;
+        while (position_ < text_.size()
+            && std::string_view("-+.eE0123456789truefalsn").find(text_[position_])
+                != std::string::npos) {
+            ++position_;
+        }
+        return position_ > kStart;
+    }
+
+    std::string_view text_;
+    size_t position_;
+};
+
+class TracerTest : public testing::Test {
+protected:
+    void SetUp() override {
+        Tracer::Get().Reset();
+        Tracer::Get().SetEnabled(true);
+    }
+
+    void TearDown() override {
+        Tracer::Get().SetEnabled(false);
+        Tracer::Get().Reset();
+    }
+};
+} // namespace
+
+TEST_F(TracerTest, HistogramBucketsArePowersOfTwo) {
+    Tracer& tracer = Tracer::Get();
+    // Nanoseconds, bucketed by whole microseconds.
+    for (uint64_t duration : {0ull, 999ull, 1999ull, 2000ull, 3999ull, 4000ull, 1023999ull,
+        1024000ull}) {
+        tracer.RecordWindow(TracePhase::ProbeWindow, Handle(1), 1, "Class", duration);
+    }
+    tracer.RecordWindow(TracePhase::LoadDetails, Handle(1), 1, "Class", 5000);
+    // Anything slower than the last bucket lands in it.
+    tracer.RecordWindow(TracePhase::LoadDetails, Handle(1), 1, "Class", uint64_t{1} << 60);
+
+    const std::string kReport = tracer.FormatReport();
+    const std::map<uint64_t, uint64_t> kProbe = {{0, 3}, {2, 2}, {4, 1}, {512, 1}, {1024, 1}};
+    EXPECT_EQ(Histogram(kReport, "window probe latency"), kProbe) << kReport;
+    const std::map<uint64_t, uint64_t> kDetails = {{4, 1},
+        {uint64_t{1} << (Tracer::kHistogramBuckets - 1), 1}};
+    EXPECT_EQ(Histogram(kReport, "detail load latency"), kDetails) << kReport;
+}
+
+TEST_F(TracerTest, KeepsTheSlowestWindows) {
+    Tracer& tracer = Tracer::Get();
+    // Milliseconds 1 to 40, in an order that evicts from the middle of the heap.
+    constexpr size_t kWindows = Tracer::kTopWindows + 24;
+    for (size_t i = 0; i < kWindows; ++i) {
+        const size_t kMilliseconds = 1 + (i * 17) % kWindows;
+        tracer.RecordWindow(TracePhase::ProbeWindow, Handle(kMilliseconds), 7, "Slow",
+            kMilliseconds * 1000000);
+    }
+    tracer.NoteProcess(7, "slow.exe");
+
+    const std::vector<std::string> kSlowest = Section(tracer.FormatReport(), "slowest windows");
+    ASSERT_EQ(kSlowest.size(), Tracer::kTopWindows);
+    for (size_t i = 0; i < kSlowest.size(); ++i) {
+        double milliseconds = 0.0;
+        ASSERT_EQ(std::sscanf(kSlowest[i].c_str(), " %lf ms", &milliseconds), 1) << kSlowest[i];
+        EXPECT_EQ(milliseconds, static_cast<double>(kWindows - i)) << kSlowest[i];
+        EXPECT_NE(kSlowest[i].find("ProbeWindow"), std::string::npos) << kSlowest[i];
+        EXPECT_NE(kSlowest[i].find("Slow slow.exe"), std::string::npos) << kSlowest[i];
+    }
+    EXPECT_TRUE(tracer.UnattributedProcesses().empty());
+
+    // Every window still counts towards its class.
+    const std::vector<std::string> kByClass = Section(tracer.FormatReport(), "by class");
+    ASSERT_EQ(kByClass.size(), 1u);
+    EXPECT_NE(kByClass[0].find("820.000 ms       40 windows  Slow"), std::string::npos)
+        << kByClass[0];
+}
+
+TEST_F(TracerTest, WritesAChromeTrace) {
+    Tracer& tracer = Tracer::Get();
+    std::thread worker([]() {
+        ScopedTrace trace(TracePhase::Font, Handle(2));
+    });
+    worker.join();
+    {
+        ScopedTrace enumerate(TracePhase::Enumerate);
+        ScopedTrace title(TracePhase::Title, Handle(1));
+    }
+    tracer.RecordWindow(TracePhase::ProbeWindow, Handle(1), 3, "Class \"quoted\"\t", 1000);
+
+    // Non-ASCII, so the path has to be taken as UTF-8.
+    const std::string kPath = testing::TempDir() + "fsb_trace_\xc3\xa9t\xc3\xa9.json";
+    ASSERT_TRUE(tracer.WriteChromeTrace(kPath));
+    std::ifstream file(kPath, std::ios::binary);
+    ASSERT_TRUE(file.is_open());
+    const std::string kJson((std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
+    static_cast<void>(std::remove(kPath.c_str()));
+
+    EXPECT_TRUE(JsonChecker(kJson).Check()) << kJson;
+    EXPECT_EQ(kJson.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u) << kJson;
+    size_t events = 0;
+    for (size_t position = kJson.find("\"ph\":\"X\""); position != std::string::npos;
+        position = kJson.find("\"ph\":\"X\"", position + 1)) {
+        ++events;
+    }
+    EXPECT_EQ(events, 3u);
+    for (std::string_view phase : {"Font", "Enumerate", "Title"}) {
+        EXPECT_NE(kJson.find("{\"name\":\"" + std::string(phase) + "\",\"ph\":\"X\",\"pid\":1,"),
+            std::string::npos) << phase;
+    }
+    EXPECT_NE(kJson.find("\"otherData\":{\"report\":\"phase "), std::string::npos);
+    EXPECT_NE(kJson.find("Class \\\"quoted\\\"\\u0009"), std::string::npos);
+}
+
+TEST_F(TracerTest, DisabledScopesRecordNothing) {
+    Tracer::Get().SetEnabled(false);
+    {
+        ScopedTrace trace(TracePhase::Title, Handle(1));
+    }
+    Tracer::Get().SetEnabled(true);
+    const std::string kReport = Tracer::Get().FormatReport();
+    EXPECT_EQ(kReport.find("Title"), std::string::npos) << kReport;
+}
+} // namespace fsb
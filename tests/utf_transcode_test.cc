@@ -0,0 +1,207 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "utf_transcode.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace fsb {
+namespace {
+constexpr char32_t kReplacement = 0xFFFD;
+
+void AppendUtf8(char32_t code_point, std::string* out) {
+    if (code_point < 0x80) {
+        out->push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        out->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        out->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        out->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+void AppendUtf16(char32_t code_point, std::u16string* out) {
+    if (code_point < 0x10000) {
+        out->push_back(static_cast<char16_t>(code_point));
+    } else {
+        out->push_back(static_cast<char16_t>(0xD800 + ((code_point - 0x10000) >> 10)));
+        out->push_back(static_cast<char16_t>(0xDC00 + ((code_point - 0x10000) & 0x3FF)));
+    }
+}
+
+//! One code point at a time, straight from the definition of UTF-16.
+std::string ReferenceUtf8(const std::u16string& input) {
+    std::string out;
+    for (size_t i = 0; i < input.size(); ++i) {
+        char32_t code_point = input[i];
+        if (code_point >= 0xD800 && code_point <= 0xDBFF && i + 1 < input.size()
+            && input[i + 1] >= 0xDC00 && input[i + 1] <= 0xDFFF) {
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (input[++i] - 0xDC00);
+        } else if (code_point >= 0xD800 && code_point <= 0xDFFF) {
+            code_point = kReplacement;
+        }
+        AppendUtf8(code_point, &out);
+    }
+    return out;
+}
+
+//! One code point at a time, straight from the definition of UTF-8: a byte that does not start
+//! a complete, shortest-form sequence of a scalar value becomes one U+FFFD.
+std::u16string ReferenceUtf16(const std::string& input) {
+    std::u16string out;
+    size_t i = 0;
+    while (i < input.size()) {
+        const auto kLead = static_cast<uint8_t>(input[i]);
+        size_t length = 0;
+        char32_t code_point = 0;
+        char32_t minimum = 0;
+        if (kLead < 0x80) {
+            length = 1;
+            code_point = kLead;
+        } else if ((kLead & 0xE0) == 0xC0) {
+            length = 2;
+            code_point = kLead & 0x1F;
+            minimum = 0x80;
+        } else if ((kLead & 0xF0) == 0xE0) {
+            length = 3;
+            code_point = kLead & 0x0F;
+            minimum = 0x800;
+        } else if ((kLead & 0xF8) == 0xF0) {
+            length = 4;
+            code_point = kLead & 0x07;
+            minimum = 0x10000;
+        }
+
+        bool valid = length != 0 && i + length <= input.size();
+        for (size_t j = 1; valid && j < length; ++j) {
+            const auto kByte = static_cast<uint8_t>(input[i + j]);
+            valid = (kByte & 0xC0) == 0x80;
+            code_point = (code_point << 6) | (kByte & 0x3F);
+        }
+        valid = valid && code_point >= minimum && code_point <= 0x10FFFF
+            && (code_point < 0xD800 || code_point > 0xDFFF);
+        if (!valid) {
+            AppendUtf16(kReplacement, &out);
+            ++i;
+            continue;
+        }
+        AppendUtf16(code_point, &out);
+        i += length;
+    }
+    return out;
+}
+
+std::string ToUtf8(const std::u16string& input) {
+    std::string out(Utf8UpperBound(input.size()), '\0');
+    out.resize(TranscodeUtf16ToUtf8(input.data(), input.size(), out.data()));
+    return out;
+}
+
+std::u16string ToUtf16(const std::string& input) {
+    std::u16string out(Utf16UpperBound(input.size()), u'\0');
+    out.resize(TranscodeUtf8ToUtf16(input.data(), input.size(), out.data()));
+    return out;
+}
+
+//! Mostly ASCII with every other class of code unit mixed in, including unpaired surrogates,
+//! so runs of every length meet the vector paths at every alignment.
+std::u16string RandomUtf16(std::mt19937& random, size_t length) {
+    std::u16string text;
+    while (text.size() < length) {
+        switch (random() % 10) {
+            case 0:
+                text.push_back(static_cast<char16_t>(0x80 + random() % 0x780));
+                break;
+            case 1:
+                text.push_back(static_cast<char16_t>(0x800 + random() % 0xD000));
+                break;
+            case 2:
+                text.push_back(static_cast<char16_t>(0xD800 + random() % 0x400));
+                text.push_back(static_cast<char16_t>(0xDC00 + random() % 0x400));
+                break;
+            case 3:
+                text.push_back(static_cast<char16_t>(0xD800 + random() % 0x800));
+                break;
+            default:
+                text.push_back(static_cast<char16_t>(random() % 0x80));
+                break;
+        }
+    }
+    return text;
+}
+} // namespace
+
+TEST(UtfTranscodeTest, KnownStrings) {
+    EXPECT_EQ(ToUtf8(u""), "");
+    EXPECT_EQ(ToUtf8(u"Explorer"), "Explorer");
+    EXPECT_EQ(ToUtf8(u"ünïcødé €"), "ünïcødé €");
+    EXPECT_EQ(ToUtf8(u"😀"), "\xF0\x9F\x98\x80");
+    EXPECT_EQ(ToUtf8(std::u16string(1, char16_t{0xD800}) + u"a"), "\xEF\xBF\xBD" "a");
+    EXPECT_EQ(ToUtf8(u"a" + std::u16string(1, char16_t{0xDC00})), "a\xEF\xBF\xBD");
+
+    EXPECT_EQ(ToUtf16("日本語"), u"日本語");
+    EXPECT_EQ(ToUtf16("\xF0\x9F\x98\x80"), u"😀");
+    // Overlong, a UTF-8 encoded surrogate, beyond U+10FFFF and a cut-off sequence.
+    EXPECT_EQ(ToUtf16("\xC0\xAF"), u"\xFFFD\xFFFD");
+    EXPECT_EQ(ToUtf16("\xED\xA0\x80"), u"\xFFFD\xFFFD\xFFFD");
+    EXPECT_EQ(ToUtf16("\xF4\x90\x80\x80"), u"\xFFFD\xFFFD\xFFFD\xFFFD");
+    EXPECT_EQ(ToUtf16("a\xE2\x82"), u"a\xFFFD\xFFFD");
+}
+
+TEST(UtfTranscodeTest, Utf16MatchesTheReference) {
+    std::mt19937 random(1);
+    for (size_t i = 0; i < 20000; ++i) {
+        const std::u16string kInput = RandomUtf16(random, random() % 200);
+        const std::string kExpected = ReferenceUtf8(kInput);
+        ASSERT_EQ(ToUtf8(kInput), kExpected) << "case " << i;
+        ASSERT_EQ(Utf8Length(kInput.data(), kInput.size()), kExpected.size()) << "case " << i;
+        // Valid UTF-8 goes back to what it came from, minus the unpaired surrogates.
+        ASSERT_EQ(ToUtf16(kExpected), ReferenceUtf16(kExpected)) << "case " << i;
+    }
+}
+
+TEST(UtfTranscodeTest, Utf8MatchesTheReference) {
+    std::mt19937 random(2);
+    for (size_t i = 0; i < 20000; ++i) {
+        // Valid text with random bytes flipped, cut or spliced in.
+        std::string input = ToUtf8(RandomUtf16(random, random() % 120));
+        const size_t kDamage = random() % 4;
+        for (size_t j = 0; j < kDamage && !input.empty(); ++j) {
+            input[random() % input.size()] = static_cast<char>(random());
+        }
+        if (random() % 4 == 0 && !input.empty()) {
+            input.resize(random() % input.size());
+        }
+        ASSERT_EQ(ToUtf16(input), ReferenceUtf16(input)) << "case " << i;
+    }
+}
+
+TEST(UtfTranscodeTest, RandomBytesStayInBounds) {
+    std::mt19937 random(3);
+    for (size_t i = 0; i < 20000; ++i) {
+        std::string input(random() % 100, '\0');
+        for (char& byte : input) {
+            byte = static_cast<char>(random());
+        }
+        // The bound is exact, so a guard past it catches any write beyond.
+        std::u16string out(Utf16UpperBound(input.size()) + 1, u'\x1234');
+        const size_t kWritten = TranscodeUtf8ToUtf16(input.data(), input.size(), out.data());
+        ASSERT_LE(kWritten, input.size());
+        ASSERT_EQ(out.back(), u'\x1234');
+        out.resize(kWritten);
+        ASSERT_EQ(out, ReferenceUtf16(input)) << "case " << i;
+    }
+}
+} // namespace fsb
@@ -0,0 +1,232 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_columns.h"
+
+#include "fake_window_source.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fsb {
+namespace {
+constexpr std::string_view kClassNames[] = {"Chrome_WidgetWin_1", "Notepad", "ConsoleWindowClass",
+    "Notepad"};
+constexpr std::string_view kTitles[] = {"", "Inbox", "inbox", "Inbox - Mail", "b", "a"};
+//! Row counts on either side of the 64-bit words.
+constexpr size_t kSizes[] = {0, 1, 2, 63, 64, 65, 127, 128, 129, 200, 1000};
+
+//! A table of random windows, drawn from few enough values that many rows share every key.
+WindowTable RandomTable(std::mt19937& random, size_t size) {
+    std::vector<ProcessData> windows(size);
+    for (size_t i = 0; i < size; ++i) {
+        ProcessData& window = windows[i];
+        window.window_handle_ = FakeHandle(i + 1);
+        window.process_id_ = static_cast<uint32_t>(random() % 5);
+        window.title_ = std::string(kTitles[random() % std::size(kTitles)]);
+        window.class_name_ = kClassNames[random() % std::size(kClassNames)];
+        window.attributes_ = {random() % 2 == 0, random() % 3 != 0,
+            static_cast<WindowState>(random() % 3)};
+        window.metrics_.style_ = static_cast<uint32_t>(random()) & 0xf00000f0u;
+        window.metrics_.ex_style_ = static_cast<uint32_t>(random()) & 0x000f000fu;
+    }
+    WindowTable table;
+    table.Reset(std::move(windows));
+    return table;
+}
+
+//! Checks a bitset bit by bit against the rows a predicate accepts, and that no bit beyond the
+//! last row is set.
+template <typename Predicate>
+void ExpectBits(const Bitset& bits, const WindowTable& table, Predicate predicate) {
+    ASSERT_EQ(bits.size(), table.size());
+    ASSERT_EQ(bits.words().size(), (table.size() + 63) / 64);
+    size_t expected_count = 0;
+    for (size_t i = 0; i < table.size(); ++i) {
+        const bool kExpected = predicate(table[i]);
+        EXPECT_EQ(bits.Test(i), kExpected) << "row " << i;
+        expected_count += kExpected ? 1 : 0;
+    }
+    EXPECT_EQ(bits.Count(), expected_count);
+}
+} // namespace
+
+TEST(BitsetTest, TailStaysClear) {
+    for (size_t size : kSizes) {
+        SCOPED_TRACE("size " + std::to_string(size));
+        Bitset all(size, true);
+        EXPECT_EQ(all.Count(), size);
+        EXPECT_EQ(all.words().size(), (size + 63) / 64);
+        if (size % 64 != 0) {
+            EXPECT_EQ(all.words().back() >> (size % 64), 0u);
+        }
+
+        std::vector<size_t> visited;
+        all.ForEach([&](size_t index) { visited.push_back(index); });
+        ASSERT_EQ(visited.size(), size);
+        for (size_t i = 0; i < size; ++i) {
+            EXPECT_EQ(visited[i], i);
+        }
+
+        // Flipping sets no bit past the end.
+        Bitset none(size);
+        EXPECT_EQ(none.Count(), 0u);
+        none.Flip();
+        EXPECT_EQ(none.Count(), size);
+        all.Flip();
+        EXPECT_EQ(all.Count(), 0u);
+    }
+}
+
+TEST(BitsetTest, OperationsMatchABoolVector) {
+    std::mt19937 random(9);
+    for (size_t size : kSizes) {
+        SCOPED_TRACE("size " + std::to_string(size));
+        std::vector<bool> left(size);
+        std::vector<bool> right(size);
+        Bitset left_bits(size);
+        Bitset right_bits(size);
+        for (size_t i = 0; i < size; ++i) {
+            left[i] = random() % 2 == 0;
+            right[i] = random() % 3 == 0;
+            if (left[i]) {
+                left_bits.Set(i);
+            }
+            if (right[i]) {
+                right_bits.Set(i);
+            }
+        }
+        // Set then Reset leaves a bit clear.
+        if (size != 0) {
+            left_bits.Set(size - 1);
+            left_bits.Reset(size - 1);
+            left[size - 1] = false;
+        }
+
+        Bitset both = left_bits;
+        both &= right_bits;
+        Bitset either = left_bits;
+        either |= right_bits;
+        Bitset neither = either;
+        neither.Flip();
+        size_t both_count = 0;
+        size_t either_count = 0;
+        for (size_t i = 0; i < size; ++i) {
+            EXPECT_EQ(both.Test(i), left[i] && right[i]) << i;
+            EXPECT_EQ(either.Test(i), left[i] || right[i]) << i;
+            EXPECT_EQ(neither.Test(i), !left[i] && !right[i]) << i;
+            both_count += left[i] && right[i] ? 1 : 0;
+            either_count += left[i] || right[i] ? 1 : 0;
+        }
+        EXPECT_EQ(both.Count(), both_count);
+        EXPECT_EQ(either.Count(), either_count);
+        EXPECT_EQ(neither.Count(), size - either_count);
+    }
+}
+
+TEST(WindowColumnsTest, PredicatesMatchTheRows) {
+    std::mt19937 random(10);
+    for (size_t size : kSizes) {
+        SCOPED_TRACE("size " + std::to_string(size));
+        const WindowTable kTable = RandomTable(random, size);
+        WindowColumns columns;
+        columns.Build(kTable);
+        ASSERT_EQ(columns.size(), size);
+
+        ExpectBits(columns.All(), kTable, [](const ProcessData&) { return true; });
+        ExpectBits(columns.MatchVisible(), kTable,
+            [](const ProcessData& window) { return window.attributes_.is_visible_; });
+        ExpectBits(columns.MatchEnabled(), kTable,
+            [](const ProcessData& window) { return window.attributes_.is_enabled_; });
+        for (const WindowState kState :
+            {WindowState::Normal, WindowState::Maximized, WindowState::Minimized}) {
+            ExpectBits(columns.MatchState(kState), kTable, [kState](const ProcessData& window) {
+                return window.attributes_.state_ == kState;
+            });
+        }
+        for (const auto& [mask, value] : {std::pair<uint32_t, uint32_t>{0x10000000u, 0x10000000u},
+            {0x10000000u, 0}, {0xf0000000u, 0x90000000u}, {0x000000f0u, 0x00000030u}, {0, 0},
+            {0x01000000u, 0x01000000u}}) {
+            ExpectBits(columns.MatchStyle(mask, value), kTable,
+                [mask = mask, value = value](const ProcessData& window) {
+                    return (window.metrics_.style_ & mask) == value;
+                });
+            ExpectBits(columns.MatchExStyle(mask >> 16, value >> 16), kTable,
+                [mask = mask, value = value](const ProcessData& window) {
+                    return (window.metrics_.ex_style_ & (mask >> 16)) == value >> 16;
+                });
+        }
+
+        // Columns hold what the rows hold.
+        for (size_t i = 0; i < size; ++i) {
+            EXPECT_EQ(columns.handle(i), kTable[i].window_handle_);
+            EXPECT_EQ(columns.process_id(i), kTable[i].process_id_);
+            EXPECT_EQ(columns.title(i), kTable[i].title_);
+            EXPECT_EQ(columns.class_name(i), kTable[i].class_name_);
+        }
+    }
+}
+
+TEST(WindowColumnsTest, SortIsStableOnEqualKeys) {
+    std::mt19937 random(11);
+    for (size_t size : kSizes) {
+        SCOPED_TRACE("size " + std::to_string(size));
+        const WindowTable kTable = RandomTable(random, size);
+        WindowColumns columns;
+        columns.Build(kTable);
+        Bitset filter = columns.MatchVisible();
+        filter |= columns.MatchState(WindowState::Minimized);
+
+        for (const auto kKey : {WindowColumns::SortKey::ZOrder,
+            WindowColumns::SortKey::ProcessId, WindowColumns::SortKey::ClassName,
+            WindowColumns::SortKey::Title}) {
+            SCOPED_TRACE("key " + std::to_string(static_cast<int>(kKey)));
+            // Compares two rows by the key alone, as -1, 0 or 1.
+            const auto kCompare = [&](uint32_t a, uint32_t b) {
+                const ProcessData& left = kTable[a];
+                const ProcessData& right = kTable[b];
+                switch (kKey) {
+                    case WindowColumns::SortKey::ZOrder:
+                        return 0;
+                    case WindowColumns::SortKey::ProcessId:
+                        return left.process_id_ < right.process_id_ ? -1
+                            : left.process_id_ > right.process_id_ ? 1 : 0;
+                    case WindowColumns::SortKey::ClassName:
+                        return left.class_name_.compare(right.class_name_) < 0 ? -1
+                            : left.class_name_.compare(right.class_name_) > 0 ? 1 : 0;
+                    case WindowColumns::SortKey::Title:
+                        return left.title_.compare(right.title_) < 0 ? -1
+                            : left.title_.compare(right.title_) > 0 ? 1 : 0;
+                }
+                return 0;
+            };
+
+            std::vector<uint32_t> order = {12345};
+            columns.SortIndex(kKey, filter, &order);
+            ASSERT_EQ(order.size(), filter.Count());
+            std::vector<bool> seen(size);
+            for (size_t i = 0; i < order.size(); ++i) {
+                ASSERT_LT(order[i], size);
+                EXPECT_TRUE(filter.Test(order[i])) << order[i];
+                EXPECT_FALSE(seen[order[i]]) << order[i];
+                seen[order[i]] = true;
+                if (i == 0) {
+                    continue;
+                }
+                // Sorted by the key, and rows with equal keys in Z-order.
+                const int kOrder = kCompare(order[i - 1], order[i]);
+                EXPECT_LE(kOrder, 0) << order[i - 1] << " before " << order[i];
+                if (kOrder == 0) {
+                    EXPECT_LT(order[i - 1], order[i]);
+                }
+            }
+        }
+    }
+}
+} // namespace fsb
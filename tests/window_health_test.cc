@@ -0,0 +1,175 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_health.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace fsb {
+namespace {
+using std::chrono::milliseconds;
+
+//! Asks for a probe and reports its outcome, returning the timeout it was given or 0 if skipped.
+uint32_t Probe(HealthTracker& health, uint32_t process_id, ProbeStatus status,
+    milliseconds elapsed = milliseconds(0)) {
+    uint32_t timeout = 0;
+    if (!health.ShouldProbe(process_id, &timeout)) {
+        return 0;
+    }
+    health.Report(process_id, status, elapsed);
+    return timeout;
+}
+} // namespace
+
+TEST(HealthTrackerTest, TimeoutFollowsTheAverageResponse) {
+    HealthTracker health;
+    health.BeginRound();
+    // Nothing is known about a new process.
+    EXPECT_EQ(Probe(health, 1, ProbeStatus::Ok, milliseconds(2)), 100u);
+    // 2 ms on average, rounded up and times the factor of 4.
+    EXPECT_EQ(Probe(health, 1, ProbeStatus::Ok, milliseconds(30)), 12u);
+    // 2 + 0.2 * (30 - 2) = 7.6 ms.
+    EXPECT_EQ(Probe(health, 1, ProbeStatus::Failed, milliseconds(0)), 32u);
+    // A failure still answered, 7.6 * 0.8 = 6.08 ms.
+    uint32_t timeout = 0;
+    ASSERT_TRUE(health.ShouldProbe(1, &timeout));
+    EXPECT_EQ(timeout, 28u);
+    health.Report(1, ProbeStatus::Ok, milliseconds(0));
+
+    // Fast answers bottom out at the minimum.
+    for (int i = 0; i < 20; ++i) {
+        static_cast<void>(Probe(health, 1, ProbeStatus::Ok));
+    }
+    EXPECT_EQ(Probe(health, 1, ProbeStatus::TimedOut), 10u);
+    // A timeout is not trusted to be fast next time.
+    EXPECT_EQ(Probe(health, 1, ProbeStatus::Ok), 100u);
+    EXPECT_EQ(health.timeouts(), 1u);
+    EXPECT_FALSE(health.IsQuarantined(1));
+
+    // Slow answers stop at the maximum.
+    HealthTracker slow;
+    slow.BeginRound();
+    static_cast<void>(Probe(slow, 2, ProbeStatus::Ok, milliseconds(80)));
+    EXPECT_EQ(Probe(slow, 2, ProbeStatus::Ok), 100u);
+}
+
+TEST(HealthTrackerTest, OneProbeAtATimeAfterATimeout) {
+    HealthTracker health;
+    health.BeginRound();
+    EXPECT_EQ(Probe(health, 1, ProbeStatus::TimedOut), 100u);
+
+    uint32_t timeout = 0;
+    ASSERT_TRUE(health.ShouldProbe(1, &timeout));
+    // Its other windows wait for this one instead of all waiting out the same hang.
+    EXPECT_FALSE(health.ShouldProbe(1, &timeout));
+    EXPECT_EQ(health.skipped(), 1u);
+    health.Report(1, ProbeStatus::Ok, milliseconds(1));
+    EXPECT_TRUE(health.ShouldProbe(1, &timeout));
+    EXPECT_TRUE(health.ShouldProbe(1, &timeout));
+}
+
+TEST(HealthTrackerTest, QuarantineDoublesAndWindsDown) {
+    HealthOptions options;
+    options.base_backoff_ = 100;
+    options.round_budget_ = 1000000;
+    HealthTracker health(options);
+    health.BeginRound();
+
+    EXPECT_NE(Probe(health, 1, ProbeStatus::TimedOut), 0u);
+    EXPECT_FALSE(health.IsQuarantined(1));
+    EXPECT_NE(Probe(health, 1, ProbeStatus::TimedOut), 0u);
+    EXPECT_TRUE(health.IsQuarantined(1));
+    EXPECT_EQ(health.quarantined_count(), 1u);
+    EXPECT_EQ(Probe(health, 1, ProbeStatus::Ok), 0u);
+    // Other processes are not affected.
+    EXPECT_NE(Probe(health, 2, ProbeStatus::Ok), 0u);
+
+    // Out after 100 ms, and back in for 200 ms on the first new timeout.
+    std::this_thread::sleep_for(milliseconds(140));
+    EXPECT_FALSE(health.IsQuarantined(1));
+    EXPECT_NE(Probe(health, 1, ProbeStatus::TimedOut), 0u);
+    EXPECT_TRUE(health.IsQuarantined(1));
+    std::this_thread::sleep_for(milliseconds(140));
+    EXPECT_TRUE(health.IsQuarantined(1));
+    std::this_thread::sleep_for(milliseconds(100));
+    EXPECT_FALSE(health.IsQuarantined(1));
+
+    // Every answer takes one doubling back, so after two a single timeout is forgiven again and
+    // the next quarantine is back to 100 ms.
+    EXPECT_NE(Probe(health, 1, ProbeStatus::Ok), 0u);
+    EXPECT_NE(Probe(health, 1, ProbeStatus::Ok), 0u);
+    EXPECT_NE(Probe(health, 1, ProbeStatus::TimedOut), 0u);
+    EXPECT_FALSE(health.IsQuarantined(1));
+    EXPECT_NE(Probe(health, 1, ProbeStatus::TimedOut), 0u);
+    EXPECT_TRUE(health.IsQuarantined(1));
+    std::this_thread::sleep_for(milliseconds(140));
+    EXPECT_FALSE(health.IsQuarantined(1));
+    EXPECT_EQ(health.timeouts(), 5u);
+}
+
+TEST(HealthTrackerTest, BackoffStopsAtTheMaximum) {
+    HealthOptions options;
+    options.quarantine_after_ = 1;
+    options.base_backoff_ = 20;
+    options.max_backoff_ = 60;
+    options.round_budget_ = 1000000;
+    HealthTracker health(options);
+    health.BeginRound();
+
+    // 20, 40, then 60 ms however often it reoffends.
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_NE(Probe(health, 1, ProbeStatus::TimedOut), 0u) << i;
+        ASSERT_TRUE(health.IsQuarantined(1));
+        std::this_thread::sleep_for(milliseconds(100));
+        ASSERT_FALSE(health.IsQuarantined(1)) << i;
+    }
+}
+
+TEST(HealthTrackerTest, RoundBudgetBoundsTheWait) {
+    HealthTracker health;
+    health.BeginRound();
+    // Three hung processes spend the 250 ms, the last one only gets what is left.
+    uint32_t timeout = 0;
+    for (uint32_t process_id : {1u, 2u}) {
+        ASSERT_TRUE(health.ShouldProbe(process_id, &timeout));
+        EXPECT_EQ(timeout, 100u);
+        health.Report(process_id, ProbeStatus::TimedOut, milliseconds(timeout));
+    }
+    ASSERT_TRUE(health.ShouldProbe(3, &timeout));
+    EXPECT_EQ(timeout, 50u);
+    health.Report(3, ProbeStatus::TimedOut, milliseconds(timeout));
+
+    // Spent: nothing else is probed this round, however fast it would answer.
+    EXPECT_FALSE(health.ShouldProbe(4, &timeout));
+    EXPECT_FALSE(health.ShouldProbe(1, &timeout));
+    EXPECT_EQ(health.skipped(), 2u);
+    EXPECT_EQ(health.timeouts(), 3u);
+    EXPECT_EQ(health.quarantined_count(), 0u);
+
+    health.BeginRound();
+    EXPECT_EQ(Probe(health, 4, ProbeStatus::Ok), 100u);
+    EXPECT_EQ(Probe(health, 1, ProbeStatus::Ok), 100u);
+}
+
+TEST(HealthTrackerTest, FastAnswersBarelyTouchTheBudget) {
+    HealthOptions options;
+    options.round_budget_ = 20;
+    HealthTracker health(options);
+    health.BeginRound();
+    for (uint32_t process_id = 1; process_id <= 1000; ++process_id) {
+        ASSERT_NE(Probe(health, process_id, ProbeStatus::Ok, milliseconds(0)), 0u);
+    }
+    // The timeout never exceeds what is left of the budget.
+    uint32_t timeout = 0;
+    ASSERT_TRUE(health.ShouldProbe(1001, &timeout));
+    EXPECT_EQ(timeout, 20u);
+    health.Report(1001, ProbeStatus::TimedOut, milliseconds(15));
+    ASSERT_TRUE(health.ShouldProbe(1002, &timeout));
+    EXPECT_EQ(timeout, 5u);
+}
+} // namespace fsb
@@ -0,0 +1,145 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_probe.h"
+
+#include "synthetic_window_source.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace fsb {
+namespace {
+constexpr uint32_t kExStyleToolWindow = 0x00000080;
+
+SyntheticOptions Desktop(size_t window_count) {
+    SyntheticOptions options;
+    options.window_count_ = window_count;
+    return options;
+}
+
+void ExpectSameWindows(const std::vector<ProcessData>& expected,
+    const std::vector<ProcessData>& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i].window_handle_, actual[i].window_handle_) << "row " << i;
+        EXPECT_EQ(expected[i].process_id_, actual[i].process_id_) << "row " << i;
+        EXPECT_EQ(expected[i].title_, actual[i].title_) << "row " << i;
+        EXPECT_EQ(expected[i].class_name_, actual[i].class_name_) << "row " << i;
+        EXPECT_EQ(expected[i].metrics_.position_.x, actual[i].metrics_.position_.x) << "row " << i;
+        EXPECT_EQ(expected[i].metrics_.style_, actual[i].metrics_.style_) << "row " << i;
+        EXPECT_EQ(expected[i].attributes_.is_visible_, actual[i].attributes_.is_visible_)
+            << "row " << i;
+    }
+}
+
+TEST(WindowProbeTest, ParallelEnumerationMatchesSerialProbes) {
+    SyntheticWindowSource source(Desktop(3000));
+    StringPool strings;
+    ProbePool pool(8);
+
+    std::vector<ProcessData> windows;
+    EnumerateWindows(source, strings, pool, kDefaultConfig, &windows);
+
+    std::vector<HWND> handles;
+    source.EnumerateWindowHandles(&handles);
+    std::vector<ProcessData> expected;
+    for (HWND window_handle : handles) {
+        ProcessData window = {};
+        if (ProbeWindow(source, strings, window_handle, kDefaultConfig, &window)) {
+            expected.push_back(window);
+        }
+    }
+
+    EXPECT_FALSE(windows.empty());
+    ExpectSameWindows(expected, windows);
+}
+
+TEST(WindowProbeTest, FiltersHiddenAndUntitledWindows) {
+    SyntheticWindowSource source(Desktop(2000));
+    StringPool strings;
+    ProbePool pool(4);
+
+    std::vector<ProcessData> listed;
+    EnumerateWindows(source, strings, pool, kDefaultConfig, &listed);
+    for (const ProcessData& window : listed) {
+        EXPECT_TRUE(window.attributes_.is_visible_);
+        EXPECT_FALSE(window.title_.empty());
+    }
+
+    Config everything = kDefaultConfig;
+    everything.hide_hidden_windows_ = false;
+    everything.hide_blank_title_windows_ = false;
+    std::vector<ProcessData> all;
+    EnumerateWindows(source, strings, pool, everything, &all);
+    for (const ProcessData& window : all) {
+        EXPECT_EQ(window.metrics_.ex_style_ & kExStyleToolWindow, 0u);
+    }
+    // Tool windows are never listed, whatever the filters say.
+    EXPECT_LT(all.size(), source.window_count());
+    EXPECT_LT(listed.size(), all.size());
+}
+
+TEST(WindowProbeTest, StreamedBatchesKeepTheZOrder) {
+    SyntheticWindowSource source(Desktop(3000));
+    StringPool strings;
+    ProbePool pool(8);
+
+    std::vector<ProcessData> expected;
+    EnumerateWindows(source, strings, pool, kDefaultConfig, &expected);
+
+    std::vector<ProcessData> streamed;
+    size_t done_calls = 0;
+    bool batch_after_done = false;
+    const size_t kProbed = StreamWindows(source, strings, pool, kDefaultConfig,
+        std::chrono::nanoseconds(0), nullptr,
+        [&](std::vector<ProcessData> batch, bool done) {
+            batch_after_done = batch_after_done || done_calls != 0;
+            done_calls += done ? 1 : 0;
+            streamed.insert(streamed.end(), batch.begin(), batch.end());
+        });
+
+    EXPECT_EQ(kProbed, source.window_count());
+    EXPECT_EQ(done_calls, 1u);
+    EXPECT_FALSE(batch_after_done);
+    ExpectSameWindows(expected, streamed);
+}
+
+TEST(WindowProbeTest, RefineDropsWindows) {
+    SyntheticWindowSource source(Desktop(1000));
+    StringPool strings;
+    ProbePool pool(4);
+
+    std::vector<ProcessData> streamed;
+    static_cast<void>(StreamWindows(source, strings, pool, kDefaultConfig,
+        std::chrono::nanoseconds(0),
+        [](ProcessData* window) { return window->process_id_ % 2 == 0; },
+        [&](std::vector<ProcessData> batch, bool done) {
+            static_cast<void>(done);
+            streamed.insert(streamed.end(), batch.begin(), batch.end());
+        }));
+
+    EXPECT_FALSE(streamed.empty());
+    for (const ProcessData& window : streamed) {
+        EXPECT_EQ(window.process_id_ % 2, 0u);
+    }
+}
+
+TEST(SyntheticWindowSourceTest, SameSeedGeneratesTheSameDesktop) {
+    SyntheticWindowSource first(Desktop(500));
+    SyntheticWindowSource second(Desktop(500));
+    StringPool strings;
+    ProbePool pool(2);
+
+    std::vector<ProcessData> first_windows;
+    std::vector<ProcessData> second_windows;
+    EnumerateWindows(first, strings, pool, kDefaultConfig, &first_windows);
+    EnumerateWindows(second, strings, pool, kDefaultConfig, &second_windows);
+    ExpectSameWindows(first_windows, second_windows);
+}
+} // namespace
+} // namespace fsb
@@ -0,0 +1,139 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_search.h"
+
+#include "fake_window_source.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fsb {
+namespace {
+const std::vector<std::string_view> kClassNames = {"Chrome_WidgetWin_1", "Notepad", "cls"};
+const std::vector<std::string_view> kFileNames = {"C:\\Apps\\chrome.exe", "", "D:\\Vim\\gvim.exe"};
+
+std::string Lower(std::string text) {
+    for (char& character : text) {
+        character = static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+    }
+    return text;
+}
+
+bool IsSubsequence(std::string_view text, std::string_view query) {
+    size_t position = 0;
+    for (char character : query) {
+        position = text.find(character, position);
+        if (position == std::string_view::npos) {
+            return false;
+        }
+        ++position;
+    }
+    return true;
+}
+
+//! Search over the rows of windows, with the class and executable picked by row.
+class WindowSearchTest : public testing::Test {
+protected:
+    void Build(std::vector<ProcessData> windows) {
+        for (size_t i = 0; i < windows.size(); ++i) {
+            windows[i].window_handle_ = FakeHandle(i + 1);
+            windows[i].class_name_ = kClassNames[i % kClassNames.size()];
+            file_names_.push_back(kFileNames[i % kFileNames.size()]);
+        }
+        windows_ = windows;
+        table_.Reset(std::move(windows));
+        search_.Build(table_, file_names_);
+    }
+
+    //! Every row the query should match, checked one by one.
+    std::vector<uint32_t> Expected(std::string_view query) const {
+        std::vector<uint32_t> rows;
+        for (uint32_t row = 0; row < windows_.size(); ++row) {
+            const ProcessData& kWindow = windows_[row];
+            if (IsSubsequence(Lower(kWindow.title_), query)
+                || IsSubsequence(Lower(std::string(kWindow.class_name_)), query)
+                || IsSubsequence(Lower(std::string(file_names_[row])), query)) {
+                rows.push_back(row);
+            }
+        }
+        return rows;
+    }
+
+    std::vector<uint32_t> Sorted(std::vector<uint32_t> rows) const {
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+
+    std::vector<ProcessData> windows_;
+    std::vector<std::string_view> file_names_;
+    WindowTable table_;
+    WindowSearch search_;
+};
+
+ProcessData Titled(std::string title) {
+    ProcessData window = {};
+    window.title_ = std::move(title);
+    return window;
+}
+} // namespace
+
+TEST_F(WindowSearchTest, RanksSubstringsAboveScatteredMatches) {
+    Build({Titled("Pull request review"), Titled("Untitled - Notepad"), Titled("prv"),
+        Titled("Inbox")});
+    search_.SetQuery("prv");
+    ASSERT_EQ(search_.results().size(), 2u);
+    EXPECT_EQ(search_.results()[0], 2u);
+    EXPECT_EQ(search_.results()[1], 0u);
+
+    // The class and the executable match too, case-insensitively.
+    search_.SetQuery("NOTEPAD");
+    EXPECT_EQ(Sorted(search_.results()), (std::vector<uint32_t>{1}));
+    search_.SetQuery("gvim");
+    EXPECT_EQ(Sorted(search_.results()), (std::vector<uint32_t>{2}));
+    search_.Clear();
+    EXPECT_FALSE(search_.active());
+    EXPECT_TRUE(search_.results().empty());
+}
+
+TEST_F(WindowSearchTest, KeystrokesMatchAFreshSearch) {
+    std::mt19937 random(3);
+    std::vector<ProcessData> windows;
+    for (int i = 0; i < 500; ++i) {
+        std::string title;
+        for (size_t length = random() % 20; length > 0; --length) {
+            title.push_back("abcAB -e"[random() % 8]);
+        }
+        windows.push_back(Titled(title));
+    }
+    Build(std::move(windows));
+
+    // Random typing and deleting, checked against every row after each key.
+    std::string query;
+    for (int key = 0; key < 3000; ++key) {
+        if (!query.empty() && random() % 3 == 0) {
+            query.pop_back();
+            search_.Pop();
+        } else if (query.size() < 6) {
+            query.push_back("abc -ex"[random() % 7]);
+            search_.Push(query.back());
+        }
+        ASSERT_EQ(search_.query(), query);
+        if (query.empty()) {
+            ASSERT_TRUE(search_.results().empty());
+            continue;
+        }
+        ASSERT_EQ(Sorted(search_.results()), Expected(query)) << "query " << query;
+
+        const std::vector<uint32_t> kIncremental = search_.results();
+        search_.SetQuery(query);
+        ASSERT_EQ(search_.results(), kIncremental) << "query " << query;
+    }
+}
+} // namespace fsb
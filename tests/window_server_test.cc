@@ -0,0 +1,212 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_server.h"
+
+#include "fake_window_source.h"
+#include "ipc_channel.h"
+#include "recording_geometry_backend.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fsb {
+namespace {
+using namespace std::chrono_literals;
+
+//! Address no other test process uses at the same time.
+std::string TestAddress(const char* name) {
+#ifdef _WIN32
+    return std::string("\\\\.\\pipe\\fsb-test-") + name;
+#else
+    return ::testing::TempDir() + "fsb-" + name + "-" + std::to_string(getpid()) + ".sock";
+#endif
+}
+
+std::string Ask(const std::string& address, const std::vector<std::string>& request) {
+    IpcChannel channel;
+    std::string response;
+    if (!channel.Connect(address) || !channel.Send(EncodeServerRequest(request))
+        || !channel.Receive(&response)) {
+        return "!";
+    }
+    return response;
+}
+
+//! Server over three windows of FakeWindowSource, serving on a thread of its own.
+class WindowServerTest : public testing::Test {
+protected:
+    void SetUp() override {
+        for (int i = 1; i <= 3; ++i) {
+            FakeWindow window;
+            window.title_ = "Window " + std::to_string(i);
+            source_.AddWindow(FakeHandle(i), window);
+        }
+        source_.window(FakeHandle(3))->class_name_ = "Other";
+        server_.Refresh();
+        address_ = TestAddress(testing::UnitTest::GetInstance()->current_test_info()->name());
+        ASSERT_TRUE(listener_.Listen(address_));
+    }
+
+    void TearDown() override {
+        server_.StopServing();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    void Start() {
+        thread_ = std::thread([this]() {
+            server_.Serve(listener_, [this]() { stopped_ = true; });
+        });
+    }
+
+    FakeWindowSource source_;
+    RecordingGeometryBackend geometry_;
+    ProbePool pool_{2};
+    WindowServer server_{source_, geometry_, pool_};
+    IpcListener listener_;
+    std::string address_;
+    std::thread thread_;
+    std::atomic<bool> stopped_{false};
+};
+} // namespace
+
+TEST(IpcChannelTest, CarriesMessagesOfEverySize) {
+    const std::string kAddress = TestAddress("sizes");
+    IpcListener listener;
+    ASSERT_TRUE(listener.Listen(kAddress));
+    const std::vector<std::string> kMessages = {"", "x", std::string(4096, 'a'),
+        std::string(4097, 'b'), std::string(size_t{3} << 20, 'c')};
+
+    std::thread echo([&]() {
+        IpcChannel channel;
+        std::string message;
+        while (listener.Accept(&channel) && channel.Receive(&message)) {
+            static_cast<void>(channel.Send(message));
+        }
+    });
+    for (const std::string& message : kMessages) {
+        IpcChannel channel;
+        std::string response;
+        ASSERT_TRUE(channel.Connect(kAddress));
+        ASSERT_TRUE(channel.Send(message));
+        ASSERT_TRUE(channel.Receive(&response));
+        EXPECT_EQ(response, message);
+    }
+    listener.Stop();
+    echo.join();
+}
+
+TEST(IpcChannelTest, SecondListenerIsRefused) {
+    const std::string kAddress = TestAddress("twice");
+    IpcListener first;
+    IpcListener second;
+    ASSERT_TRUE(first.Listen(kAddress));
+    EXPECT_FALSE(second.Listen(kAddress));
+}
+
+TEST(IpcChannelTest, ReceiveTimesOutOnAStalledPeer) {
+    const std::string kAddress = TestAddress("stalled");
+    IpcListener listener;
+    ASSERT_TRUE(listener.Listen(kAddress));
+    IpcChannel client;
+    ASSERT_TRUE(client.Connect(kAddress));
+    IpcChannel server;
+    ASSERT_TRUE(listener.Accept(&server));
+
+    // One message, then nothing.
+    ASSERT_TRUE(client.Send(std::string(100, 'x')));
+    std::string message;
+    server.SetTimeout(50ms);
+    ASSERT_TRUE(server.Receive(&message));
+    const auto kStart = std::chrono::steady_clock::now();
+    EXPECT_FALSE(server.Receive(&message));
+    EXPECT_GE(std::chrono::steady_clock::now() - kStart, 40ms);
+    EXPECT_LT(std::chrono::steady_clock::now() - kStart, 5s);
+}
+
+TEST(IpcChannelTest, CancelUnblocksReceive) {
+    const std::string kAddress = TestAddress("cancel");
+    IpcListener listener;
+    ASSERT_TRUE(listener.Listen(kAddress));
+    IpcChannel client;
+    ASSERT_TRUE(client.Connect(kAddress));
+    IpcChannel server;
+    ASSERT_TRUE(listener.Accept(&server));
+
+    std::atomic<bool> received{true};
+    std::thread reader([&]() {
+        std::string message;
+        received = server.Receive(&message);
+    });
+    std::this_thread::sleep_for(20ms);
+    server.Cancel();
+    reader.join();
+    EXPECT_FALSE(received);
+}
+
+TEST_F(WindowServerTest, AnswersRequestsUntilAskedToStop) {
+    Start();
+    EXPECT_EQ(Ask(address_, {"list", "--fields", "handle,title", "--format", "csv"}),
+        "+handle,title\n12,Window 3\n8,Window 2\n4,Window 1\n");
+    EXPECT_EQ(Ask(address_, {"list", "--fields=title", "--filter", "class=Other"}),
+        "+{\"title\":\"Window 3\"}\n");
+    EXPECT_EQ(Ask(address_, {"query", "8", "--fields", "title", "--format", "csv"}),
+        "+title\nWindow 2\n");
+    EXPECT_EQ(Ask(address_, {"query", "16"}), "-No such window.");
+    EXPECT_EQ(Ask(address_, {"lst"})[0], kResponseError);
+
+    EXPECT_EQ(Ask(address_, {"stop"}), "+Stopping.\n");
+    thread_.join();
+    EXPECT_TRUE(stopped_);
+    EXPECT_EQ(Ask(address_, {"list"}), "!");
+}
+
+TEST_F(WindowServerTest, DropsAClientThatStalls) {
+    server_.SetRequestTimeout(50ms);
+    Start();
+    IpcChannel stalled;
+    ASSERT_TRUE(stalled.Connect(address_));
+
+    // Queued behind the stalled client until the server gives up on it.
+    EXPECT_EQ(Ask(address_, {"query", "4", "--fields", "title", "--format", "csv"}),
+        "+title\nWindow 1\n");
+    std::string response;
+    EXPECT_FALSE(stalled.Receive(&response));
+}
+
+TEST_F(WindowServerTest, StopServingDropsTheClientInFlight) {
+    server_.SetRequestTimeout(0ms);
+    Start();
+    ASSERT_EQ(Ask(address_, {"query", "4", "--fields", "title", "--format", "csv"}),
+        "+title\nWindow 1\n");
+
+    // Without a timeout only StopServing gets the server away from this client.
+    IpcChannel stalled;
+    ASSERT_TRUE(stalled.Connect(address_));
+    std::this_thread::sleep_for(20ms);
+    server_.StopServing();
+    thread_.join();
+    EXPECT_FALSE(stopped_);
+    std::string response;
+    EXPECT_FALSE(stalled.Receive(&response));
+}
+
+TEST_F(WindowServerTest, StopServingBeforeServeReturnsAtOnce) {
+    server_.StopServing();
+    Start();
+    thread_.join();
+    EXPECT_FALSE(stopped_);
+}
+} // namespace fsb
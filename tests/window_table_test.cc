@@ -0,0 +1,115 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_table.h"
+
+#include "fake_window_source.h"
+#include "probe_pool.h"
+#include "string_pool.h"
+#include "window_probe.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace fsb {
+namespace {
+class WindowTableTest : public testing::Test {
+protected:
+    void SetUp() override {
+        for (uintptr_t i = 1; i <= 3; ++i) {
+            FakeWindow window;
+            window.title_ = "Window " + std::to_string(i);
+            source_.AddWindow(FakeHandle(i), window);
+        }
+        std::vector<ProcessData> windows;
+        EnumerateWindows(source_, strings_, pool_, kDefaultConfig, &windows);
+        table_.Reset(std::move(windows));
+    }
+
+    size_t Apply(std::vector<WindowEvent> events) {
+        return table_.Apply(events, source_, strings_, kDefaultConfig, &removed_, &probed_);
+    }
+
+    FakeWindowSource source_;
+    StringPool strings_;
+    ProbePool pool_{2};
+    WindowTable table_;
+    std::vector<HWND> removed_;
+    std::vector<HWND> probed_;
+};
+} // namespace
+
+TEST_F(WindowTableTest, CoalescesEventsPerWindow) {
+    source_.window(FakeHandle(2))->title_ = "Renamed";
+    EXPECT_EQ(Apply({{WindowEventType::TitleChanged, FakeHandle(2)},
+        {WindowEventType::Moved, FakeHandle(2)},
+        {WindowEventType::TitleChanged, FakeHandle(2)}}), 1u);
+    EXPECT_EQ(table_[table_.Find(FakeHandle(2))].title_, "Renamed");
+    EXPECT_EQ(probed_, std::vector<HWND>{FakeHandle(2)});
+    EXPECT_TRUE(removed_.empty());
+}
+
+TEST_F(WindowTableTest, CreatedAndDestroyedWindows) {
+    source_.AddWindow(FakeHandle(4));
+    source_.RemoveWindow(FakeHandle(1));
+    static_cast<void>(Apply({{WindowEventType::Created, FakeHandle(4)},
+        {WindowEventType::Destroyed, FakeHandle(1)}}));
+    EXPECT_EQ(table_.size(), 3u);
+    EXPECT_LT(table_.Find(FakeHandle(1)), 0);
+    EXPECT_EQ(table_.Find(FakeHandle(4)), 2);
+    EXPECT_EQ(removed_, std::vector<HWND>{FakeHandle(1)});
+    EXPECT_EQ(probed_, std::vector<HWND>{FakeHandle(4)});
+}
+
+TEST_F(WindowTableTest, ReusedHandleIsRemovedThenProbed) {
+    FakeWindow replacement;
+    replacement.process_id_ = 7;
+    replacement.title_ = "Replacement";
+    source_.AddWindow(FakeHandle(2), replacement);
+    static_cast<void>(Apply({{WindowEventType::Destroyed, FakeHandle(2)},
+        {WindowEventType::Created, FakeHandle(2)}}));
+
+    EXPECT_EQ(removed_, std::vector<HWND>{FakeHandle(2)});
+    EXPECT_EQ(probed_, std::vector<HWND>{FakeHandle(2)});
+    const ProcessData& kRow = table_[table_.Find(FakeHandle(2))];
+    EXPECT_EQ(kRow.process_id_, 7u);
+    EXPECT_EQ(kRow.title_, "Replacement");
+}
+
+TEST_F(WindowTableTest, DestroyedAfterCreatedIsRemoved) {
+    source_.RemoveWindow(FakeHandle(3));
+    static_cast<void>(Apply({{WindowEventType::Created, FakeHandle(3)},
+        {WindowEventType::Destroyed, FakeHandle(3)}}));
+    EXPECT_LT(table_.Find(FakeHandle(3)), 0);
+    EXPECT_EQ(removed_, std::vector<HWND>{FakeHandle(3)});
+    EXPECT_TRUE(probed_.empty());
+}
+
+TEST_F(WindowTableTest, MovedRereadsTheWindowState) {
+    FakeWindow* window = source_.window(FakeHandle(1));
+    window->attributes_.state_ = WindowState::Maximized;
+    window->metrics_.size_ = {1920, 1080};
+    static_cast<void>(Apply({{WindowEventType::Moved, FakeHandle(1)}}));
+
+    const ProcessData& kRow = table_[table_.Find(FakeHandle(1))];
+    EXPECT_EQ(kRow.attributes_.state_, WindowState::Maximized);
+    EXPECT_EQ(kRow.metrics_.size_.x, 1920);
+    EXPECT_TRUE(probed_.empty());
+}
+
+TEST_F(WindowTableTest, TitleMakesAnUntitledWindowEligible) {
+    FakeWindow untitled;
+    untitled.title_.clear();
+    source_.AddWindow(FakeHandle(5), untitled);
+    static_cast<void>(Apply({{WindowEventType::Created, FakeHandle(5)}}));
+    EXPECT_LT(table_.Find(FakeHandle(5)), 0);
+
+    source_.window(FakeHandle(5))->title_ = "Titled";
+    static_cast<void>(Apply({{WindowEventType::TitleChanged, FakeHandle(5)}}));
+    EXPECT_GE(table_.Find(FakeHandle(5)), 0);
+    EXPECT_EQ(probed_, std::vector<HWND>{FakeHandle(5)});
+}
+} // namespace fsb
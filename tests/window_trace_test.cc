@@ -0,0 +1,373 @@
+// Copyright 2025 Jamie Howell
+// Use of this source code is governed by an MIT license that can be
+// found in the LICENSE file.
+
+#include "window_trace.h"
+
+#include "fake_window_source.h"
+#include "probe_pool.h"
+#include "recording_window_source.h"
+#include "replay_window_source.h"
+#include "string_pool.h"
+#include "window_probe.h"
+#include "window_table.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fsb {
+namespace {
+//! What the error reader reports for a failed call, as GetLastError would.
+constexpr uint32_t kInvalidWindowHandle = 1400;
+
+uint32_t ReadError() {
+    return kInvalidWindowHandle;
+}
+
+std::string TracePath(const std::string& name) {
+    return testing::TempDir() + "fsb_" + name + ".fsbt";
+}
+
+void ExpectSameRecord(const TraceRecord& expected, const TraceRecord& actual, size_t index) {
+    SCOPED_TRACE("record " + std::to_string(index));
+    EXPECT_EQ(actual.call_, expected.call_);
+    EXPECT_EQ(actual.result_, expected.result_);
+    EXPECT_EQ(actual.error_code_, expected.error_code_);
+    EXPECT_EQ(actual.time_, expected.time_);
+    EXPECT_EQ(actual.latency_, expected.latency_);
+    EXPECT_EQ(actual.key_, expected.key_);
+    EXPECT_EQ(actual.window_handles_, expected.window_handles_);
+    ASSERT_EQ(actual.events_.size(), expected.events_.size());
+    for (size_t i = 0; i < expected.events_.size(); ++i) {
+        EXPECT_EQ(actual.events_[i].type_, expected.events_[i].type_);
+        EXPECT_EQ(actual.events_[i].window_handle_, expected.events_[i].window_handle_);
+    }
+    EXPECT_EQ(actual.attributes_.is_visible_, expected.attributes_.is_visible_);
+    EXPECT_EQ(actual.attributes_.is_enabled_, expected.attributes_.is_enabled_);
+    EXPECT_EQ(actual.attributes_.state_, expected.attributes_.state_);
+    EXPECT_EQ(actual.metrics_.position_.x, expected.metrics_.position_.x);
+    EXPECT_EQ(actual.metrics_.position_.y, expected.metrics_.position_.y);
+    EXPECT_EQ(actual.metrics_.size_.x, expected.metrics_.size_.x);
+    EXPECT_EQ(actual.metrics_.size_.y, expected.metrics_.size_.y);
+    EXPECT_EQ(actual.metrics_.style_, expected.metrics_.style_);
+    EXPECT_EQ(actual.metrics_.ex_style_, expected.metrics_.ex_style_);
+    EXPECT_EQ(actual.text_, expected.text_);
+    EXPECT_EQ(actual.value_, expected.value_);
+}
+
+//! One record of every call, with failures, large values and a record that started before the
+//! one written ahead of it, as concurrent probes do.
+std::vector<TraceRecord> EveryCall() {
+    std::vector<TraceRecord> records(9);
+    records[0].call_ = TraceCall::EnumerateWindowHandles;
+    records[0].time_ = 1000;
+    records[0].latency_ = 250000;
+    records[0].window_handles_ = {FakeHandle(9), FakeHandle(2), FakeHandle(0x7fffffff),
+        FakeHandle(1)};
+
+    records[1].call_ = TraceCall::GetWindowAttributes;
+    records[1].time_ = 300000;
+    records[1].latency_ = 12;
+    records[1].key_ = 36;
+    records[1].attributes_ = {true, false, WindowState::Minimized};
+
+    records[2].call_ = TraceCall::GetWindowMetrics;
+    records[2].time_ = 290000;
+    records[2].latency_ = 40;
+    records[2].key_ = 8;
+    records[2].metrics_ = {{-1920, -8}, {3840, 2160}, 0x94000000u, 0x00040008u};
+
+    records[3].call_ = TraceCall::GetWindowFont;
+    records[3].result_ = static_cast<uint8_t>(ProbeStatus::TimedOut);
+    records[3].error_code_ = 1460;
+    records[3].time_ = 310000;
+    records[3].latency_ = 200000000;
+    records[3].key_ = 8;
+    records[3].text_ = "Segoe UI";
+    records[3].value_ = 9;
+
+    records[4].call_ = TraceCall::GetWindowProcessId;
+    records[4].result_ = 1;
+    records[4].error_code_ = kInvalidWindowHandle;
+    records[4].time_ = 500000000;
+    records[4].latency_ = 3;
+    records[4].key_ = 4;
+    records[4].value_ = 0xffffffffu;
+
+    records[5].call_ = TraceCall::GetWindowTitle;
+    records[5].time_ = 500000010;
+    records[5].key_ = 4;
+    records[5].text_ = "Caf\xc3\xa9 \xe2\x80\x94 \"quoted\"\n";
+
+    records[6].call_ = TraceCall::GetWindowClassName;
+    records[6].time_ = 500000020;
+    records[6].latency_ = 1;
+    records[6].key_ = 4;
+    records[6].text_ = std::string("Nul\0Inside", 10);
+
+    records[7].call_ = TraceCall::GetProcessInfo;
+    records[7].result_ = 1;
+    records[7].error_code_ = 5;
+    records[7].time_ = 500000030;
+    records[7].latency_ = 1500;
+    records[7].key_ = 4242;
+    records[7].value_ = 0x01d9a1b2c3d4e5f6ull;
+
+    records[8].call_ = TraceCall::WindowEvents;
+    records[8].time_ = 600000000;
+    records[8].events_ = {{WindowEventType::Created, FakeHandle(10)},
+        {WindowEventType::Moved, FakeHandle(2)}, {WindowEventType::Destroyed, FakeHandle(9)}};
+    return records;
+}
+
+std::vector<char> ReadBytes(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>());
+}
+
+void WriteBytes(const std::string& path, const std::vector<char>& bytes, size_t size) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(size));
+}
+
+void ExpectSameTable(const WindowTable& expected, const WindowTable& actual) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        SCOPED_TRACE("row " + std::to_string(i));
+        EXPECT_EQ(actual[i].window_handle_, expected[i].window_handle_);
+        EXPECT_EQ(actual[i].process_id_, expected[i].process_id_);
+        EXPECT_EQ(actual[i].title_, expected[i].title_);
+        EXPECT_EQ(actual[i].class_name_, expected[i].class_name_);
+        EXPECT_EQ(actual[i].attributes_.state_, expected[i].attributes_.state_);
+        EXPECT_EQ(actual[i].metrics_.position_.x, expected[i].metrics_.position_.x);
+        EXPECT_EQ(actual[i].metrics_.size_.x, expected[i].metrics_.size_.x);
+    }
+}
+
+class RecordedTraceTest : public testing::Test {
+protected:
+    void SetUp() override {
+        for (uintptr_t i = 1; i <= 4; ++i) {
+            FakeWindow window;
+            window.process_id_ = static_cast<uint32_t>(100 + i % 2);
+            window.title_ = "Window " + std::to_string(i);
+            window.metrics_.position_ = {static_cast<int32_t>(i) * 10, 0};
+            window.metrics_.size_ = {640, 480};
+            source_.AddWindow(FakeHandle(i), window);
+        }
+        source_.SetProcess(100, {7, "C:\\Apps\\even.exe"});
+        source_.SetProcess(101, {8, "C:\\Apps\\odd.exe"});
+
+        path_ = TracePath(testing::UnitTest::GetInstance()->current_test_info()->name());
+        ASSERT_TRUE(writer_.Open(path_));
+        RecordingWindowSource recording(source_, writer_, ReadError);
+
+        std::vector<ProcessData> windows;
+        EnumerateWindows(recording, strings_, pool_, kDefaultConfig, &windows);
+        WindowTable table;
+        table.Reset(std::move(windows));
+
+        // A batch that adds, renames and removes a window.
+        FakeWindow created;
+        created.title_ = "Created";
+        source_.AddWindow(FakeHandle(5), created);
+        source_.window(FakeHandle(2))->title_ = "Renamed";
+        source_.RemoveWindow(FakeHandle(3));
+        events_ = {{WindowEventType::Created, FakeHandle(5)},
+            {WindowEventType::TitleChanged, FakeHandle(2)},
+            {WindowEventType::Destroyed, FakeHandle(3)}};
+        static_cast<void>(table.Apply(events_, recording, strings_, kDefaultConfig));
+
+        // A call on a window that is gone, which fails and records the error.
+        std::string title;
+        EXPECT_FALSE(recording.GetWindowTitle(FakeHandle(3), &title));
+        duration_ = writer_.Now();
+        writer_.Close();
+    }
+
+    FakeWindowSource source_;
+    StringPool strings_;
+    ProbePool pool_{2};
+    TraceWriter writer_;
+    std::string path_;
+    std::vector<WindowEvent> events_;
+    uint64_t duration_ = 0;
+};
+} // namespace
+
+TEST(WindowTraceTest, EveryFieldRoundTrips) {
+    const std::string kPath = TracePath("every_call");
+    const std::vector<TraceRecord> kRecords = EveryCall();
+    TraceWriter writer;
+    ASSERT_TRUE(writer.Open(kPath));
+    for (const TraceRecord& record : kRecords) {
+        writer.Write(record);
+    }
+    EXPECT_EQ(writer.record_count(), kRecords.size());
+    writer.Close();
+
+    TraceReader reader;
+    ASSERT_TRUE(reader.Open(kPath));
+    EXPECT_FALSE(reader.truncated());
+    ASSERT_EQ(reader.records().size(), kRecords.size());
+    for (size_t i = 0; i < kRecords.size(); ++i) {
+        ExpectSameRecord(kRecords[i], reader.records()[i], i);
+    }
+}
+
+TEST(WindowTraceTest, CutOffTraceKeepsItsCompleteRecords) {
+    const std::string kPath = TracePath("cut_off");
+    const std::vector<TraceRecord> kRecords = EveryCall();
+    TraceWriter writer;
+    ASSERT_TRUE(writer.Open(kPath));
+    for (const TraceRecord& record : kRecords) {
+        writer.Write(record);
+    }
+    writer.Close();
+    const std::vector<char> kBytes = ReadBytes(kPath);
+
+    // Every cut inside the records keeps a prefix, and only a cut between records is clean.
+    const std::string kCutPath = TracePath("cut_off_part");
+    size_t clean_cuts = 0;
+    for (size_t size = 16; size < kBytes.size(); ++size) {
+        SCOPED_TRACE("cut at " + std::to_string(size));
+        WriteBytes(kCutPath, kBytes, size);
+        TraceReader reader;
+        ASSERT_TRUE(reader.Open(kCutPath));
+        ASSERT_LT(reader.records().size(), kRecords.size());
+        for (size_t i = 0; i < reader.records().size(); ++i) {
+            ExpectSameRecord(kRecords[i], reader.records()[i], i);
+        }
+        clean_cuts += reader.truncated() ? 0 : 1;
+    }
+    EXPECT_EQ(clean_cuts, kRecords.size());
+
+    // A header that is cut short is not a trace.
+    WriteBytes(kCutPath, kBytes, 15);
+    TraceReader reader;
+    EXPECT_FALSE(reader.Open(kCutPath));
+}
+
+TEST(WindowTraceTest, TornTailIsDropped) {
+    const std::string kPath = TracePath("torn");
+    const std::vector<TraceRecord> kRecords = EveryCall();
+    TraceWriter writer;
+    ASSERT_TRUE(writer.Open(kPath));
+    for (const TraceRecord& record : kRecords) {
+        writer.Write(record);
+    }
+    writer.Close();
+
+    // Half a record followed by garbage, as a crash in the middle of a write leaves it.
+    std::vector<char> bytes = ReadBytes(kPath);
+    bytes.insert(bytes.end(), {static_cast<char>(TraceCall::GetWindowTitle), 0, 0, 2, 0, 8, 40,
+        'T', 'o', 'r', 'n'});
+    WriteBytes(kPath, bytes, bytes.size());
+    TraceReader reader;
+    ASSERT_TRUE(reader.Open(kPath));
+    EXPECT_TRUE(reader.truncated());
+    ASSERT_EQ(reader.records().size(), kRecords.size());
+    for (size_t i = 0; i < kRecords.size(); ++i) {
+        ExpectSameRecord(kRecords[i], reader.records()[i], i);
+    }
+
+    // A call the reader does not know is torn as well.
+    bytes.resize(bytes.size() - 11);
+    bytes.push_back(static_cast<char>(0xff));
+    WriteBytes(kPath, bytes, bytes.size());
+    ASSERT_TRUE(reader.Open(kPath));
+    EXPECT_TRUE(reader.truncated());
+    EXPECT_EQ(reader.records().size(), kRecords.size());
+
+    // So is a file that is not a trace at all.
+    bytes[0] = 'X';
+    WriteBytes(kPath, bytes, bytes.size());
+    EXPECT_FALSE(reader.Open(kPath));
+}
+
+TEST_F(RecordedTraceTest, RecordsWhatTheSourceAnswered) {
+    TraceReader reader;
+    ASSERT_TRUE(reader.Open(path_));
+    EXPECT_FALSE(reader.truncated());
+
+    size_t enumerations = 0;
+    size_t batches = 0;
+    size_t failures = 0;
+    for (const TraceRecord& record : reader.records()) {
+        EXPECT_LE(record.time_ + record.latency_, duration_);
+        switch (record.call_) {
+            case TraceCall::EnumerateWindowHandles:
+                ++enumerations;
+                EXPECT_EQ(record.window_handles_, (std::vector<HWND>{FakeHandle(4),
+                    FakeHandle(3), FakeHandle(2), FakeHandle(1)}));
+                break;
+            case TraceCall::WindowEvents:
+                ++batches;
+                ASSERT_EQ(record.events_.size(), events_.size());
+                for (size_t i = 0; i < events_.size(); ++i) {
+                    EXPECT_EQ(record.events_[i].type_, events_[i].type_);
+                    EXPECT_EQ(record.events_[i].window_handle_, events_[i].window_handle_);
+                }
+                break;
+            case TraceCall::GetWindowMetrics:
+                if (record.key_ == reinterpret_cast<uintptr_t>(FakeHandle(4))) {
+                    EXPECT_EQ(record.metrics_.position_.x, 40);
+                    EXPECT_EQ(record.metrics_.size_.y, 480);
+                }
+                break;
+            default:
+                break;
+        }
+        if (record.result_ != 0) {
+            ++failures;
+            EXPECT_EQ(record.error_code_, kInvalidWindowHandle);
+        } else {
+            EXPECT_EQ(record.error_code_, 0u);
+        }
+    }
+    EXPECT_EQ(enumerations, 1u);
+    EXPECT_EQ(batches, 1u);
+    EXPECT_GE(failures, 1u);
+
+    // The failed call at the end, after everything else completed.
+    const TraceRecord& kLast = reader.records().back();
+    EXPECT_EQ(kLast.call_, TraceCall::GetWindowTitle);
+    EXPECT_EQ(kLast.key_, reinterpret_cast<uintptr_t>(FakeHandle(3)));
+    EXPECT_EQ(kLast.result_, 1);
+    EXPECT_EQ(kLast.error_code_, kInvalidWindowHandle);
+}
+
+TEST_F(RecordedTraceTest, ReplaysTheSameTableEveryTime) {
+    ReplayWindowSource source(0.0);
+    ASSERT_TRUE(source.Open(path_));
+
+    WindowTable first;
+    std::vector<ReplayStep> steps;
+    ReplayTrace(source, strings_, pool_, kDefaultConfig, &first, &steps);
+    ASSERT_EQ(steps.size(), 2u);
+    EXPECT_EQ(steps[0].call_, TraceCall::EnumerateWindowHandles);
+    EXPECT_EQ(steps[0].windows_, 4u);
+    EXPECT_EQ(steps[1].call_, TraceCall::WindowEvents);
+    EXPECT_EQ(steps[1].windows_, 4u);
+
+    // What the desktop looked like after the batch.
+    ASSERT_EQ(first.size(), 4u);
+    EXPECT_LT(first.Find(FakeHandle(3)), 0);
+    ASSERT_GE(first.Find(FakeHandle(5)), 0);
+    EXPECT_EQ(first[first.Find(FakeHandle(5))].title_, "Created");
+    EXPECT_EQ(first[first.Find(FakeHandle(2))].title_, "Renamed");
+    EXPECT_EQ(first[first.Find(FakeHandle(4))].metrics_.position_.x, 40);
+
+    ASSERT_TRUE(source.Open(path_));
+    WindowTable second;
+    ReplayTrace(source, strings_, pool_, kDefaultConfig, &second, &steps);
+    ExpectSameTable(first, second);
+    EXPECT_EQ(source.misses(), 0u);
+}
+} // namespace fsb